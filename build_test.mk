@@ -40,6 +40,10 @@ VPATH += \
 
 all: elf
 
+# Runs the test and keeps what its benchmarks measured as JSON next to the executable
+bench: elf
+	QMK_BENCHMARK_JSON=$(BUILD_DIR)/$(TARGET).json $(BUILD_DIR)/$(TARGET).elf
+
 VPATH += $(COMMON_VPATH)
 PLATFORM:=TEST
 PLATFORM_KEY:=test
@@ -60,6 +64,13 @@ include $(TMK_PATH)/protocol.mk
 include $(QUANTUM_PATH)/debounce/tests/rules.mk
 include $(QUANTUM_PATH)/encoder/tests/rules.mk
 include $(QUANTUM_PATH)/sequencer/tests/rules.mk
+include $(QUANTUM_PATH)/split_common/tests/rules.mk
+include $(QUANTUM_PATH)/audio/tests/rules.mk
+include $(QUANTUM_PATH)/tests/rules.mk
+include $(DRIVER_PATH)/oled/tests/rules.mk
+include $(DRIVER_PATH)/sensors/tests/rules.mk
+include $(DRIVER_PATH)/ps2/tests/rules.mk
+include $(DRIVER_PATH)/led/issi/tests/rules.mk
 include $(PLATFORM_PATH)/test/rules.mk
 ifneq ($(filter $(FULL_TESTS),$(TEST)),)
 include build_full_test.mk
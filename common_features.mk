@@ -46,6 +46,12 @@ else ifeq ($(strip $(DEBUG_MATRIX_SCAN_RATE_ENABLE)), api)
     OPT_DEFS += -DDEBUG_MATRIX_SCAN_RATE
 endif
 
+ifeq ($(strip $(PROFILER_ENABLE)), yes)
+    OPT_DEFS += -DPROFILER_ENABLE
+    SRC += $(QUANTUM_DIR)/profiler.c
+    SRC += $(PLATFORM_PATH)/$(PLATFORM_KEY)/profiler.c
+endif
+
 AUDIO_ENABLE ?= no
 ifeq ($(strip $(AUDIO_ENABLE)), yes)
     ifeq ($(PLATFORM),CHIBIOS)
@@ -54,6 +60,7 @@ ifeq ($(strip $(AUDIO_ENABLE)), yes)
             OPT_DEFS += -DAUDIO_DRIVER_DAC
         else ifeq ($(strip $(AUDIO_DRIVER)), dac_additive)
             OPT_DEFS += -DAUDIO_DRIVER_DAC
+            SRC += $(QUANTUM_DIR)/audio/mixer.c
         ## stm32f2 and above have a usable DAC unit, f1 do not, and need to use pwm instead
         else ifeq ($(strip $(AUDIO_DRIVER)), pwm_software)
             OPT_DEFS += -DAUDIO_DRIVER_PWM
@@ -20,3 +20,5 @@
 
 void eeprom_driver_init(void);
 void eeprom_driver_erase(void);
+void eeprom_driver_task(void);  // Called from the main loop, for drivers that hold back writes
+void eeprom_flush(void);        // Writes out anything the driver is holding back, before a reset or power loss
@@ -0,0 +1,81 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Dirty tracking for the IS31FL37xx PWM buffers. A register is only marked
+// dirty when its buffered value changes, so clean registers always hold what
+// the chip already has and the buffer doubles as the shadow copy of the chip.
+// Only the dirty registers are sent, in as few auto-increment transfers as
+// the transfer buffer allows.
+
+// Clean registers between two dirty ones are sent along rather than starting
+// another transfer, as long as that is no more than the address and register
+// bytes of a new transfer would cost.
+#ifndef ISSI_PWM_MERGE_GAP
+#    define ISSI_PWM_MERGE_GAP 2
+#endif
+
+#define IS31_DIRTY_SIZE(registers) (((registers) + 7) / 8)
+
+static inline bool is31_dirty_get(const uint8_t *dirty, uint16_t index) { return dirty[index / 8] & (1 << (index % 8)); }
+
+static inline void is31_dirty_mark(uint8_t *dirty, uint16_t start, uint16_t length) {
+    for (uint16_t i = start; i < start + length; i++) {
+        dirty[i / 8] |= 1 << (i % 8);
+    }
+}
+
+// Sets a register in the PWM buffer, returns true if that changed it
+static inline bool is31_dirty_set(uint8_t *pwm_buffer, uint8_t *dirty, uint16_t index, uint8_t value) {
+    if (pwm_buffer[index] == value) {
+        return false;
+    }
+    pwm_buffer[index] = value;
+    is31_dirty_mark(dirty, index, 1);
+    return true;
+}
+
+// Finds the next run of dirty registers from *start up to end, at most max_length long.
+// Moves *start to the beginning of the run, marks the run clean and returns its length,
+// or 0 if there is nothing left to send before end.
+static inline uint16_t is31_dirty_next_run(uint8_t *dirty, uint16_t *start, uint16_t end, uint16_t max_length) {
+    uint16_t first = *start;
+    while (first < end && !is31_dirty_get(dirty, first)) {
+        // skip clean bytes of the bitmap in one go
+        first = (first % 8 == 0 && dirty[first / 8] == 0) ? first + 8 : first + 1;
+    }
+    if (first >= end) {
+        *start = end;
+        return 0;
+    }
+
+    uint16_t last = first;
+    for (uint16_t i = first + 1; i < end && i < first + max_length && i <= last + ISSI_PWM_MERGE_GAP + 1; i++) {
+        if (is31_dirty_get(dirty, i)) {
+            last = i;
+        }
+    }
+    for (uint16_t i = first; i <= last; i++) {
+        dirty[i / 8] &= ~(1 << (i % 8));
+    }
+
+    *start = first;
+    return last - first + 1;
+}
@@ -17,6 +17,8 @@
  */
 
 #include "is31fl3731.h"
+#include "is31_dirty.h"
+#include <string.h>
 #include "i2c_master.h"
 #include "wait.h"
 
@@ -66,7 +68,8 @@ uint8_t g_twi_transfer_buffer[20];
 // buffers and the transfers in IS31FL3731_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][144];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][IS31_DIRTY_SIZE(144)] = {{0}};
+bool    g_pwm_buffer_update_required[DRIVER_COUNT]             = {false};
 
 uint8_t g_led_control_registers[DRIVER_COUNT][18]             = {{0}};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
@@ -125,6 +128,34 @@ void IS31FL3731_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     }
 }
 
+// Sends only the PWM registers that changed, see is31_dirty.h
+static bool IS31FL3731_write_pwm_changes(uint8_t addr, uint8_t *pwm_buffer, uint8_t *dirty) {
+    // assumes bank is already selected
+    // If a transfer fails the function returns false, with the
+    // registers that weren't sent still marked dirty.
+
+    uint16_t start = 0, length;
+    while ((length = is31_dirty_next_run(dirty, &start, 144, 16)) > 0) {
+        g_twi_transfer_buffer[0] = 0x24 + start;
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + start, length);
+
+#if ISSI_PERSISTENCE > 0
+        i2c_status_t status = I2C_STATUS_ERROR;
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE && status != I2C_STATUS_SUCCESS; i++) {
+            status = i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT);
+        }
+#else
+        i2c_status_t status = i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT);
+#endif
+        if (status != I2C_STATUS_SUCCESS) {
+            is31_dirty_mark(dirty, start, length);
+            return false;
+        }
+        start += length;
+    }
+    return true;
+}
+
 void IS31FL3731_init(uint8_t addr) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, first enable software shutdown,
@@ -167,6 +198,9 @@ void IS31FL3731_init(uint8_t addr) {
     for (int i = 0x24; i <= 0xB3; i++) {
         IS31FL3731_write_register(addr, i, 0x00);
     }
+    // Every driver is set up before any LED, so the shadow copy can simply start over to match
+    memset(g_pwm_buffer, 0, sizeof(g_pwm_buffer));
+    memset(g_pwm_buffer_dirty, 0, sizeof(g_pwm_buffer_dirty));
 
     // select "function register" bank
     IS31FL3731_write_register(addr, ISSI_COMMANDREGISTER, ISSI_BANK_FUNCTIONREG);
@@ -186,10 +220,12 @@ void IS31FL3731_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
         // Subtract 0x24 to get the second index of g_pwm_buffer
-        g_pwm_buffer[led.driver][led.r - 0x24]   = red;
-        g_pwm_buffer[led.driver][led.g - 0x24]   = green;
-        g_pwm_buffer[led.driver][led.b - 0x24]   = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        bool changed = is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.r - 0x24, red);
+        changed |= is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.g - 0x24, green);
+        changed |= is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.b - 0x24, blue);
+        if (changed) {
+            g_pwm_buffer_update_required[led.driver] = true;
+        }
     }
 }
 
@@ -231,7 +267,10 @@ void IS31FL3731_set_led_control_register(uint8_t index, bool red, bool green, bo
 
 void IS31FL3731_update_pwm_buffers(uint8_t addr, uint8_t index) {
     if (g_pwm_buffer_update_required[index]) {
-        IS31FL3731_write_pwm_buffer(addr, g_pwm_buffer[index]);
+        // What doesn't make it stays dirty for next time
+        if (!IS31FL3731_write_pwm_changes(addr, g_pwm_buffer[index], g_pwm_buffer_dirty[index])) {
+            return;
+        }
     }
     g_pwm_buffer_update_required[index] = false;
 }
@@ -18,6 +18,8 @@
  */
 
 #include "is31fl3733.h"
+#include "is31_dirty.h"
+#include <string.h>
 #include "i2c_master.h"
 #include "wait.h"
 
@@ -79,7 +81,8 @@ uint8_t g_twi_transfer_buffer[20];
 // buffers and the transfers in IS31FL3733_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][192];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][IS31_DIRTY_SIZE(192)] = {{0}};
+bool    g_pwm_buffer_update_required[DRIVER_COUNT]             = {false};
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24]             = {0};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
@@ -134,6 +137,35 @@ bool IS31FL3733_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     return true;
 }
 
+// Sends only the PWM registers that changed, see is31_dirty.h
+static bool IS31FL3733_write_pwm_changes(uint8_t addr, uint8_t *pwm_buffer, uint8_t *dirty) {
+    // Assumes PG1 is already selected.
+    // If any of the transactions fails function returns false, with the
+    // registers that weren't sent still marked dirty.
+
+    uint16_t start = 0, length;
+    while ((length = is31_dirty_next_run(dirty, &start, 192, 16)) > 0) {
+        g_twi_transfer_buffer[0] = start;
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + start, length);
+
+#if ISSI_PERSISTENCE > 0
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
+                is31_dirty_mark(dirty, start, length);
+                return false;
+            }
+        }
+#else
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
+            is31_dirty_mark(dirty, start, length);
+            return false;
+        }
+#endif
+        start += length;
+    }
+    return true;
+}
+
 void IS31FL3733_init(uint8_t addr, uint8_t sync) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, shutdown is enabled last.
@@ -161,6 +193,9 @@ void IS31FL3733_init(uint8_t addr, uint8_t sync) {
     for (int i = 0x00; i <= 0xBF; i++) {
         IS31FL3733_write_register(addr, i, 0x00);
     }
+    // Every driver is set up before any LED, so the shadow copy can simply start over to match
+    memset(g_pwm_buffer, 0, sizeof(g_pwm_buffer));
+    memset(g_pwm_buffer_dirty, 0, sizeof(g_pwm_buffer_dirty));
 
     // Unlock the command register.
     IS31FL3733_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
@@ -185,10 +220,12 @@ void IS31FL3733_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        bool changed = is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.r, red);
+        changed |= is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.g, green);
+        changed |= is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.b, blue);
+        if (changed) {
+            g_pwm_buffer_update_required[led.driver] = true;
+        }
     }
 }
 
@@ -235,9 +272,10 @@ void IS31FL3733_update_pwm_buffers(uint8_t addr, uint8_t index) {
         IS31FL3733_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM);
 
         // If any of the transactions fail we risk writing dirty PG0,
-        // refresh page 0 just in case.
-        if (!IS31FL3733_write_pwm_buffer(addr, g_pwm_buffer[index])) {
+        // refresh page 0 just in case, and send what's left next time.
+        if (!IS31FL3733_write_pwm_changes(addr, g_pwm_buffer[index], g_pwm_buffer_dirty[index])) {
             g_led_control_registers_update_required[index] = true;
+            return;
         }
     }
     g_pwm_buffer_update_required[index] = false;
@@ -16,6 +16,8 @@
  */
 
 #include "is31fl3736.h"
+#include "is31_dirty.h"
+#include <string.h>
 #include "i2c_master.h"
 #include "wait.h"
 
@@ -73,7 +75,8 @@ uint8_t g_twi_transfer_buffer[20];
 // buffers and the transfers in IS31FL3736_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][192];
-bool    g_pwm_buffer_update_required = false;
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][IS31_DIRTY_SIZE(192)] = {{0}};
+bool    g_pwm_buffer_update_required                           = false;
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24] = {{0}, {0}};
 bool    g_led_control_registers_update_required   = false;
@@ -117,6 +120,34 @@ void IS31FL3736_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     }
 }
 
+// Sends only the PWM registers that changed, see is31_dirty.h
+static bool IS31FL3736_write_pwm_changes(uint8_t addr, uint8_t *pwm_buffer, uint8_t *dirty) {
+    // assumes PG1 is already selected
+    // If a transfer fails the function returns false, with the
+    // registers that weren't sent still marked dirty.
+
+    uint16_t start = 0, length;
+    while ((length = is31_dirty_next_run(dirty, &start, 192, 16)) > 0) {
+        g_twi_transfer_buffer[0] = start;
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + start, length);
+
+#if ISSI_PERSISTENCE > 0
+        i2c_status_t status = I2C_STATUS_ERROR;
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE && status != I2C_STATUS_SUCCESS; i++) {
+            status = i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT);
+        }
+#else
+        i2c_status_t status = i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT);
+#endif
+        if (status != I2C_STATUS_SUCCESS) {
+            is31_dirty_mark(dirty, start, length);
+            return false;
+        }
+        start += length;
+    }
+    return true;
+}
+
 void IS31FL3736_init(uint8_t addr) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, shutdown is enabled last.
@@ -143,6 +174,9 @@ void IS31FL3736_init(uint8_t addr) {
     for (int i = 0x00; i <= 0xBF; i++) {
         IS31FL3736_write_register(addr, i, 0x00);
     }
+    // Every driver is set up before any LED, so the shadow copy can simply start over to match
+    memset(g_pwm_buffer, 0, sizeof(g_pwm_buffer));
+    memset(g_pwm_buffer_dirty, 0, sizeof(g_pwm_buffer_dirty));
 
     // Unlock the command register.
     IS31FL3736_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
@@ -167,10 +201,12 @@ void IS31FL3736_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
-        g_pwm_buffer[led.driver][led.r] = red;
-        g_pwm_buffer[led.driver][led.g] = green;
-        g_pwm_buffer[led.driver][led.b] = blue;
-        g_pwm_buffer_update_required    = true;
+        bool changed = is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.r, red);
+        changed |= is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.g, green);
+        changed |= is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.b, blue);
+        if (changed) {
+            g_pwm_buffer_update_required = true;
+        }
     }
 }
 
@@ -228,9 +264,10 @@ void IS31FL3736_mono_set_brightness(int index, uint8_t value) {
     if (index >= 0 && index < 96) {
         // Index in range 0..95 -> A1..A8, B1..B8, etc.
         // Map index 0..95 to registers 0x00..0xBE (interleaved)
-        uint8_t pwm_register          = index * 2;
-        g_pwm_buffer[0][pwm_register] = value;
-        g_pwm_buffer_update_required  = true;
+        uint8_t pwm_register = index * 2;
+        if (is31_dirty_set(g_pwm_buffer[0], g_pwm_buffer_dirty[0], pwm_register, value)) {
+            g_pwm_buffer_update_required = true;
+        }
     }
 }
 
@@ -264,7 +301,12 @@ void IS31FL3736_update_pwm_buffers(uint8_t addr1, uint8_t addr2) {
         IS31FL3736_write_register(addr1, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
         IS31FL3736_write_register(addr1, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM);
 
-        IS31FL3736_write_pwm_buffer(addr1, g_pwm_buffer[0]);
+        // If any of the transactions fail we risk writing dirty PG0,
+        // refresh page 0 just in case, and send what's left next time.
+        if (!IS31FL3736_write_pwm_changes(addr1, g_pwm_buffer[0], g_pwm_buffer_dirty[0])) {
+            g_led_control_registers_update_required = true;
+            return;
+        }
         // IS31FL3736_write_pwm_buffer(addr2, g_pwm_buffer[1]);
     }
     g_pwm_buffer_update_required = false;
@@ -18,6 +18,8 @@
  */
 
 #include "is31fl3737.h"
+#include "is31_dirty.h"
+#include <string.h>
 #include "i2c_master.h"
 #include "wait.h"
 
@@ -76,7 +78,8 @@ uint8_t g_twi_transfer_buffer[20];
 // probably not worth the extra complexity.
 
 uint8_t g_pwm_buffer[DRIVER_COUNT][192];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][IS31_DIRTY_SIZE(192)] = {{0}};
+bool    g_pwm_buffer_update_required[DRIVER_COUNT]             = {false};
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24]             = {0};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
@@ -120,6 +123,34 @@ void IS31FL3737_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     }
 }
 
+// Sends only the PWM registers that changed, see is31_dirty.h
+static bool IS31FL3737_write_pwm_changes(uint8_t addr, uint8_t *pwm_buffer, uint8_t *dirty) {
+    // assumes PG1 is already selected
+    // If a transfer fails the function returns false, with the
+    // registers that weren't sent still marked dirty.
+
+    uint16_t start = 0, length;
+    while ((length = is31_dirty_next_run(dirty, &start, 192, 16)) > 0) {
+        g_twi_transfer_buffer[0] = start;
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + start, length);
+
+#if ISSI_PERSISTENCE > 0
+        i2c_status_t status = I2C_STATUS_ERROR;
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE && status != I2C_STATUS_SUCCESS; i++) {
+            status = i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT);
+        }
+#else
+        i2c_status_t status = i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT);
+#endif
+        if (status != I2C_STATUS_SUCCESS) {
+            is31_dirty_mark(dirty, start, length);
+            return false;
+        }
+        start += length;
+    }
+    return true;
+}
+
 void IS31FL3737_init(uint8_t addr) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, shutdown is enabled last.
@@ -146,6 +177,9 @@ void IS31FL3737_init(uint8_t addr) {
     for (int i = 0x00; i <= 0xBF; i++) {
         IS31FL3737_write_register(addr, i, 0x00);
     }
+    // Every driver is set up before any LED, so the shadow copy can simply start over to match
+    memset(g_pwm_buffer, 0, sizeof(g_pwm_buffer));
+    memset(g_pwm_buffer_dirty, 0, sizeof(g_pwm_buffer_dirty));
 
     // Unlock the command register.
     IS31FL3737_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
@@ -170,10 +204,12 @@ void IS31FL3737_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        bool changed = is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.r, red);
+        changed |= is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.g, green);
+        changed |= is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.b, blue);
+        if (changed) {
+            g_pwm_buffer_update_required[led.driver] = true;
+        }
     }
 }
 
@@ -219,7 +255,12 @@ void IS31FL3737_update_pwm_buffers(uint8_t addr, uint8_t index) {
         IS31FL3737_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
         IS31FL3737_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM);
 
-        IS31FL3737_write_pwm_buffer(addr, g_pwm_buffer[index]);
+        // If any of the transactions fail we risk writing dirty PG0,
+        // refresh page 0 just in case, and send what's left next time.
+        if (!IS31FL3737_write_pwm_changes(addr, g_pwm_buffer[index], g_pwm_buffer_dirty[index])) {
+            g_led_control_registers_update_required[index] = true;
+            return;
+        }
     }
     g_pwm_buffer_update_required[index] = false;
 }
@@ -20,6 +20,7 @@
 #include "wait.h"
 
 #include "is31fl3741.h"
+#include "is31_dirty.h"
 #include <string.h>
 #include "i2c_master.h"
 #include "progmem.h"
@@ -81,8 +82,9 @@ uint8_t g_twi_transfer_buffer[20] = {0xFF};
 // buffers and the transfers in IS31FL3741_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][ISSI_MAX_LEDS];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT]        = {false};
-bool    g_scaling_registers_update_required[DRIVER_COUNT] = {false};
+uint8_t g_pwm_buffer_dirty[DRIVER_COUNT][IS31_DIRTY_SIZE(ISSI_MAX_LEDS)] = {{0}};
+bool    g_pwm_buffer_update_required[DRIVER_COUNT]                       = {false};
+bool    g_scaling_registers_update_required[DRIVER_COUNT]                = {false};
 
 uint8_t g_scaling_registers[DRIVER_COUNT][ISSI_MAX_LEDS];
 
@@ -146,6 +148,43 @@ bool IS31FL3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
     return true;
 }
 
+// Sends only the PWM registers that changed, see is31_dirty.h
+static bool IS31FL3741_write_pwm_changes(uint8_t addr, uint8_t *pwm_buffer, uint8_t *dirty) {
+    // The first 180 registers are on PG0, the rest on PG1
+    for (uint16_t page = 0; page < 2; page++) {
+        uint16_t start = page * 180, end = page ? ISSI_MAX_LEDS : 180, length;
+        bool     selected = false;
+
+        while ((length = is31_dirty_next_run(dirty, &start, end, 18)) > 0) {
+            if (!selected) {
+                // unlock the command register and select PG0 or PG1
+                IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
+                IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, page ? ISSI_PAGE_PWM1 : ISSI_PAGE_PWM0);
+                selected = true;
+            }
+
+            g_twi_transfer_buffer[0] = start % 180;
+            memcpy(g_twi_transfer_buffer + 1, pwm_buffer + start, length);
+
+#if ISSI_PERSISTENCE > 0
+            for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+                if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
+                    is31_dirty_mark(dirty, start, length);
+                    return false;
+                }
+            }
+#else
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
+                is31_dirty_mark(dirty, start, length);
+                return false;
+            }
+#endif
+            start += length;
+        }
+    }
+    return true;
+}
+
 void IS31FL3741_init(uint8_t addr) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, shutdown is enabled last.
@@ -169,6 +208,14 @@ void IS31FL3741_init(uint8_t addr) {
 
     // IS31FL3741_update_led_scaling_registers(addr, 0xFF, 0xFF, 0xFF);
 
+    // The PWM pages keep their values over a reset of the MCU alone, so the shadow copy starts out
+    // cleared and all dirty, and the first update writes every register
+    memset(g_pwm_buffer, 0, sizeof(g_pwm_buffer));
+    for (uint8_t i = 0; i < DRIVER_COUNT; i++) {
+        is31_dirty_mark(g_pwm_buffer_dirty[i], 0, ISSI_MAX_LEDS);
+        g_pwm_buffer_update_required[i] = true;
+    }
+
     // Wait 10ms to ensure the device has woken up.
     wait_ms(10);
 }
@@ -178,10 +225,12 @@ void IS31FL3741_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        bool changed = is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.r, red);
+        changed |= is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.g, green);
+        changed |= is31_dirty_set(g_pwm_buffer[led.driver], g_pwm_buffer_dirty[led.driver], led.b, blue);
+        if (changed) {
+            g_pwm_buffer_update_required[led.driver] = true;
+        }
     }
 }
 
@@ -218,18 +267,23 @@ void IS31FL3741_set_led_control_register(uint8_t index, bool red, bool green, bo
 
 void IS31FL3741_update_pwm_buffers(uint8_t addr, uint8_t index) {
     if (g_pwm_buffer_update_required[index]) {
-        IS31FL3741_write_pwm_buffer(addr, g_pwm_buffer[index]);
+        // What doesn't make it stays dirty for next time
+        if (!IS31FL3741_write_pwm_changes(addr, g_pwm_buffer[index], g_pwm_buffer_dirty[index])) {
+            return;
+        }
     }
 
     g_pwm_buffer_update_required[index] = false;
 }
 
 void IS31FL3741_set_pwm_buffer(const is31_led *pled, uint8_t red, uint8_t green, uint8_t blue) {
-    g_pwm_buffer[pled->driver][pled->r] = red;
-    g_pwm_buffer[pled->driver][pled->g] = green;
-    g_pwm_buffer[pled->driver][pled->b] = blue;
+    bool changed = is31_dirty_set(g_pwm_buffer[pled->driver], g_pwm_buffer_dirty[pled->driver], pled->r, red);
+    changed |= is31_dirty_set(g_pwm_buffer[pled->driver], g_pwm_buffer_dirty[pled->driver], pled->g, green);
+    changed |= is31_dirty_set(g_pwm_buffer[pled->driver], g_pwm_buffer_dirty[pled->driver], pled->b, blue);
 
-    g_pwm_buffer_update_required[pled->driver] = true;
+    if (changed) {
+        g_pwm_buffer_update_required[pled->driver] = true;
+    }
 }
 
 void IS31FL3741_update_led_control_registers(uint8_t addr, uint8_t index) {
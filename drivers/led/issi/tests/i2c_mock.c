@@ -0,0 +1,56 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "i2c_master.h"
+
+uint8_t             i2c_mock_log[I2C_MOCK_LOG_SIZE];
+i2c_mock_transfer_t i2c_mock_transfers[I2C_MOCK_MAX_TRANSFERS];
+uint16_t            i2c_mock_transfer_count = 0;
+i2c_status_t        i2c_mock_status         = I2C_STATUS_SUCCESS;
+
+static uint16_t log_size = 0;
+
+void i2c_mock_reset(void) {
+    log_size                = 0;
+    i2c_mock_transfer_count = 0;
+    i2c_mock_status         = I2C_STATUS_SUCCESS;
+}
+
+// Everything the transfers put on the bus: the address byte, then the data
+uint32_t i2c_mock_bus_bytes(void) {
+    uint32_t bytes = 0;
+    for (uint16_t t = 0; t < i2c_mock_transfer_count; t++) {
+        bytes += 1 + i2c_mock_transfers[t].length;
+    }
+    return bytes;
+}
+
+void i2c_init(void) {}
+
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout) {
+    if (i2c_mock_status != I2C_STATUS_SUCCESS) {
+        return i2c_mock_status;
+    }
+    if (i2c_mock_transfer_count >= I2C_MOCK_MAX_TRANSFERS || log_size + length > I2C_MOCK_LOG_SIZE) {
+        return I2C_STATUS_ERROR;
+    }
+
+    i2c_mock_transfers[i2c_mock_transfer_count++] = (i2c_mock_transfer_t){.address = address, .start = log_size, .length = length};
+    for (uint16_t i = 0; i < length; i++) {
+        i2c_mock_log[log_size++] = data[i];
+    }
+    return I2C_STATUS_SUCCESS;
+}
@@ -0,0 +1,251 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "i2c_master.h"
+#if defined(IS31FL3731)
+#    include "is31fl3731.h"
+#elif defined(IS31FL3733)
+#    include "is31fl3733.h"
+#elif defined(IS31FL3737)
+#    include "is31fl3737.h"
+#elif defined(IS31FL3741)
+#    include "is31fl3741.h"
+#endif
+
+extern uint8_t g_pwm_buffer[DRIVER_COUNT][PWM_REGISTERS];
+}
+
+#define ADDR 0x50
+
+#if defined(IS31FL3731)
+#    define REG(i) (0x24 + (i))
+#    define init() IS31FL3731_init(ADDR)
+#    define set_color IS31FL3731_set_color
+#    define write_pwm_buffer IS31FL3731_write_pwm_buffer
+#    define update_pwm_buffers() IS31FL3731_update_pwm_buffers(ADDR, 0)
+#elif defined(IS31FL3733)
+#    define REG(i) (i)
+#    define init() IS31FL3733_init(ADDR, 0)
+#    define set_color IS31FL3733_set_color
+#    define write_pwm_buffer IS31FL3733_write_pwm_buffer
+#    define update_pwm_buffers() IS31FL3733_update_pwm_buffers(ADDR, 0)
+#elif defined(IS31FL3737)
+#    define REG(i) (i)
+#    define init() IS31FL3737_init(ADDR)
+#    define set_color IS31FL3737_set_color
+#    define write_pwm_buffer IS31FL3737_write_pwm_buffer
+#    define update_pwm_buffers() IS31FL3737_update_pwm_buffers(ADDR, 0)
+#elif defined(IS31FL3741)
+#    define REG(i) (i)
+#    define init() IS31FL3741_init(ADDR)
+#    define set_color IS31FL3741_set_color
+#    define write_pwm_buffer IS31FL3741_write_pwm_buffer
+#    define update_pwm_buffers() IS31FL3741_update_pwm_buffers(ADDR, 0)
+#endif
+
+/* Red, green and blue each in their own block of registers, like most boards wire them */
+#define LED(k) {0, REG(k), REG((k) + DRIVER_LED_TOTAL), REG((k) + 2 * DRIVER_LED_TOTAL)},
+#define LEDS_1(k) LED(k)
+#define LEDS_4(k) LEDS_1(k) LEDS_1(k + 1) LEDS_1(k + 2) LEDS_1(k + 3)
+#define LEDS_16(k) LEDS_4(k) LEDS_4(k + 4) LEDS_4(k + 8) LEDS_4(k + 12)
+#define LEDS_64(k) LEDS_16(k) LEDS_16(k + 16) LEDS_16(k + 32) LEDS_16(k + 48)
+
+// clang-format off
+const is31_led PROGMEM g_is31_leds[DRIVER_LED_TOTAL] = {
+#if DRIVER_LED_TOTAL == 48
+    LEDS_16(0) LEDS_16(16) LEDS_16(32)
+#elif DRIVER_LED_TOTAL == 64
+    LEDS_64(0)
+#elif DRIVER_LED_TOTAL == 117
+    LEDS_64(0) LEDS_16(64) LEDS_16(80) LEDS_16(96) LEDS_4(112) LEDS_1(116)
+#endif
+};
+// clang-format on
+
+/* Just enough of the chip to replay the recorded transfers: the command register picks the page, everything else auto-increments */
+class Chip {
+   public:
+    uint8_t pages[16][256] = {};
+    uint8_t page           = 0;
+
+    void replay(void) {
+        for (uint16_t t = 0; t < i2c_mock_transfer_count; t++) {
+            const uint8_t* data   = &i2c_mock_log[i2c_mock_transfers[t].start];
+            uint16_t       length = i2c_mock_transfers[t].length;
+            EXPECT_EQ(i2c_mock_transfers[t].address, ADDR << 1);
+            if (data[0] == 0xFD) {
+                page = data[1];
+            } else if (data[0] != 0xFE) {
+                for (uint16_t i = 1; i < length; i++) {
+                    pages[page][data[0] + i - 1] = data[i];
+                }
+            }
+        }
+    }
+
+    uint8_t pwm(uint16_t i) {
+#if defined(IS31FL3731)
+        return pages[0][REG(i)];
+#elif defined(IS31FL3733) || defined(IS31FL3737)
+        return pages[1][i];
+#elif defined(IS31FL3741)
+        return pages[i / 180][i % 180];
+#endif
+    }
+};
+
+class IssiTest : public testing::Test {
+   protected:
+    Chip chip;
+
+    void SetUp() override {
+        memset(g_pwm_buffer, 0, sizeof(g_pwm_buffer));
+        i2c_mock_reset();
+        init();
+        flush();
+    }
+
+    /* Sends the frame, applies it to the chip and returns the bytes it took on the bus */
+    uint32_t flush(void) {
+        i2c_mock_reset();
+        update_pwm_buffers();
+        chip.replay();
+        for (uint16_t i = 0; i < PWM_REGISTERS; i++) {
+            EXPECT_EQ(chip.pwm(i), g_pwm_buffer[0][i]) << "register " << i;
+        }
+        return i2c_mock_bus_bytes();
+    }
+
+    /* What sending the whole page takes */
+    uint32_t full_page_bytes(void) {
+        i2c_mock_reset();
+        write_pwm_buffer(ADDR, g_pwm_buffer[0]);
+        uint32_t bytes = i2c_mock_bus_bytes();
+        i2c_mock_reset();
+        return bytes;
+    }
+
+    /* Runs an effect, returns the bus bytes of every frame */
+    template <typename Effect>
+    std::vector<uint32_t> run(Effect effect, int frames = 32) {
+        std::vector<uint32_t> bytes;
+        for (int frame = 0; frame < frames; frame++) {
+            for (int led = 0; led < DRIVER_LED_TOTAL; led++) {
+                uint8_t r, g, b;
+                effect(frame, led, r, g, b);
+                set_color(led, r, g, b);
+            }
+            bytes.push_back(flush());
+        }
+        return bytes;
+    }
+};
+
+TEST_F(IssiTest, SolidColorIsSentOnce) {
+    auto bytes = run([](int frame, int led, uint8_t& r, uint8_t& g, uint8_t& b) { r = 0x10, g = 0x80, b = 0xFF; });
+    EXPECT_GT(bytes[0], 0u);
+    EXPECT_LE(bytes[0], full_page_bytes() + 6);
+    for (size_t i = 1; i < bytes.size(); i++) {
+        EXPECT_EQ(bytes[i], 0u) << "frame " << i;
+    }
+}
+
+TEST_F(IssiTest, ReactiveKeySendsOnlyItsRegisters) {
+    /* One key fading out on a dark board */
+    auto bytes = run([](int frame, int led, uint8_t& r, uint8_t& g, uint8_t& b) { r = g = b = led == 5 ? 255 - frame * 8 : 0; });
+    uint32_t total = 0;
+    for (auto frame : bytes) {
+        /* At most two page selects, then three single register writes */
+        EXPECT_LE(frame, 2 * 6u + 3 * 3);
+        total += frame;
+    }
+    RecordProperty("ReactiveBytes", total);
+    RecordProperty("FullPageBytes", full_page_bytes() * bytes.size());
+}
+
+TEST_F(IssiTest, SplashSendsNeighboursTogether) {
+    /* A few neighbouring keys lit by a wave that moves along the row */
+    auto bytes = run([](int frame, int led, uint8_t& r, uint8_t& g, uint8_t& b) {
+        int distance = led - frame;
+        r = g = b = (distance >= 0 && distance < 4) ? 0xFF - distance * 0x30 : 0;
+    });
+    uint32_t full = full_page_bytes();
+    for (auto frame : bytes) {
+        EXPECT_LT(frame, full / 4);
+    }
+}
+
+TEST_F(IssiTest, CycleAllIsNoWorseThanTheFullPage) {
+    /* Every register changes every frame */
+    auto bytes = run([](int frame, int led, uint8_t& r, uint8_t& g, uint8_t& b) {
+        r = frame * 8 + led;
+        g = frame * 8 + led + 85;
+        b = frame * 8 + led + 170;
+    });
+    uint32_t full = full_page_bytes();
+    for (size_t i = 0; i < bytes.size(); i++) {
+        EXPECT_LE(bytes[i], full + 6) << "frame " << i;
+    }
+}
+
+TEST_F(IssiTest, BreathingSkipsUnusedRegisters) {
+    /* Every LED changes, but registers that no LED uses never need sending */
+    auto bytes = run([](int frame, int led, uint8_t& r, uint8_t& g, uint8_t& b) { r = g = b = frame * 7; });
+    uint32_t total = 0;
+    for (auto frame : bytes) {
+        total += frame;
+    }
+    RecordProperty("BreathingBytes", total);
+}
+
+TEST_F(IssiTest, FailedTransfersAreSentAgain) {
+    for (int led = 0; led < DRIVER_LED_TOTAL; led++) {
+        set_color(led, led, 0x40, 0xFF - led);
+    }
+    i2c_mock_reset();
+    i2c_mock_status = I2C_STATUS_ERROR;
+    update_pwm_buffers();
+    EXPECT_EQ(i2c_mock_transfer_count, 0);
+
+    /* Nothing new was set, the next update still sends all of it */
+    flush();
+    EXPECT_EQ(chip.pwm(REG(3) - REG(0)), 3);
+}
+
+TEST_F(IssiTest, InitForgetsEarlierColors) {
+    /* A reset of the MCU alone leaves the chip lit with what it had, while the shadow copy starts over from zero */
+    set_color(7, 0x11, 0x22, 0x33);
+    flush();
+    memset(g_pwm_buffer, 0, sizeof(g_pwm_buffer));
+    i2c_mock_reset();
+    init();
+    chip.replay();
+
+    /* Turning the LED off has to reach the chip, flush() checks every register */
+    set_color(7, 0, 0, 0);
+    flush();
+    EXPECT_EQ(chip.pwm(REG(7) - REG(0)), 0);
+
+    set_color(7, 0x11, 0x22, 0x33);
+    flush();
+    EXPECT_EQ(chip.pwm(REG(7) - REG(0)), 0x11);
+}
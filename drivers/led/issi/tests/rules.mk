@@ -0,0 +1,23 @@
+issi_DEFS := -DNO_PRINT -DNO_DEBUG -DDRIVER_COUNT=1
+
+issi_3731_DEFS := $(issi_DEFS) -DIS31FL3731 -DDRIVER_LED_TOTAL=48 -DPWM_REGISTERS=144
+issi_3733_DEFS := $(issi_DEFS) -DIS31FL3733 -DDRIVER_LED_TOTAL=64 -DPWM_REGISTERS=192
+issi_3737_DEFS := $(issi_DEFS) -DIS31FL3737 -DDRIVER_LED_TOTAL=64 -DPWM_REGISTERS=192
+issi_3741_DEFS := $(issi_DEFS) -DIS31FL3741 -DDRIVER_LED_TOTAL=117 -DPWM_REGISTERS=351
+
+issi_INC := \
+	$(DRIVER_PATH)/led/issi/tests \
+	$(DRIVER_PATH)/led/issi
+issi_3731_INC := $(issi_INC)
+issi_3733_INC := $(issi_INC)
+issi_3737_INC := $(issi_INC)
+issi_3741_INC := $(issi_INC)
+
+issi_SRC := \
+	$(DRIVER_PATH)/led/issi/tests/issi_tests.cpp \
+	$(DRIVER_PATH)/led/issi/tests/i2c_mock.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+issi_3731_SRC := $(issi_SRC) $(DRIVER_PATH)/led/issi/is31fl3731.c
+issi_3733_SRC := $(issi_SRC) $(DRIVER_PATH)/led/issi/is31fl3733.c
+issi_3737_SRC := $(issi_SRC) $(DRIVER_PATH)/led/issi/is31fl3737.c
+issi_3741_SRC := $(issi_SRC) $(DRIVER_PATH)/led/issi/is31fl3741.c
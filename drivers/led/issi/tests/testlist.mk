@@ -0,0 +1 @@
+TEST_LIST += issi_3731 issi_3733 issi_3737 issi_3741
@@ -170,6 +170,12 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define OLED_UPDATE_INTERVAL 50
 #endif
 
+// Maximum number of bytes oled_render sends per call, in whole blocks
+// Bounds the time a single call blocks on i2c, a full redraw takes OLED_MATRIX_SIZE / OLED_RENDER_BUDGET calls
+#if !defined(OLED_RENDER_BUDGET)
+#    define OLED_RENDER_BUDGET OLED_DISPLAY_WIDTH
+#endif
+
 typedef struct __attribute__((__packed__)) {
     uint8_t *current_element;
     uint16_t remaining_element_count;
@@ -197,6 +203,7 @@ oled_rotation_t oled_init_user(oled_rotation_t rotation);
 void oled_clear(void);
 
 // Renders the dirty chunks of the buffer to oled display
+// Neighbouring dirty chunks are sent together, up to OLED_RENDER_BUDGET bytes per call
 void oled_render(void);
 
 // Moves cursor to character position indicated by column and line, wraps if out of bounds
@@ -25,6 +25,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "progmem.h"
 
 #include "keyboard.h"
+#include "profiler.h"
 
 // Used commands from spec sheet: https://cdn-shop.adafruit.com/datasheets/SSD1306.pdf
 // for SH1106: https://www.velleman.eu/downloads/29/infosheets/sh1106_datasheet.pdf
@@ -241,34 +242,55 @@ void oled_clear(void) {
     oled_dirty  = OLED_ALL_BLOCKS_MASK;
 }
 
-static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
-    // Calculate commands to set memory addressing bounds.
-    uint8_t start_page   = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_WIDTH;
-    uint8_t start_column = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH;
+// Display memory area covered by a render window
+typedef struct {
+    uint8_t column;
+    uint8_t width;
+    uint8_t page;
+    uint8_t pages;
+} oled_window_t;
+
+// Blocks are grouped into lines: a page row of the display normally, an 8 column
+// strip of it with 90 degree rotation. One window can hold consecutive blocks of a
+// single line, or several whole lines.
+static uint8_t line_block_count(void) {
+    uint16_t line_size = !HAS_FLAGS(oled_rotation, OLED_ROTATION_90) ? OLED_DISPLAY_WIDTH : OLED_DISPLAY_HEIGHT;
+    return OLED_BLOCK_SIZE < line_size ? line_size / OLED_BLOCK_SIZE : 1;
+}
+
+static void calc_block_window(uint8_t block, oled_window_t *window) {
+    uint16_t start = OLED_BLOCK_SIZE * block;
+    if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
+        window->column = start % OLED_DISPLAY_WIDTH;
+        window->width  = OLED_BLOCK_SIZE < OLED_DISPLAY_WIDTH ? OLED_BLOCK_SIZE : OLED_DISPLAY_WIDTH;
+        window->page   = start / OLED_DISPLAY_WIDTH;
+        window->pages  = OLED_BLOCK_SIZE < OLED_DISPLAY_WIDTH ? 1 : OLED_BLOCK_SIZE / OLED_DISPLAY_WIDTH;
+    } else {
+        window->column = start / OLED_DISPLAY_HEIGHT * 8;
+        window->width  = (OLED_BLOCK_SIZE < OLED_DISPLAY_HEIGHT ? 1 : OLED_BLOCK_SIZE / OLED_DISPLAY_HEIGHT) * 8;
+        window->page   = start % OLED_DISPLAY_HEIGHT / 8;
+        window->pages  = (OLED_BLOCK_SIZE < OLED_DISPLAY_HEIGHT ? OLED_BLOCK_SIZE : OLED_DISPLAY_HEIGHT) / 8;
+    }
+}
+
+static void calc_window(uint8_t first, uint8_t count, oled_window_t *window) {
+    oled_window_t last;
+    calc_block_window(first, window);
+    calc_block_window(first + count - 1, &last);
+    window->width = last.column + last.width - window->column;
+    window->pages = last.page + last.pages - window->page;
+}
+
+static bool send_window(const oled_window_t *window) {
 #if (OLED_IC == OLED_IC_SH1106)
     // Commands for Page Addressing Mode. Sets starting page and column; has no end bound.
     // Column value must be split into high and low nybble and sent as two commands.
-    cmd_array[0] = PAM_PAGE_ADDR | start_page;
-    cmd_array[1] = PAM_SETCOLUMN_LSB | ((OLED_COLUMN_OFFSET + start_column) & 0x0f);
-    cmd_array[2] = PAM_SETCOLUMN_MSB | ((OLED_COLUMN_OFFSET + start_column) >> 4 & 0x0f);
-    cmd_array[3] = NOP;
-    cmd_array[4] = NOP;
-    cmd_array[5] = NOP;
+    uint8_t display_start[] = {I2C_CMD, PAM_PAGE_ADDR | window->page, PAM_SETCOLUMN_LSB | ((OLED_COLUMN_OFFSET + window->column) & 0x0f), PAM_SETCOLUMN_MSB | ((OLED_COLUMN_OFFSET + window->column) >> 4 & 0x0f), NOP, NOP, NOP};
 #else
     // Commands for use in Horizontal Addressing mode.
-    cmd_array[1] = start_column;
-    cmd_array[4] = start_page;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1;
+    uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, window->column, window->column + window->width - 1, PAGE_ADDR, window->page, window->page + window->pages - 1};
 #endif
-}
-
-static void calc_bounds_90(uint8_t update_start, uint8_t *cmd_array) {
-    cmd_array[1] = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_HEIGHT * 8;
-    cmd_array[4] = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_HEIGHT;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8 - 1 + cmd_array[1];
-    ;
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) % OLED_DISPLAY_HEIGHT / 8;
+    return I2C_TRANSMIT(display_start) == I2C_STATUS_SUCCESS;
 }
 
 uint8_t crot(uint8_t a, int8_t n) {
@@ -286,66 +308,103 @@ static void rotate_90(const uint8_t *src, uint8_t *dest) {
     }
 }
 
-void oled_render(void) {
-    if (!oled_initialized) {
-        return;
-    }
-
-    // Do we have work to do?
-    oled_dirty &= OLED_ALL_BLOCKS_MASK;
-    if (!oled_dirty || oled_scrolling) {
-        return;
-    }
+// Whole blocks per oled_render call, at least one and at most the entire display
+#define OLED_RENDER_BLOCKS (OLED_RENDER_BUDGET < OLED_BLOCK_SIZE ? 1 : OLED_RENDER_BUDGET / OLED_BLOCK_SIZE > OLED_BLOCK_COUNT ? OLED_BLOCK_COUNT : OLED_RENDER_BUDGET / OLED_BLOCK_SIZE)
 
-    // Find first dirty block
-    uint8_t update_start = 0;
-    while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
-        ++update_start;
-    }
+// Sends blocks first to first + count - 1 as a single window
+static bool render_window(uint8_t first, uint8_t count) {
+    oled_window_t window;
+    calc_window(first, count, &window);
 
     // Set column & page position
-    static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
-    if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        calc_bounds(update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
-    } else {
-        calc_bounds_90(update_start, &display_start[1]);  // Offset from I2C_CMD byte at the start
-    }
-
-    // Send column & page position
-    if (I2C_TRANSMIT(display_start) != I2C_STATUS_SUCCESS) {
+    if (!send_window(&window)) {
         print("oled_render offset command failed\n");
-        return;
+        return false;
     }
 
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        // Send render data chunk as is
-        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+        // The window matches the buffer layout, send it as is
+        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * first], OLED_BLOCK_SIZE * count) != I2C_STATUS_SUCCESS) {
             print("oled_render data failed\n");
-            return;
+            return false;
         }
     } else {
-        // Rotate the render chunks
+        // Rotate every block straight into its place in the window
         const static uint8_t source_map[] = OLED_SOURCE_MAP;
         const static uint8_t target_map[] = OLED_TARGET_MAP;
 
-        static uint8_t temp_buffer[OLED_BLOCK_SIZE];
-        memset(temp_buffer, 0, sizeof(temp_buffer));
-        for (uint8_t i = 0; i < sizeof(source_map); ++i) {
-            rotate_90(&oled_buffer[OLED_BLOCK_SIZE * update_start + source_map[i]], &temp_buffer[target_map[i]]);
+        static uint8_t render_buffer[OLED_BLOCK_SIZE * OLED_RENDER_BLOCKS];
+        for (uint8_t block = first; block < first + count; ++block) {
+            oled_window_t block_window;
+            calc_block_window(block, &block_window);
+            for (uint8_t i = 0; i < sizeof(source_map); ++i) {
+                uint8_t  target = target_map[i];
+                uint8_t *dest   = &render_buffer[(block_window.page - window.page + target / block_window.width) * window.width + block_window.column - window.column + target % block_window.width];
+                memset(dest, 0, 8);
+                rotate_90(&oled_buffer[OLED_BLOCK_SIZE * block + source_map[i]], dest);
+            }
         }
 
-        // Send render data chunk after rotating
-        if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+        // Send render data after rotating
+        if (I2C_WRITE_REG(I2C_DATA, &render_buffer[0], OLED_BLOCK_SIZE * count) != I2C_STATUS_SUCCESS) {
             print("oled_render90 data failed\n");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void oled_render(void) {
+    if (!oled_initialized) {
+        return;
+    }
+
+    // Do we have work to do?
+    oled_dirty &= OLED_ALL_BLOCKS_MASK;
+    if (!oled_dirty || oled_scrolling) {
+        return;
+    }
+
+    uint8_t budget = OLED_RENDER_BLOCKS;
+    while (oled_dirty && budget) {
+        // Find first dirty block and the dirty blocks following it
+        uint8_t first = 0;
+        while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << first))) {
+            ++first;
+        }
+        uint8_t count = 1;
+        while (count < budget && first + count < OLED_BLOCK_COUNT && (oled_dirty & ((OLED_BLOCK_TYPE)1 << (first + count)))) {
+            ++count;
+        }
+
+        // Trim the run to something a single window can hold
+        uint8_t line_blocks = line_block_count();
+        uint8_t offset      = first % line_blocks;
+        bool    whole_lines = !offset && count >= line_blocks;
+#if (OLED_IC == OLED_IC_SH1106)
+        // No end bound in Page Addressing Mode, so stay on one line
+        whole_lines = false;
+#endif
+        if (whole_lines) {
+            count -= count % line_blocks;
+        } else if (count > line_blocks - offset) {
+            count = line_blocks - offset;
+        }
+
+        if (!render_window(first, count)) {
             return;
         }
+
+        // Clear dirty flags
+        for (uint8_t i = first; i < first + count; ++i) {
+            oled_dirty &= ~((OLED_BLOCK_TYPE)1 << i);
+        }
+        budget -= count;
     }
 
     // Turn on display if it is off
     oled_on();
-
-    // Clear dirty flag
-    oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
 }
 
 void oled_set_cursor(uint8_t col, uint8_t line) {
@@ -742,11 +801,15 @@ void oled_task(void) {
     if (timer_elapsed(oled_update_timeout) >= OLED_UPDATE_INTERVAL) {
         oled_update_timeout = timer_read();
         oled_set_cursor(0, 0);
+        PROFILER_BEGIN(OLED_RENDER);
         oled_task_kb();
+        PROFILER_END(OLED_RENDER);
     }
 #else
     oled_set_cursor(0, 0);
+    PROFILER_BEGIN(OLED_RENDER);
     oled_task_kb();
+    PROFILER_END(OLED_RENDER);
 #endif
 
 #if OLED_SCROLL_TIMEOUT > 0
@@ -757,7 +820,9 @@ void oled_task(void) {
 #endif
 
     // Smart render system, no need to check for dirty
+    PROFILER_BEGIN(OLED_FLUSH);
     oled_render();
+    PROFILER_END(OLED_FLUSH);
 
     // Display timeout check
 #if OLED_TIMEOUT > 0
@@ -0,0 +1,48 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Stand-in for the platform i2c_master that records every transfer instead of sending it */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef int16_t i2c_status_t;
+
+#define I2C_STATUS_SUCCESS (0)
+#define I2C_STATUS_ERROR (-1)
+#define I2C_STATUS_TIMEOUT (-2)
+
+#define I2C_MOCK_LOG_SIZE 16384
+#define I2C_MOCK_MAX_TRANSFERS 512
+
+typedef struct {
+    uint8_t  address;
+    uint16_t start;  // offset of the first byte in i2c_mock_log
+    uint16_t length;
+} i2c_mock_transfer_t;
+
+extern uint8_t             i2c_mock_log[I2C_MOCK_LOG_SIZE];
+extern i2c_mock_transfer_t i2c_mock_transfers[I2C_MOCK_MAX_TRANSFERS];
+extern uint16_t            i2c_mock_transfer_count;
+// Returned by every transfer; failed transfers are not recorded
+extern i2c_status_t i2c_mock_status;
+
+void i2c_mock_reset(void);
+
+void         i2c_init(void);
+i2c_status_t i2c_transmit(uint8_t address, const uint8_t *data, uint16_t length, uint16_t timeout);
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t *data, uint16_t length, uint16_t timeout);
@@ -0,0 +1,258 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <vector>
+
+extern "C" {
+#include "i2c_master.h"
+#include "oled_driver.h"
+
+extern uint8_t         oled_buffer[OLED_MATRIX_SIZE];
+extern OLED_BLOCK_TYPE oled_dirty;
+}
+
+#define PAGES (OLED_DISPLAY_HEIGHT / 8)
+
+/* Just enough of an SSD1306 to replay the recorded byte stream in horizontal addressing mode */
+class Display {
+   public:
+    uint8_t ram[PAGES][OLED_DISPLAY_WIDTH] = {};
+    uint8_t column_start = 0, column_end = OLED_DISPLAY_WIDTH - 1, column = 0;
+    uint8_t page_start = 0, page_end = PAGES - 1, page = 0;
+
+    void replay(uint16_t first_transfer = 0) {
+        for (uint16_t t = first_transfer; t < i2c_mock_transfer_count; t++) {
+            const uint8_t* data   = &i2c_mock_log[i2c_mock_transfers[t].start];
+            uint16_t       length = i2c_mock_transfers[t].length;
+            if (data[0] == 0x40) {
+                for (uint16_t i = 1; i < length; i++) {
+                    write(data[i]);
+                }
+            } else {
+                command(data + 1, length - 1);
+            }
+        }
+    }
+
+   private:
+    void write(uint8_t data) {
+        ram[page][column] = data;
+        if (column++ == column_end) {
+            column = column_start;
+            if (page++ == page_end) {
+                page = page_start;
+            }
+        }
+    }
+
+    void command(const uint8_t* data, uint16_t length) {
+        for (uint16_t i = 0; i < length; i++) {
+            switch (data[i]) {
+                case 0x21:  // COLUMN_ADDR
+                    column = column_start = data[++i];
+                    column_end            = data[++i];
+                    break;
+                case 0x22:  // PAGE_ADDR
+                    page = page_start = data[++i];
+                    page_end          = data[++i];
+                    break;
+                case 0x20:
+                case 0x23:
+                case 0x81:
+                case 0x8D:
+                case 0xA8:
+                case 0xD3:
+                case 0xD5:
+                case 0xD9:
+                case 0xDA:
+                case 0xDB:
+                    // Commands with one argument
+                    i++;
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+};
+
+/* The display contents the driver should produce, rendering one block at a time like it always has */
+static void reference_render(Display& display, oled_rotation_t rotation) {
+    if (!(rotation & OLED_ROTATION_90)) {
+        for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+            display.ram[i / OLED_DISPLAY_WIDTH][i % OLED_DISPLAY_WIDTH] = oled_buffer[i];
+        }
+        return;
+    }
+
+    const uint8_t source_map[] = OLED_SOURCE_MAP;
+    const uint8_t target_map[] = OLED_TARGET_MAP;
+    const uint8_t width        = (OLED_BLOCK_SIZE + OLED_DISPLAY_HEIGHT - 1) / OLED_DISPLAY_HEIGHT * 8;
+    for (uint16_t block = 0; block < OLED_BLOCK_COUNT; block++) {
+        uint8_t temp[OLED_BLOCK_SIZE] = {};
+        for (uint8_t i = 0; i < sizeof(source_map); i++) {
+            const uint8_t* src  = &oled_buffer[OLED_BLOCK_SIZE * block + source_map[i]];
+            uint8_t*       dest = &temp[target_map[i]];
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                for (uint8_t j = 0; j < 8; j++) {
+                    dest[bit] |= ((src[j] >> bit) & 1) << (7 - j);
+                }
+            }
+        }
+        uint8_t column = OLED_BLOCK_SIZE * block / OLED_DISPLAY_HEIGHT * 8;
+        uint8_t page   = OLED_BLOCK_SIZE * block % OLED_DISPLAY_HEIGHT / 8;
+        for (uint16_t i = 0; i < OLED_BLOCK_SIZE; i++) {
+            display.ram[page + i / width][column + i % width] = temp[i];
+        }
+    }
+}
+
+static uint32_t xorshift(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+class Oled : public ::testing::Test {
+   protected:
+    void init(oled_rotation_t rotation) {
+        i2c_mock_reset();
+        ASSERT_TRUE(oled_init(rotation));
+        while (oled_dirty) {
+            oled_render();
+        }
+        i2c_mock_reset();
+    }
+
+    /* Renders until nothing is dirty and returns the number of calls that took */
+    unsigned render_all() {
+        unsigned calls = 0;
+        while (oled_dirty && calls < OLED_BLOCK_COUNT + 1) {
+            oled_render();
+            calls++;
+        }
+        return calls;
+    }
+
+    void expect_display_matches(oled_rotation_t rotation) {
+        Display reference, actual;
+        reference_render(reference, rotation);
+        actual.replay();
+        EXPECT_EQ(0, std::memcmp(reference.ram, actual.ram, sizeof(actual.ram)));
+    }
+
+    /* The display starts out blank after init, so replaying from scratch has to give the full image */
+    void fill_random(uint32_t seed) {
+        for (uint16_t i = 0; i < OLED_MATRIX_SIZE; i++) {
+            oled_write_raw_byte(xorshift(seed), i);
+        }
+    }
+};
+
+TEST_F(Oled, FullRedrawIsBounded) {
+    init(OLED_ROTATION_0);
+    fill_random(0x1234567);
+
+    unsigned calls = 0;
+    while (oled_dirty) {
+        uint16_t before = i2c_mock_transfer_count;
+        oled_render();
+        calls++;
+        // One address window and one data transfer per call, within the budget
+        ASSERT_EQ(i2c_mock_transfer_count - before, 2);
+        EXPECT_LE(i2c_mock_transfers[before + 1].length, OLED_RENDER_BUDGET + 1);
+    }
+    EXPECT_EQ(calls, (OLED_MATRIX_SIZE + OLED_RENDER_BUDGET - 1) / OLED_RENDER_BUDGET);
+    expect_display_matches(OLED_ROTATION_0);
+}
+
+TEST_F(Oled, NeighbouringDirtyBlocksShareOneWindow) {
+    init(OLED_ROTATION_0);
+    oled_write_raw_byte(0x55, OLED_BLOCK_SIZE * 1);
+    oled_write_raw_byte(0xAA, OLED_BLOCK_SIZE * 2 + 3);
+
+    oled_render();
+    ASSERT_EQ(i2c_mock_transfer_count, 2);
+    const uint8_t* window = &i2c_mock_log[i2c_mock_transfers[0].start];
+    EXPECT_EQ(window[1], 0x21);
+    EXPECT_EQ(window[2], OLED_BLOCK_SIZE);
+    EXPECT_EQ(window[3], OLED_BLOCK_SIZE * 3 - 1);
+    EXPECT_EQ(window[5], 0);
+    EXPECT_EQ(window[6], 0);
+    EXPECT_EQ(i2c_mock_transfers[1].length, OLED_BLOCK_SIZE * 2 + 1);
+    EXPECT_EQ(oled_dirty, 0);
+    expect_display_matches(OLED_ROTATION_0);
+}
+
+TEST_F(Oled, RunAcrossPagesIsSplitAtPageBoundary) {
+    init(OLED_ROTATION_0);
+    const uint8_t blocks_per_page = OLED_DISPLAY_WIDTH / OLED_BLOCK_SIZE;
+    // Last block of page 0 and first block of page 1
+    oled_write_raw_byte(1, OLED_BLOCK_SIZE * (blocks_per_page - 1));
+    oled_write_raw_byte(2, OLED_BLOCK_SIZE * blocks_per_page);
+
+    EXPECT_EQ(render_all(), 1u);
+    ASSERT_EQ(i2c_mock_transfer_count, 4);
+    EXPECT_EQ(i2c_mock_transfers[1].length, OLED_BLOCK_SIZE + 1);
+    EXPECT_EQ(i2c_mock_transfers[3].length, OLED_BLOCK_SIZE + 1);
+    expect_display_matches(OLED_ROTATION_0);
+}
+
+TEST_F(Oled, SparseUpdatesMatchReference) {
+    init(OLED_ROTATION_0);
+    uint32_t rng = 42;
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 5; i++) {
+            oled_write_raw_byte(xorshift(rng), xorshift(rng) % OLED_MATRIX_SIZE);
+        }
+        render_all();
+    }
+    expect_display_matches(OLED_ROTATION_0);
+}
+
+TEST_F(Oled, RotatedRenderMatchesReference) {
+    init(OLED_ROTATION_90);
+    uint32_t rng = 7;
+    fill_random(rng);
+    EXPECT_EQ(render_all(), (OLED_MATRIX_SIZE + OLED_RENDER_BUDGET - 1) / OLED_RENDER_BUDGET);
+    expect_display_matches(OLED_ROTATION_90);
+
+    for (int round = 0; round < 50; round++) {
+        for (int i = 0; i < 5; i++) {
+            oled_write_pixel(xorshift(rng) % OLED_DISPLAY_HEIGHT, xorshift(rng) % OLED_DISPLAY_WIDTH, xorshift(rng) & 1);
+        }
+        render_all();
+    }
+    expect_display_matches(OLED_ROTATION_90);
+}
+
+TEST_F(Oled, FailedTransferKeepsBlocksDirty) {
+    init(OLED_ROTATION_0);
+    oled_write_raw_byte(0x55, 0);
+
+    i2c_mock_status = I2C_STATUS_ERROR;
+    oled_render();
+    EXPECT_EQ(oled_dirty, 1);
+
+    i2c_mock_status = I2C_STATUS_SUCCESS;
+    oled_render();
+    EXPECT_EQ(oled_dirty, 0);
+    expect_display_matches(OLED_ROTATION_0);
+}
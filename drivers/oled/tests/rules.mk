@@ -0,0 +1,11 @@
+oled_DEFS := -DNO_PRINT -DNO_DEBUG
+
+oled_INC := \
+	$(DRIVER_PATH)/oled/tests \
+	$(DRIVER_PATH)/oled
+
+oled_SRC := \
+	$(DRIVER_PATH)/oled/tests/oled_tests.cpp \
+	$(DRIVER_PATH)/oled/tests/i2c_mock.c \
+	$(DRIVER_PATH)/oled/ssd1306_sh1106.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
@@ -0,0 +1,48 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "ps2.h"
+#include "ps2_mock.h"
+
+uint8_t        ps2_mock_packet[4];
+uint8_t        ps2_mock_packet_index;
+uint16_t       ps2_mock_reports_sent;
+report_mouse_t ps2_mock_last_report;
+
+uint8_t ps2_error  = PS2_ERR_NONE;
+int     tp_buttons = 0;
+
+void ps2_mock_reset(void) {
+    memset(ps2_mock_packet, 0, sizeof(ps2_mock_packet));
+    memset(&ps2_mock_last_report, 0, sizeof(ps2_mock_last_report));
+    ps2_mock_packet_index = 0;
+    ps2_mock_reports_sent = 0;
+}
+
+void ps2_host_init(void) {}
+
+uint8_t ps2_host_send(uint8_t data) {
+    ps2_mock_packet_index = 0;
+    return PS2_ACK;
+}
+
+uint8_t ps2_host_recv_response(void) { return ps2_mock_packet_index < sizeof(ps2_mock_packet) ? ps2_mock_packet[ps2_mock_packet_index++] : 0; }
+
+void host_mouse_send(report_mouse_t *report) {
+    ps2_mock_last_report = *report;
+    ps2_mock_reports_sent++;
+}
@@ -0,0 +1,57 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "ps2_mouse.h"
+#include "ps2_mock.h"
+}
+
+class PS2Mouse : public testing::Test {
+   protected:
+    void SetUp() override { ps2_mock_reset(); }
+
+    /* One stream packet: buttons and sign bits, then the low 8 bits of x and y */
+    void receive(uint8_t buttons, uint8_t x, uint8_t y) {
+        ps2_mock_packet[0] = buttons;
+        ps2_mock_packet[1] = x;
+        ps2_mock_packet[2] = y;
+        ps2_mouse_task();
+    }
+};
+
+TEST_F(PS2Mouse, RightAndDownArePositive) {
+    receive(0x08 | 1 << PS2_MOUSE_Y_SIGN, 5, 0xFD);
+    ASSERT_EQ(ps2_mock_reports_sent, 1);
+    EXPECT_EQ(ps2_mock_last_report.x, 5);
+    /* PS/2 counts up as the mouse moves away, HID counts down */
+    EXPECT_EQ(ps2_mock_last_report.y, 3);
+}
+
+TEST_F(PS2Mouse, LeftAndUpAreNegative) {
+    receive(0x08 | 1 << PS2_MOUSE_X_SIGN, 0xFB, 2);
+    ASSERT_EQ(ps2_mock_reports_sent, 1);
+    EXPECT_EQ(ps2_mock_last_report.x, -5);
+    EXPECT_EQ(ps2_mock_last_report.y, -2);
+}
+
+TEST_F(PS2Mouse, OverflowIsClampedToTheReportRange) {
+    receive(0x08 | 1 << PS2_MOUSE_X_SIGN | 1 << PS2_MOUSE_X_OVFLW | 1 << PS2_MOUSE_Y_OVFLW, 0x10, 0x10);
+    ASSERT_EQ(ps2_mock_reports_sent, 1);
+    EXPECT_EQ(ps2_mock_last_report.x, -127);
+    EXPECT_EQ(ps2_mock_last_report.y, -127);
+}
@@ -0,0 +1,15 @@
+ps2_mouse_DEFS := -DNO_PRINT -DNO_DEBUG
+
+ps2_mouse_INC := \
+	$(DRIVER_PATH)/ps2/tests \
+	$(DRIVER_PATH)/ps2
+
+ps2_mouse_SRC := \
+	$(DRIVER_PATH)/ps2/tests/ps2_mouse_tests.cpp \
+	$(DRIVER_PATH)/ps2/tests/ps2_mock.c \
+	$(DRIVER_PATH)/ps2/ps2_mouse.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+ps2_mouse_extended_DEFS := $(ps2_mouse_DEFS) -DMOUSE_EXTENDED_REPORT
+ps2_mouse_extended_INC := $(ps2_mouse_INC)
+ps2_mouse_extended_SRC := $(ps2_mouse_SRC)
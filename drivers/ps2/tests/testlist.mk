@@ -0,0 +1,3 @@
+TEST_LIST += \
+	ps2_mouse \
+	ps2_mouse_extended
@@ -184,7 +184,7 @@ static int16_t convertDeltaToInt(uint8_t high, uint8_t low) {
 }
 
 report_adns9800_t adns9800_get_report(void) {
-    report_adns9800_t report = {0, 0};
+    report_adns9800_t report = {0};
 
     adns9800_spi_start();
 
@@ -193,26 +193,21 @@ report_adns9800_t adns9800_get_report(void) {
 
     wait_us(US_BEFORE_MOTION);
 
-    uint8_t motion = spi_read();
-
-    if (motion & 0x80) {
-        // clear observation register
-        spi_read();
-
-        // delta registers
-        uint8_t delta_x_l = spi_read();
-        uint8_t delta_x_h = spi_read();
-        uint8_t delta_y_l = spi_read();
-        uint8_t delta_y_h = spi_read();
-
-        report.x = convertDeltaToInt(delta_x_h, delta_x_l);
-        report.y = convertDeltaToInt(delta_y_h, delta_y_l);
-    }
+    // Motion, Observation, Delta_X_L, Delta_X_H, Delta_Y_L, Delta_Y_H, SQUAL, Pixel_Sum, Maximum_Pixel, Minimum_Pixel, Shutter_Upper, Shutter_Lower
+    uint8_t burst[12] = {0};
+    spi_receive(burst, sizeof(burst));
 
     // clear residual motion
     spi_write(REG_Motion & 0x7f);
 
     spi_stop();
 
+    if (burst[0] & 0x80) {
+        report.x = convertDeltaToInt(burst[3], burst[2]);
+        report.y = convertDeltaToInt(burst[5], burst[4]);
+    }
+    report.squal   = burst[6];
+    report.shutter = (burst[10] << 8) | burst[11];
+
     return report;
 }
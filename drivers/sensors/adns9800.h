@@ -52,8 +52,10 @@ typedef struct {
 } config_adns9800_t;
 
 typedef struct {
-    int16_t x;
-    int16_t y;
+    int16_t  x;
+    int16_t  y;
+    uint8_t  squal;    // Surface quality, roughly a quarter of the features the sensor can see
+    uint16_t shutter;  // Shutter time in clock cycles, rises as the surface gets harder to track
 } report_adns9800_t;
 
 void              adns9800_init(void);
@@ -61,5 +63,5 @@ config_adns9800_t adns9800_get_config(void);
 void              adns9800_set_config(config_adns9800_t);
 uint16_t          adns9800_get_cpi(void);
 void              adns9800_set_cpi(uint16_t cpi);
-/* Reads and clears the current delta values on the ADNS sensor */
+/* Reads and clears the current delta values on the ADNS sensor, along with SQUAL and shutter, in a single burst */
 report_adns9800_t adns9800_get_report(void);
@@ -242,17 +242,22 @@ report_pmw3360_t pmw3360_read_burst(void) {
     spi_write(REG_Motion_Burst);
     wait_us(35);  // waits for tSRAD
 
-    report_pmw3360_t data = {0};
-
-    data.motion = spi_read();
-    spi_write(0x00);  // skip Observation
-    data.dx  = spi_read();
-    data.mdx = spi_read();
-    data.dy  = spi_read();
-    data.mdy = spi_read();
+    // Motion, Observation, Delta_X_L, Delta_X_H, Delta_Y_L, Delta_Y_H, SQUAL, Raw_Data_Sum, Maximum_Raw_Data, Minimum_Raw_Data, Shutter_Upper, Shutter_Lower
+    uint8_t burst[12] = {0};
+    spi_receive(burst, sizeof(burst));
 
     spi_stop();
 
+    report_pmw3360_t data = {0};
+
+    data.motion  = burst[0];
+    data.dx      = burst[2];
+    data.mdx     = burst[3];
+    data.dy      = burst[4];
+    data.mdy     = burst[5];
+    data.squal   = burst[6];
+    data.shutter = (burst[10] << 8) | burst[11];
+
 #ifdef CONSOLE_ENABLE
     if (debug_mouse) {
         print_byte(data.motion);
@@ -271,8 +276,6 @@ report_pmw3360_t pmw3360_read_burst(void) {
     data.dy |= (data.mdy << 8);
     data.dy = data.dy * -1;
 
-    spi_stop();
-
     if (data.motion & 0b111) {  // panic recovery, sometimes burst mode works weird.
         _inBurst = false;
     }
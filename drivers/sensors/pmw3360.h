@@ -74,13 +74,15 @@ void print_byte(uint8_t byte);
 #endif
 
 typedef struct {
-    int8_t  motion;
-    bool    isMotion;     // True if a motion is detected.
-    bool    isOnSurface;  // True when a chip is on a surface
-    int16_t dx;           // displacement on x directions. Unit: Count. (CPI * Count = Inch value)
-    int8_t  mdx;
-    int16_t dy;  // displacement on y directions.
-    int8_t  mdy;
+    int8_t   motion;
+    bool     isMotion;     // True if a motion is detected.
+    bool     isOnSurface;  // True when a chip is on a surface
+    int16_t  dx;           // displacement on x directions. Unit: Count. (CPI * Count = Inch value)
+    int8_t   mdx;
+    int16_t  dy;  // displacement on y directions.
+    int8_t   mdy;
+    uint8_t  squal;    // Surface quality, roughly a quarter of the features the sensor can see
+    uint16_t shutter;  // Shutter time in clock cycles, rises as the surface gets harder to track
 } report_pmw3360_t;
 
 bool             spi_start_adv(void);
@@ -92,6 +94,7 @@ void             pmw3360_set_cpi(uint16_t cpi);
 uint16_t         pmw3360_get_cpi(void);
 void             pmw3360_upload_firmware(void);
 bool             pmw3360_check_signature(void);
+/* Reads motion, SQUAL and shutter in a single motion burst transaction */
 report_pmw3360_t pmw3360_read_burst(void);
 
 #define degToRad(angleInDegrees) ((angleInDegrees)*M_PI / 180.0)
@@ -0,0 +1,33 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Pins for the host tests, nothing is driven */
+
+#pragma once
+
+#include <stdint.h>
+
+typedef uint8_t pin_t;
+
+#define NO_PIN (pin_t)(~0)
+
+#define setPinInput(pin)
+#define setPinInputHigh(pin)
+#define setPinOutput(pin)
+#define writePinHigh(pin)
+#define writePinLow(pin)
+#define writePin(pin, level)
+#define readPin(pin) 0
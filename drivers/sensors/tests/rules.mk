@@ -0,0 +1,12 @@
+sensors_DEFS := -DNO_PRINT -DNO_DEBUG -DPMW3360_CS_PIN=1 -DADNS9800_CS_PIN=2
+
+sensors_INC := \
+	$(DRIVER_PATH)/sensors/tests \
+	$(DRIVER_PATH)/sensors
+
+sensors_SRC := \
+	$(DRIVER_PATH)/sensors/tests/sensors_tests.cpp \
+	$(DRIVER_PATH)/sensors/tests/spi_mock.c \
+	$(DRIVER_PATH)/sensors/pmw3360.c \
+	$(DRIVER_PATH)/sensors/adns9800.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
@@ -0,0 +1,152 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+extern "C" {
+#include "spi_master.h"
+#include "adns9800.h"
+#include "pmw3360.h"
+}
+
+#define REG_Config1 0x0F
+#define REG_Motion_Burst 0x50
+
+/* Both sensors answer a register read with the register, and a motion burst with this frame */
+class Sensor {
+   public:
+    uint8_t registers[0x80] = {};
+    uint8_t burst[12]       = {};
+
+    void set_motion(int16_t dx, int16_t dy, uint8_t squal, uint16_t shutter) {
+        burst[0]  = 0x80;
+        burst[2]  = dx & 0xFF;
+        burst[3]  = dx >> 8;
+        burst[4]  = dy & 0xFF;
+        burst[5]  = dy >> 8;
+        burst[6]  = squal;
+        burst[10] = shutter >> 8;
+        burst[11] = shutter & 0xFF;
+    }
+
+    uint8_t exchange(uint16_t index, uint8_t mosi) {
+        if (index == 0) {
+            address = mosi;
+            return 0;
+        }
+        if (address & 0x80) {
+            registers[address & 0x7F] = mosi;
+            return 0;
+        }
+        if (address == REG_Motion_Burst) {
+            return index <= sizeof(burst) ? burst[index - 1] : 0;
+        }
+        return index == 1 ? registers[address] : 0;
+    }
+
+   private:
+    uint8_t address = 0;
+};
+
+static Sensor pmw3360, adns9800;
+
+static uint8_t device(pin_t slave_pin, uint16_t index, uint8_t mosi) {
+    if (slave_pin == PMW3360_CS_PIN) return pmw3360.exchange(index, mosi);
+    if (slave_pin == ADNS9800_CS_PIN) return adns9800.exchange(index, mosi);
+    return 0;
+}
+
+class SensorTest : public testing::Test {
+   protected:
+    void SetUp() override {
+        pmw3360         = Sensor();
+        adns9800        = Sensor();
+        spi_mock_device = device;
+        spi_mock_reset();
+    }
+
+    void TearDown() override { spi_mock_device = nullptr; }
+};
+
+TEST_F(SensorTest, Pmw3360BurstIsOneTransaction) {
+    pmw3360_init();
+    pmw3360.set_motion(-300, 5, 0x40, 0x1234);
+
+    /* The first read switches burst mode on, after that each read is a single transaction */
+    spi_mock_reset();
+    pmw3360_read_burst();
+    EXPECT_EQ(spi_mock_transaction_count, 2);
+
+    for (int i = 0; i < 10; i++) {
+        spi_mock_reset();
+        report_pmw3360_t data = pmw3360_read_burst();
+
+        ASSERT_EQ(spi_mock_transaction_count, 1);
+        EXPECT_EQ(spi_mock_transactions[0].slave_pin, PMW3360_CS_PIN);
+        EXPECT_EQ(spi_mock_mosi[0], REG_Motion_Burst);
+        EXPECT_EQ(spi_mock_transactions[0].length, 1 + sizeof(pmw3360.burst));
+
+        EXPECT_TRUE(data.isMotion);
+        EXPECT_EQ(data.dx, 300);
+        EXPECT_EQ(data.dy, -5);
+        EXPECT_EQ(data.squal, 0x40);
+        EXPECT_EQ(data.shutter, 0x1234);
+    }
+}
+
+TEST_F(SensorTest, Pmw3360RegisterWriteLeavesBurstMode) {
+    pmw3360_init();
+    pmw3360_read_burst();
+
+    pmw3360_set_cpi(3200);
+    EXPECT_EQ(pmw3360.registers[REG_Config1], 3200 / 100 - 1);
+
+    spi_mock_reset();
+    pmw3360_read_burst();
+    EXPECT_EQ(spi_mock_transaction_count, 2);
+    spi_mock_reset();
+    pmw3360_read_burst();
+    EXPECT_EQ(spi_mock_transaction_count, 1);
+}
+
+TEST_F(SensorTest, Adns9800BurstIsOneTransaction) {
+    adns9800_init();
+    adns9800.set_motion(-1000, 1000, 0x20, 0x0321);
+
+    spi_mock_reset();
+    report_adns9800_t report = adns9800_get_report();
+
+    ASSERT_EQ(spi_mock_transaction_count, 1);
+    EXPECT_EQ(spi_mock_transactions[0].slave_pin, ADNS9800_CS_PIN);
+    EXPECT_EQ(spi_mock_mosi[0], REG_Motion_Burst);
+    EXPECT_EQ(report.x, -1000);
+    EXPECT_EQ(report.y, 1000);
+    EXPECT_EQ(report.squal, 0x20);
+    EXPECT_EQ(report.shutter, 0x0321);
+}
+
+TEST_F(SensorTest, Adns9800IgnoresDeltasWithoutMotion) {
+    adns9800_init();
+    adns9800.set_motion(7, 7, 0x20, 0x0321);
+    adns9800.burst[0] = 0;
+
+    report_adns9800_t report = adns9800_get_report();
+    EXPECT_EQ(report.x, 0);
+    EXPECT_EQ(report.y, 0);
+    EXPECT_EQ(report.squal, 0x20);
+}
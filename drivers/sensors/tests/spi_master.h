@@ -0,0 +1,56 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Stand-in for the platform spi_master that records every transaction and lets the test answer for the device */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "gpio.h"
+
+typedef int16_t spi_status_t;
+
+#define SPI_STATUS_SUCCESS (0)
+#define SPI_STATUS_ERROR (-1)
+#define SPI_STATUS_TIMEOUT (-2)
+
+#define SPI_MOCK_LOG_SIZE 16384
+#define SPI_MOCK_MAX_TRANSACTIONS 512
+
+typedef struct {
+    pin_t    slave_pin;
+    uint16_t start;  // offset of the first byte in spi_mock_mosi and spi_mock_miso
+    uint16_t length;
+} spi_mock_transaction_t;
+
+// What the host sent and what the device answered, byte for byte
+extern uint8_t                spi_mock_mosi[SPI_MOCK_LOG_SIZE];
+extern uint8_t                spi_mock_miso[SPI_MOCK_LOG_SIZE];
+extern spi_mock_transaction_t spi_mock_transactions[SPI_MOCK_MAX_TRANSACTIONS];
+extern uint16_t               spi_mock_transaction_count;
+// Answers each byte the host clocks out, index counts from the start of the transaction
+extern uint8_t (*spi_mock_device)(pin_t slave_pin, uint16_t index, uint8_t mosi);
+
+void spi_mock_reset(void);
+
+void         spi_init(void);
+bool         spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor);
+spi_status_t spi_write(uint8_t data);
+spi_status_t spi_read(void);
+spi_status_t spi_transmit(const uint8_t *data, uint16_t length);
+spi_status_t spi_receive(uint8_t *data, uint16_t length);
+void         spi_stop(void);
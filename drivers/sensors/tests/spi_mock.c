@@ -0,0 +1,94 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stddef.h>
+#include "spi_master.h"
+
+uint8_t                spi_mock_mosi[SPI_MOCK_LOG_SIZE];
+uint8_t                spi_mock_miso[SPI_MOCK_LOG_SIZE];
+spi_mock_transaction_t spi_mock_transactions[SPI_MOCK_MAX_TRANSACTIONS];
+uint16_t               spi_mock_transaction_count = 0;
+uint8_t (*spi_mock_device)(pin_t slave_pin, uint16_t index, uint8_t mosi) = NULL;
+
+static uint16_t log_size    = 0;
+static pin_t    current_pin = NO_PIN;
+
+void spi_mock_reset(void) {
+    log_size                   = 0;
+    spi_mock_transaction_count = 0;
+    current_pin                = NO_PIN;
+}
+
+static uint8_t exchange(uint8_t mosi) {
+    spi_mock_transaction_t *transaction = &spi_mock_transactions[spi_mock_transaction_count - 1];
+
+    uint8_t miso = spi_mock_device ? spi_mock_device(current_pin, transaction->length, mosi) : 0;
+    if (log_size < SPI_MOCK_LOG_SIZE) {
+        spi_mock_mosi[log_size] = mosi;
+        spi_mock_miso[log_size] = miso;
+        log_size++;
+    }
+    transaction->length++;
+    return miso;
+}
+
+void spi_init(void) {}
+
+bool spi_start(pin_t slavePin, bool lsbFirst, uint8_t mode, uint16_t divisor) {
+    // Like the real drivers, a transaction that is already running has to be stopped first
+    if (current_pin != NO_PIN || slavePin == NO_PIN || spi_mock_transaction_count >= SPI_MOCK_MAX_TRANSACTIONS) {
+        return false;
+    }
+    current_pin                                         = slavePin;
+    spi_mock_transactions[spi_mock_transaction_count++] = (spi_mock_transaction_t){.slave_pin = slavePin, .start = log_size, .length = 0};
+    return true;
+}
+
+spi_status_t spi_write(uint8_t data) {
+    if (current_pin == NO_PIN) {
+        return SPI_STATUS_ERROR;
+    }
+    return exchange(data);
+}
+
+spi_status_t spi_read(void) {
+    if (current_pin == NO_PIN) {
+        return SPI_STATUS_ERROR;
+    }
+    return exchange(0);
+}
+
+spi_status_t spi_transmit(const uint8_t *data, uint16_t length) {
+    if (current_pin == NO_PIN) {
+        return SPI_STATUS_ERROR;
+    }
+    for (uint16_t i = 0; i < length; i++) {
+        exchange(data[i]);
+    }
+    return SPI_STATUS_SUCCESS;
+}
+
+spi_status_t spi_receive(uint8_t *data, uint16_t length) {
+    if (current_pin == NO_PIN) {
+        return SPI_STATUS_ERROR;
+    }
+    for (uint16_t i = 0; i < length; i++) {
+        data[i] = exchange(0);
+    }
+    return SPI_STATUS_SUCCESS;
+}
+
+void spi_stop(void) { current_pin = NO_PIN; }
@@ -29,6 +29,9 @@ extern uint8_t note_timbre;
 
 #define CPU_PRESCALER 8
 
+// timer ticks per period of a pitch; kept in integer math, F_CPU / CPU_PRESCALER in 1/256 still fits 32bit
+#define PWM_PERIOD(pitch) ((uint16_t)((((uint32_t)(F_CPU / CPU_PRESCALER)) << AUDIO_PITCH_SHIFT) / (pitch)))
+
 /*
   Audio Driver: PWM
 
@@ -150,9 +153,9 @@ extern uint8_t note_timbre;
 // -----------------------------------------------------------------------------
 
 #ifdef AUDIO1_PIN_SET
-static float channel_1_frequency = 0.0f;
-void         channel_1_set_frequency(float freq) {
-    if (freq == 0.0f)  // a pause/rest is a valid "note" with freq=0
+static audio_pitch_t channel_1_frequency = 0;
+void                 channel_1_set_frequency(audio_pitch_t freq) {
+    if (freq == 0)  // a pause/rest is a valid "note" with freq=0
     {
         // disable the output, but keep the pwm-ISR going (with the previous
         // frequency) so the audio-state keeps getting updated
@@ -166,9 +169,10 @@ void         channel_1_set_frequency(float freq) {
     channel_1_frequency = freq;
 
     // set pwm period
-    AUDIO1_ICRx = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
+    uint16_t period = PWM_PERIOD(freq);
+    AUDIO1_ICRx     = period;
     // and duty cycle
-    AUDIO1_OCRxy = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre / 100);
+    AUDIO1_OCRxy = (uint32_t)period * note_timbre / 100;
 }
 
 void channel_1_start(void) {
@@ -187,9 +191,9 @@ void channel_1_stop(void) {
 #endif
 
 #ifdef AUDIO2_PIN_SET
-static float channel_2_frequency = 0.0f;
-void         channel_2_set_frequency(float freq) {
-    if (freq == 0.0f) {
+static audio_pitch_t channel_2_frequency = 0;
+void                 channel_2_set_frequency(audio_pitch_t freq) {
+    if (freq == 0) {
         AUDIO2_TCCRxA &= ~(_BV(AUDIO2_COMxy1) | _BV(AUDIO2_COMxy0));
         return;
     } else {
@@ -198,11 +202,12 @@ void         channel_2_set_frequency(float freq) {
 
     channel_2_frequency = freq;
 
-    AUDIO2_ICRx  = (uint16_t)(((float)F_CPU) / (freq * CPU_PRESCALER));
-    AUDIO2_OCRxy = (uint16_t)((((float)F_CPU) / (freq * CPU_PRESCALER)) * note_timbre / 100);
+    uint16_t period = PWM_PERIOD(freq);
+    AUDIO2_ICRx     = period;
+    AUDIO2_OCRxy    = (uint32_t)period * note_timbre / 100;
 }
 
-float channel_2_get_frequency(void) { return channel_2_frequency; }
+audio_pitch_t channel_2_get_frequency(void) { return channel_2_frequency; }
 
 void channel_2_start(void) {
     AUDIO2_TIMSKx |= _BV(AUDIO2_OCIExy);
@@ -270,14 +275,14 @@ void audio_driver_start(void) {
 #ifdef AUDIO1_PIN_SET
     channel_1_start();
     if (playing_note) {
-        channel_1_set_frequency(audio_get_processed_frequency(0));
+        channel_1_set_frequency(audio_get_processed_pitch(0));
     }
 #endif
 
 #if !defined(AUDIO1_PIN_SET) && defined(AUDIO2_PIN_SET)
     channel_2_start();
     if (playing_note) {
-        channel_2_set_frequency(audio_get_processed_frequency(0));
+        channel_2_set_frequency(audio_get_processed_pitch(0));
     }
 #endif
 }
@@ -286,7 +291,7 @@ static volatile uint32_t isr_counter = 0;
 #ifdef AUDIO1_PIN_SET
 ISR(AUDIO1_TIMERx_COMPy_vect) {
     isr_counter++;
-    if (isr_counter < channel_1_frequency / (CPU_PRESCALER * 8)) return;
+    if ((isr_counter * (CPU_PRESCALER * 8)) << AUDIO_PITCH_SHIFT < channel_1_frequency) return;
 
     isr_counter        = 0;
     bool state_changed = audio_update_state();
@@ -300,10 +305,10 @@ ISR(AUDIO1_TIMERx_COMPy_vect) {
     }
 
     if (state_changed) {
-        channel_1_set_frequency(audio_get_processed_frequency(0));
+        channel_1_set_frequency(audio_get_processed_pitch(0));
 #    ifdef AUDIO2_PIN_SET
         if (audio_get_number_of_active_tones() > 1) {
-            channel_2_set_frequency(audio_get_processed_frequency(1));
+            channel_2_set_frequency(audio_get_processed_pitch(1));
         } else {
             channel_2_stop();
         }
@@ -315,7 +320,7 @@ ISR(AUDIO1_TIMERx_COMPy_vect) {
 #if !defined(AUDIO1_PIN_SET) && defined(AUDIO2_PIN_SET)
 ISR(AUDIO2_TIMERx_COMPy_vect) {
     isr_counter++;
-    if (isr_counter < channel_2_frequency / (CPU_PRESCALER * 8)) return;
+    if ((isr_counter * (CPU_PRESCALER * 8)) << AUDIO_PITCH_SHIFT < channel_2_frequency) return;
 
     isr_counter        = 0;
     bool state_changed = audio_update_state();
@@ -326,7 +331,7 @@ ISR(AUDIO2_TIMERx_COMPy_vect) {
     }
 
     if (state_changed) {
-        channel_2_set_frequency(audio_get_processed_frequency(0));
+        channel_2_set_frequency(audio_get_processed_pitch(0));
     }
 }
 #endif
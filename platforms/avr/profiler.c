@@ -0,0 +1,54 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <avr/io.h>
+#include <util/atomic.h>
+
+#include "profiler.h"
+#include "timer.h"
+#include "timer_avr.h"
+
+#if defined(__AVR_ATmega32A__)
+#    define PROFILER_TIMER_FLAGS TIFR
+#    define PROFILER_TIMER_MATCH OCF0
+#elif defined(__AVR_ATtiny85__)
+#    define PROFILER_TIMER_FLAGS TIFR
+#    define PROFILER_TIMER_MATCH OCF0A
+#else
+#    define PROFILER_TIMER_FLAGS TIFR0
+#    define PROFILER_TIMER_MATCH OCF0A
+#endif
+
+// Timer0 counts TIMER_RAW_TOP + 1 steps per millisecond for the timer interrupt, this adds those steps to the milliseconds
+void profiler_clock_init(void) {}
+
+uint32_t profiler_clock_read(void) {
+    uint32_t ms;
+    uint8_t  raw;
+
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        ms  = timer_count;
+        raw = TIMER_RAW;
+        // The count has started over, but the interrupt that counts the millisecond hasn't run yet
+        if (PROFILER_TIMER_FLAGS & _BV(PROFILER_TIMER_MATCH)) {
+            ms++;
+            raw = TIMER_RAW;
+        }
+    }
+    return ms * (TIMER_RAW_TOP + 1) + raw;
+}
+
+uint32_t profiler_clock_rate(void) { return TIMER_RAW_TOP + 1; }
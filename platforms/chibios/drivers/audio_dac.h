@@ -16,6 +16,8 @@
  */
 #pragma once
 
+#include "mixer.h"
+
 #ifndef A4
 #    define A4 PAL_LINE(GPIOA, 4)
 #endif
@@ -121,6 +123,12 @@
 #endif
 
 /**
- *user overridable sample generation/processing
+ * user provided sample generation/processing, for the dac_additive driver: when a keymap
+ * implements it, its samples are played instead of the ones the mixer renders
+ */
+__attribute__((weak)) uint16_t dac_value_generate(void);
+
+/**
+ * dac_additive: how many buffers the mixer rendered, and how long that took
  */
-uint16_t dac_value_generate(void);
+audio_mixer_stats_t audio_dac_get_mixer_stats(void);
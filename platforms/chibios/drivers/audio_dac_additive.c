@@ -16,17 +16,21 @@
  */
 
 #include "audio.h"
+#include "luts.h"
+#include "mixer.h"
 #include <ch.h>
 #include <hal.h>
+#include <string.h>
 
 /*
   Audio Driver: DAC
 
   which utilizes the dac unit many STM32 are equipped with, to output a modulated waveform from samples stored in the dac_buffer_* array who are passed to the hardware through DMA
 
-  it is also possible to have a custom sample-LUT by implementing/overriding 'dac_value_generate'
+  it is also possible to have a custom sample-LUT by implementing 'dac_value_generate'
 
-  this driver allows for multiple simultaneous tones to be played through one single channel by doing additive wave-synthesis
+  this driver allows for multiple simultaneous tones to be played through one single channel by doing additive wave-synthesis:
+  the DMA plays one half of dac_buffer while a thread has the mixer render the other half
 */
 
 #if !defined(AUDIO_PIN)
@@ -45,14 +49,6 @@
 #    define AUDIO_DAC_SAMPLE_WAVEFORM_SINE
 #endif
 
-#ifdef AUDIO_DAC_SAMPLE_WAVEFORM_SINE
-/* one full sine wave over [0,2*pi], but shifted up one amplitude and left pi/4; for the samples to start at 0
- */
-static const dacsample_t dac_buffer_sine[AUDIO_DAC_BUFFER_SIZE] = {
-    // 256 values, max 4095
-    0x0,   0x1,   0x2,   0x6,   0xa,   0xf,   0x16,  0x1e,  0x27,  0x32,  0x3d,  0x4a,  0x58,  0x67,  0x78,  0x89,  0x9c,  0xb0,  0xc5,  0xdb,  0xf2,  0x10a, 0x123, 0x13e, 0x159, 0x175, 0x193, 0x1b1, 0x1d1, 0x1f1, 0x212, 0x235, 0x258, 0x27c, 0x2a0, 0x2c6, 0x2ed, 0x314, 0x33c, 0x365, 0x38e, 0x3b8, 0x3e3, 0x40e, 0x43a, 0x467, 0x494, 0x4c2, 0x4f0, 0x51f, 0x54e, 0x57d, 0x5ad, 0x5dd, 0x60e, 0x63f, 0x670, 0x6a1, 0x6d3, 0x705, 0x737, 0x769, 0x79b, 0x7cd, 0x800, 0x832, 0x864, 0x896, 0x8c8, 0x8fa, 0x92c, 0x95e, 0x98f, 0x9c0, 0x9f1, 0xa22, 0xa52, 0xa82, 0xab1, 0xae0, 0xb0f, 0xb3d, 0xb6b, 0xb98, 0xbc5, 0xbf1, 0xc1c, 0xc47, 0xc71, 0xc9a, 0xcc3, 0xceb, 0xd12, 0xd39, 0xd5f, 0xd83, 0xda7, 0xdca, 0xded, 0xe0e, 0xe2e, 0xe4e, 0xe6c, 0xe8a, 0xea6, 0xec1, 0xedc, 0xef5, 0xf0d, 0xf24, 0xf3a, 0xf4f, 0xf63, 0xf76, 0xf87, 0xf98, 0xfa7, 0xfb5, 0xfc2, 0xfcd, 0xfd8, 0xfe1, 0xfe9, 0xff0, 0xff5, 0xff9, 0xffd, 0xffe,
-    0xfff, 0xffe, 0xffd, 0xff9, 0xff5, 0xff0, 0xfe9, 0xfe1, 0xfd8, 0xfcd, 0xfc2, 0xfb5, 0xfa7, 0xf98, 0xf87, 0xf76, 0xf63, 0xf4f, 0xf3a, 0xf24, 0xf0d, 0xef5, 0xedc, 0xec1, 0xea6, 0xe8a, 0xe6c, 0xe4e, 0xe2e, 0xe0e, 0xded, 0xdca, 0xda7, 0xd83, 0xd5f, 0xd39, 0xd12, 0xceb, 0xcc3, 0xc9a, 0xc71, 0xc47, 0xc1c, 0xbf1, 0xbc5, 0xb98, 0xb6b, 0xb3d, 0xb0f, 0xae0, 0xab1, 0xa82, 0xa52, 0xa22, 0x9f1, 0x9c0, 0x98f, 0x95e, 0x92c, 0x8fa, 0x8c8, 0x896, 0x864, 0x832, 0x800, 0x7cd, 0x79b, 0x769, 0x737, 0x705, 0x6d3, 0x6a1, 0x670, 0x63f, 0x60e, 0x5dd, 0x5ad, 0x57d, 0x54e, 0x51f, 0x4f0, 0x4c2, 0x494, 0x467, 0x43a, 0x40e, 0x3e3, 0x3b8, 0x38e, 0x365, 0x33c, 0x314, 0x2ed, 0x2c6, 0x2a0, 0x27c, 0x258, 0x235, 0x212, 0x1f1, 0x1d1, 0x1b1, 0x193, 0x175, 0x159, 0x13e, 0x123, 0x10a, 0xf2,  0xdb,  0xc5,  0xb0,  0x9c,  0x89,  0x78,  0x67,  0x58,  0x4a,  0x3d,  0x32,  0x27,  0x1e,  0x16,  0xf,   0xa,   0x6,   0x2,   0x1};
-#endif  // AUDIO_DAC_SAMPLE_WAVEFORM_SINE
 #ifdef AUDIO_DAC_SAMPLE_WAVEFORM_TRIANGLE
 static const dacsample_t dac_buffer_triangle[AUDIO_DAC_BUFFER_SIZE] = {
     // 256 values, max 4095
@@ -79,175 +75,172 @@ static const dacsample_t dac_buffer_trapezoid[AUDIO_DAC_BUFFER_SIZE] = {0x0,   0
                                                                         0xfff, 0xfdf, 0xf7f, 0xf1f, 0xebf, 0xe5f, 0xdff, 0xd9f, 0xd3f, 0xcdf, 0xc7f, 0xc1f, 0xbbf, 0xb5f, 0xaff, 0xa9f, 0xa3f, 0x9df, 0x97f, 0x91f, 0x8bf, 0x85f, 0x7ff, 0x79f, 0x73f, 0x6df, 0x67f, 0x61f, 0x5bf, 0x55f, 0x4ff, 0x49f, 0x43f, 0x3df, 0x37f, 0x31f, 0x2bf, 0x25f, 0x1ff, 0x19f, 0x13f, 0xdf,  0x7f,  0x1f,  0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0,   0x0};
 #endif  // AUDIO_DAC_SAMPLE_WAVEFORM_TRAPEZOID
 
-static dacsample_t dac_buffer_empty[AUDIO_DAC_BUFFER_SIZE] = {AUDIO_DAC_OFF_VALUE};
-
-/* keep track of the sample position for for each frequency */
-static float dac_if[AUDIO_MAX_SIMULTANEOUS_TONES] = {0.0};
-
-static float   active_tones_snapshot[AUDIO_MAX_SIMULTANEOUS_TONES] = {0, 0};
-static uint8_t active_tones_snapshot_length                        = 0;
-
-typedef enum {
-    OUTPUT_SHOULD_START,
-    OUTPUT_RUN_NORMALLY,
-    // path 1: wait for zero, then change/update active tones
-    OUTPUT_TONES_CHANGED,
-    OUTPUT_REACHED_ZERO_BEFORE_TONE_CHANGE,
-    // path 2: hardware should stop, wait for zero then turn output off = stop the timer
-    OUTPUT_SHOULD_STOP,
-    OUTPUT_REACHED_ZERO_BEFORE_OFF,
-    OUTPUT_OFF,
-    OUTPUT_OFF_1,
-    OUTPUT_OFF_2,  // trailing off: giving the DAC two more conversion cycles until the AUDIO_DAC_OFF_VALUE reaches the output, then turn the timer off, which leaves the output at that level
-    number_of_output_states
-} output_states_t;
-output_states_t state = OUTPUT_OFF_2;
+#if defined(AUDIO_DAC_SAMPLE_WAVEFORM_SINE)
+#    define dac_wavetable sine_lut
+#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRIANGLE)
+#    define dac_wavetable dac_buffer_triangle
+#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRAPEZOID)
+#    define dac_wavetable dac_buffer_trapezoid
+#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_SQUARE)
+#    define dac_wavetable dac_buffer_square
+#endif
 
-/**
- * Generation of the waveform being passed to the callback. Declared weak so users
- * can override it with their own wave-forms/noises.
- */
-__attribute__((weak)) uint16_t dac_value_generate(void) {
-    // DAC is running/asking for values but snapshot length is zero -> must be playing a pause
-    if (active_tones_snapshot_length == 0) {
-        return AUDIO_DAC_OFF_VALUE;
-    }
+_Static_assert(AUDIO_DAC_BUFFER_SIZE == AUDIO_MIXER_WAVETABLE_LENGTH, "AUDIO_DAC: the wavetables have to be as long as the mixer expects");
+_Static_assert(AUDIO_MAX_SIMULTANEOUS_TONES <= AUDIO_MIXER_MAX_VOICES, "AUDIO_DAC: raise AUDIO_MIXER_MAX_VOICES to play that many tones");
 
-    /* doing additive wave synthesis over all currently playing tones = adding up
-     * sine-wave-samples for each frequency, scaled by the number of active tones
-     */
-    uint16_t value     = 0;
-    float    frequency = 0.0f;
+/* the gpt timer runs with 3*AUDIO_DAC_SAMPLE_RATE, and triggers a conversion every other tick */
+#define DAC_OUTPUT_RATE (AUDIO_DAC_SAMPLE_RATE * 3 / 2)
 
-    for (uint8_t i = 0; i < active_tones_snapshot_length; i++) {
-        /* Note: a user implementation does not have to rely on the active_tones_snapshot, but
-         * could directly query the active frequencies through audio_get_processed_frequency */
-        frequency = active_tones_snapshot[i];
+#if PORT_SUPPORTS_RT == TRUE
+typedef rtcnt_t dac_clock_t;
+#    define DAC_CLOCK() chSysGetRealtimeCounterX()
+#    define DAC_CLOCK_FREQUENCY STM32_HCLK
+#else
+typedef systime_t dac_clock_t;
+#    define DAC_CLOCK() chVTGetSystemTimeX()
+#    define DAC_CLOCK_FREQUENCY CH_CFG_ST_FREQUENCY
+#endif
+/* how long the DMA takes to play half of dac_buffer, in DAC_CLOCK ticks */
+#define DAC_HALF_BUFFER_TIME ((uint32_t)((uint64_t)DAC_CLOCK_FREQUENCY * (AUDIO_DAC_BUFFER_SIZE / 2) / DAC_OUTPUT_RATE))
+
+static dacsample_t dac_buffer[AUDIO_DAC_BUFFER_SIZE] = {[0 ... AUDIO_DAC_BUFFER_SIZE - 1] = AUDIO_DAC_OFF_VALUE};
+
+static audio_mixer_t       mixer;
+static audio_mixer_stats_t mixer_stats;
+
+/* the half of dac_buffer the DMA just finished with, up for rendering */
+static dacsample_t *      dac_half_free = NULL;
+static bool               dac_half_late = false;
+static binary_semaphore_t dac_half_freed;
+
+static volatile bool dac_should_start = false;
+static volatile bool dac_should_stop  = false;
+static bool          dac_stopping     = true;
+static uint8_t       dac_silent_halves;
+static bool          dac_should_halt = false;
+
+/* the tones to play, taken where the audio state is updated and handed to the mixer thread */
+static audio_pitch_t dac_pitches[AUDIO_MAX_SIMULTANEOUS_TONES];
+static uint8_t       dac_pitch_count   = 0;
+static bool          dac_tones_changed = false;
+
+/* call with the system locked */
+static void dac_take_tones(void) {
+    dac_pitch_count = MIN(AUDIO_MAX_SIMULTANEOUS_TONES, audio_get_number_of_active_tones());
+    for (uint8_t i = 0; i < dac_pitch_count; i++) {
+        dac_pitches[i] = audio_get_processed_pitch(i);
+    }
+    dac_tones_changed = true;
+}
 
-        dac_if[i] = dac_if[i] + ((frequency * AUDIO_DAC_BUFFER_SIZE) / AUDIO_DAC_SAMPLE_RATE) * 2 / 3;
-        /*Note: the 2/3 are necessary to get the correct frequencies on the
-         *      DAC output (as measured with an oscilloscope), since the gpt
-         *      timer runs with 3*AUDIO_DAC_SAMPLE_RATE; and the DAC callback
-         *      is called twice per conversion.*/
+static void dac_render(dacsample_t *samples) {
+    audio_pitch_t pitches[AUDIO_MAX_SIMULTANEOUS_TONES];
+    uint8_t       count = 0;
 
-        dac_if[i] = fmod(dac_if[i], AUDIO_DAC_BUFFER_SIZE);
+    chSysLock();
+    bool changed      = dac_tones_changed;
+    dac_tones_changed = false;
+    if (changed) {
+        count = dac_pitch_count;
+        memcpy(pitches, dac_pitches, count * sizeof(audio_pitch_t));
+    }
+    chSysUnlock();
 
-        // Wavetable generation/lookup
-        uint16_t dac_i = (uint16_t)dac_if[i];
+    if (dac_should_start) {
+        dac_should_start  = false;
+        dac_stopping      = false;
+        dac_silent_halves = 0;
+    }
+    if (dac_should_stop) {
+        dac_should_stop = false;
+        dac_stopping    = true;
+        audio_mixer_set_pitches(&mixer, NULL, 0);
+    } else if (changed && !dac_stopping) {
+        audio_mixer_set_pitches(&mixer, pitches, count);
+    }
 
-#if defined(AUDIO_DAC_SAMPLE_WAVEFORM_SINE)
-        value += dac_buffer_sine[dac_i] / active_tones_snapshot_length;
-#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRIANGLE)
-        value += dac_buffer_triangle[dac_i] / active_tones_snapshot_length;
-#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_TRAPEZOID)
-        value += dac_buffer_trapezoid[dac_i] / active_tones_snapshot_length;
-#elif defined(AUDIO_DAC_SAMPLE_WAVEFORM_SQUARE)
-        value += dac_buffer_square[dac_i] / active_tones_snapshot_length;
-#endif
-        /*
-        // SINE
-        value += dac_buffer_sine[dac_i] / active_tones_snapshot_length / 3;
-        // TRIANGLE
-        value += dac_buffer_triangle[dac_i] / active_tones_snapshot_length / 3;
-        // SQUARE
-        value += dac_buffer_square[dac_i] / active_tones_snapshot_length / 3;
-        //NOTE: combination of these three wave-forms is more exemplary - and doesn't sound particularly good :-P
-        */
-
-        // STAIRS (mostly usefully as test-pattern)
-        // value_avg = dac_buffer_staircase[dac_i] / active_tones_snapshot_length;
+    if (dac_stopping && audio_mixer_is_silent(&mixer)) {
+        // trailing off: give the DAC the rest of the buffer until AUDIO_DAC_OFF_VALUE reaches the output,
+        // then have the DAC callback stop the timer, which leaves the output at that level
+        if (++dac_silent_halves > 2) {
+            chSysLock();
+            dac_should_halt = true;
+            chSysUnlock();
+            return;
+        }
+    }
+
+    if (dac_value_generate != NULL) {
+        // a keymap brings its own samples, which are only started and stopped at AUDIO_DAC_OFF_VALUE
+        for (uint16_t s = 0; s < AUDIO_DAC_BUFFER_SIZE / 2; s++) {
+            samples[s] = audio_mixer_gate(&mixer, dac_value_generate());
+        }
+    } else {
+        audio_mixer_render(&mixer, samples, AUDIO_DAC_BUFFER_SIZE / 2);
     }
+}
+
+static THD_WORKING_AREA(waMixerThread, 512);
+static THD_FUNCTION(MixerThread, arg) {
+    (void)arg;
+    chRegSetThreadName("audio_mixer");
+
+    while (true) {
+        chBSemWait(&dac_half_freed);
 
-    return value;
+        chSysLock();
+        dacsample_t *samples = dac_half_free;
+        bool         late    = dac_half_late;
+        dac_half_free        = NULL;
+        dac_half_late        = false;
+        chSysUnlock();
+
+        if (samples == NULL) {
+            continue;
+        }
+        dac_clock_t start = DAC_CLOCK();
+        dac_render(samples);
+        audio_mixer_account(&mixer_stats, (dac_clock_t)(DAC_CLOCK() - start), DAC_HALF_BUFFER_TIME, late);
+    }
 }
 
+audio_mixer_stats_t audio_dac_get_mixer_stats(void) { return mixer_stats; }
+
 /**
- * DAC streaming callback. Does all of the main computing for playing songs.
+ * DAC streaming callback, hands the half of the buffer that was just played to the mixer thread.
  *
  * Note: chibios calls this CB twice: during the 'half buffer event', and the 'full buffer event'.
  */
 static void dac_end(DACDriver *dacp) {
-    dacsample_t *sample_p = (dacp)->samples;
+    dacsample_t *samples = dacp->samples;
 
     // work on the other half of the buffer
     if (dacIsBufferComplete(dacp)) {
-        sample_p += AUDIO_DAC_BUFFER_SIZE / 2;  // 'half_index'
+        samples += AUDIO_DAC_BUFFER_SIZE / 2;  // 'half_index'
     }
 
-    for (uint8_t s = 0; s < AUDIO_DAC_BUFFER_SIZE / 2; s++) {
-        if (OUTPUT_OFF <= state) {
-            sample_p[s] = AUDIO_DAC_OFF_VALUE;
-            continue;
-        } else {
-            sample_p[s] = dac_value_generate();
-        }
-
-        /* zero crossing (or approach, whereas zero == DAC_OFF_VALUE, which can be configured to anything from 0 to DAC_SAMPLE_MAX)
-         * ============================*=*========================== AUDIO_DAC_SAMPLE_MAX
-         *                          *       *
-         *                        *           *
-         * ---------------------------------------------------------
-         *                     *                 *                  } AUDIO_DAC_SAMPLE_MAX/100
-         * --------------------------------------------------------- AUDIO_DAC_OFF_VALUE
-         *                  *                       *               } AUDIO_DAC_SAMPLE_MAX/100
-         * ---------------------------------------------------------
-         *               *
-         * *           *
-         *   *       *
-         * =====*=*================================================= 0x0
-         */
-        if (((sample_p[s] + (AUDIO_DAC_SAMPLE_MAX / 100)) > AUDIO_DAC_OFF_VALUE) &&  // value approaches from below
-            (sample_p[s] < (AUDIO_DAC_OFF_VALUE + (AUDIO_DAC_SAMPLE_MAX / 100)))     // or above
-        ) {
-            if ((OUTPUT_SHOULD_START == state) && (active_tones_snapshot_length > 0)) {
-                state = OUTPUT_RUN_NORMALLY;
-            } else if (OUTPUT_TONES_CHANGED == state) {
-                state = OUTPUT_REACHED_ZERO_BEFORE_TONE_CHANGE;
-            } else if (OUTPUT_SHOULD_STOP == state) {
-                state = OUTPUT_REACHED_ZERO_BEFORE_OFF;
-            }
-        }
-
-        // still 'ramping up', reset the output to OFF_VALUE until the generated values reach that value, to do a smooth handover
-        if (OUTPUT_SHOULD_START == state) {
-            sample_p[s] = AUDIO_DAC_OFF_VALUE;
-        }
-
-        if ((OUTPUT_SHOULD_START == state) || (OUTPUT_REACHED_ZERO_BEFORE_OFF == state) || (OUTPUT_REACHED_ZERO_BEFORE_TONE_CHANGE == state)) {
-            uint8_t active_tones         = MIN(AUDIO_MAX_SIMULTANEOUS_TONES, audio_get_number_of_active_tones());
-            active_tones_snapshot_length = 0;
-            // update the snapshot - once, and only on occasion that something changed;
-            // -> saves cpu cycles (?)
-            for (uint8_t i = 0; i < active_tones; i++) {
-                float freq = audio_get_processed_frequency(i);
-                if (freq > 0) {  // disregard 'rest' notes, with valid frequency 0.0f; which would only lower the resulting waveform volume during the additive synthesis step
-                    active_tones_snapshot[active_tones_snapshot_length++] = freq;
-                }
-            }
-
-            if ((0 == active_tones_snapshot_length) && (OUTPUT_REACHED_ZERO_BEFORE_OFF == state)) {
-                state = OUTPUT_OFF;
-            }
-            if (OUTPUT_REACHED_ZERO_BEFORE_TONE_CHANGE == state) {
-                state = OUTPUT_RUN_NORMALLY;
-            }
-        }
+    chSysLockFromISR();
+    if (dac_should_halt) {
+        // stopping timer6 = stopping the DAC at whatever value it is currently pushing to the output = AUDIO_DAC_OFF_VALUE
+        dac_should_halt = false;
+        gptStopTimerI(&GPTD6);
+        chSysUnlockFromISR();
+        return;
     }
-
-    // update audio internal state (note position, current_note, ...)
-    if (audio_update_state()) {
-        if (OUTPUT_SHOULD_STOP != state) {
-            state = OUTPUT_TONES_CHANGED;
-        }
+    // the thread never got to the last half, which is now being played again
+    if (dac_half_free != NULL) {
+        dac_half_late = true;
     }
+    dac_half_free = samples;
+    chBSemSignalI(&dac_half_freed);
+    chSysUnlockFromISR();
 
-    if (OUTPUT_OFF <= state) {
-        if (OUTPUT_OFF_2 == state) {
-            // stopping timer6 = stopping the DAC at whatever value it is currently pushing to the output = AUDIO_DAC_OFF_VALUE
-            gptStopTimer(&GPTD6);
-        } else {
-            state++;
-        }
+    // update audio internal state (note position, current_note, ...) here as it always was, which
+    // keeps the mixer thread's stack down to rendering
+    if (audio_update_state()) {
+        chSysLockFromISR();
+        dac_take_tones();
+        chSysUnlockFromISR();
     }
 }
 
@@ -282,6 +275,10 @@ static const DACConfig dac_conf = {.init = AUDIO_DAC_OFF_VALUE, .datamode = DAC_
 static const DACConversionGroup dac_conv_cfg = {.num_channels = 1U, .end_cb = dac_end, .error_cb = dac_error, .trigger = DAC_TRG(0b000)};
 
 void audio_driver_initialize() {
+    audio_mixer_init(&mixer, dac_wavetable, DAC_OUTPUT_RATE, AUDIO_DAC_OFF_VALUE, AUDIO_DAC_SAMPLE_MAX / 100);
+    chBSemObjectInit(&dac_half_freed, true);
+    chThdCreateStatic(waMixerThread, sizeof(waMixerThread), HIGHPRIO, MixerThread, NULL);
+
     if ((AUDIO_PIN == A4) || (AUDIO_PIN_ALT == A4)) {
         palSetLineMode(A4, PAL_MODE_INPUT_ANALOG);
         dacStart(&DACD1, &dac_conf);
@@ -304,9 +301,9 @@ void audio_driver_initialize() {
     DACD2.params->dac->CR &= ~DAC_CR_BOFF2;
 
     if (AUDIO_PIN == A4) {
-        dacStartConversion(&DACD1, &dac_conv_cfg, dac_buffer_empty, AUDIO_DAC_BUFFER_SIZE);
+        dacStartConversion(&DACD1, &dac_conv_cfg, dac_buffer, AUDIO_DAC_BUFFER_SIZE);
     } else if (AUDIO_PIN == A5) {
-        dacStartConversion(&DACD2, &dac_conv_cfg, dac_buffer_empty, AUDIO_DAC_BUFFER_SIZE);
+        dacStartConversion(&DACD2, &dac_conv_cfg, dac_buffer, AUDIO_DAC_BUFFER_SIZE);
     }
 
     // no inverted/out-of-phase waveform (yet?), only pulling AUDIO_PIN_ALT to AUDIO_DAC_OFF_VALUE
@@ -321,15 +318,14 @@ void audio_driver_initialize() {
     gptStart(&GPTD6, &gpt6cfg1);
 }
 
-void audio_driver_stop(void) { state = OUTPUT_SHOULD_STOP; }
+void audio_driver_stop(void) { dac_should_stop = true; }
 
 void audio_driver_start(void) {
+    dac_should_stop  = false;
+    dac_should_start = true;
+    chSysLock();
+    dac_should_halt = false;
+    dac_take_tones();
+    chSysUnlock();
     gptStartContinuous(&GPTD6, 2U);
-
-    for (uint8_t i = 0; i < AUDIO_MAX_SIMULTANEOUS_TONES; i++) {
-        dac_if[i]                = 0.0f;
-        active_tones_snapshot[i] = 0.0f;
-    }
-    active_tones_snapshot_length = 0;
-    state                        = OUTPUT_SHOULD_START;
 }
@@ -110,18 +110,18 @@ void channel_1_stop(void) {
     palSetPad(GPIOA, 4);
 }
 
-static float channel_1_frequency = 0.0f;
-void         channel_1_set_frequency(float freq) {
+static audio_pitch_t channel_1_frequency = 0;
+void                 channel_1_set_frequency(audio_pitch_t freq) {
     channel_1_frequency = freq;
 
     channel_1_stop();
-    if (freq <= 0.0)  // a pause/rest has freq=0
+    if (freq == 0)  // a pause/rest has freq=0
         return;
 
-    gpt6cfg1.frequency = 2 * freq * AUDIO_DAC_BUFFER_SIZE;
+    gpt6cfg1.frequency = (2 * freq * AUDIO_DAC_BUFFER_SIZE) >> AUDIO_PITCH_SHIFT;
     channel_1_start();
 }
-float channel_1_get_frequency(void) { return channel_1_frequency; }
+audio_pitch_t channel_1_get_frequency(void) { return channel_1_frequency; }
 
 void channel_2_start(void) {
     gptStart(&GPTD7, &gpt7cfg1);
@@ -135,33 +135,33 @@ void channel_2_stop(void) {
     palSetPad(GPIOA, 5);
 }
 
-static float channel_2_frequency = 0.0f;
-void         channel_2_set_frequency(float freq) {
+static audio_pitch_t channel_2_frequency = 0;
+void                 channel_2_set_frequency(audio_pitch_t freq) {
     channel_2_frequency = freq;
 
     channel_2_stop();
-    if (freq <= 0.0)  // a pause/rest has freq=0
+    if (freq == 0)  // a pause/rest has freq=0
         return;
 
-    gpt7cfg1.frequency = 2 * freq * AUDIO_DAC_BUFFER_SIZE;
+    gpt7cfg1.frequency = (2 * freq * AUDIO_DAC_BUFFER_SIZE) >> AUDIO_PITCH_SHIFT;
     channel_2_start();
 }
-float channel_2_get_frequency(void) { return channel_2_frequency; }
+audio_pitch_t channel_2_get_frequency(void) { return channel_2_frequency; }
 
 static void gpt_audio_state_cb(GPTDriver *gptp) {
     if (audio_update_state()) {
 #if defined(AUDIO_PIN_ALT_AS_NEGATIVE)
         // one piezo/speaker connected to both audio pins, the generated square-waves are inverted
-        channel_1_set_frequency(audio_get_processed_frequency(0));
-        channel_2_set_frequency(audio_get_processed_frequency(0));
+        channel_1_set_frequency(audio_get_processed_pitch(0));
+        channel_2_set_frequency(audio_get_processed_pitch(0));
 
 #else  // two separate audio outputs/speakers
        // primary speaker on A4, optional secondary on A5
         if (AUDIO_PIN == A4) {
-            channel_1_set_frequency(audio_get_processed_frequency(0));
+            channel_1_set_frequency(audio_get_processed_pitch(0));
             if (AUDIO_PIN_ALT == A5) {
                 if (audio_get_number_of_active_tones() > 1) {
-                    channel_2_set_frequency(audio_get_processed_frequency(1));
+                    channel_2_set_frequency(audio_get_processed_pitch(1));
                 } else {
                     channel_2_stop();
                 }
@@ -170,10 +170,10 @@ static void gpt_audio_state_cb(GPTDriver *gptp) {
 
         // primary speaker on A5, optional secondary on A4
         if (AUDIO_PIN == A5) {
-            channel_2_set_frequency(audio_get_processed_frequency(0));
+            channel_2_set_frequency(audio_get_processed_pitch(0));
             if (AUDIO_PIN_ALT == A4) {
                 if (audio_get_number_of_active_tones() > 1) {
-                    channel_1_set_frequency(audio_get_processed_frequency(1));
+                    channel_1_set_frequency(audio_get_processed_pitch(1));
                 } else {
                     channel_1_stop();
                 }
@@ -24,6 +24,9 @@
 #include "debug.h"
 #include "eeprom_stm32.h"
 #include "flash_stm32.h"
+#ifdef FEE_WRITE_BACK
+#    include "timer.h"
+#endif
 
 /*
  * We emulate eeprom by writing a snapshot compacted view of eeprom contents,
@@ -53,6 +56,11 @@
  *
  * FEE_PAGE_COUNT   # Total number of pages to use for eeprom simulation (Compact + Write log)
  * FEE_DENSITY_BYTES   # Size of simulated eeprom. (Defaults to half the space allocated by FEE_PAGE_COUNT)
+ * FEE_WRITE_BATCH_WORDS   # Number of distinct words that can be dirty before they have to be written out (Defaults to 16)
+ * FEE_WRITE_BACK   # Keep dirty words in RAM until writes stop, instead of writing them at the end of every write
+ * FEE_WRITE_BACK_DELAY   # Milliseconds without writes before dirty words are written out (Defaults to 1000)
+ * FEE_BACKGROUND_COMPACTION   # Split the pages into two banks and compact into the other bank a few words at a time, see below
+ * FEE_COMPACTION_STEP_WORDS   # Number of words copied per background compaction step (Defaults to 16)
  * NOTE: The current implementation does not include page swapping,
  * and FEE_DENSITY_BYTES will consume that amount of RAM as a cached view of actual EEPROM contents.
  *
@@ -73,11 +81,34 @@
  * EEPROM contents are given back directly from the cache in memory.
  *
  * During writes:
- * The contents of the cache is updated first.
+ * The contents of the cache is updated first, and the word written to is marked dirty.
+ * Dirty words are written to flash together, as one batch:
+ * - at the end of every write, or of every block write, by default
+ * - once no writes have happened for FEE_WRITE_BACK_DELAY milliseconds, with FEE_WRITE_BACK
+ * - when there is no room to mark another word dirty, or eeprom_flush() is called
+ * For each dirty word whose value differs from what flash holds:
  * If the Compacted-flash area corresponding to the write address is unprogrammed, the 1's complement of the value is written directly into Compacted-flash
- * Otherwise:
- * If the write log is full, erase both the Compacted-flash area and the Write log, then write cached contents to the Compacted-flash area.
  * Otherwise a Write log entry is constructed and appended to the next free position in the Write log.
+ * If the Write log cannot hold all entries of the batch, erase both the Compacted-flash area and the Write log, then write cached contents to the Compacted-flash area.
+ *
+ *
+ * *** Background Compaction ***
+ *
+ * With FEE_BACKGROUND_COMPACTION, the pages are split into two banks, each with its own
+ * Compacted-flash area, Write log and a header in its last 4 bytes. The header holds a sequence
+ * number and its 1's complement, and is written last, so a bank only counts once it is complete.
+ * At initialization the valid bank with the newest sequence number is used.
+ *
+ * Once half of the Write log is used, eeprom_driver_task() starts compacting into the other bank
+ * in small steps: each call erases one page, or copies the flashed value of FEE_COMPACTION_STEP_WORDS
+ * words, or finally writes the header of the other bank and switches to it.
+ * The bank in use is never touched, so losing power at any point leaves a complete bank behind.
+ * Batches written while words are being copied also go to the other bank's Write log for words
+ * that were already copied. If the Write log fills up before compaction is done, compaction
+ * finishes at once from the cached contents, as it does without FEE_BACKGROUND_COMPACTION.
+ *
+ * Each bank is half of FEE_PAGE_COUNT pages, so FEE_DENSITY_BYTES defaults to a quarter of the
+ * space allocated and the Write log is half of what it would otherwise be.
  *
  *
  * *** Write Log Structure ***
@@ -150,14 +181,26 @@
 /* Flash word value after erase */
 #define FEE_EMPTY_WORD ((uint16_t)0xFFFF)
 
-/* Size of combined compacted eeprom and write log pages */
-#define FEE_DENSITY_MAX_SIZE (FEE_PAGE_COUNT * FEE_PAGE_SIZE)
-
 #ifndef FEE_MCU_FLASH_SIZE_IGNORE_CHECK /* *TODO: Get rid of this check */
-#    if FEE_DENSITY_MAX_SIZE > (FEE_MCU_FLASH_SIZE * 1024)
-#        pragma message STR(FEE_DENSITY_MAX_SIZE) " > " STR(FEE_MCU_FLASH_SIZE * 1024)
-#        error emulated eeprom: FEE_DENSITY_MAX_SIZE is greater than available flash size
+#    if (FEE_PAGE_COUNT * FEE_PAGE_SIZE) > (FEE_MCU_FLASH_SIZE * 1024)
+#        pragma message STR(FEE_PAGE_COUNT * FEE_PAGE_SIZE) " > " STR(FEE_MCU_FLASH_SIZE * 1024)
+#        error emulated eeprom: FEE_PAGE_COUNT * FEE_PAGE_SIZE is greater than available flash size
+#    endif
+#endif
+
+#ifdef FEE_BACKGROUND_COMPACTION
+#    if (FEE_PAGE_COUNT % 2) == 1
+#        error emulated eeprom: FEE_PAGE_COUNT must be even for FEE_BACKGROUND_COMPACTION
 #    endif
+/* Size of each of the two banks, one in use while the other one is compacted into */
+#    define FEE_BANK_SIZE (FEE_PAGE_COUNT / 2 * FEE_PAGE_SIZE)
+/* Each bank ends with a sequence number and its 1's complement, written once the bank is complete */
+#    define FEE_BANK_HEADER_SIZE 4
+/* Size of combined compacted eeprom and write log within a bank */
+#    define FEE_DENSITY_MAX_SIZE (FEE_BANK_SIZE - FEE_BANK_HEADER_SIZE)
+#else
+/* Size of combined compacted eeprom and write log pages */
+#    define FEE_DENSITY_MAX_SIZE (FEE_PAGE_COUNT * FEE_PAGE_SIZE)
 #endif
 
 /* Size of emulated eeprom */
@@ -179,7 +222,11 @@
 #    endif
 #else
 /* Default to half of allocated space used for emulated eeprom, half for write log */
-#    define FEE_DENSITY_BYTES (FEE_PAGE_COUNT * FEE_PAGE_SIZE / 2)
+#    ifdef FEE_BACKGROUND_COMPACTION
+#        define FEE_DENSITY_BYTES (FEE_BANK_SIZE / 2)
+#    else
+#        define FEE_DENSITY_BYTES (FEE_PAGE_COUNT * FEE_PAGE_SIZE / 2)
+#    endif
 #endif
 
 /* Size of write log */
@@ -193,11 +240,15 @@
 #    endif
 #else
 /* Default to use all remaining space */
-#    define FEE_WRITE_LOG_BYTES (FEE_PAGE_COUNT * FEE_PAGE_SIZE - FEE_DENSITY_BYTES)
+#    define FEE_WRITE_LOG_BYTES (FEE_DENSITY_MAX_SIZE - FEE_DENSITY_BYTES)
 #endif
 
 /* Start of the emulated eeprom compacted flash area */
-#define FEE_COMPACTED_BASE_ADDRESS FEE_PAGE_BASE_ADDRESS
+#ifdef FEE_BACKGROUND_COMPACTION
+#    define FEE_COMPACTED_BASE_ADDRESS active_bank
+#else
+#    define FEE_COMPACTED_BASE_ADDRESS FEE_PAGE_BASE_ADDRESS
+#endif
 /* End of the emulated eeprom compacted flash area */
 #define FEE_COMPACTED_LAST_ADDRESS (FEE_COMPACTED_BASE_ADDRESS + FEE_DENSITY_BYTES)
 /* Start of the emulated eeprom write log */
@@ -209,6 +260,21 @@
 #    error emulated eeprom: DYNAMIC_KEYMAP_EEPROM_MAX_ADDR is greater than the FEE_DENSITY_BYTES available
 #endif
 
+#ifndef FEE_WRITE_BATCH_WORDS
+#    define FEE_WRITE_BATCH_WORDS 16
+#endif
+#if FEE_WRITE_BATCH_WORDS < 1 || FEE_WRITE_BATCH_WORDS > 255
+#    error emulated eeprom: FEE_WRITE_BATCH_WORDS must be between 1 and 255
+#endif
+
+#if defined(FEE_WRITE_BACK) && !defined(FEE_WRITE_BACK_DELAY)
+#    define FEE_WRITE_BACK_DELAY 1000
+#endif
+
+#if defined(FEE_BACKGROUND_COMPACTION) && !defined(FEE_COMPACTION_STEP_WORDS)
+#    define FEE_COMPACTION_STEP_WORDS 16
+#endif
+
 /* In-memory contents of emulated eeprom for faster access */
 /* *TODO: Implement page swapping */
 static uint16_t WordBuf[FEE_DENSITY_BYTES / 2];
@@ -217,6 +283,44 @@ static uint8_t *DataBuf = (uint8_t *)WordBuf;
 /* Pointer to the first available slot within the write log */
 static uint16_t *empty_slot;
 
+/* Word changed in DataBuf but not yet in flash */
+typedef struct {
+    uint16_t address; /* Word aligned */
+    uint16_t clean;   /* Value flash holds for this word */
+} eeprom_dirty_word_t;
+
+/* Dirty words, in the order they were first written */
+static eeprom_dirty_word_t dirty_words[FEE_WRITE_BATCH_WORDS];
+static uint8_t             dirty_count = 0;
+
+/* Non-zero while a block write is in progress, its words are written out together at the end */
+static uint8_t batch_depth = 0;
+
+#ifdef FEE_WRITE_BACK
+/* Time of the last write, dirty words are written out once it is FEE_WRITE_BACK_DELAY ago */
+static uint16_t last_write_time;
+#endif
+
+#ifdef FEE_BACKGROUND_COMPACTION
+/* Start and sequence number of the bank in use */
+static uintptr_t active_bank;
+static uint16_t  active_sequence;
+
+typedef enum {
+    COMPACTION_IDLE,
+    COMPACTION_ERASE,  /* Erasing the other bank, one page per step */
+    COMPACTION_COPY,   /* Copying words into the other bank's compacted area */
+    COMPACTION_SWITCH, /* Writing the other bank's header, which puts it in use */
+} eeprom_compaction_state_t;
+
+static struct {
+    eeprom_compaction_state_t state;
+    bool                      include_dirty; /* Copy dirty words as they are in DataBuf rather than in flash */
+    uint16_t                  next;          /* Next page to erase, or next word to copy */
+    uint16_t *                empty_slot;    /* First available slot within the other bank's write log */
+} compaction;
+#endif
+
 // #define DEBUG_EEPROM_OUTPUT
 
 /*
@@ -275,7 +379,139 @@ void print_eeprom(void) {
 #endif
 }
 
+#ifdef FEE_BACKGROUND_COMPACTION
+/*
+ * Banks and background compaction
+ */
+
+static void eeprom_clear(void);
+
+/* Start of the bank not in use */
+static uintptr_t eeprom_other_bank(void) { return active_bank == FEE_PAGE_BASE_ADDRESS ? FEE_PAGE_BASE_ADDRESS + FEE_BANK_SIZE : FEE_PAGE_BASE_ADDRESS; }
+
+/* Returns whether a bank has a complete header, along with its sequence number */
+static bool eeprom_bank_valid(uintptr_t bank, uint16_t *sequence) {
+    uint16_t *header = (uint16_t *)(bank + FEE_BANK_SIZE - FEE_BANK_HEADER_SIZE);
+    *sequence        = header[0];
+    /* Sequence number 0 is never used, so that a header with only its first word written can't look complete */
+    return header[0] != 0 && header[0] != FEE_EMPTY_WORD && header[1] == (uint16_t)~header[0];
+}
+
+/* Writes the header that puts a bank in use. Flash must be unlocked. */
+static uint8_t eeprom_write_bank_header(uintptr_t bank, uint16_t sequence) {
+    uintptr_t header = bank + FEE_BANK_SIZE - FEE_BANK_HEADER_SIZE;
+    eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x) [HEADER]\n", (uint32_t)header, sequence);
+    FLASH_Status status = FLASH_ProgramHalfWord(header, sequence);
+    if (status != FLASH_COMPLETE) return status;
+    return FLASH_ProgramHalfWord(header + 2, ~sequence);
+}
+
+/* Puts the newest complete bank in use, or starts over with empty flash if neither is complete */
+static void eeprom_select_bank(void) {
+    uint16_t sequence[2];
+    bool     valid[2] = {eeprom_bank_valid(FEE_PAGE_BASE_ADDRESS, &sequence[0]), eeprom_bank_valid(FEE_PAGE_BASE_ADDRESS + FEE_BANK_SIZE, &sequence[1])};
+
+    compaction.state = COMPACTION_IDLE;
+    if (valid[1] && (!valid[0] || (int16_t)(sequence[1] - sequence[0]) > 0)) {
+        active_bank     = FEE_PAGE_BASE_ADDRESS + FEE_BANK_SIZE;
+        active_sequence = sequence[1];
+    } else if (valid[0]) {
+        active_bank     = FEE_PAGE_BASE_ADDRESS;
+        active_sequence = sequence[0];
+    } else {
+        eeprom_println("eeprom_select_bank: no complete bank");
+        eeprom_clear();
+    }
+}
+
+/* Starts compacting into the other bank once half the write log is used */
+static void eeprom_compaction_check(void) {
+    if (compaction.state == COMPACTION_IDLE && (uintptr_t)empty_slot - FEE_WRITE_LOG_BASE_ADDRESS >= FEE_WRITE_LOG_BYTES / 2) {
+        compaction.state         = COMPACTION_ERASE;
+        compaction.include_dirty = false;
+        compaction.next          = 0;
+    }
+}
+
+/* Value flash holds for a word, which for a dirty word is its value from before it changed */
+static uint16_t eeprom_flashed_word(uint16_t Address) {
+    for (uint8_t i = 0; i < dirty_count; ++i) {
+        if (dirty_words[i].address == Address) return dirty_words[i].clean;
+    }
+    return WordBuf[Address / 2];
+}
+
+/*
+ * Does one step of compaction into the other bank: erases one page, copies up to `words` words,
+ * or writes the header that puts the other bank in use. The bank in use is left alone, so flash
+ * always holds one complete bank. Words changed after they were copied get log entries in both banks.
+ */
+static uint8_t eeprom_compaction_step(uint16_t words) {
+    uintptr_t    bank   = eeprom_other_bank();
+    FLASH_Status status = FLASH_COMPLETE;
+
+    FLASH_Unlock();
+
+    switch (compaction.state) {
+        case COMPACTION_IDLE:
+            break;
+
+        case COMPACTION_ERASE:
+            eeprom_printf("FLASH_ErasePage(0x%04x)\n", (uint32_t)(bank + compaction.next * FEE_PAGE_SIZE));
+            status = FLASH_ErasePage(bank + compaction.next * FEE_PAGE_SIZE);
+            if (++compaction.next == FEE_PAGE_COUNT / 2) {
+                compaction.state      = COMPACTION_COPY;
+                compaction.next       = 0;
+                compaction.empty_slot = (uint16_t *)(bank + FEE_DENSITY_BYTES);
+            }
+            break;
+
+        case COMPACTION_COPY:
+            for (; words && compaction.next < FEE_DENSITY_BYTES / 2 && status == FLASH_COMPLETE; --words) {
+                uint16_t value = compaction.include_dirty ? WordBuf[compaction.next] : eeprom_flashed_word(compaction.next * 2);
+                if (value) {
+                    status = FLASH_ProgramHalfWord(bank + compaction.next * 2, ~value);
+                }
+                ++compaction.next;
+            }
+            if (compaction.next == FEE_DENSITY_BYTES / 2) {
+                compaction.state = COMPACTION_SWITCH;
+            }
+            break;
+
+        case COMPACTION_SWITCH: {
+            uint16_t sequence = active_sequence + 1;
+            if (sequence == FEE_EMPTY_WORD) sequence = 1;
+            status = eeprom_write_bank_header(bank, sequence);
+            if (status == FLASH_COMPLETE) {
+                active_bank      = bank;
+                active_sequence  = sequence;
+                empty_slot       = compaction.empty_slot;
+                compaction.state = COMPACTION_IDLE;
+            }
+            break;
+        }
+    }
+
+    FLASH_Lock();
+
+    if (status != FLASH_COMPLETE) {
+        eeprom_printf("eeprom_compaction_step [STATUS == %d]\n", status);
+        /* Start over the next time it is needed */
+        compaction.state = COMPACTION_IDLE;
+    }
+    return status;
+}
+#endif
+
 uint16_t EEPROM_Init(void) {
+    /* Pending writes would be lost by reloading DataBuf */
+    EEPROM_Flush();
+
+#ifdef FEE_BACKGROUND_COMPACTION
+    eeprom_select_bank();
+#endif
+
     /* Load emulated eeprom contents from compacted flash into memory */
     uint16_t *src  = (uint16_t *)FEE_COMPACTED_BASE_ADDRESS;
     uint16_t *dest = (uint16_t *)DataBuf;
@@ -347,6 +583,10 @@ uint16_t EEPROM_Init(void) {
         print_eeprom();
     }
 
+#ifdef FEE_BACKGROUND_COMPACTION
+    eeprom_compaction_check();
+#endif
+
     return FEE_DENSITY_BYTES;
 }
 
@@ -359,6 +599,14 @@ static void eeprom_clear(void) {
         FLASH_ErasePage(FEE_PAGE_BASE_ADDRESS + (page_num * FEE_PAGE_SIZE));
     }
 
+#ifdef FEE_BACKGROUND_COMPACTION
+    /* Start over in the first bank */
+    active_bank      = FEE_PAGE_BASE_ADDRESS;
+    active_sequence  = 1;
+    compaction.state = COMPACTION_IDLE;
+    eeprom_write_bank_header(active_bank, active_sequence);
+#endif
+
     FLASH_Lock();
 
     empty_slot = (uint16_t *)FEE_WRITE_LOG_BASE_ADDRESS;
@@ -368,6 +616,8 @@ static void eeprom_clear(void) {
 /* Erase emulated eeprom */
 void EEPROM_Erase(void) {
     eeprom_println("EEPROM_Erase");
+    /* Drop pending writes */
+    dirty_count = 0;
     /* Erase compacted pages and write log */
     eeprom_clear();
     /* re-initialize to reset DataBuf */
@@ -376,6 +626,24 @@ void EEPROM_Erase(void) {
 
 /* Compact write log */
 static uint8_t eeprom_compact(void) {
+#ifdef FEE_BACKGROUND_COMPACTION
+    /* Start over and finish in one go, taking dirty words along */
+    compaction.state         = COMPACTION_ERASE;
+    compaction.include_dirty = true;
+    compaction.next          = 0;
+
+    FLASH_Status status = FLASH_COMPLETE;
+    while (compaction.state != COMPACTION_IDLE && status == FLASH_COMPLETE) {
+        status = eeprom_compaction_step(FEE_DENSITY_BYTES / 2);
+    }
+
+    if (debug_eeprom) {
+        println("eeprom_compacted:");
+        print_eeprom();
+    }
+
+    return status;
+#else
     /* Erase compacted pages and write log */
     eeprom_clear();
 
@@ -404,29 +672,27 @@ static uint8_t eeprom_compact(void) {
     }
 
     return final_status;
+#endif
 }
 
-static uint8_t eeprom_write_direct_entry(uint16_t Address) {
+/* Write a dirty word directly to the compacted area of a bank, returns 0 if it already holds a value. Flash must be unlocked. */
+static uint8_t eeprom_write_direct_entry(uintptr_t bank, uint16_t Address) {
     /* Check if we can just write this directly to the compacted flash area */
-    uintptr_t directAddress = FEE_COMPACTED_BASE_ADDRESS + (Address & 0xFFFE);
+    uintptr_t directAddress = bank + (Address & 0xFFFE);
     if (*(uint16_t *)directAddress == FEE_EMPTY_WORD) {
         /* Write the value directly to the compacted area without a log entry */
         uint16_t value = ~*(uint16_t *)(&DataBuf[Address & 0xFFFE]);
         /* Early exit if a write isn't needed */
         if (value == FEE_EMPTY_WORD) return FLASH_COMPLETE;
 
-        FLASH_Unlock();
-
         eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x) [DIRECT]\n", (uint32_t)directAddress, value);
-        FLASH_Status status = FLASH_ProgramHalfWord(directAddress, value);
-
-        FLASH_Lock();
-        return status;
+        return FLASH_ProgramHalfWord(directAddress, value);
     }
     return 0;
 }
 
-static uint8_t eeprom_write_log_word_entry(uint16_t Address) {
+/* Append a word entry to a write log. Flash must be unlocked, and the log must have room for it. */
+static uint8_t eeprom_write_log_word_entry(uint16_t **slot, uint16_t Address) {
     FLASH_Status final_status = FLASH_COMPLETE;
 
     uint16_t value = *(uint16_t *)(&DataBuf[Address]);
@@ -434,67 +700,153 @@ static uint8_t eeprom_write_log_word_entry(uint16_t Address) {
 
     /* MSB signifies the lowest 128-byte optimization is not in effect */
     uint16_t encoding = FEE_WORD_ENCODING;
-    uint8_t  entry_size;
     if (value <= 1) {
         encoding |= value << 13;
-        entry_size = 2;
     } else {
         encoding |= FEE_VALUE_NEXT;
-        entry_size = 4;
         /* Writes to addresses less than 128 are byte log entries */
         Address -= FEE_BYTE_RANGE;
     }
 
-    /* if we can't find an empty spot, we must compact emulated eeprom */
-    if (empty_slot > (uint16_t *)(FEE_WRITE_LOG_LAST_ADDRESS - entry_size)) {
-        /* compact the write log into the compacted flash area */
-        return eeprom_compact();
-    }
-
     /* Word log writes should be word-aligned.  Take back a bit */
     Address >>= 1;
     Address |= encoding;
 
-    /* ok we found a place let's write our data */
-    FLASH_Unlock();
-
     /* address */
-    eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)empty_slot, Address);
-    final_status = FLASH_ProgramHalfWord((uintptr_t)empty_slot++, Address);
+    eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)*slot, Address);
+    final_status = FLASH_ProgramHalfWord((uintptr_t)(*slot)++, Address);
 
     /* value */
     if (encoding == (FEE_WORD_ENCODING | FEE_VALUE_NEXT)) {
-        eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)empty_slot, ~value);
-        FLASH_Status status = FLASH_ProgramHalfWord((uintptr_t)empty_slot++, ~value);
+        eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)*slot, ~value);
+        FLASH_Status status = FLASH_ProgramHalfWord((uintptr_t)(*slot)++, ~value);
         if (status != FLASH_COMPLETE) final_status = status;
     }
 
-    FLASH_Lock();
-
     return final_status;
 }
 
-static uint8_t eeprom_write_log_byte_entry(uint16_t Address) {
+/* Append a byte entry to a write log. Flash must be unlocked, and the log must have room for it. */
+static uint8_t eeprom_write_log_byte_entry(uint16_t **slot, uint16_t Address) {
     eeprom_printf("eeprom_write_log_byte_entry(0x%04x): 0x%02x\n", Address, DataBuf[Address]);
 
-    /* if couldn't find an empty spot, we must compact emulated eeprom */
-    if (empty_slot >= (uint16_t *)FEE_WRITE_LOG_LAST_ADDRESS) {
-        /* compact the write log into the compacted flash area */
-        return eeprom_compact();
-    }
-
-    /* ok we found a place let's write our data */
-    FLASH_Unlock();
-
     /* Pack address and value into the same word */
     uint16_t value = (Address << 8) | DataBuf[Address];
 
     /* write to flash */
-    eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)empty_slot, value);
-    FLASH_Status status = FLASH_ProgramHalfWord((uintptr_t)empty_slot++, value);
+    eeprom_printf("FLASH_ProgramHalfWord(0x%08x, 0x%04x)\n", (uint32_t)*slot, value);
+    return FLASH_ProgramHalfWord((uintptr_t)(*slot)++, value);
+}
 
-    FLASH_Lock();
+/* Number of write log bytes needed to bring a bank up to date with a dirty word */
+static uint16_t eeprom_log_entry_size(uintptr_t bank, const eeprom_dirty_word_t *dirty) {
+    uint16_t value = WordBuf[dirty->address / 2];
+    if (value == dirty->clean || *(uint16_t *)(bank + dirty->address) == FEE_EMPTY_WORD) {
+        return 0;
+    }
+    if (dirty->address < FEE_BYTE_RANGE) {
+        /* One byte entry for each byte that has changed */
+        return ((uint8_t)value != (uint8_t)dirty->clean ? 2 : 0) + ((value >> 8) != (dirty->clean >> 8) ? 2 : 0);
+    }
+    return value <= 1 ? 2 : 4;
+}
+
+/* Bring a bank up to date with a dirty word. Flash must be unlocked, and the bank's log must have room for it. */
+static uint8_t eeprom_write_dirty_word(uintptr_t bank, uint16_t **slot, const eeprom_dirty_word_t *dirty) {
+    uint16_t Address = dirty->address;
+    uint16_t value   = WordBuf[Address / 2];
+
+    /* Written back to what flash already holds */
+    if (value == dirty->clean) return FLASH_COMPLETE;
+
+    /* First, attempt to write directly into the compacted flash area */
+    FLASH_Status final_status = eeprom_write_direct_entry(bank, Address);
+    if (final_status) return final_status;
+
+    /* Otherwise append to the write log */
+    if (Address >= FEE_BYTE_RANGE) {
+        return eeprom_write_log_word_entry(slot, Address);
+    }
+    /* Only write a byte if it has changed */
+    final_status = FLASH_COMPLETE;
+    if ((uint8_t)value != (uint8_t)dirty->clean) {
+        final_status = eeprom_write_log_byte_entry(slot, Address);
+    }
+    if ((value >> 8) != (dirty->clean >> 8)) {
+        FLASH_Status status = eeprom_write_log_byte_entry(slot, Address + 1);
+        if (status != FLASH_COMPLETE) final_status = status;
+    }
+    return final_status;
+}
+
+uint8_t EEPROM_Flush(void) {
+    if (!dirty_count) {
+        return FLASH_COMPLETE;
+    }
 
+    /* Check the whole batch fits in the write log before writing any of it */
+    uint16_t log_bytes = 0;
+    for (uint8_t i = 0; i < dirty_count; ++i) {
+        log_bytes += eeprom_log_entry_size(FEE_COMPACTED_BASE_ADDRESS, &dirty_words[i]);
+    }
+
+    FLASH_Status final_status = FLASH_COMPLETE;
+    if ((uint8_t *)empty_slot + log_bytes > (uint8_t *)FEE_WRITE_LOG_LAST_ADDRESS) {
+        /* compact the write log into the compacted flash area, which takes every dirty word along */
+        final_status = eeprom_compact();
+    } else {
+        FLASH_Unlock();
+        for (uint8_t i = 0; i < dirty_count; ++i) {
+            FLASH_Status status = eeprom_write_dirty_word(FEE_COMPACTED_BASE_ADDRESS, &empty_slot, &dirty_words[i]);
+            if (status != FLASH_COMPLETE) final_status = status;
+#ifdef FEE_BACKGROUND_COMPACTION
+            /* Keep what has already been copied to the other bank in step, it ends up with the same log entries */
+            if (compaction.state >= COMPACTION_COPY && dirty_words[i].address / 2 < compaction.next) {
+                status = eeprom_write_dirty_word(eeprom_other_bank(), &compaction.empty_slot, &dirty_words[i]);
+                if (status != FLASH_COMPLETE) final_status = status;
+            }
+#endif
+        }
+        FLASH_Lock();
+    }
+    dirty_count = 0;
+#ifdef FEE_BACKGROUND_COMPACTION
+    eeprom_compaction_check();
+#endif
+
+    if (final_status != FLASH_COMPLETE) {
+        eeprom_printf("EEPROM_Flush [STATUS == %d]\n", final_status);
+    }
+    return final_status;
+}
+
+/* Mark the word holding Address dirty before it changes, returns the status of writing out the batch if it was full */
+static uint8_t eeprom_mark_dirty(uint16_t Address) {
+    Address &= 0xFFFE;
+    for (uint8_t i = 0; i < dirty_count; ++i) {
+        if (dirty_words[i].address == Address) return FLASH_COMPLETE;
+    }
+
+    FLASH_Status status = FLASH_COMPLETE;
+    if (dirty_count == FEE_WRITE_BATCH_WORDS) {
+        status = EEPROM_Flush();
+    }
+    dirty_words[dirty_count].address = Address;
+    dirty_words[dirty_count].clean   = WordBuf[Address / 2];
+    ++dirty_count;
+    return status;
+}
+
+/* Called after DataBuf has been updated, writes dirty words out unless they are to be held back */
+static uint8_t eeprom_write_done(uint8_t status) {
+#ifdef FEE_WRITE_BACK
+    last_write_time = timer_read();
+#else
+    if (!batch_depth) {
+        FLASH_Status flush_status = EEPROM_Flush();
+        if (flush_status != FLASH_COMPLETE) status = flush_status;
+    }
+#endif
     return status;
 }
 
@@ -511,21 +863,14 @@ uint8_t EEPROM_WriteDataByte(uint16_t Address, uint8_t DataByte) {
         return 0;
     }
 
+    FLASH_Status status = eeprom_mark_dirty(Address);
+
     /* keep DataBuf cache in sync */
     DataBuf[Address] = DataByte;
     eeprom_printf("EEPROM_WriteDataByte DataBuf[0x%04x] = 0x%02x\n", Address, DataBuf[Address]);
 
-    /* perform the write into flash memory */
-    /* First, attempt to write directly into the compacted flash area */
-    FLASH_Status status = eeprom_write_direct_entry(Address);
-    if (!status) {
-        /* Otherwise append to the write log */
-        if (Address < FEE_BYTE_RANGE) {
-            status = eeprom_write_log_byte_entry(Address);
-        } else {
-            status = eeprom_write_log_word_entry(Address & 0xFFFE);
-        }
-    }
+    /* perform the write into flash memory, now or later */
+    status = eeprom_write_done(status);
     if (status != 0 && status != FLASH_COMPLETE) {
         eeprom_printf("EEPROM_WriteDataByte [STATUS == %d]\n", status);
     }
@@ -558,32 +903,14 @@ uint8_t EEPROM_WriteDataWord(uint16_t Address, uint16_t DataWord) {
         return 0;
     }
 
+    final_status = eeprom_mark_dirty(Address);
+
     /* keep DataBuf cache in sync */
     *(uint16_t *)(&DataBuf[Address]) = DataWord;
     eeprom_printf("EEPROM_WriteDataWord DataBuf[0x%04x] = 0x%04x\n", Address, *(uint16_t *)(&DataBuf[Address]));
 
-    /* perform the write into flash memory */
-    /* First, attempt to write directly into the compacted flash area */
-    final_status = eeprom_write_direct_entry(Address);
-    if (!final_status) {
-        /* Otherwise append to the write log */
-        /* Check if we need to fall back to byte write */
-        if (Address < FEE_BYTE_RANGE) {
-            final_status = FLASH_COMPLETE;
-            /* Only write a byte if it has changed */
-            if ((uint8_t)oldValue != (uint8_t)DataWord) {
-                final_status = eeprom_write_log_byte_entry(Address);
-            }
-            FLASH_Status status = FLASH_COMPLETE;
-            /* Only write a byte if it has changed */
-            if ((oldValue >> 8) != (DataWord >> 8)) {
-                status = eeprom_write_log_byte_entry(Address + 1);
-            }
-            if (status != FLASH_COMPLETE) final_status = status;
-        } else {
-            final_status = eeprom_write_log_word_entry(Address);
-        }
-    }
+    /* perform the write into flash memory, now or later */
+    final_status = eeprom_write_done(final_status);
     if (final_status != 0 && final_status != FLASH_COMPLETE) {
         eeprom_printf("EEPROM_WriteDataWord [STATUS == %d]\n", final_status);
     }
@@ -626,6 +953,21 @@ void eeprom_driver_init(void) { EEPROM_Init(); }
 
 void eeprom_driver_erase(void) { EEPROM_Erase(); }
 
+void eeprom_flush(void) { EEPROM_Flush(); }
+
+void eeprom_driver_task(void) {
+#ifdef FEE_WRITE_BACK
+    if (dirty_count && timer_elapsed(last_write_time) >= FEE_WRITE_BACK_DELAY) {
+        EEPROM_Flush();
+    }
+#endif
+#ifdef FEE_BACKGROUND_COMPACTION
+    if (compaction.state != COMPACTION_IDLE) {
+        eeprom_compaction_step(FEE_COMPACTION_STEP_WORDS);
+    }
+#endif
+}
+
 void eeprom_read_block(void *buf, const void *addr, size_t len) {
     const uint8_t *src  = (const uint8_t *)addr;
     uint8_t *      dest = (uint8_t *)buf;
@@ -660,6 +1002,9 @@ void eeprom_write_block(const void *buf, void *addr, size_t len) {
     uint8_t *      dest = (uint8_t *)addr;
     const uint8_t *src  = (const uint8_t *)buf;
 
+    /* Write the whole block out as one batch */
+    ++batch_depth;
+
     /* Check word alignment */
     if (len && (uintptr_t)dest % 2) {
         /* Write the unaligned first byte */
@@ -684,4 +1029,7 @@ void eeprom_write_block(const void *buf, void *addr, size_t len) {
     if (len) {
         EEPROM_WriteDataByte((uintptr_t)dest, *src);
     }
+
+    --batch_depth;
+    eeprom_write_done(FLASH_COMPLETE);
 }
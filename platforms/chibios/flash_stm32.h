@@ -23,9 +23,18 @@ extern "C" {
 #endif
 
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef FLASH_STM32_MOCKED
 extern uint8_t FlashBuf[MOCK_FLASH_SIZE];
+/* Number of successful page erases and half word programs since the counts were last reset */
+extern uint32_t FlashEraseCount;
+extern uint32_t FlashProgramCount;
+/* Number of page erases and half word programs that go through before power is cut, or -1 to keep it on.
+ * The operation that gets cut does not finish, a page erase only erases the first half of the page.
+ * Every operation after that fails, until FlashPowerLost is cleared. */
+extern int32_t FlashPowerCutAfter;
+extern bool    FlashPowerLost;
 #endif
 
 typedef enum { FLASH_BUSY = 1, FLASH_ERROR_PG, FLASH_ERROR_WRP, FLASH_ERROR_OPT, FLASH_COMPLETE, FLASH_TIMEOUT, FLASH_BAD_ADDRESS } FLASH_Status;
@@ -0,0 +1,44 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <ch.h>
+
+#include "profiler.h"
+#include "timer.h"
+
+// The realtime counter is the DWT cycle counter on Cortex-M3/M4/M7, which the port already runs.
+// Elsewhere the system time is used if it is 32 bits wide, otherwise the millisecond timer.
+void profiler_clock_init(void) {}
+
+uint32_t profiler_clock_read(void) {
+#if PORT_SUPPORTS_RT
+    return chSysGetRealtimeCounterX();
+#elif CH_CFG_ST_RESOLUTION >= 32
+    return chVTGetSystemTimeX();
+#else
+    return timer_read32();
+#endif
+}
+
+uint32_t profiler_clock_rate(void) {
+#if PORT_SUPPORTS_RT
+    return 0;
+#elif CH_CFG_ST_RESOLUTION >= 32
+    return CH_CFG_ST_FREQUENCY / 1000;
+#else
+    return 1;
+#endif
+}
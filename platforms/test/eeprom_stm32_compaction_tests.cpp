@@ -0,0 +1,244 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "flash_stm32.h"
+#include "eeprom_stm32.h"
+#include "eeprom_driver.h"
+}
+
+/* Mock Flash Parameters:
+ *
+ * flash size: 2048
+ * page size: 256
+ * density pages: 4, two banks of two pages
+ * Simulated EEPROM size: 256
+ *
+ * FlashBuf Layout:
+ * [Unused | Bank 0                          | Bank 1                          ]
+ * [       | Compact | Write Log  | Header | Compact | Write Log  | Header ]
+ * [0......|1024.....|1280...1531|1532....|1536.....|1792...2043|2044....2047]
+ *
+ */
+
+#define BANK_SIZE (FEE_PAGE_SIZE * FEE_PAGE_COUNT / 2)
+#define EEPROM_SIZE (BANK_SIZE / 2)
+#define LOG_SIZE (BANK_SIZE - EEPROM_SIZE - 4)
+#define BANK_BASE(bank) (MOCK_FLASH_SIZE - (2 - (bank)) * BANK_SIZE)
+#define HEADER(bank) (*(uint16_t*)&FlashBuf[BANK_BASE(bank) + BANK_SIZE - 4])
+
+/* Simple xorshift, so that every run sees the same writes */
+static uint32_t rng_state;
+static uint32_t rng(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+class EepromStm32CompactionTest : public testing::Test {
+   protected:
+    std::vector<uint8_t> model;
+
+    void SetUp() override {
+        FlashPowerCutAfter = -1;
+        FlashPowerLost     = false;
+        EEPROM_Erase();
+        model.assign(EEPROM_SIZE, 0);
+        rng_state = 0x12345678;
+    }
+
+    /* Changes one byte below 0x80 or one aligned word above, each of which takes a single log entry */
+    void random_write(void) {
+        uint32_t r = rng();
+        if (r & 1) {
+            uint16_t address = (r >> 8) % 0x80;
+            uint8_t  value   = r >> 16;
+            EEPROM_WriteDataByte(address, value);
+            model[address] = value;
+        } else {
+            uint16_t address = 0x80 + ((r >> 8) % ((EEPROM_SIZE - 0x80) / 2)) * 2;
+            /* Plenty of 0 and 1, they have their own log encoding */
+            uint16_t value = (r >> 16) % 4 == 0 ? (r >> 20) % 2 : r >> 16;
+            EEPROM_WriteDataWord(address, value);
+            model[address]     = value;
+            model[address + 1] = value >> 8;
+        }
+    }
+
+    std::vector<uint8_t> contents(void) {
+        std::vector<uint8_t> data(EEPROM_SIZE);
+        for (uint16_t i = 0; i < EEPROM_SIZE; i++) {
+            data[i] = EEPROM_ReadDataByte(i);
+        }
+        return data;
+    }
+
+    uint32_t flash_operations(void) { return FlashEraseCount + FlashProgramCount; }
+
+    /* Fills the write log with entries for one word */
+    void fill_log(uint16_t bytes) {
+        for (uint16_t i = 0; i < bytes / 4; i++) {
+            EEPROM_WriteDataWord(0xF0, 0x1000 + i);
+            model[0xF0] = 0x1000 + i;
+            model[0xF1] = (0x1000 + i) >> 8;
+        }
+    }
+};
+
+TEST_F(EepromStm32CompactionTest, TestStartsInFirstBank) {
+    EXPECT_EQ(HEADER(0), 1);
+    EXPECT_EQ(*(&HEADER(0) + 1), (uint16_t)~1);
+    EXPECT_EQ(HEADER(1), 0xFFFF);
+}
+
+TEST_F(EepromStm32CompactionTest, TestCompactsInSteps) {
+    EEPROM_WriteDataWord(0xF0, 0xFFFF);
+    /* Half the log starts compaction, but it doesn't run from the writes */
+    FlashEraseCount = 0;
+    fill_log(LOG_SIZE / 2 + 4);
+    EXPECT_EQ(FlashEraseCount, 0u);
+    EXPECT_EQ(HEADER(1), 0xFFFF);
+
+    int steps = 0;
+    while (HEADER(1) == 0xFFFF && steps < 100) {
+        uint32_t erases   = FlashEraseCount;
+        uint32_t programs = FlashProgramCount;
+        eeprom_driver_task();
+        EXPECT_LE(FlashEraseCount - erases, 1u);
+        EXPECT_LE(FlashProgramCount - programs, (uint32_t)FEE_COMPACTION_STEP_WORDS);
+        EXPECT_FALSE(FlashEraseCount - erases && FlashProgramCount - programs);
+        EXPECT_EQ(contents(), model);
+        steps++;
+    }
+    /* Erase each page, copy every word, then write the header */
+    EXPECT_EQ(steps, FEE_PAGE_COUNT / 2 + EEPROM_SIZE / 2 / FEE_COMPACTION_STEP_WORDS + 1);
+    EXPECT_EQ(HEADER(1), 2);
+    /* The new bank holds everything, with an empty log */
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[BANK_BASE(1) + 0xF0], (uint16_t)~(model[0xF0] | model[0xF1] << 8));
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[BANK_BASE(1) + EEPROM_SIZE], 0xFFFF);
+    /* Nothing left to do */
+    uint32_t operations = flash_operations();
+    eeprom_driver_task();
+    EXPECT_EQ(flash_operations(), operations);
+
+    EEPROM_Init();
+    EXPECT_EQ(contents(), model);
+}
+
+TEST_F(EepromStm32CompactionTest, TestWritesDuringCompaction) {
+    uint16_t sequence = HEADER(0);
+    for (int i = 0; i < 3000; i++) {
+        if (rng() % 3) {
+            random_write();
+        } else {
+            eeprom_driver_task();
+        }
+        ASSERT_EQ(contents(), model) << "after " << i;
+        if (i % 100 == 99) {
+            EEPROM_Init();
+            ASSERT_EQ(contents(), model) << "after reloading at " << i;
+        }
+    }
+    /* Banks took turns a few times */
+    uint16_t latest = std::max(HEADER(0) == 0xFFFF ? 0 : HEADER(0), HEADER(1) == 0xFFFF ? 0 : HEADER(1));
+    EXPECT_GE(latest - sequence, 5);
+}
+
+TEST_F(EepromStm32CompactionTest, TestFullLogCompactsAtOnce) {
+    EEPROM_WriteDataWord(0xF0, 0xFFFF);
+    EEPROM_WriteDataByte(0x10, 0x42);
+    model[0x10] = 0x42;
+    fill_log(LOG_SIZE);
+    EXPECT_EQ(HEADER(1), 0xFFFF);
+    /* Without the task, the write that doesn't fit compacts into the other bank on the spot */
+    FlashEraseCount = 0;
+    EEPROM_WriteDataWord(0xF0, 0x0102);
+    model[0xF0] = 0x02;
+    model[0xF1] = 0x01;
+    EXPECT_EQ(FlashEraseCount, (uint32_t)FEE_PAGE_COUNT / 2);
+    EXPECT_EQ(HEADER(1), 2);
+    EXPECT_EQ(HEADER(0), 1);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[BANK_BASE(1) + EEPROM_SIZE], 0xFFFF);
+    EEPROM_Init();
+    EXPECT_EQ(contents(), model);
+}
+
+TEST_F(EepromStm32CompactionTest, TestPowerCutAtEveryStep) {
+    /* Start with some contents, and a log that is nearly half full */
+    for (int i = 0; i < 40; i++) {
+        random_write();
+    }
+    uint8_t baseline[MOCK_FLASH_SIZE];
+    memcpy(baseline, FlashBuf, sizeof(baseline));
+    std::vector<uint8_t> baseline_model = model;
+
+    /* Writes, with the task running between some of them, and sometimes not for long enough */
+    auto workload = [&](std::vector<std::vector<uint8_t>>* snapshots, std::vector<uint32_t>* done) {
+        rng_state = 0xcafef00d;
+        for (int i = 0; i < 400; i++) {
+            random_write();
+            if (snapshots) snapshots->push_back(model);
+            if (done) done->push_back(flash_operations());
+            if ((i / 80) % 2 == 0) {
+                eeprom_driver_task();
+            }
+        }
+    };
+
+    std::vector<std::vector<uint8_t>> snapshots = {model};
+    std::vector<uint32_t>             done;
+    FlashEraseCount   = 0;
+    FlashProgramCount = 0;
+    workload(&snapshots, &done);
+    uint32_t total = flash_operations();
+    RecordProperty("FlashOperations", total);
+    EXPECT_GT(FlashEraseCount, (uint32_t)FEE_PAGE_COUNT);
+
+    for (uint32_t cut = 0; cut <= total; cut++) {
+        memcpy(FlashBuf, baseline, sizeof(baseline));
+        model = baseline_model;
+        EEPROM_Init();
+
+        FlashPowerCutAfter = cut;
+        FlashEraseCount    = 0;
+        FlashProgramCount  = 0;
+        workload(nullptr, nullptr);
+
+        /* Power comes back */
+        FlashPowerCutAfter = -1;
+        FlashPowerLost     = false;
+        EEPROM_Init();
+
+        /* Every write that finished is there, the one that was cut may or may not be */
+        size_t finished = 0;
+        while (finished < done.size() && done[finished] <= cut) {
+            finished++;
+        }
+        std::vector<uint8_t> data = contents();
+        bool                 ok   = data == snapshots[finished] || (finished + 1 < snapshots.size() && data == snapshots[finished + 1]);
+        ASSERT_TRUE(ok) << "power cut after " << cut << " of " << total << " flash operations, " << finished << " writes finished";
+
+        /* And it keeps working from there */
+        EEPROM_WriteDataByte(0x7F, cut);
+        EEPROM_Init();
+        ASSERT_EQ(EEPROM_ReadDataByte(0x7F), (uint8_t)cut) << "power cut after " << cut;
+    }
+}
@@ -19,7 +19,8 @@
 extern "C" {
 #include "flash_stm32.h"
 #include "eeprom_stm32.h"
-#include "eeprom.h"
+#include "eeprom_driver.h"
+void advance_time(uint32_t ms);
 }
 
 /* Mock Flash Parameters:
@@ -131,6 +132,7 @@ TEST_F(EepromStm32Test, TestReadByte) {
     EXPECT_EQ(EEPROM_ReadDataByte(EEPROM_SIZE - 1), 0x9a);
 }
 
+#ifndef FEE_WRITE_BACK /* Checks what each write leaves in flash right away */
 TEST_F(EepromStm32Test, TestWriteByte) {
     /* Direct compacted-area baseline: Address < 0x80 */
     EEPROM_WriteDataByte(2, 0xef);
@@ -148,6 +150,7 @@ TEST_F(EepromStm32Test, TestWriteByte) {
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 2], WORD_NEXT(EEPROM_SIZE - 1));
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 4], (uint16_t)~0x5678);
 }
+#endif
 
 TEST_F(EepromStm32Test, TestByteRoundTrip) {
     /* Direct compacted-area: Address < 0x80 */
@@ -207,6 +210,7 @@ TEST_F(EepromStm32Test, TestReadWord) {
     EXPECT_EQ(EEPROM_ReadDataWord(EEPROM_SIZE - 2), 0x9abc);
 }
 
+#ifndef FEE_WRITE_BACK /* Checks what each write leaves in flash right away */
 TEST_F(EepromStm32Test, TestWriteWord) {
     /* Direct compacted-area: Address < 0x80 */
     EEPROM_WriteDataWord(0, 0xdead);  // Aligned
@@ -249,6 +253,7 @@ TEST_F(EepromStm32Test, TestWriteWord) {
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 16], WORD_NEXT(204));
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 18], (uint16_t)~0x00cd);
 }
+#endif
 
 TEST_F(EepromStm32Test, TestWordRoundTrip) {
     /* Direct compacted-area: Address < 0x80 */
@@ -286,6 +291,7 @@ TEST_F(EepromStm32Test, TestWordRoundTrip) {
     EXPECT_EQ(EEPROM_ReadDataWord(EEPROM_SIZE - 2), 1);
 }
 
+#ifndef FEE_WRITE_BACK /* Checks what each write leaves in flash right away */
 TEST_F(EepromStm32Test, TestByteWordBoundary) {
     /* Direct compacted-area write */
     EEPROM_WriteDataWord(0x7e, 0xdead);
@@ -324,6 +330,7 @@ TEST_F(EepromStm32Test, TestByteWordBoundary) {
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 16], WORD_NEXT(0x80));
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + 18], (uint16_t)~0xf00d);
 }
+#endif
 
 TEST_F(EepromStm32Test, TestDWordRoundTrip) {
     /* Direct compacted-area: Address < 0x80 */
@@ -408,6 +415,7 @@ TEST_F(EepromStm32Test, TestCompaction) {
     eeprom_write_word((uint16_t*)6, 0xd00d);
     eeprom_write_dword((uint32_t*)150, 0xcafef00d);
     eeprom_write_dword((uint32_t*)200, 0x12345678);
+    EEPROM_Flush();
     /* Fill write log entries */
     uint32_t i;
     uint32_t val = 0xd8453c6b;
@@ -415,6 +423,7 @@ TEST_F(EepromStm32Test, TestCompaction) {
         val ^= 0x593ca5b3;
         val += i;
         eeprom_write_dword((uint32_t*)200, val);
+        EEPROM_Flush();
     }
     /* Check values pre-compaction */
     EEPROM_Init();
@@ -436,3 +445,132 @@ TEST_F(EepromStm32Test, TestCompaction) {
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE], 0xFFFF);
     EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + LOG_SIZE - 2], 0xFFFF);
 }
+
+TEST_F(EepromStm32Test, TestBlockWriteIsOneBatch) {
+    uint16_t block[4] = {0x1111, 0x2222, 0x3333, 0x4444};
+    /* Direct writes */
+    eeprom_write_block(block, (void*)0x90, sizeof(block));
+    eeprom_write_word((uint16_t*)200, 0x1234);
+    EEPROM_Flush();
+    /* Fill the write log up to its last 8 bytes */
+    for (uint16_t i = 0; i < (LOG_SIZE - 8) / 4; i++) {
+        eeprom_write_word((uint16_t*)200, 0x2000 + i);
+        EEPROM_Flush();
+    }
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + LOG_SIZE - 10], (uint16_t)~(0x2000 + (LOG_SIZE - 8) / 4 - 1));
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE + LOG_SIZE - 8], 0xFFFF);
+    /* Four word entries don't fit, so the whole block goes into one compaction */
+    uint32_t erases = FlashEraseCount;
+    block[0]        = 0x5555;
+    block[1]        = 0x6666;
+    block[2]        = 0x7777;
+    block[3]        = 0x8888;
+    eeprom_write_block(block, (void*)0x90, sizeof(block));
+    EEPROM_Flush();
+    EXPECT_EQ(FlashEraseCount - erases, (uint32_t)FEE_PAGE_COUNT);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE], 0xFFFF);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[EEPROM_BASE + 0x90], (uint16_t)~0x5555);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[EEPROM_BASE + 0x96], (uint16_t)~0x8888);
+    /* Check values */
+    EEPROM_Init();
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)0x90), 0x66665555);
+    EXPECT_EQ(eeprom_read_dword((uint32_t*)0x94), 0x88887777);
+    EXPECT_EQ(eeprom_read_word((uint16_t*)200), 0x2000 + (LOG_SIZE - 8) / 4 - 1);
+}
+
+TEST_F(EepromStm32Test, TestStepWorkload) {
+    /* Bursts of hue and brightness steps, like holding down a lighting key, with a pause after each */
+    const int bursts = 8;
+    const int steps  = 40;
+    uint8_t   hue    = 0;
+    uint8_t   val    = 0;
+    FlashEraseCount   = 0;
+    FlashProgramCount = 0;
+    for (int burst = 0; burst < bursts; burst++) {
+        for (int step = 0; step < steps; step++) {
+            if (burst % 2) {
+                val += 17;
+                eeprom_update_byte((uint8_t*)0x21, val);
+            } else {
+                hue += 8;
+                eeprom_update_byte((uint8_t*)0x20, hue);
+            }
+            /* Key repeat */
+            advance_time(30);
+            eeprom_driver_task();
+        }
+        advance_time(1000);
+        eeprom_driver_task();
+    }
+    RecordProperty("FlashProgramCount", FlashProgramCount);
+    RecordProperty("FlashEraseCount", FlashEraseCount);
+#ifdef FEE_WRITE_BACK
+    /* Every burst is written out once, as a single byte entry */
+    EXPECT_EQ(FlashProgramCount, (uint32_t)bursts);
+    EXPECT_EQ(FlashEraseCount, 0u);
+#else
+    /* Every step costs a log entry */
+    EXPECT_GE(FlashProgramCount, (uint32_t)(bursts * steps));
+    EXPECT_EQ(FlashEraseCount, (uint32_t)(FEE_PAGE_COUNT * ((bursts * steps - 1) / (LOG_SIZE / 2))));
+#endif
+    /* Check values */
+    EEPROM_Init();
+    EXPECT_EQ(eeprom_read_byte((uint8_t*)0x20), hue);
+    EXPECT_EQ(eeprom_read_byte((uint8_t*)0x21), val);
+}
+
+#ifdef FEE_WRITE_BACK
+TEST_F(EepromStm32Test, TestWriteBackWaitsForIdle) {
+    FlashProgramCount = 0;
+    eeprom_write_byte((uint8_t*)5, 0x42);
+    eeprom_write_word((uint16_t*)200, 0xbeef);
+    EXPECT_EQ(eeprom_read_byte((uint8_t*)5), 0x42);
+    EXPECT_EQ(eeprom_read_word((uint16_t*)200), 0xbeef);
+    advance_time(FEE_WRITE_BACK_DELAY - 1);
+    eeprom_driver_task();
+    EXPECT_EQ(FlashProgramCount, 0u);
+    /* Another write starts the wait over */
+    eeprom_write_byte((uint8_t*)5, 0x43);
+    advance_time(FEE_WRITE_BACK_DELAY - 1);
+    eeprom_driver_task();
+    EXPECT_EQ(FlashProgramCount, 0u);
+    advance_time(1);
+    eeprom_driver_task();
+    EXPECT_EQ(FlashProgramCount, 2u);
+    EXPECT_EQ(FlashBuf[EEPROM_BASE + 5], (uint8_t)~0x43);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[EEPROM_BASE + 200], (uint16_t)~0xbeef);
+}
+
+TEST_F(EepromStm32Test, TestWriteBackSkipsRestoredValue) {
+    eeprom_write_word((uint16_t*)200, 0xbeef);
+    eeprom_flush();
+    FlashProgramCount = 0;
+    eeprom_write_word((uint16_t*)200, 0xf00d);
+    eeprom_write_word((uint16_t*)200, 0xbeef);
+    eeprom_flush();
+    EXPECT_EQ(FlashProgramCount, 0u);
+    EXPECT_EQ(*(uint16_t*)&FlashBuf[LOG_BASE], 0xFFFF);
+}
+
+TEST_F(EepromStm32Test, TestWriteBackFullBatchIsWritten) {
+    FlashProgramCount = 0;
+    for (int i = 0; i < FEE_WRITE_BATCH_WORDS; i++) {
+        eeprom_write_word((uint16_t*)(uintptr_t)(0x80 + i * 2), 0x100 + i);
+    }
+    EXPECT_EQ(FlashProgramCount, 0u);
+    /* No room to hold another word */
+    eeprom_write_word((uint16_t*)(uintptr_t)(0x80 + FEE_WRITE_BATCH_WORDS * 2), 0x100);
+    EXPECT_EQ(FlashProgramCount, (uint32_t)FEE_WRITE_BATCH_WORDS);
+    eeprom_flush();
+    EXPECT_EQ(FlashProgramCount, (uint32_t)FEE_WRITE_BATCH_WORDS + 1);
+}
+
+TEST_F(EepromStm32Test, TestWriteBackEraseDropsPendingWrites) {
+    eeprom_write_byte((uint8_t*)5, 0x42);
+    EEPROM_Erase();
+    FlashProgramCount = 0;
+    eeprom_flush();
+    EXPECT_EQ(FlashProgramCount, 0u);
+    EXPECT_EQ(eeprom_read_byte((uint8_t*)5), 0);
+}
+#endif
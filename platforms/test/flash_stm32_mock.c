@@ -18,16 +18,35 @@
 #include <stdbool.h>
 #include "flash_stm32.h"
 
-uint8_t FlashBuf[MOCK_FLASH_SIZE] = {0};
+uint8_t  FlashBuf[MOCK_FLASH_SIZE] = {0};
+uint32_t FlashEraseCount           = 0;
+uint32_t FlashProgramCount         = 0;
+int32_t  FlashPowerCutAfter        = -1;
+bool     FlashPowerLost            = false;
 
 static bool flash_locked = true;
 
+/* Counts down to the power cut, returns true for the operation it interrupts */
+static bool flash_power_cut(void) {
+    if (FlashPowerCutAfter < 0) return false;
+    if (FlashPowerCutAfter-- > 0) return false;
+    FlashPowerLost = true;
+    return true;
+}
+
 FLASH_Status FLASH_ErasePage(uint32_t Page_Address) {
     if (flash_locked) return FLASH_ERROR_WRP;
     Page_Address -= (uintptr_t)FlashBuf;
     Page_Address -= (Page_Address % FEE_PAGE_SIZE);
     if (Page_Address >= MOCK_FLASH_SIZE) return FLASH_BAD_ADDRESS;
+    if (FlashPowerLost) return FLASH_TIMEOUT;
+    if (flash_power_cut()) {
+        /* Only part of the page gets erased */
+        memset(&FlashBuf[Page_Address], '\xff', FEE_PAGE_SIZE / 2);
+        return FLASH_TIMEOUT;
+    }
     memset(&FlashBuf[Page_Address], '\xff', FEE_PAGE_SIZE);
+    FlashEraseCount++;
     return FLASH_COMPLETE;
 }
 
@@ -35,9 +54,11 @@ FLASH_Status FLASH_ProgramHalfWord(uint32_t Address, uint16_t Data) {
     if (flash_locked) return FLASH_ERROR_WRP;
     Address -= (uintptr_t)FlashBuf;
     if (Address >= MOCK_FLASH_SIZE) return FLASH_BAD_ADDRESS;
+    if (FlashPowerLost || flash_power_cut()) return FLASH_TIMEOUT;
     uint16_t oldData = *(uint16_t*)&FlashBuf[Address];
     if (oldData == 0xFFFF || Data == 0) {
         *(uint16_t*)&FlashBuf[Address] = Data;
+        FlashProgramCount++;
         return FLASH_COMPLETE;
     } else {
         return FLASH_ERROR_PG;
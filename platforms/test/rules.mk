@@ -9,16 +9,38 @@ eeprom_stm32_large_DEFS := $(eeprom_stm32_DEFS) \
 	-DMOCK_FLASH_SIZE=65536 \
 	-DFEE_PAGE_SIZE=2048 \
 	-DFEE_PAGE_COUNT=16
+eeprom_stm32_write_back_DEFS := $(eeprom_stm32_tiny_DEFS) \
+	-DFEE_WRITE_BACK \
+	-DFEE_WRITE_BACK_DELAY=100 \
+	-DFEE_WRITE_BATCH_WORDS=8
+eeprom_stm32_compaction_DEFS := $(eeprom_stm32_DEFS) \
+	-DFEE_MCU_FLASH_SIZE=2 \
+	-DMOCK_FLASH_SIZE=2048 \
+	-DFEE_PAGE_SIZE=256 \
+	-DFEE_PAGE_COUNT=4 \
+	-DFEE_BACKGROUND_COMPACTION \
+	-DFEE_COMPACTION_STEP_WORDS=16
 
 eeprom_stm32_INC := \
-	$(PLATFORM_PATH)/chibios/
+	$(PLATFORM_PATH)/chibios/ \
+	$(TOP_DIR)/drivers/eeprom/
 eeprom_stm32_tiny_INC := $(eeprom_stm32_INC)
 eeprom_stm32_large_INC := $(eeprom_stm32_INC)
+eeprom_stm32_write_back_INC := $(eeprom_stm32_INC)
+eeprom_stm32_compaction_INC := $(eeprom_stm32_INC)
 
 eeprom_stm32_SRC := \
 	$(TOP_DIR)/drivers/eeprom/eeprom_driver.c \
 	$(PLATFORM_PATH)/$(PLATFORM_KEY)/eeprom_stm32_tests.cpp \
 	$(PLATFORM_PATH)/$(PLATFORM_KEY)/flash_stm32_mock.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
 	$(PLATFORM_PATH)/chibios/eeprom_stm32.c
 eeprom_stm32_tiny_SRC := $(eeprom_stm32_SRC)
 eeprom_stm32_large_SRC := $(eeprom_stm32_SRC)
+eeprom_stm32_write_back_SRC := $(eeprom_stm32_SRC)
+eeprom_stm32_compaction_SRC := \
+	$(TOP_DIR)/drivers/eeprom/eeprom_driver.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/eeprom_stm32_compaction_tests.cpp \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/flash_stm32_mock.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(PLATFORM_PATH)/chibios/eeprom_stm32.c
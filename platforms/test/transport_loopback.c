@@ -0,0 +1,185 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "transactions.h"
+#include "transport_loopback.h"
+
+static split_shared_memory_t shared_memory;
+split_shared_memory_t *const split_shmem = &shared_memory;
+
+// Whichever half is not running right now
+static split_shared_memory_t other_half;
+
+static transport_loopback_fault_t fault       = LOOPBACK_OK;
+static uint16_t                   fault_after = 0;
+
+transport_loopback_stats_t transport_loopback_stats;
+
+#ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+#    define PUSH_QUEUE_SIZE 8
+
+typedef struct {
+    uint8_t                    data[sizeof(split_slave_push_t)];
+    uint8_t                    length;
+    transport_loopback_fault_t fault;
+} pending_push_t;
+
+static bool           push_allowed = true;
+static bool           push_held    = false;
+static pending_push_t push_queue[PUSH_QUEUE_SIZE];
+static uint8_t        push_queued = 0;
+#endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+
+static void swap_halves(void) {
+    split_shared_memory_t temp;
+    memcpy(&temp, &shared_memory, sizeof(temp));
+    memcpy(&shared_memory, &other_half, sizeof(shared_memory));
+    memcpy(&other_half, &temp, sizeof(other_half));
+}
+
+static transport_loopback_fault_t next_fault(void) {
+    transport_loopback_fault_t this_fault = LOOPBACK_OK;
+    if (fault_after > 0) {
+        fault_after--;
+    } else {
+        this_fault = fault;
+        fault      = LOOPBACK_OK;
+    }
+    return this_fault;
+}
+
+void transport_loopback_reset(void) {
+    memset(&transport_loopback_stats, 0, sizeof(transport_loopback_stats));
+    fault       = LOOPBACK_OK;
+    fault_after = 0;
+#ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+    push_allowed = true;
+    push_held    = false;
+    push_queued  = 0;
+#endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+}
+
+void transport_loopback_inject(transport_loopback_fault_t next, uint16_t after) {
+    fault       = next;
+    fault_after = after;
+}
+
+void transport_loopback_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    swap_halves();
+    transport_slave(master_matrix, slave_matrix);
+    swap_halves();
+}
+
+const split_shared_memory_t *transport_loopback_slave_shmem(void) { return &other_half; }
+
+void transport_master_init(void) {}
+void transport_slave_init(void) {}
+
+bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    split_transaction_desc_t * trans      = &split_transaction_table[id];
+    uint16_t                   i2t_len    = trans->initiator2target_buffer_size < initiator2target_length ? trans->initiator2target_buffer_size : initiator2target_length;
+    uint16_t                   t2i_len    = trans->target2initiator_buffer_size < target2initiator_length ? trans->target2initiator_buffer_size : target2initiator_length;
+    transport_loopback_fault_t this_fault = next_fault();
+
+    transport_loopback_stats.round_trips++;
+    transport_loopback_stats.initiator2target_bytes += i2t_len;
+    transport_loopback_stats.target2initiator_bytes += t2i_len;
+
+    if (i2t_len > 0) {
+        memcpy(split_trans_initiator2target_buffer(trans), initiator2target_buf, i2t_len);
+    }
+    if (this_fault == LOOPBACK_LOSE_REQUEST) {
+        return false;
+    }
+
+    if (this_fault != LOOPBACK_STALE_REPLY) {
+        swap_halves();
+        if (i2t_len > 0) {
+            memcpy(split_trans_initiator2target_buffer(trans), ((uint8_t *)&other_half) + trans->initiator2target_offset, i2t_len);
+            if (this_fault == LOOPBACK_CORRUPT_REQUEST) {
+                split_trans_initiator2target_buffer(trans)[i2t_len / 2] ^= 0x10;
+            }
+        }
+        if (trans->slave_callback) {
+            trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), trans->target2initiator_buffer_size, split_trans_target2initiator_buffer(trans));
+        }
+        swap_halves();
+    }
+
+    if (this_fault == LOOPBACK_LOSE_REPLY) {
+        return false;
+    }
+    if (t2i_len > 0) {
+        memcpy(split_trans_target2initiator_buffer(trans), ((uint8_t *)&other_half) + trans->target2initiator_offset, t2i_len);
+        if (this_fault == LOOPBACK_CORRUPT_REPLY) {
+            split_trans_target2initiator_buffer(trans)[t2i_len / 2] ^= 0x10;
+        }
+        memcpy(target2initiator_buf, split_trans_target2initiator_buffer(trans), t2i_len);
+    }
+    return true;
+}
+
+#ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+static void deliver_push(split_shared_memory_t *to, const uint8_t *data, uint8_t length, transport_loopback_fault_t this_fault) {
+    if (this_fault == LOOPBACK_LOSE_REQUEST || this_fault == LOOPBACK_LOSE_REPLY || this_fault == LOOPBACK_STALE_REPLY) {
+        return;
+    }
+    memcpy(&to->spush, data, length);
+    if (this_fault == LOOPBACK_CORRUPT_REQUEST || this_fault == LOOPBACK_CORRUPT_REPLY) {
+        ((uint8_t *)&to->spush)[length / 2] ^= 0x10;
+    }
+}
+
+bool transport_slave_push(uint8_t length) {
+    if (!push_allowed) {
+        return false;
+    }
+    transport_loopback_fault_t this_fault = next_fault();
+
+    transport_loopback_stats.pushes++;
+    transport_loopback_stats.target2initiator_bytes += length;
+
+    if (!push_held) {
+        deliver_push(&other_half, (const uint8_t *)&split_shmem->spush, length, this_fault);
+    } else if (push_queued < PUSH_QUEUE_SIZE) {
+        pending_push_t *pending = &push_queue[push_queued++];
+        memcpy(pending->data, &split_shmem->spush, length);
+        pending->length = length;
+        pending->fault  = this_fault;
+    }
+    // A full queue drops the push, like a transport that is still busy with earlier ones
+    return true;
+}
+
+void transport_loopback_allow_push(bool allow) { push_allowed = allow; }
+
+void transport_loopback_hold_pushes(bool hold) { push_held = hold; }
+
+bool transport_loopback_deliver_push(void) {
+    if (push_queued == 0) {
+        return false;
+    }
+    deliver_push(split_shmem, push_queue[0].data, push_queue[0].length, push_queue[0].fault);
+    memmove(&push_queue[0], &push_queue[1], --push_queued * sizeof(push_queue[0]));
+    return true;
+}
+#endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+
+bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) { return transactions_master(master_matrix, slave_matrix); }
+
+void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) { transactions_slave(master_matrix, slave_matrix); }
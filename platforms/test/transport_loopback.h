@@ -0,0 +1,69 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "transport.h"
+
+/*
+ * Split transport with both halves in the same process. Each half has its own copy of the
+ * shared memory, split_shmem always holds the half that is currently running. Transactions
+ * move the same number of bytes an I2C transport would and run the slave callback in between.
+ */
+
+typedef enum {
+    LOOPBACK_OK,
+    LOOPBACK_LOSE_REQUEST,     // the slave never sees the transaction
+    LOOPBACK_LOSE_REPLY,       // the slave runs the transaction but the master gets an error
+    LOOPBACK_CORRUPT_REQUEST,  // one bit of what the slave receives is flipped
+    LOOPBACK_CORRUPT_REPLY,    // one bit of what the master receives is flipped
+    LOOPBACK_STALE_REPLY,      // the slave never sees the transaction, but the master reads back what its buffer still holds
+} transport_loopback_fault_t;
+
+typedef struct {
+    uint32_t round_trips;
+    uint32_t initiator2target_bytes;
+    uint32_t target2initiator_bytes;
+    uint32_t pushes;  // transfers started by the slave, their bytes count as target to initiator
+} transport_loopback_stats_t;
+
+extern transport_loopback_stats_t transport_loopback_stats;
+
+// Clears the stats, any fault that is still waiting to happen and any push still in flight
+void transport_loopback_reset(void);
+
+// Lets `after` transactions through, then makes the next one fail in the given way
+void transport_loopback_inject(transport_loopback_fault_t fault, uint16_t after);
+
+// Runs the slave's side of a scan against the slave's shared memory
+void transport_loopback_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+
+// The slave's shared memory, as seen from the master
+const split_shared_memory_t *transport_loopback_slave_shmem(void);
+
+#ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+// Whether the slave can push at all, it can unless told otherwise
+void transport_loopback_allow_push(bool allow);
+
+// Keeps pushes in flight until they are delivered one by one, instead of handing them over at once
+void transport_loopback_hold_pushes(bool hold);
+
+// Hands the oldest push in flight to the master, returns false if there was none
+bool transport_loopback_deliver_push(void);
+#endif  // SPLIT_TRANSPORT_EVENTS_PUSH
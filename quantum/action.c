@@ -69,6 +69,8 @@ __attribute__((weak)) bool pre_process_record_quantum(keyrecord_t *record) { ret
  */
 void action_exec(keyevent_t event) {
     if (!IS_NOEVENT(event)) {
+        // new input may start timers in any of the scheduled tasks
+        task_schedule_wake();
         dprint("\n---- action_exec: start -----\n");
         dprint("EVENT: ");
         debug_event(event);
@@ -1067,6 +1069,10 @@ bool is_tap_key(keypos_t key) {
  * FIXME: Needs documentation.
  */
 bool is_tap_record(keyrecord_t *record) {
+    if (IS_NOEVENT(record->event)) {
+        return false;
+    }
+
 #ifdef COMBO_ENABLE
     action_t action;
     if (record->keycode) {
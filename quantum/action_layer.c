@@ -1,4 +1,5 @@
 #include <stdint.h>
+#include <string.h>
 #include "keyboard.h"
 #include "action.h"
 #include "util.h"
@@ -246,16 +247,15 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
 #endif
 }
 
-/** \brief Layer switch get layer
+#ifndef NO_ACTION_LAYER
+/** \brief Find layer
  *
- * Gets the layer based on key info
+ * Walks the given layers from the top down to the first one where key isn't transparent
  */
-uint8_t layer_switch_get_layer(keypos_t key) {
-#ifndef NO_ACTION_LAYER
+static uint8_t layer_switch_find_layer(keypos_t key, layer_state_t layers) {
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
-    layer_state_t layers = layer_state | default_layer_state;
     /* check top layer first */
     for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
         if (layers & ((layer_state_t)1 << i)) {
@@ -267,6 +267,73 @@ uint8_t layer_switch_get_layer(keypos_t key) {
     }
     /* fall back to layer 0 */
     return 0;
+}
+#endif
+
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_CACHE_SIZE)
+/** \brief resolved layer cache
+ *
+ * The layer each of the first LAYER_CACHE_SIZE keys resolves to with the layers in
+ * layer_cache_state, or LAYER_CACHE_INVALID if it has to be looked up again.
+ */
+#    define LAYER_CACHE_INVALID 0xFF
+
+static uint8_t       layer_cache[LAYER_CACHE_SIZE];
+static layer_state_t layer_cache_state;
+static bool          layer_cache_ready = false;
+
+/** \brief invalidate layer cache
+ *
+ * Forgets every resolved layer, needed when the keymap itself changes
+ */
+void layer_cache_invalidate(void) { layer_cache_ready = false; }
+
+/** \brief update layer cache
+ *
+ * Brings the cache up to date with the active layers. Only the keys whose
+ * resolved layer went away, or that got a new layer above it, are dropped.
+ */
+static void layer_cache_update(layer_state_t layers) {
+    if (!layer_cache_ready) {
+        memset(layer_cache, LAYER_CACHE_INVALID, sizeof(layer_cache));
+        layer_cache_ready = true;
+    } else {
+        const layer_state_t removed = layer_cache_state & ~layers;
+        const layer_state_t added   = layers & ~layer_cache_state;
+
+        for (uint16_t i = 0; i < LAYER_CACHE_SIZE; i++) {
+            const uint8_t layer = layer_cache[i];
+            if (layer != LAYER_CACHE_INVALID && (((removed >> layer) & 1) || ((added >> layer) >> 1))) {
+                layer_cache[i] = LAYER_CACHE_INVALID;
+            }
+        }
+    }
+    layer_cache_state = layers;
+}
+#endif
+
+/** \brief Layer switch get layer
+ *
+ * Gets the layer based on key info
+ */
+uint8_t layer_switch_get_layer(keypos_t key) {
+#ifndef NO_ACTION_LAYER
+    layer_state_t layers = layer_state | default_layer_state;
+#    ifdef LAYER_CACHE_SIZE
+    const uint16_t key_number = key.col + (key.row * MATRIX_COLS);
+
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS && key_number < LAYER_CACHE_SIZE) {
+        // layer_state is also written directly in a few places, so check it here rather than in layer_state_set()
+        if (!layer_cache_ready || layers != layer_cache_state) {
+            layer_cache_update(layers);
+        }
+        if (layer_cache[key_number] == LAYER_CACHE_INVALID) {
+            layer_cache[key_number] = layer_switch_find_layer(key, layers);
+        }
+        return layer_cache[key_number];
+    }
+#    endif
+    return layer_switch_find_layer(key, layers);
 #else
     return get_highest_layer(default_layer_state);
 #endif
@@ -143,5 +143,17 @@ action_t store_or_get_action(bool pressed, keypos_t key);
 /* return the topmost non-transparent layer currently associated with key */
 uint8_t layer_switch_get_layer(keypos_t key);
 
+/* resolved layer cache */
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_CACHE_SIZE)
+#    if LAYER_CACHE_SIZE < 1 || LAYER_CACHE_SIZE > MATRIX_ROWS * MATRIX_COLS
+#        error LAYER_CACHE_SIZE must be between 1 and the number of keys in the matrix
+#    endif
+
+/* call after changing what keymap_key_to_keycode() returns */
+void layer_cache_invalidate(void);
+#else
+#    define layer_cache_invalidate()
+#endif
+
 /* return action depending on current layer status */
 action_t layer_switch_get_action(keypos_t key);
@@ -59,6 +59,11 @@
  * 'duration' can either be in the beats-per-minute related unit found in
  * musical_notes.h, OR in ms; keyboards create SONGs with the former, while
  * the internal state of the audio system does its calculations with the later - ms
+ *
+ * pitches are tracked as fixed point numbers (audio_pitch_t, in 1/256 Hz), the
+ * float API and SONGs are converted on the way in; so that nothing running in
+ * 'audio_update_state' - which the drivers call from their interrupts - needs
+ * float math, which AVRs can only do in software
  */
 
 #ifndef AUDIO_TONE_STACKSIZE
@@ -81,6 +86,8 @@ uint16_t current_note                 = 0;              // index into the array
 bool     note_resting                 = false;          // if a short pause was introduced between two notes with the same frequency while playing a melody
 uint16_t last_timestamp               = 0;
 
+const musical_note_t *notes_integer;  // or a melody with integer pitches, played instead of notes_pointer when set
+
 #ifdef AUDIO_ENABLE_TONE_MULTIPLEXING
 #    ifndef AUDIO_MAX_SIMULTANEOUS_TONES
 #        define AUDIO_MAX_SIMULTANEOUS_TONES 3
@@ -131,7 +138,7 @@ void audio_init() {
 #endif  // EEPROM settings
 
     for (uint8_t i = 0; i < AUDIO_TONE_STACKSIZE; i++) {
-        tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+        tones[i] = (musical_tone_t){.time_started = 0, .pitch = 0, .duration = 0};
     }
 
     if (!audio_initialized) {
@@ -180,6 +187,34 @@ void audio_off(void) {
 
 bool audio_is_on(void) { return (audio_config.enable != 0); }
 
+/* Converts a float to a fixed point number with 'shift' fractional bits, rounding
+ * to the nearest and dropping the sign. This works on the IEEE 754 bits, without
+ * pulling in float math. */
+static uint32_t float_to_fixed(float value, uint8_t shift) {
+    union {
+        float    f;
+        uint32_t u;
+    } bits = {.f = value};
+
+    uint8_t  exponent = (bits.u >> 23) & 0xFF;
+    uint32_t mantissa = (bits.u & 0x7FFFFF) | 0x800000;
+    int16_t  scale    = (int16_t)exponent - 127 - 23 + shift;
+
+    if (exponent == 0) {
+        return 0;  // zero, or too small to matter
+    }
+    if (scale > 8) {
+        return UINT32_MAX;
+    }
+    if (scale >= 0) {
+        return mantissa << scale;
+    }
+    if (scale < -24) {
+        return 0;
+    }
+    return (mantissa + ((uint32_t)1 << (-scale - 1))) >> -scale;
+}
+
 void audio_stop_all() {
     if (audio_driver_stopped) {
         return;
@@ -195,29 +230,27 @@ void audio_stop_all() {
     melody_current_note_duration = 0;
 
     for (uint8_t i = 0; i < AUDIO_TONE_STACKSIZE; i++) {
-        tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+        tones[i] = (musical_tone_t){.time_started = 0, .pitch = 0, .duration = 0};
     }
 
     audio_driver_stopped = true;
 }
 
-void audio_stop_tone(float pitch) {
-    if (pitch < 0.0f) {
-        pitch = -1 * pitch;
-    }
+void audio_stop_tone(float pitch) { audio_stop_pitch(float_to_fixed(pitch, AUDIO_PITCH_SHIFT)); }
 
+void audio_stop_pitch(audio_pitch_t pitch) {
     if (playing_note) {
         if (!audio_initialized) {
             audio_init();
         }
         bool found = false;
-        for (int i = AUDIO_TONE_STACKSIZE - 1; i >= 0; i--) {
+        for (int i = active_tones - 1; i >= 0; i--) {
             found = (tones[i].pitch == pitch);
             if (found) {
-                tones[i] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+                tones[i] = (musical_tone_t){.time_started = 0, .pitch = 0, .duration = 0};
                 for (int j = i; (j < AUDIO_TONE_STACKSIZE - 1); j++) {
                     tones[j]     = tones[j + 1];
-                    tones[j + 1] = (musical_tone_t){.time_started = 0, .pitch = -1.0f, .duration = 0};
+                    tones[j + 1] = (musical_tone_t){.time_started = 0, .pitch = 0, .duration = 0};
                 }
                 break;
             }
@@ -242,7 +275,9 @@ void audio_stop_tone(float pitch) {
     }
 }
 
-void audio_play_note(float pitch, uint16_t duration) {
+void audio_play_note(float pitch, uint16_t duration) { audio_play_pitch(float_to_fixed(pitch, AUDIO_PITCH_SHIFT), duration); }
+
+void audio_play_pitch(audio_pitch_t pitch, uint16_t duration) {
     if (!audio_config.enable) {
         return;
     }
@@ -251,10 +286,6 @@ void audio_play_note(float pitch, uint16_t duration) {
         audio_init();
     }
 
-    if (pitch < 0.0f) {
-        pitch = -1 * pitch;
-    }
-
     // round-robin: shifting out old tones, keeping only unique ones
     // if the new frequency is already amongst the active tones, shift it to the top of the stack
     bool found = false;
@@ -291,9 +322,17 @@ void audio_play_note(float pitch, uint16_t duration) {
     }
 }
 
-void audio_play_tone(float pitch) { audio_play_note(pitch, 0xffff); }
+void audio_play_tone(float pitch) { audio_play_pitch(float_to_fixed(pitch, AUDIO_PITCH_SHIFT), 0xffff); }
 
-void audio_play_melody(float (*np)[][2], uint16_t n_count, bool n_repeat) {
+/* The note at 'index' of the playing melody, with the floats of a SONG converted */
+static musical_note_t melody_note(uint16_t index) {
+    if (notes_integer) {
+        return notes_integer[index];
+    }
+    return (musical_note_t){.pitch = float_to_fixed((*notes_pointer)[index][0], AUDIO_PITCH_SHIFT), .duration = float_to_fixed((*notes_pointer)[index][1], 0)};
+}
+
+static void melody_start(float (*np)[][2], const musical_note_t *notes, uint16_t n_count, bool n_repeat) {
     if (!audio_config.enable) {
         audio_stop_all();
         return;
@@ -310,6 +349,7 @@ void audio_play_melody(float (*np)[][2], uint16_t n_count, bool n_repeat) {
     note_resting   = false;
 
     notes_pointer = np;
+    notes_integer = notes;
     notes_count   = n_count;
     notes_repeat  = n_repeat;
 
@@ -317,30 +357,31 @@ void audio_play_melody(float (*np)[][2], uint16_t n_count, bool n_repeat) {
 
     // start first note manually, which also starts the audio_driver
     // all following/remaining notes are played by 'audio_update_state'
-    audio_play_note((*notes_pointer)[current_note][0], audio_duration_to_ms((*notes_pointer)[current_note][1]));
+    musical_note_t note = melody_note(current_note);
+    audio_play_pitch(note.pitch, audio_duration_to_ms(note.duration));
     last_timestamp               = timer_read();
-    melody_current_note_duration = audio_duration_to_ms((*notes_pointer)[current_note][1]);
+    melody_current_note_duration = audio_duration_to_ms(note.duration);
 }
 
-float click[2][2];
-void  audio_play_click(uint16_t delay, float pitch, uint16_t duration) {
+void audio_play_melody(float (*np)[][2], uint16_t n_count, bool n_repeat) { melody_start(np, NULL, n_count, n_repeat); }
+
+void audio_play_notes(const musical_note_t *notes, uint16_t n_count, bool n_repeat) { melody_start(NULL, notes, n_count, n_repeat); }
+
+musical_note_t click[2];
+void           audio_play_click(uint16_t delay, float pitch, uint16_t duration) {
     uint16_t duration_tone  = audio_ms_to_duration(duration);
     uint16_t duration_delay = audio_ms_to_duration(delay);
 
-    if (delay <= 0.0f) {
-        click[0][0] = pitch;
-        click[0][1] = duration_tone;
-        click[1][0] = 0.0f;
-        click[1][1] = 0.0f;
-        audio_play_melody(&click, 1, false);
+    if (delay == 0) {
+        click[0] = (musical_note_t){.pitch = float_to_fixed(pitch, AUDIO_PITCH_SHIFT), .duration = duration_tone};
+        click[1] = (musical_note_t){.pitch = 0, .duration = 0};
+        audio_play_notes(click, 1, false);
     } else {
         // first note is a rest/pause
-        click[0][0] = 0.0f;
-        click[0][1] = duration_delay;
+        click[0] = (musical_note_t){.pitch = 0, .duration = duration_delay};
         // second note is the actual click
-        click[1][0] = pitch;
-        click[1][1] = duration_tone;
-        audio_play_melody(&click, 2, false);
+        click[1] = (musical_note_t){.pitch = float_to_fixed(pitch, AUDIO_PITCH_SHIFT), .duration = duration_tone};
+        audio_play_notes(click, 2, false);
     }
 }
 
@@ -350,16 +391,20 @@ bool audio_is_playing_melody(void) { return playing_melody; }
 
 uint8_t audio_get_number_of_active_tones(void) { return active_tones; }
 
-float audio_get_frequency(uint8_t tone_index) {
+float audio_get_frequency(uint8_t tone_index) { return audio_get_pitch(tone_index) / (float)(1 << AUDIO_PITCH_SHIFT); }
+
+audio_pitch_t audio_get_pitch(uint8_t tone_index) {
     if (tone_index >= active_tones) {
-        return 0.0f;
+        return 0;
     }
     return tones[active_tones - tone_index - 1].pitch;
 }
 
-float audio_get_processed_frequency(uint8_t tone_index) {
+float audio_get_processed_frequency(uint8_t tone_index) { return audio_get_processed_pitch(tone_index) / (float)(1 << AUDIO_PITCH_SHIFT); }
+
+audio_pitch_t audio_get_processed_pitch(uint8_t tone_index) {
     if (tone_index >= active_tones) {
-        return 0.0f;
+        return 0;
     }
 
     int8_t index = active_tones - tone_index - 1;
@@ -371,8 +416,8 @@ float audio_get_processed_frequency(uint8_t tone_index) {
         index += active_tones;
 #endif
 
-    if (tones[index].pitch <= 0.0f) {
-        return 0.0f;
+    if (tones[index].pitch == 0) {
+        return 0;
     }
 
     return voice_envelope(tones[index].pitch);
@@ -404,12 +449,12 @@ bool audio_update_state(void) {
                 }
             }
 
-            if (!note_resting && (*notes_pointer)[previous_note][0] == (*notes_pointer)[current_note][0]) {
+            if (!note_resting && melody_note(previous_note).pitch == melody_note(current_note).pitch) {
                 note_resting = true;
 
                 // special handling for successive notes of the same frequency:
                 // insert a short pause to separate them audibly
-                audio_play_note(0.0f, audio_duration_to_ms(2));
+                audio_play_pitch(0, audio_duration_to_ms(2));
                 current_note                 = previous_note;
                 melody_current_note_duration = audio_duration_to_ms(2);
 
@@ -428,13 +473,13 @@ bool audio_update_state(void) {
 
                 // '- delta': Skip forward in the next note's length if we've over shot
                 //            the last, so the overall length of the song is the same
-                uint16_t duration = audio_duration_to_ms((*notes_pointer)[current_note][1]);
+                uint16_t duration = audio_duration_to_ms(melody_note(current_note).duration);
 
                 // Skip forward past any completely missed notes
                 while (delta > duration && current_note < notes_count - 1) {
                     delta -= duration;
                     current_note++;
-                    duration = audio_duration_to_ms((*notes_pointer)[current_note][1]);
+                    duration = audio_duration_to_ms(melody_note(current_note).duration);
                 }
 
                 if (delta < duration) {
@@ -445,7 +490,7 @@ bool audio_update_state(void) {
                     duration = 1;
                 }
 
-                audio_play_note((*notes_pointer)[current_note][0], duration);
+                audio_play_pitch(melody_note(current_note).pitch, duration);
                 melody_current_note_duration = duration;
             }
         }
@@ -467,7 +512,7 @@ bool audio_update_state(void) {
                 && (tones[i].duration != 0)    // 'uninitialized'
             ) {
                 if (timer_elapsed(tones[i].time_started) >= tones[i].duration) {
-                    audio_stop_tone(tones[i].pitch);  // also sets 'state_changed=true'
+                    audio_stop_pitch(tones[i].pitch);  // also sets 'state_changed=true'
                 }
             }
         }
@@ -523,20 +568,6 @@ void audio_decrease_tempo(uint8_t tempo_change) {
         note_tempo -= tempo_change;
 }
 
-// TODO in the int-math version are some bugs; songs sometimes abruptly end - maybe an issue with the timer/system-tick wrapping around?
-uint16_t audio_duration_to_ms(uint16_t duration_bpm) {
-#if defined(__AVR__)
-    // doing int-math saves us some bytes in the overall firmware size, but the intermediate result is less accurate before being cast to/returned as uint
-    return ((uint32_t)duration_bpm * 60 * 1000) / (64 * note_tempo);
-    // NOTE: beware of uint16_t overflows when note_tempo is low and/or the duration is long
-#else
-    return ((float)duration_bpm * 60) / (64 * note_tempo) * 1000;
-#endif
-}
-uint16_t audio_ms_to_duration(uint16_t duration_ms) {
-#if defined(__AVR__)
-    return ((uint32_t)duration_ms * 64 * note_tempo) / 60 / 1000;
-#else
-    return ((float)duration_ms * 64 * note_tempo) / 60 / 1000;
-#endif
-}
+// NOTE: beware of uint16_t overflows when note_tempo is low and/or the duration is long
+uint16_t audio_duration_to_ms(uint16_t duration_bpm) { return ((uint32_t)duration_bpm * 60 * 1000) / (64 * note_tempo); }
+uint16_t audio_ms_to_duration(uint16_t duration_ms) { return ((uint32_t)duration_ms * 64 * note_tempo) / 60 / 1000; }
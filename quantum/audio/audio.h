@@ -54,9 +54,9 @@ typedef union {
  * "A musical tone is characterized by its duration, pitch, intensity (or loudness), and timbre (or quality)"
  */
 typedef struct {
-    uint16_t time_started;  // timestamp the tone/note was started, system time runs with 1ms resolution -> 16bit timer overflows every ~64 seconds, long enough under normal circumstances; but might be too soon for long-duration notes when the note_tempo is set to a very low value
-    float    pitch;         // aka frequency, in Hz
-    uint16_t duration;      // in ms, converted from the musical_notes.h unit which has 64parts to a beat, factoring in the current tempo in beats-per-minute
+    uint16_t      time_started;  // timestamp the tone/note was started, system time runs with 1ms resolution -> 16bit timer overflows every ~64 seconds, long enough under normal circumstances; but might be too soon for long-duration notes when the note_tempo is set to a very low value
+    audio_pitch_t pitch;         // aka frequency, in 1/256 Hz - see AUDIO_PITCH
+    uint16_t      duration;      // in ms, converted from the musical_notes.h unit which has 64parts to a beat, factoring in the current tempo in beats-per-minute
     // float intensity;    // aka volume [0,1] TODO: not used at the moment; pwm drivers can't handle it
     // uint8_t timbre;     // range: [0,100] TODO: this currently kept track of globally, should we do this per tone instead?
 } musical_tone_t;
@@ -100,6 +100,13 @@ bool audio_is_on(void);
  *                     from the musical_notes.h unit to ms
  */
 void audio_play_note(float pitch, uint16_t duration);
+/**
+ * @brief same as audio_play_note, with a fixed point pitch
+ *
+ * @param[in] pitch in 1/256 Hz, use AUDIO_PITCH to convert from Hz
+ * @param[in] duration in milliseconds
+ */
+void audio_play_pitch(audio_pitch_t pitch, uint16_t duration);
 // TODO: audio_play_note(float pitch, uint16_t duration, float intensity, float timbre);
 // audio_play_note_with_instrument ifdef AUDIO_ENABLE_VOICES
 
@@ -129,6 +136,7 @@ void audio_play_tone(float pitch);
  * @param[in] pitch tone/frequency to be stopped
  */
 void audio_stop_tone(float pitch);
+void audio_stop_pitch(audio_pitch_t pitch);
 
 /**
  * @brief play a melody
@@ -142,6 +150,18 @@ void audio_stop_tone(float pitch);
  */
 void audio_play_melody(float (*np)[][2], uint16_t n_count, bool n_repeat);
 
+/**
+ * @brief play a melody with integer pitches
+ *
+ * @details same as audio_play_melody, for an array of musical_note_t which
+ *          can be played without converting the floats of a SONG first
+ *
+ * @param[in] notes the musical_note_t array
+ * @param[in] n_count number of notes in the array
+ * @param[in] n_repeat false for onetime, true for looped playback
+ */
+void audio_play_notes(const musical_note_t *notes, uint16_t n_count, bool n_repeat);
+
 /**
  * @brief play a short tone of a specific frequency to emulate a 'click'
  *
@@ -187,6 +207,11 @@ bool audio_is_playing_melody(void);
  * @brief convenience macro, to play a melody/SONG in a loop, until stopped by 'audio_stop_all'
  */
 #define PLAY_LOOP(note_array) audio_play_melody(&note_array, NOTE_ARRAY_SIZE((note_array)), true)
+/**
+ * @brief the same two for an array of musical_note_t
+ */
+#define PLAY_NOTES(note_array) audio_play_notes(note_array, NOTE_ARRAY_SIZE((note_array)), false)
+#define LOOP_NOTES(note_array) audio_play_notes(note_array, NOTE_ARRAY_SIZE((note_array)), true)
 
 // Tone-Multiplexing functions
 // this feature only makes sense for hardware setups which can't do proper
@@ -236,9 +261,11 @@ uint8_t audio_get_number_of_active_tones(void);
  * @param[in] tone_index, ranging from 0 to number_of_active_tones-1, with the
  *            first being the most recent and each increment yielding the next
  *            older one
- * @return a positive frequency, in Hz; or zero if the tone is a pause
+ * @return a positive frequency, in Hz (or 1/256 Hz for audio_get_pitch); or
+ *         zero if the tone is a pause
  */
-float audio_get_frequency(uint8_t tone_index);
+float         audio_get_frequency(uint8_t tone_index);
+audio_pitch_t audio_get_pitch(uint8_t tone_index);
 
 /**
  * @brief calculate and return the frequency for the requested tone
@@ -248,9 +275,11 @@ float audio_get_frequency(uint8_t tone_index);
  * @param[in] tone_index, ranging from 0 to number_of_active_tones-1, with the
  *            first being the most recent and each increment yielding the next
  *            older one
- * @return a positive frequency, in Hz; or zero if the tone is a pause
+ * @return a positive frequency, in Hz (or 1/256 Hz for audio_get_processed_pitch);
+ *         or zero if the tone is a pause
  */
-float audio_get_processed_frequency(uint8_t tone_index);
+float         audio_get_processed_frequency(uint8_t tone_index);
+audio_pitch_t audio_get_processed_pitch(uint8_t tone_index);
 
 /**
  * @brief   update audio internal state: currently playing and active tones,...
@@ -23,5 +23,9 @@
 
 #define FREQUENCY_LUT_LENGTH 349
 
-extern const float    vibrato_lut[VIBRATO_LUT_LENGTH];
+#define SINE_LUT_LENGTH 256
+#define SINE_LUT_MAX 4095
+
+extern const int16_t  vibrato_lut[VIBRATO_LUT_LENGTH];
 extern const uint16_t frequency_lut[FREQUENCY_LUT_LENGTH];
+extern const uint16_t sine_lut[SINE_LUT_LENGTH];
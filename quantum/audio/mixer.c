@@ -0,0 +1,146 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mixer.h"
+
+// the top bits of a phase index the wavetable, the rest are the fraction in between
+#define PHASE_SHIFT (32 - 8)
+
+_Static_assert(AUDIO_MIXER_WAVETABLE_LENGTH == 1 << (32 - PHASE_SHIFT), "PHASE_SHIFT has to match the wavetable length");
+
+void audio_mixer_init(audio_mixer_t *mixer, const uint16_t *wavetable, uint32_t sample_rate, uint16_t off_value, uint16_t threshold) {
+    *mixer             = (audio_mixer_t){0};
+    mixer->wavetable   = wavetable;
+    mixer->sample_rate = sample_rate;
+    mixer->off_value   = off_value;
+    mixer->threshold   = threshold;
+    mixer->last        = off_value;
+
+    uint16_t closest = UINT16_MAX;
+    for (uint16_t i = 0; i < AUDIO_MIXER_WAVETABLE_LENGTH; i++) {
+        uint16_t distance = wavetable[i] > off_value ? wavetable[i] - off_value : off_value - wavetable[i];
+        if (distance < closest) {
+            closest      = distance;
+            mixer->start = (uint32_t)i << PHASE_SHIFT;
+        }
+    }
+}
+
+void audio_mixer_set_pitches(audio_mixer_t *mixer, const audio_pitch_t *pitches, uint8_t count) {
+    uint8_t voices = 0;
+    for (uint8_t i = 0; i < count && voices < AUDIO_MIXER_MAX_VOICES; i++) {
+        if (pitches[i] == 0) {
+            continue;
+        }
+        // fraction of a period per sample, where 2^32 is a whole one; nothing above the nyquist rate
+        uint64_t increment = ((uint64_t)pitches[i] << (32 - AUDIO_PITCH_SHIFT)) / mixer->sample_rate;
+        if (increment > (1UL << 31)) {
+            increment = 1UL << 31;
+        }
+        mixer->next_increment[voices++] = increment;
+    }
+    mixer->next_voices = voices;
+    mixer->pending     = true;
+}
+
+bool audio_mixer_is_silent(const audio_mixer_t *mixer) { return mixer->voices == 0 && !mixer->pending; }
+
+/* The output is close to off_value, or went past it since the last sample
+ *
+ * ============================*=*========================== wavetable max
+ *                          *       *
+ *                        *           *
+ * ---------------------------------------------------------
+ *                     *                 *                  } threshold
+ * --------------------------------------------------------- off_value
+ *                  *                       *               } threshold
+ * ---------------------------------------------------------
+ *               *
+ * *           *
+ *   *       *
+ * =====*=*================================================= 0x0
+ */
+static bool at_off_value(const audio_mixer_t *mixer, uint16_t value) {
+    uint16_t distance = value > mixer->off_value ? value - mixer->off_value : mixer->off_value - value;
+    return distance <= mixer->threshold || (mixer->last < mixer->off_value) != (value < mixer->off_value);
+}
+
+static void handover(audio_mixer_t *mixer) {
+    bool was_silent = mixer->voices == 0;
+    for (uint8_t i = 0; i < mixer->next_voices; i++) {
+        mixer->increment[i] = mixer->next_increment[i];
+        // voices that keep playing just change pitch, new ones join in without a jump
+        if (i >= mixer->voices) {
+            mixer->phase[i] = mixer->start;
+        }
+    }
+    mixer->voices  = mixer->next_voices;
+    mixer->pending = false;
+    // the waveform might start anywhere, keep quiet until it comes by off_value
+    mixer->muted = was_silent && mixer->voices > 0;
+}
+
+static uint16_t output(audio_mixer_t *mixer, uint16_t value) {
+    if (mixer->muted && at_off_value(mixer, value)) {
+        mixer->muted = false;
+    }
+    mixer->last = value;
+    return (mixer->muted || mixer->voices == 0) ? mixer->off_value : value;
+}
+
+static inline uint16_t next_sample(audio_mixer_t *mixer) {
+    if (mixer->voices == 0) {
+        return mixer->off_value;
+    }
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < mixer->voices; i++) {
+        sum += mixer->wavetable[mixer->phase[i] >> PHASE_SHIFT];
+        mixer->phase[i] += mixer->increment[i];
+    }
+    return sum / mixer->voices;
+}
+
+void audio_mixer_render(audio_mixer_t *mixer, uint16_t *samples, uint16_t count) {
+    for (uint16_t s = 0; s < count; s++) {
+        uint16_t value = next_sample(mixer);
+        if (mixer->pending && at_off_value(mixer, value)) {
+            handover(mixer);
+            value       = next_sample(mixer);
+            mixer->last = value;
+        }
+        samples[s] = output(mixer, value);
+    }
+}
+
+uint16_t audio_mixer_gate(audio_mixer_t *mixer, uint16_t value) {
+    if (mixer->pending && (mixer->voices == 0 || at_off_value(mixer, value))) {
+        handover(mixer);
+        mixer->last = value;
+    }
+    return output(mixer, value);
+}
+
+void audio_mixer_account(audio_mixer_stats_t *stats, uint32_t render_time, uint32_t buffer_time, bool late) {
+    uint32_t load = buffer_time ? ((uint64_t)render_time << 8) / buffer_time : UINT16_MAX;
+    stats->load   = load > UINT16_MAX ? UINT16_MAX : load;
+    if (stats->load > stats->peak_load) {
+        stats->peak_load = stats->load;
+    }
+    stats->buffers++;
+    if (late) {
+        stats->late++;
+    }
+}
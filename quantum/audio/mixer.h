@@ -0,0 +1,94 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "musical_notes.h"
+
+/*
+  Software mixer: renders up to AUDIO_MIXER_MAX_VOICES tones from one wavetable into a buffer of samples
+
+  it only does integer math and touches no hardware, so a driver can call it from wherever it refills its
+  buffers - and it runs just the same on the host
+*/
+
+#ifndef AUDIO_MIXER_MAX_VOICES
+#    define AUDIO_MIXER_MAX_VOICES 8
+#endif
+
+/**
+ * Length of a wavetable, one period of the waveform.
+ */
+#define AUDIO_MIXER_WAVETABLE_LENGTH 256
+
+typedef struct {
+    const uint16_t *wavetable;
+    uint32_t        sample_rate;
+    uint16_t        off_value;  // output while nothing plays; the set of voices changes when the output is at or crosses it
+    uint16_t        threshold;  // how close to off_value counts as being there
+    uint16_t        last;       // previous sample, before muting
+    uint32_t        start;      // phase at which the wavetable is closest to off_value, where new voices start
+    uint8_t         voices;
+    uint8_t         next_voices;
+    bool            pending;  // next_* are waiting for the output to reach off_value
+    bool            muted;    // started from silence, waiting for the waveform to reach off_value
+    uint32_t        phase[AUDIO_MIXER_MAX_VOICES];
+    uint32_t        increment[AUDIO_MIXER_MAX_VOICES];
+    uint32_t        next_increment[AUDIO_MIXER_MAX_VOICES];
+} audio_mixer_t;
+
+typedef struct {
+    uint32_t buffers;    // buffers rendered
+    uint32_t late;       // buffers that were not rendered before they were due
+    uint16_t load;       // time spent rendering the last buffer, in 1/256 of the time it takes to play
+    uint16_t peak_load;  // highest load since the stats were reset
+} audio_mixer_stats_t;
+
+/**
+ * @brief Sets the mixer up to play samples from a wavetable, at a sample rate in Hz.
+ * It starts out silent.
+ */
+void audio_mixer_init(audio_mixer_t *mixer, const uint16_t *wavetable, uint32_t sample_rate, uint16_t off_value, uint16_t threshold);
+
+/**
+ * @brief Tones to play from now on, pitches in 1/256 Hz; rests (pitch 0) are skipped.
+ * The previous tones keep playing until the output reaches off_value, then these take over.
+ * An empty set stops the output the same way.
+ */
+void audio_mixer_set_pitches(audio_mixer_t *mixer, const audio_pitch_t *pitches, uint8_t count);
+
+/**
+ * @brief Fills samples with the sum of the playing tones, scaled by their number.
+ */
+void audio_mixer_render(audio_mixer_t *mixer, uint16_t *samples, uint16_t count);
+
+/**
+ * @brief For samples a driver generates on its own: applies the same start and stop at off_value as
+ * audio_mixer_render, with the tones as set by audio_mixer_set_pitches.
+ */
+uint16_t audio_mixer_gate(audio_mixer_t *mixer, uint16_t value);
+
+/**
+ * @brief Nothing is playing, and nothing is waiting to.
+ */
+bool audio_mixer_is_silent(const audio_mixer_t *mixer);
+
+/**
+ * @brief Accounts for a buffer that took render_time to render, and buffer_time to play, in any unit.
+ */
+void audio_mixer_account(audio_mixer_stats_t *stats, uint32_t render_time, uint32_t buffer_time, bool late);
@@ -16,6 +16,8 @@
  */
 #pragma once
 
+#include <stdint.h>
+
 #ifndef TEMPO_DEFAULT
 #    define TEMPO_DEFAULT 120
 // in beats-per-minute
@@ -24,6 +26,28 @@
 #define SONG(notes...) \
     { notes }
 
+/*
+ * pitches are kept as fixed point numbers in 1/256 Hz internally, so no float
+ * math is needed while tones are playing. AUDIO_PITCH turns a frequency in Hz
+ * into one; given a constant like the NOTE_* below, this happens at compile time.
+ */
+typedef uint32_t audio_pitch_t;
+#define AUDIO_PITCH_SHIFT 8
+#define AUDIO_PITCH(hz) ((audio_pitch_t)((hz) * (1 << AUDIO_PITCH_SHIFT) + 0.5f))
+
+/*
+ * a SONG with integer pitches, to be played with PLAY_NOTES:
+ *   const musical_note_t my_song[] = {AUDIO_NOTE(_C4, 16), AUDIO_NOTE(_REST, 8), AUDIO_NOTE(_E4, 16)};
+ * durations are in the same 64-parts-to-a-beat unit as MUSICAL_NOTE below
+ */
+typedef struct {
+    audio_pitch_t pitch;
+    uint16_t      duration;
+} musical_note_t;
+
+#define AUDIO_NOTE(note, duration) \
+    { AUDIO_PITCH(NOTE##note), duration }
+
 // Note Types
 #define MUSICAL_NOTE(note, duration) \
     { (NOTE##note), duration }
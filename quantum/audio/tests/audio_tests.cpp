@@ -0,0 +1,256 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "audio.h"
+#include "driver_mock.h"
+#include "timer.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+audio_pitch_t voice_add_vibrato(audio_pitch_t average_freq);
+
+extern uint8_t note_timbre;
+extern bool    glissando;
+extern bool    vibrato;
+}
+
+namespace {
+uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/* The vibrato factors as they were, before they became integers */
+const float vibrato_factors[VIBRATO_LUT_LENGTH] = {
+    1.0022336811487, 1.0042529943610, 1.0058584256028, 1.0068905285205, 1.0072464122237, 1.0068905285205, 1.0058584256028, 1.0042529943610, 1.0022336811487, 1.0000000000000, 0.9977712970630, 0.9957650169978, 0.9941756956510, 0.9931566259436, 0.9928057204913, 0.9931566259436, 0.9941756956510, 0.9957650169978, 0.9977712970630, 1.0000000000000,
+};
+
+double cents(audio_pitch_t pitch, double reference_hz) { return 1200 * std::log2(pitch / 256.0 / reference_hz); }
+}  // namespace
+
+struct frame_t {
+    audio_pitch_t pitch;
+    uint8_t       timbre;
+    uint8_t       tones;
+
+    bool operator==(const frame_t& other) const { return pitch == other.pitch && timbre == other.timbre && tones == other.tones; }
+};
+
+class AudioTest : public testing::Test {
+   protected:
+    void SetUp() override {
+        audio_init();
+        audio_stop_all();
+        set_time(0);
+        set_voice(default_voice);
+        audio_set_tempo(TEMPO_DEFAULT);
+        voice_set_vibrato_rate(0.125);
+        voice_set_vibrato_strength(0.5);
+        note_timbre = TIMBRE_DEFAULT;
+        glissando   = false;
+        vibrato     = false;
+    }
+
+    void TearDown() override { audio_stop_all(); }
+
+    /* Plays on for 'ms', updating the state every millisecond like the drivers' timers do */
+    std::vector<frame_t> render(uint32_t ms, uint32_t step = 1) {
+        std::vector<frame_t> frames;
+        for (uint32_t t = 0; t < ms; t += step) {
+            audio_update_state();
+            frames.push_back({audio_get_processed_pitch(0), note_timbre, audio_get_number_of_active_tones()});
+            advance_time(step);
+        }
+        return frames;
+    }
+
+    /* The pitches in the order they were played, without repeats */
+    static std::vector<audio_pitch_t> pitches(const std::vector<frame_t>& frames) {
+        std::vector<audio_pitch_t> played;
+        for (auto& frame : frames) {
+            if (played.empty() || played.back() != frame.pitch) played.push_back(frame.pitch);
+        }
+        return played;
+    }
+};
+
+TEST_F(AudioTest, FloatsConvertLikeTheCompileTimeMacro) {
+    const float         hz[]      = {NOTE_C0, NOTE_A0, NOTE_GS2, NOTE_C4, NOTE_A4, NOTE_CS6, NOTE_B8, 0.5f, 1234.567f};
+    const audio_pitch_t pitches[] = {AUDIO_PITCH(NOTE_C0), AUDIO_PITCH(NOTE_A0), AUDIO_PITCH(NOTE_GS2), AUDIO_PITCH(NOTE_C4), AUDIO_PITCH(NOTE_A4), AUDIO_PITCH(NOTE_CS6), AUDIO_PITCH(NOTE_B8), AUDIO_PITCH(0.5f), AUDIO_PITCH(1234.567f)};
+
+    for (size_t i = 0; i < sizeof(hz) / sizeof(hz[0]); i++) {
+        EXPECT_EQ(pitches[i], (audio_pitch_t)std::lround(hz[i] * 256.0));
+        audio_play_tone(hz[i]);
+        EXPECT_EQ(audio_get_pitch(0), pitches[i]) << hz[i] << " Hz";
+        EXPECT_FLOAT_EQ(audio_get_frequency(0), pitches[i] / 256.0f);
+        audio_stop_tone(hz[i]);
+        EXPECT_EQ(audio_get_number_of_active_tones(), 0);
+    }
+
+    audio_play_tone(-NOTE_A4);
+    EXPECT_EQ(audio_get_pitch(0), AUDIO_PITCH(NOTE_A4));
+}
+
+TEST_F(AudioTest, SongAndIntegerNotesPlayAlike) {
+    float                song[][2] = SONG(Q__NOTE(_C4), Q__NOTE(_C4), E__NOTE(_REST), ED_NOTE(_E5), S__NOTE(_G5), H__NOTE(_A4));
+    const musical_note_t notes[]   = {AUDIO_NOTE(_C4, 16), AUDIO_NOTE(_C4, 16), AUDIO_NOTE(_REST, 8), AUDIO_NOTE(_E5, 8 + 4), AUDIO_NOTE(_G5, 4), AUDIO_NOTE(_A4, 32)};
+
+    PLAY_SONG(song);
+    auto from_song = render(1000);
+    EXPECT_FALSE(audio_is_playing_melody());
+
+    set_time(0);
+    PLAY_NOTES(notes);
+    auto from_notes = render(1000);
+
+    EXPECT_EQ(from_song, from_notes);
+    /* The two C4 are kept apart by a short rest */
+    std::vector<audio_pitch_t> expected = {AUDIO_PITCH(NOTE_C4), 0, AUDIO_PITCH(NOTE_C4), 0, AUDIO_PITCH(NOTE_E5), AUDIO_PITCH(NOTE_G5), AUDIO_PITCH(NOTE_A4), 0};
+    EXPECT_EQ(pitches(from_notes), expected);
+}
+
+TEST_F(AudioTest, NotesFollowTheTempo) {
+    const musical_note_t notes[] = {AUDIO_NOTE(_A4, 16), AUDIO_NOTE(_B4, 16)};
+
+    for (uint8_t tempo : {60, 120, 200}) {
+        audio_set_tempo(tempo);
+        set_time(0);
+        PLAY_NOTES(notes);
+        auto   frames = render(2000);
+        size_t second = 0;
+        while (second < frames.size() && frames[second].pitch != AUDIO_PITCH(NOTE_B4)) {
+            second++;
+        }
+        /* A whole note is a beat */
+        EXPECT_EQ(second, 60000u / tempo / 4) << tempo << " bpm";
+        EXPECT_EQ(audio_duration_to_ms(64), 60000u / tempo);
+        EXPECT_EQ(audio_ms_to_duration(60000u / tempo), 64);
+    }
+}
+
+TEST_F(AudioTest, LoopedNotesStartOver) {
+    const musical_note_t notes[] = {AUDIO_NOTE(_A4, 16), AUDIO_NOTE(_B4, 16)};
+
+    LOOP_NOTES(notes);
+    auto played = pitches(render(4 * audio_duration_to_ms(16)));
+    EXPECT_TRUE(audio_is_playing_melody());
+    std::vector<audio_pitch_t> expected = {AUDIO_PITCH(NOTE_A4), AUDIO_PITCH(NOTE_B4), AUDIO_PITCH(NOTE_A4), AUDIO_PITCH(NOTE_B4)};
+    EXPECT_EQ(played, expected);
+}
+
+TEST_F(AudioTest, ClickWaitsForItsDelay) {
+    audio_play_click(20, 2000.0f, 30);
+    auto frames = render(200);
+
+    EXPECT_EQ(frames[0].pitch, 0u);
+    EXPECT_EQ(frames[0].tones, 1);
+    std::vector<audio_pitch_t> expected = {0, AUDIO_PITCH(2000), 0};
+    EXPECT_EQ(pitches(frames), expected);
+    EXPECT_FALSE(audio_is_playing_melody());
+}
+
+TEST_F(AudioTest, VibratoStaysWithTheFloatVersion) {
+    for (float strength : {0.25f, 0.5f, 1.0f}) {
+        for (float rate : {0.125f, 0.5f}) {
+            voice_set_vibrato_strength(strength);
+            voice_set_vibrato_rate(rate);
+            for (float hz : {NOTE_C2, NOTE_A4, NOTE_C8}) {
+                for (uint32_t t = 0; t < 3000; t += 7) {
+                    set_time(t);
+                    double reference = hz * std::pow(vibrato_factors[(int)std::fmod(t / (100 * rate), VIBRATO_LUT_LENGTH)], strength);
+                    ASSERT_NEAR(cents(voice_add_vibrato(AUDIO_PITCH(hz)), reference), 0, 0.25) << hz << " Hz at " << t << " ms, strength " << strength << ", rate " << rate;
+                }
+            }
+        }
+    }
+}
+
+TEST_F(AudioTest, DelayedVibratoStaysWithTheFloatVersion) {
+    set_voice(delayed_vibrato);
+    audio_play_tone(NOTE_A4);
+
+    auto frames = render(30000, 10);
+    for (size_t i = 0; i < frames.size(); i++) {
+        uint16_t index     = i * 10 / 100;
+        double   reference = NOTE_A4;
+        if (index > 150) {
+            reference *= vibrato_factors[(index - 151) * 50 / 1000 % VIBRATO_LUT_LENGTH];
+        }
+        ASSERT_NEAR(cents(frames[i].pitch, reference), 0, 0.25) << "at " << i * 10 << " ms";
+    }
+}
+
+TEST_F(AudioTest, ButtsFaderStaysWithTheFloatVersion) {
+    set_voice(butts_fader);
+    audio_play_tone(NOTE_A4);
+
+    auto frames = render(25000, 10);
+    for (size_t i = 0; i < frames.size(); i++) {
+        uint16_t      index  = i * 10 / 100;
+        audio_pitch_t pitch  = AUDIO_PITCH(NOTE_A4);
+        uint8_t       timbre = 0;
+        if (index < 10) {
+            pitch /= 4, timbre = TIMBRE_12;
+        } else if (index < 20) {
+            pitch /= 2, timbre = TIMBRE_12;
+        } else if (index <= 200) {
+            timbre = 12 - (uint8_t)(std::pow((index - 20) / 180.0, 2) * 12.5);
+        }
+        ASSERT_EQ(frames[i].pitch, pitch) << "at " << i * 10 << " ms";
+        ASSERT_EQ(frames[i].timbre, timbre) << "at " << i * 10 << " ms";
+    }
+}
+
+/* Every voice plays the same melody the same way each time; and what one state update costs */
+TEST_F(AudioTest, VoicesAreDeterministic) {
+    const musical_note_t notes[] = {AUDIO_NOTE(_C4, 16), AUDIO_NOTE(_E4, 16), AUDIO_NOTE(_G4, 16), AUDIO_NOTE(_REST, 8), AUDIO_NOTE(_C5, 64)};
+    const char*          names[] = {"default", "vibrating", "something", "drums", "butts_fader", "octave_crunch", "duty_osc", "duty_octave_down", "delayed_vibrato"};
+
+    for (int voice = 0; voice < number_of_voices; voice++) {
+        std::vector<frame_t> runs[2];
+        uint64_t             cycles  = 0;
+        const uint32_t       updates = 2000;
+        for (auto& run : runs) {
+            SetUp();
+            set_voice((voice_type)voice);
+            srand(1);
+            PLAY_NOTES(notes);
+            uint64_t start = read_cycles();
+            run            = render(updates);
+            cycles         = read_cycles() - start;
+        }
+        EXPECT_EQ(runs[0], runs[1]) << names[voice];
+        std::cout << "[ BENCHMARK] " << names[voice] << ": " << cycles / updates << " cycles/update" << std::endl;
+        RecordProperty(std::string(names[voice]) + "_cycles_per_update", (int)(cycles / updates));
+    }
+}
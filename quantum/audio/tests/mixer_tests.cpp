@@ -0,0 +1,260 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "mixer.h"
+#include "luts.h"
+}
+
+#define SAMPLE_RATE 24576
+#define OFF_VALUE (SINE_LUT_MAX / 2)
+#define THRESHOLD (SINE_LUT_MAX / 100)
+
+namespace {
+uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/* Magnitude of one frequency in the samples, as a fraction of full scale */
+double goertzel(const std::vector<uint16_t>& samples, double hz) {
+    double coefficient = 2 * std::cos(2 * M_PI * hz / SAMPLE_RATE);
+    double s1 = 0, s2 = 0;
+    for (uint16_t sample : samples) {
+        double s0 = (sample - OFF_VALUE) + coefficient * s1 - s2;
+        s2        = s1;
+        s1        = s0;
+    }
+    return std::sqrt(s1 * s1 + s2 * s2 - coefficient * s1 * s2) / samples.size() / (SINE_LUT_MAX / 2.0);
+}
+
+/* Biggest step between two samples that follow each other */
+int largest_step(const std::vector<uint16_t>& samples, uint16_t before = OFF_VALUE) {
+    int step = 0;
+    for (uint16_t sample : samples) {
+        step   = std::max(step, std::abs(sample - before));
+        before = sample;
+    }
+    return step;
+}
+}  // namespace
+
+class Mixer : public testing::Test {
+   protected:
+    audio_mixer_t mixer;
+
+    void SetUp() override { audio_mixer_init(&mixer, sine_lut, SAMPLE_RATE, OFF_VALUE, THRESHOLD); }
+
+    void play(std::vector<audio_pitch_t> pitches) { audio_mixer_set_pitches(&mixer, pitches.data(), pitches.size()); }
+
+    std::vector<uint16_t> render(size_t count) {
+        std::vector<uint16_t> samples(count);
+        /* in half buffers, the way the DAC driver does */
+        for (size_t s = 0; s < count; s += 128) {
+            audio_mixer_render(&mixer, samples.data() + s, std::min<size_t>(128, count - s));
+        }
+        return samples;
+    }
+};
+
+TEST_F(Mixer, SilentUntilSomethingPlays) {
+    EXPECT_TRUE(audio_mixer_is_silent(&mixer));
+    for (uint16_t sample : render(1024)) {
+        ASSERT_EQ(sample, OFF_VALUE);
+    }
+}
+
+TEST_F(Mixer, OneTone) {
+    play({AUDIO_PITCH(440)});
+    render(SAMPLE_RATE / 10);
+    std::vector<uint16_t> samples = render(SAMPLE_RATE);
+
+    /* One rising crossing per period */
+    int crossings = 0;
+    for (size_t s = 1; s < samples.size(); s++) {
+        if (samples[s - 1] < OFF_VALUE && samples[s] >= OFF_VALUE) crossings++;
+    }
+    EXPECT_NEAR(crossings, 440, 1);
+    EXPECT_NEAR(goertzel(samples, 440), 0.5, 0.02);
+    EXPECT_LT(goertzel(samples, 880), 0.01);
+    EXPECT_LT(goertzel(samples, 220), 0.01);
+}
+
+TEST_F(Mixer, FractionalPitch) {
+    /* A4 a little flat; whole periods over 100 seconds show the 1/256 Hz */
+    play({AUDIO_PITCH(439.5)});
+    std::vector<uint16_t> samples = render(100 * SAMPLE_RATE);
+    int                   crossings = 0;
+    for (size_t s = 1; s < samples.size(); s++) {
+        if (samples[s - 1] < OFF_VALUE && samples[s] >= OFF_VALUE) crossings++;
+    }
+    EXPECT_NEAR(crossings, 43950, 1);
+}
+
+TEST_F(Mixer, ToneAddsUp) {
+    play({AUDIO_PITCH(440), 0, AUDIO_PITCH(660), AUDIO_PITCH(990)});
+    render(SAMPLE_RATE / 10);
+    std::vector<uint16_t> samples = render(SAMPLE_RATE);
+
+    /* The rest is skipped, the other three share the output */
+    EXPECT_EQ(mixer.voices, 3);
+    for (double hz : {440, 660, 990}) {
+        EXPECT_NEAR(goertzel(samples, hz), 0.5 / 3, 0.01) << hz;
+    }
+    for (double hz : {220, 550, 880, 1320}) {
+        EXPECT_LT(goertzel(samples, hz), 0.01) << hz;
+    }
+    EXPECT_LE(*std::max_element(samples.begin(), samples.end()), SINE_LUT_MAX);
+}
+
+TEST_F(Mixer, StartsAndStopsWithoutAClick) {
+    std::vector<uint16_t> samples = render(100);
+    play({AUDIO_PITCH(440), AUDIO_PITCH(554.37)});
+    for (uint16_t sample : render(SAMPLE_RATE / 10)) {
+        samples.push_back(sample);
+    }
+    play({});
+    for (uint16_t sample : render(SAMPLE_RATE / 10)) {
+        samples.push_back(sample);
+    }
+
+    /* Nothing jumps further than two tones can move in one sample */
+    int steepest = 2 * SINE_LUT_MAX * M_PI * 554.37 / SAMPLE_RATE / 2;
+    EXPECT_LE(largest_step(samples), steepest + THRESHOLD);
+    EXPECT_TRUE(audio_mixer_is_silent(&mixer));
+    EXPECT_EQ(samples.back(), OFF_VALUE);
+    EXPECT_NE(std::count(samples.begin(), samples.end(), OFF_VALUE), (long)samples.size());
+}
+
+TEST_F(Mixer, TonesChangeAtTheCrossing) {
+    play({AUDIO_PITCH(440)});
+    std::vector<uint16_t> samples = render(SAMPLE_RATE / 10);
+    uint16_t              before  = samples.back();
+    play({AUDIO_PITCH(440), AUDIO_PITCH(660)});
+    samples = render(SAMPLE_RATE / 10);
+
+    int steepest = SINE_LUT_MAX * M_PI * 660 / SAMPLE_RATE;
+    EXPECT_LE(largest_step(samples, before), steepest + THRESHOLD);
+    EXPECT_EQ(mixer.voices, 2);
+}
+
+TEST_F(Mixer, SquareWavesChangeToo) {
+    /* A square wave never comes near the off value, it only goes past it */
+    static uint16_t square[AUDIO_MIXER_WAVETABLE_LENGTH];
+    for (int i = 0; i < AUDIO_MIXER_WAVETABLE_LENGTH; i++) {
+        square[i] = i < AUDIO_MIXER_WAVETABLE_LENGTH / 2 ? 0 : SINE_LUT_MAX;
+    }
+    audio_mixer_init(&mixer, square, SAMPLE_RATE, OFF_VALUE, THRESHOLD);
+
+    play({AUDIO_PITCH(440)});
+    render(SAMPLE_RATE / 10);
+    EXPECT_EQ(mixer.voices, 1);
+    play({AUDIO_PITCH(880)});
+    render(SAMPLE_RATE / 100);
+    EXPECT_FALSE(mixer.pending);
+    play({});
+    render(SAMPLE_RATE / 100);
+    EXPECT_TRUE(audio_mixer_is_silent(&mixer));
+}
+
+TEST_F(Mixer, GatesOtherSamples) {
+    /* A keymap's own waveform: a ramp that starts far from the off value */
+    uint16_t ramp = 0;
+    auto     next = [&]() { return audio_mixer_gate(&mixer, ramp = (ramp + 64) % SINE_LUT_MAX); };
+
+    EXPECT_EQ(next(), OFF_VALUE);
+    play({AUDIO_PITCH(440)});
+    std::vector<uint16_t> samples;
+    for (int i = 0; i < 200; i++) {
+        samples.push_back(next());
+    }
+    /* Held at the off value until the ramp gets there, then the ramp */
+    EXPECT_EQ(samples[0], OFF_VALUE);
+    EXPECT_NE(samples.back(), OFF_VALUE);
+    EXPECT_LE(largest_step(std::vector<uint16_t>(samples.begin(), samples.begin() + 60)), 64);
+
+    play({});
+    for (int i = 0; i < 200; i++) {
+        next();
+    }
+    EXPECT_TRUE(audio_mixer_is_silent(&mixer));
+    EXPECT_EQ(next(), OFF_VALUE);
+}
+
+TEST_F(Mixer, RendersTheSameEveryTime) {
+    auto checksum = [&]() {
+        SetUp();
+        play({AUDIO_PITCH(261.63), AUDIO_PITCH(329.63), AUDIO_PITCH(392)});
+        uint32_t sum = 0;
+        for (uint16_t sample : render(SAMPLE_RATE)) {
+            sum = sum * 31 + sample;
+        }
+        return sum;
+    };
+    EXPECT_EQ(checksum(), checksum());
+}
+
+TEST_F(Mixer, Load) {
+    audio_mixer_stats_t stats = {0};
+    audio_mixer_account(&stats, 25, 100, false);
+    EXPECT_EQ(stats.load, 64);
+    audio_mixer_account(&stats, 50, 100, true);
+    audio_mixer_account(&stats, 10, 100, false);
+    EXPECT_EQ(stats.load, 25);
+    EXPECT_EQ(stats.peak_load, 128);
+    EXPECT_EQ(stats.buffers, 3u);
+    EXPECT_EQ(stats.late, 1u);
+    /* Way too slow still fits */
+    audio_mixer_account(&stats, 1000000, 1, false);
+    EXPECT_EQ(stats.load, UINT16_MAX);
+}
+
+TEST_F(Mixer, Benchmark) {
+    for (uint8_t voices = 1; voices <= AUDIO_MIXER_MAX_VOICES; voices *= 2) {
+        SetUp();
+        std::vector<audio_pitch_t> pitches;
+        for (uint8_t i = 0; i < voices; i++) {
+            pitches.push_back(AUDIO_PITCH(220) * (i + 2) / 2);
+        }
+        play(pitches);
+        render(SAMPLE_RATE / 10);
+
+        uint16_t half[128];
+        uint64_t start = read_cycles();
+        for (int i = 0; i < 1000; i++) {
+            audio_mixer_render(&mixer, half, 128);
+        }
+        uint64_t cycles = read_cycles() - start;
+        std::cout << "[ BENCHMARK] " << (int)voices << " voices: " << cycles / 1000 / 128 << " cycles/sample" << std::endl;
+        RecordProperty("cycles_per_sample_" + std::to_string(voices), (int)(cycles / 1000 / 128));
+    }
+}
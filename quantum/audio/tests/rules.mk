@@ -0,0 +1,18 @@
+audio_DEFS := -DNO_PRINT -DNO_DEBUG -DMATRIX_ROWS=1 -DMATRIX_COLS=1 -DAUDIO_ENABLE -DAUDIO_INIT_DELAY -DAUDIO_VOICES
+
+audio_INC := $(QUANTUM_PATH)/audio/tests
+
+audio_SRC := \
+	$(QUANTUM_PATH)/audio/tests/audio_tests.cpp \
+	$(QUANTUM_PATH)/audio/tests/driver_mock.c \
+	$(QUANTUM_PATH)/audio/audio.c \
+	$(QUANTUM_PATH)/audio/voices.c \
+	$(QUANTUM_PATH)/audio/luts.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+audio_mixer_DEFS := -DNO_PRINT -DNO_DEBUG
+
+audio_mixer_SRC := \
+	$(QUANTUM_PATH)/audio/tests/mixer_tests.cpp \
+	$(QUANTUM_PATH)/audio/mixer.c \
+	$(QUANTUM_PATH)/audio/luts.c
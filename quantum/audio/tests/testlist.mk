@@ -0,0 +1,2 @@
+TEST_LIST += audio
+TEST_LIST += audio_mixer
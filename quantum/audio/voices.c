@@ -18,11 +18,11 @@
 #include "audio.h"
 #include <stdlib.h>
 
-uint8_t note_timbre      = TIMBRE_DEFAULT;
-bool    glissando        = false;
-bool    vibrato          = false;
-float   vibrato_strength = 0.5;
-float   vibrato_rate     = 0.125;
+uint8_t  note_timbre      = TIMBRE_DEFAULT;
+bool     glissando        = false;
+bool     vibrato          = false;
+uint16_t vibrato_strength = 128;  // in 1/256, 0.5
+uint16_t vibrato_rate     = 32;   // in 1/256, 0.125
 
 uint16_t voices_timer = 0;
 
@@ -39,31 +39,33 @@ void voice_iterate() { voice = (voice + 1) % number_of_voices; }
 void voice_deiterate() { voice = (voice - 1 + number_of_voices) % number_of_voices; }
 
 #ifdef AUDIO_VOICES
-float mod(float a, int b) {
-    float r = fmod(a, b);
-    return r < 0 ? r + b : r;
-}
+// Raises/lowers 'pitch' by depth/65536 of itself, the unit of vibrato_lut
+// shifting the pitch first keeps the product in 32bit, for anything up to ~16kHz
+static audio_pitch_t voice_shift_pitch(audio_pitch_t pitch, int32_t depth) { return pitch + (((int32_t)(pitch >> 4) * depth) >> 12); }
 
 // Effect: 'vibrate' a given target frequency slightly above/below its initial value
-float voice_add_vibrato(float average_freq) {
-    float vibrato_counter = mod(timer_read() / (100 * vibrato_rate), VIBRATO_LUT_LENGTH);
+// the lut holds factors just around 1.0, so lut^strength is as good as scaling their deviation from 1.0 by the strength
+audio_pitch_t voice_add_vibrato(audio_pitch_t average_freq) {
+    uint8_t vibrato_counter = ((uint32_t)timer_read() * 256 / (100 * (uint32_t)(vibrato_rate ? vibrato_rate : 1))) % VIBRATO_LUT_LENGTH;
 
-    return average_freq * pow(vibrato_lut[(int)vibrato_counter], vibrato_strength);
+    return voice_shift_pitch(average_freq, (int32_t)vibrato_lut[vibrato_counter] * vibrato_strength / 256);
 }
 
 // Effect: 'slides' the 'frequency' from the starting-point, to the target frequency
-float voice_add_glissando(float from_freq, float to_freq) {
-    if (to_freq != 0 && from_freq < to_freq && from_freq < to_freq * pow(2, -440 / to_freq / 12 / 2)) {
-        return from_freq * pow(2, 440 / from_freq / 12 / 2);
-    } else if (to_freq != 0 && from_freq > to_freq && from_freq > to_freq * pow(2, 440 / to_freq / 12 / 2)) {
-        return from_freq * pow(2, -440 / from_freq / 12 / 2);
+// in steps of from * 2^(440 / from / 12 / 2), which come to 440 * ln(2) / 24 Hz whatever the frequency
+#    define GLISSANDO_STEP AUDIO_PITCH(440 * 0.693147f / 24)
+audio_pitch_t voice_add_glissando(audio_pitch_t from_freq, audio_pitch_t to_freq) {
+    if (to_freq != 0 && from_freq + GLISSANDO_STEP < to_freq) {
+        return from_freq + GLISSANDO_STEP;
+    } else if (to_freq != 0 && from_freq > to_freq + GLISSANDO_STEP) {
+        return from_freq - GLISSANDO_STEP;
     } else {
         return to_freq;
     }
 }
 #endif
 
-float voice_envelope(float frequency) {
+audio_pitch_t voice_envelope(audio_pitch_t frequency) {
     // envelope_index ranges from 0 to 0xFFFF, which is preserved at 880.0 Hz
 //    __attribute__((unused)) uint16_t compensated_index = (uint16_t)((float)envelope_index * (880.0 / frequency));
 #ifdef AUDIO_VOICES
@@ -120,10 +122,10 @@ float voice_envelope(float frequency) {
             // }
             // frequency = (rand() % (int)(frequency * 1.2 - frequency)) + (frequency * 0.8);
 
-            if (frequency < 80.0) {
-            } else if (frequency < 160.0) {
+            if (frequency < AUDIO_PITCH(80)) {
+            } else if (frequency < AUDIO_PITCH(160)) {
                 // Bass drum: 60 - 100 Hz
-                frequency = (rand() % (int)(40)) + 60;
+                frequency = (audio_pitch_t)((rand() % 40) + 60) << AUDIO_PITCH_SHIFT;
                 switch (envelope_index) {
                     case 0 ... 10:
                         note_timbre = 50;
@@ -136,9 +138,9 @@ float voice_envelope(float frequency) {
                         break;
                 }
 
-            } else if (frequency < 320.0) {
+            } else if (frequency < AUDIO_PITCH(320)) {
                 // Snare drum: 1 - 2 KHz
-                frequency = (rand() % (int)(1000)) + 1000;
+                frequency = (audio_pitch_t)((rand() % 1000) + 1000) << AUDIO_PITCH_SHIFT;
                 switch (envelope_index) {
                     case 0 ... 5:
                         note_timbre = 50;
@@ -151,9 +153,9 @@ float voice_envelope(float frequency) {
                         break;
                 }
 
-            } else if (frequency < 640.0) {
+            } else if (frequency < AUDIO_PITCH(640)) {
                 // Closed Hi-hat: 3 - 5 KHz
-                frequency = (rand() % (int)(2000)) + 3000;
+                frequency = (audio_pitch_t)((rand() % 2000) + 3000) << AUDIO_PITCH_SHIFT;
                 switch (envelope_index) {
                     case 0 ... 15:
                         note_timbre = 50;
@@ -166,9 +168,9 @@ float voice_envelope(float frequency) {
                         break;
                 }
 
-            } else if (frequency < 1280.0) {
+            } else if (frequency < AUDIO_PITCH(1280)) {
                 // Open Hi-hat: 3 - 5 KHz
-                frequency = (rand() % (int)(2000)) + 3000;
+                frequency = (audio_pitch_t)((rand() % 2000) + 3000) << AUDIO_PITCH_SHIFT;
                 switch (envelope_index) {
                     case 0 ... 35:
                         note_timbre = 50;
@@ -196,7 +198,8 @@ float voice_envelope(float frequency) {
                     break;
 
                 case 20 ... 200:
-                    note_timbre = 12 - (uint8_t)(pow(((float)compensated_index - 20) / (200 - 20), 2) * 12.5);
+                    // fading out along ((index - 20) / (200 - 20))^2 * 12.5
+                    note_timbre = 12 - (uint8_t)((uint32_t)(compensated_index - 20) * (compensated_index - 20) * 25 / ((200 - 20) * (200 - 20) * 2));
                     break;
 
                 default:
@@ -233,18 +236,18 @@ float voice_envelope(float frequency) {
             switch (compensated_index) {
                 default:
 #    define OCS_SPEED 10
-#    define OCS_AMP .25
+#    define OCS_AMP 25
                     // sine wave is slow
-                    // note_timbre = (sin((float)compensated_index/10000*OCS_SPEED) * OCS_AMP / 2) + .5;
-                    // triangle wave is a bit faster
-                    note_timbre = (uint8_t)abs((compensated_index * OCS_SPEED % 3000) - 1500) * (OCS_AMP / 1500) + (1 - OCS_AMP) / 2;
+                    // note_timbre = (sin((float)compensated_index/10000*OCS_SPEED) * OCS_AMP / 2) + 50;
+                    // triangle wave is a bit faster, swinging the timbre by OCS_AMP percent around 50
+                    note_timbre = abs((compensated_index * OCS_SPEED % 3000) - 1500) * OCS_AMP / 1500 + (100 - OCS_AMP) / 2;
                     break;
             }
             break;
 
         case duty_octave_down:
             glissando   = true;
-            note_timbre = (uint8_t)(100 * (envelope_index % 2) * .125 + .375 * 2);
+            note_timbre = (envelope_index % 2) * 13;  // 12.5% on every other tick, off in between
             if ((envelope_index % 4) == 0) note_timbre = 50;
             if ((envelope_index % 8) == 0) note_timbre = 0;
             break;
@@ -258,7 +261,7 @@ float voice_envelope(float frequency) {
                     break;
                 default:
                     // TODO: merge/replace with voice_add_vibrato above
-                    frequency = frequency * vibrato_lut[(int)fmod((((float)compensated_index - (VOICE_VIBRATO_DELAY + 1)) / 1000 * VOICE_VIBRATO_SPEED), VIBRATO_LUT_LENGTH)];
+                    frequency = voice_shift_pitch(frequency, vibrato_lut[((compensated_index - (VOICE_VIBRATO_DELAY + 1)) * VOICE_VIBRATO_SPEED / 1000) % VIBRATO_LUT_LENGTH]);
                     break;
             }
             break;
@@ -325,12 +328,12 @@ float voice_envelope(float frequency) {
 
 // Vibrato functions
 
-void voice_set_vibrato_rate(float rate) { vibrato_rate = rate; }
-void voice_increase_vibrato_rate(float change) { vibrato_rate *= change; }
-void voice_decrease_vibrato_rate(float change) { vibrato_rate /= change; }
-void voice_set_vibrato_strength(float strength) { vibrato_strength = strength; }
-void voice_increase_vibrato_strength(float change) { vibrato_strength *= change; }
-void voice_decrease_vibrato_strength(float change) { vibrato_strength /= change; }
+void voice_set_vibrato_rate(float rate) { vibrato_rate = rate * 256; }
+void voice_increase_vibrato_rate(float change) { vibrato_rate = vibrato_rate * change; }
+void voice_decrease_vibrato_rate(float change) { vibrato_rate = vibrato_rate / change; }
+void voice_set_vibrato_strength(float strength) { vibrato_strength = strength * 256; }
+void voice_increase_vibrato_strength(float change) { vibrato_strength = vibrato_strength * change; }
+void voice_decrease_vibrato_strength(float change) { vibrato_strength = vibrato_strength / change; }
 
 // Timbre functions
 
@@ -20,8 +20,9 @@
 #include <stdbool.h>
 #include "wait.h"
 #include "luts.h"
+#include "musical_notes.h"
 
-float voice_envelope(float frequency);
+audio_pitch_t voice_envelope(audio_pitch_t frequency);
 
 typedef enum {
     default_voice,
@@ -48,6 +49,7 @@ void voice_iterate(void);
 void voice_deiterate(void);
 
 // Vibrato functions
+// rate and strength are kept in 1/256 internally
 void voice_set_vibrato_rate(float rate);
 void voice_increase_vibrato_rate(float change);
 void voice_decrease_vibrato_rate(float change);
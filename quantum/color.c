@@ -18,46 +18,55 @@
 #include "led_tables.h"
 #include "progmem.h"
 
-RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
+#if !defined(HSV_TO_RGB_PACKED) && defined(__ARM_FEATURE_DSP)
+#    define HSV_TO_RGB_PACKED
+#endif
+
+#ifdef HSV_TO_RGB_PACKED
+// Bytes 1 and 3 of x, moved down into the low byte of each half
+static inline uint32_t packed_high_bytes(uint32_t x) {
+#    ifdef __ARM_FEATURE_DSP
+    uint32_t r;
+    __asm__("uxtb16 %0, %1, ror #8" : "=r"(r) : "r"(x));
+    return r;
+#    else
+    return (x >> 8) & 0x00FF00FF;
+#    endif
+}
+#endif
+
+// Hue and saturation, for a value that has already been through the curve
+static inline RGB hsv_to_rgb_curved(uint8_t hue, uint8_t sat, uint8_t val) {
     RGB      rgb;
     uint8_t  region, remainder, p, q, t;
     uint16_t h, s, v;
 
-    if (hsv.s == 0) {
-#ifdef USE_CIE1931_CURVE
-        if (use_cie) {
-            rgb.r = rgb.g = rgb.b = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-        } else {
-            rgb.r = hsv.v;
-            rgb.g = hsv.v;
-            rgb.b = hsv.v;
-        }
-#else
-        rgb.r = hsv.v;
-        rgb.g = hsv.v;
-        rgb.b = hsv.v;
-#endif
+    if (sat == 0) {
+        rgb.r = val;
+        rgb.g = val;
+        rgb.b = val;
         return rgb;
     }
 
-    h = hsv.h;
-    s = hsv.s;
-#ifdef USE_CIE1931_CURVE
-    if (use_cie) {
-        v = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-    } else {
-        v = hsv.v;
-    }
-#else
-    v = hsv.v;
-#endif
+    h = hue;
+    s = sat;
+    v = val;
 
-    region    = h * 6 / 255;
+    // h * 6 / 255, without the division
+    region    = (h * 6 + 1 + ((h * 6) >> 8)) >> 8;
     remainder = (h * 2 - region * 85) * 3;
 
     p = (v * (255 - s)) >> 8;
+#ifdef HSV_TO_RGB_PACKED
+    // q in the low half and t in the high half of one word, no product is over 255 * 255 so neither carries into the other
+    uint32_t sq = (uint32_t)s * remainder;
+    uint32_t qt = packed_high_bytes(v * (0x00FF00FF - packed_high_bytes(sq | ((uint32_t)s * 255 - sq) << 16)));
+    q           = qt;
+    t           = qt >> 16;
+#else
     q = (v * (255 - ((s * remainder) >> 8))) >> 8;
     t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+#endif
 
     switch (region) {
         case 6:
@@ -96,6 +105,15 @@ RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
     return rgb;
 }
 
+RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
+#ifdef USE_CIE1931_CURVE
+    if (use_cie) {
+        return hsv_to_rgb_curved(hsv.h, hsv.s, pgm_read_byte(&CIE1931_CURVE[hsv.v]));
+    }
+#endif
+    return hsv_to_rgb_curved(hsv.h, hsv.s, hsv.v);
+}
+
 RGB hsv_to_rgb(HSV hsv) {
 #ifdef USE_CIE1931_CURVE
     return hsv_to_rgb_impl(hsv, true);
@@ -106,6 +124,31 @@ RGB hsv_to_rgb(HSV hsv) {
 
 RGB hsv_to_rgb_nocie(HSV hsv) { return hsv_to_rgb_impl(hsv, false); }
 
+// Every color is read before it is written, so rgb can be the same memory as hsv
+static void hsv_to_rgb_buffer_impl(const HSV *hsv, RGB *rgb, uint16_t count, bool use_cie) {
+#ifdef USE_CIE1931_CURVE
+    if (use_cie) {
+        for (uint16_t i = 0; i < count; i++) {
+            rgb[i] = hsv_to_rgb_curved(hsv[i].h, hsv[i].s, pgm_read_byte(&CIE1931_CURVE[hsv[i].v]));
+        }
+        return;
+    }
+#endif
+    for (uint16_t i = 0; i < count; i++) {
+        rgb[i] = hsv_to_rgb_curved(hsv[i].h, hsv[i].s, hsv[i].v);
+    }
+}
+
+void hsv_to_rgb_buffer(const HSV *hsv, RGB *rgb, uint16_t count) {
+#ifdef USE_CIE1931_CURVE
+    hsv_to_rgb_buffer_impl(hsv, rgb, count, true);
+#else
+    hsv_to_rgb_buffer_impl(hsv, rgb, count, false);
+#endif
+}
+
+void hsv_to_rgb_buffer_nocie(const HSV *hsv, RGB *rgb, uint16_t count) { hsv_to_rgb_buffer_impl(hsv, rgb, count, false); }
+
 #ifdef RGBW
 #    ifndef MIN
 #        define MIN(a, b) ((a) < (b) ? (a) : (b))
@@ -145,6 +145,9 @@ typedef struct PACKED {
 
 RGB hsv_to_rgb(HSV hsv);
 RGB hsv_to_rgb_nocie(HSV hsv);
+// Converts count colors at once, rgb may point at the same memory as hsv to convert in place
+void hsv_to_rgb_buffer(const HSV *hsv, RGB *rgb, uint16_t count);
+void hsv_to_rgb_buffer_nocie(const HSV *hsv, RGB *rgb, uint16_t count);
 #ifdef RGBW
 void convert_rgb_to_rgbw(LED_TYPE *led);
 #endif
@@ -0,0 +1,182 @@
+/*
+Copyright 2021 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Symmetric per-key defer algorithm, same behaviour as sym_defer_pk.
+Instead of a counter for every key, only keys that are currently bouncing are kept in a small
+fixed-size list (DEBOUNCE_SPARSE_SIZE entries, static storage, no malloc), so the cost of
+each call is proportional to the number of bouncing keys rather than the matrix size.
+When no state changes have occured for DEBOUNCE milliseconds, we push the state.
+
+If more keys are bouncing than fit in the list, the extra keys share a single timer that is
+restarted by every change (like sym_defer_g), until a slot becomes free.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+#ifndef DEBOUNCE_SPARSE_SIZE
+#    define DEBOUNCE_SPARSE_SIZE 16
+#endif
+
+#if DEBOUNCE_SPARSE_SIZE > UINT8_MAX
+#    error DEBOUNCE_SPARSE_SIZE must be 255 or less
+#endif
+
+#define ROW_SHIFTER ((matrix_row_t)1)
+
+typedef uint8_t debounce_counter_t;
+
+typedef struct {
+    uint8_t            row;
+    uint8_t            col;
+    debounce_counter_t remaining;
+} debounce_entry_t;
+
+#if DEBOUNCE > 0
+static debounce_entry_t   debounce_entries[DEBOUNCE_SPARSE_SIZE];
+static uint8_t            debounce_entry_count;
+static matrix_row_t       debounce_tracked[MATRIX_ROWS];
+static debounce_counter_t overflow_counter;
+static fast_timer_t       last_time;
+
+#    define DEBOUNCE_ELAPSED 0
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time);
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+static inline bool counters_need_update(void) { return debounce_entry_count > 0 || overflow_counter != DEBOUNCE_ELAPSED; }
+
+static inline void remove_entry(uint8_t index) {
+    debounce_entry_t *entry = &debounce_entries[index];
+
+    debounce_tracked[entry->row] &= ~(ROW_SHIFTER << entry->col);
+    *entry = debounce_entries[--debounce_entry_count];
+}
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    for (uint8_t r = 0; r < num_rows; r++) {
+        debounce_tracked[r] = 0;
+    }
+    debounce_entry_count = 0;
+    overflow_counter     = DEBOUNCE_ELAPSED;
+}
+
+void debounce_free(void) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+
+    if (counters_need_update()) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters_and_transfer_if_expired(raw, cooked, num_rows, elapsed_time);
+        }
+    }
+
+    if (changed) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        start_debounce_counters(raw, cooked, num_rows);
+    }
+}
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
+    for (uint8_t i = 0; i < debounce_entry_count;) {
+        debounce_entry_t *entry = &debounce_entries[i];
+        if (entry->remaining <= elapsed_time) {
+            matrix_row_t col_mask = ROW_SHIFTER << entry->col;
+            cooked[entry->row]    = (cooked[entry->row] & ~col_mask) | (raw[entry->row] & col_mask);
+            remove_entry(i);
+        } else {
+            entry->remaining -= elapsed_time;
+            i++;
+        }
+    }
+
+    if (overflow_counter != DEBOUNCE_ELAPSED) {
+        if (overflow_counter <= elapsed_time) {
+            overflow_counter = DEBOUNCE_ELAPSED;
+            // push every key that did not fit in the list
+            for (uint8_t row = 0; row < num_rows; row++) {
+                matrix_row_t untracked = ~debounce_tracked[row];
+                cooked[row]            = (cooked[row] & ~untracked) | (raw[row] & untracked);
+            }
+        } else {
+            overflow_counter -= elapsed_time;
+        }
+    }
+}
+
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    bool overflowed = false;
+
+    // forget keys that went back to their debounced state
+    for (uint8_t i = 0; i < debounce_entry_count;) {
+        debounce_entry_t *entry = &debounce_entries[i];
+        if (!((raw[entry->row] ^ cooked[entry->row]) & (ROW_SHIFTER << entry->col))) {
+            remove_entry(i);
+        } else {
+            i++;
+        }
+    }
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t pending = (raw[row] ^ cooked[row]) & ~debounce_tracked[row];
+        for (uint8_t col = 0; pending && col < MATRIX_COLS; col++, pending >>= 1) {
+            if (pending & 1) {
+                if (debounce_entry_count < DEBOUNCE_SPARSE_SIZE) {
+                    debounce_entries[debounce_entry_count++] = (debounce_entry_t){.row = row, .col = col, .remaining = DEBOUNCE};
+                    debounce_tracked[row] |= ROW_SHIFTER << col;
+                } else {
+                    overflowed = true;
+                }
+            }
+        }
+    }
+
+    if (overflowed) {
+        overflow_counter = DEBOUNCE;
+    }
+}
+
+bool debounce_active(void) { return true; }
+#else
+#    include "none.c"
+#endif
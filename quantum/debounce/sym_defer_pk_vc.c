@@ -0,0 +1,106 @@
+/*
+Copyright 2021 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Symmetric per-key defer algorithm, same behaviour as sym_defer_pk.
+Counters are stored as vertical bit-sliced counters (see vertical_counter.h), so each row
+is updated with a few word-wide operations instead of a loop over every column.
+Uses static storage only, no malloc.
+When no state changes have occured for DEBOUNCE milliseconds, we push the state.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+#include "vertical_counter.h"
+
+#if DEBOUNCE > 0
+static vc_row_t     debounce_counters[MATRIX_ROWS];
+static fast_timer_t last_time;
+static bool         counters_need_update;
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time);
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    for (uint8_t r = 0; r < num_rows; r++) {
+        vc_clear(&debounce_counters[r], ~(matrix_row_t)0);
+    }
+    counters_need_update = false;
+}
+
+void debounce_free(void) {}
+
+void debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters_and_transfer_if_expired(raw, cooked, num_rows, elapsed_time);
+        }
+    }
+
+    if (changed) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        start_debounce_counters(raw, cooked, num_rows);
+    }
+}
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
+    counters_need_update = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t expired = vc_elapse(&debounce_counters[row], elapsed_time);
+        if (expired) {
+            cooked[row] = (cooked[row] & ~expired) | (raw[row] & expired);
+        }
+        if (vc_active(&debounce_counters[row])) {
+            counters_need_update = true;
+        }
+    }
+}
+
+static void start_debounce_counters(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        vc_row_t *   counters = &debounce_counters[row];
+        matrix_row_t delta    = (raw[row] ^ cooked[row]) & VC_COL_MASK;
+        matrix_row_t start    = delta & ~vc_active(counters);
+
+        vc_clear(counters, ~delta);
+        if (start) {
+            vc_start(counters, start);
+            counters_need_update = true;
+        }
+    }
+}
+
+bool debounce_active(void) { return true; }
+#else
+#    include "none.c"
+#endif
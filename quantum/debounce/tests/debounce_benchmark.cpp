@@ -0,0 +1,130 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#endif
+
+extern "C" {
+#include "quantum.h"
+#include "timer.h"
+#include "debounce.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+
+#ifdef DEBOUNCE_REFERENCE
+void debounce_reference(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+void debounce_reference_init(uint8_t num_rows);
+void debounce_reference_free(void);
+#endif
+}
+
+namespace {
+uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/* Small deterministic PRNG so every algorithm sees the same input */
+uint32_t xorshift(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+}  // namespace
+
+/* Replay a typing workload with contact bounce on a large matrix and report the average cost of one debounce() call.
+ * With DEBOUNCE_REFERENCE the same scans also go through the plain per-key algorithm it replaces, and the cooked
+ * matrices have to match after every scan. */
+TEST(DebounceBenchmark, CyclesPerCall) {
+    const uint32_t scans = 200000;
+    matrix_row_t   raw[MATRIX_ROWS]    = {};
+    matrix_row_t   cooked[MATRIX_ROWS] = {};
+    matrix_row_t   target[MATRIX_ROWS] = {};
+    uint32_t       rng                 = 0x1234567;
+    uint32_t       checksum            = 0;
+    uint64_t       cycles              = 0;
+
+    debounce_init(MATRIX_ROWS);
+#ifdef DEBOUNCE_REFERENCE
+    matrix_row_t expected[MATRIX_ROWS] = {};
+    uint32_t     mismatches            = 0;
+    debounce_reference_init(MATRIX_ROWS);
+#endif
+    set_time(1000);
+
+    auto wall_start = std::chrono::steady_clock::now();
+    for (uint32_t scan = 0; scan < scans; scan++) {
+        bool changed = false;
+
+        /* Roughly one key toggles every 20 scans; keys near a transition bounce for a few scans */
+        if (xorshift(rng) % 20 == 0) {
+            uint32_t key = xorshift(rng);
+            target[(key >> 8) % MATRIX_ROWS] ^= MATRIX_ROW_SHIFTER << (key % MATRIX_COLS);
+        }
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            matrix_row_t next = target[row];
+            if (raw[row] != target[row] && xorshift(rng) % 4 == 0) {
+                next = raw[row];
+            }
+            changed |= next != raw[row];
+            raw[row] = next;
+        }
+
+        uint64_t start = read_cycles();
+        debounce(raw, cooked, MATRIX_ROWS, changed);
+        cycles += read_cycles() - start;
+
+#ifdef DEBOUNCE_REFERENCE
+        debounce_reference(raw, expected, MATRIX_ROWS, changed);
+        if (!std::equal(std::begin(expected), std::end(expected), std::begin(cooked)) && mismatches++ == 0) {
+            ADD_FAILURE() << "Output differs from the reference at scan " << scan;
+        }
+#endif
+
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            checksum = (checksum * 31) ^ cooked[row];
+        }
+        advance_time(1);
+    }
+    auto wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - wall_start).count();
+
+    /* Let everything settle and make sure the output caught up with the input */
+    for (int i = 0; i < 1000; i++) {
+        debounce(target, cooked, MATRIX_ROWS, false);
+        advance_time(1);
+    }
+    debounce_free();
+#ifdef DEBOUNCE_REFERENCE
+    debounce_reference_free();
+    EXPECT_EQ(mismatches, 0u);
+#endif
+    EXPECT_TRUE(std::equal(std::begin(target), std::end(target), std::begin(cooked)));
+
+    std::cout << "[ BENCHMARK] " << MATRIX_ROWS << "x" << MATRIX_COLS << " matrix, " << scans << " calls: " << (double)cycles / scans << " cycles/call, " << (double)wall_ns / scans << " ns/call (wall), checksum " << std::hex << checksum << std::dec << std::endl;
+    RecordProperty("cycles_per_call", (int)(cycles / scans));
+}
@@ -18,6 +18,15 @@ DEBOUNCE_COMMON_DEFS := -DMATRIX_ROWS=4 -DMATRIX_COLS=10 -DDEBOUNCE=5
 DEBOUNCE_COMMON_SRC := $(QUANTUM_PATH)/debounce/tests/debounce_test_common.cpp \
 	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
 
+DEBOUNCE_BENCHMARK_DEFS := -DMATRIX_ROWS=12 -DMATRIX_COLS=32 -DDEBOUNCE=5
+
+DEBOUNCE_BENCHMARK_SRC := $(QUANTUM_PATH)/debounce/tests/debounce_benchmark.cpp \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+# The rewritten per-key algorithms are checked scan by scan against the one they replace
+DEBOUNCE_BENCHMARK_DEFER_REFERENCE := $(QUANTUM_PATH)/debounce/tests/debounce_reference_defer.c
+DEBOUNCE_BENCHMARK_EAGER_REFERENCE := $(QUANTUM_PATH)/debounce/tests/debounce_reference_eager.c
+
 debounce_sym_defer_g_DEFS := $(DEBOUNCE_COMMON_DEFS)
 debounce_sym_defer_g_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/sym_defer_g.c \
@@ -42,3 +51,46 @@ debounce_asym_eager_defer_pk_DEFS := $(DEBOUNCE_COMMON_DEFS)
 debounce_asym_eager_defer_pk_SRC := $(DEBOUNCE_COMMON_SRC) \
 	$(QUANTUM_PATH)/debounce/asym_eager_defer_pk.c \
 	$(QUANTUM_PATH)/debounce/tests/asym_eager_defer_pk_tests.cpp
+
+debounce_sym_defer_pk_vc_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_defer_pk_vc_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk_vc.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_tests.cpp
+
+debounce_sym_eager_pk_vc_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_eager_pk_vc_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pk_vc.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_eager_pk_tests.cpp
+
+debounce_sym_defer_pk_sparse_DEFS := $(DEBOUNCE_COMMON_DEFS)
+debounce_sym_defer_pk_sparse_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk_sparse.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_tests.cpp
+
+debounce_sym_defer_pk_sparse_overflow_DEFS := $(DEBOUNCE_COMMON_DEFS) -DDEBOUNCE_SPARSE_SIZE=2
+debounce_sym_defer_pk_sparse_overflow_SRC := $(DEBOUNCE_COMMON_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk_sparse.c \
+	$(QUANTUM_PATH)/debounce/tests/sym_defer_pk_sparse_tests.cpp
+
+debounce_benchmark_sym_defer_pk_DEFS := $(DEBOUNCE_BENCHMARK_DEFS)
+debounce_benchmark_sym_defer_pk_SRC := $(DEBOUNCE_BENCHMARK_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk.c
+
+debounce_benchmark_sym_defer_pk_vc_DEFS := $(DEBOUNCE_BENCHMARK_DEFS) -DDEBOUNCE_REFERENCE
+debounce_benchmark_sym_defer_pk_vc_SRC := $(DEBOUNCE_BENCHMARK_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk_vc.c \
+	$(DEBOUNCE_BENCHMARK_DEFER_REFERENCE)
+
+debounce_benchmark_sym_eager_pk_DEFS := $(DEBOUNCE_BENCHMARK_DEFS)
+debounce_benchmark_sym_eager_pk_SRC := $(DEBOUNCE_BENCHMARK_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pk.c
+
+debounce_benchmark_sym_eager_pk_vc_DEFS := $(DEBOUNCE_BENCHMARK_DEFS) -DDEBOUNCE_REFERENCE
+debounce_benchmark_sym_eager_pk_vc_SRC := $(DEBOUNCE_BENCHMARK_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_eager_pk_vc.c \
+	$(DEBOUNCE_BENCHMARK_EAGER_REFERENCE)
+
+debounce_benchmark_sym_defer_pk_sparse_DEFS := $(DEBOUNCE_BENCHMARK_DEFS) -DDEBOUNCE_REFERENCE
+debounce_benchmark_sym_defer_pk_sparse_SRC := $(DEBOUNCE_BENCHMARK_SRC) \
+	$(QUANTUM_PATH)/debounce/sym_defer_pk_sparse.c \
+	$(DEBOUNCE_BENCHMARK_DEFER_REFERENCE)
@@ -0,0 +1,70 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "gtest/gtest.h"
+
+#include "debounce_test_common.h"
+
+/* These tests are built with DEBOUNCE_SPARSE_SIZE=2 to exercise the overflow path */
+
+TEST_F(DebounceTest, OverflowKeyPushedWithTrackedKeys) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}, {0, 2, DOWN}, {0, 3, DOWN}}, {}},
+        {5, {}, {{0, 1, DOWN}, {0, 2, DOWN}, {0, 3, DOWN}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, OverflowKeyBounceRestartsTimer) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}, {0, 2, DOWN}, {0, 3, DOWN}}, {}},
+        {2, {{0, 3, UP}}, {}},
+        {3, {{0, 3, DOWN}}, {}},
+        {5, {}, {{0, 1, DOWN}, {0, 2, DOWN}}},
+        /* 5ms after the last change of the overflowed key */
+        {8, {}, {{0, 3, DOWN}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, OverflowKeysShareOneTimer) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}, {0, 2, DOWN}, {0, 3, DOWN}}, {}},
+        {4, {{1, 0, DOWN}}, {}},
+        {5, {}, {{0, 1, DOWN}, {0, 2, DOWN}}},
+        /* Any change to a key without a slot restarts the shared timer */
+        {9, {}, {{0, 3, DOWN}, {1, 0, DOWN}}},
+    });
+    runEvents();
+}
+
+TEST_F(DebounceTest, FreedSlotIsReused) {
+    addEvents({
+        /* Time, Inputs, Outputs */
+        {0, {{0, 1, DOWN}, {0, 2, DOWN}}, {}},
+        {5, {}, {{0, 1, DOWN}, {0, 2, DOWN}}},
+        {6, {{2, 4, DOWN}, {3, 9, DOWN}}, {}},
+        {7, {{2, 4, UP}}, {}},
+        {8, {{2, 4, DOWN}}, {}},
+        {11, {}, {{3, 9, DOWN}}},
+        {13, {}, {{2, 4, DOWN}}},
+    });
+    runEvents();
+}
@@ -3,4 +3,13 @@ TEST_LIST += \
 	debounce_sym_defer_pk \
 	debounce_sym_eager_pk \
 	debounce_sym_eager_pr \
-	debounce_asym_eager_defer_pk
+	debounce_asym_eager_defer_pk \
+	debounce_sym_defer_pk_vc \
+	debounce_sym_eager_pk_vc \
+	debounce_sym_defer_pk_sparse \
+	debounce_sym_defer_pk_sparse_overflow \
+	debounce_benchmark_sym_defer_pk \
+	debounce_benchmark_sym_defer_pk_vc \
+	debounce_benchmark_sym_eager_pk \
+	debounce_benchmark_sym_eager_pk_vc \
+	debounce_benchmark_sym_defer_pk_sparse
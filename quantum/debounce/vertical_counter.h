@@ -0,0 +1,129 @@
+/*
+Copyright 2021 QMK
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/*
+Vertical (bit-sliced) per-key counters.
+Each counter bit is stored in its own matrix_row_t, so bit n of every key on a row lives in
+the same word. A whole row of counters is loaded, decremented or reset with a handful of
+word-wide AND/OR/XOR operations, no matter how many columns the matrix has.
+*/
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "matrix.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 255ms
+#if DEBOUNCE > UINT8_MAX
+#    undef DEBOUNCE
+#    define DEBOUNCE UINT8_MAX
+#endif
+
+// Number of bit planes needed to hold DEBOUNCE
+#if DEBOUNCE < 2
+#    define VC_BITS 1
+#elif DEBOUNCE < 4
+#    define VC_BITS 2
+#elif DEBOUNCE < 8
+#    define VC_BITS 3
+#elif DEBOUNCE < 16
+#    define VC_BITS 4
+#elif DEBOUNCE < 32
+#    define VC_BITS 5
+#elif DEBOUNCE < 64
+#    define VC_BITS 6
+#elif DEBOUNCE < 128
+#    define VC_BITS 7
+#else
+#    define VC_BITS 8
+#endif
+
+// Only the lanes that map to real columns take part
+#if MATRIX_COLS >= 32
+#    define VC_COL_MASK ((matrix_row_t)~(matrix_row_t)0)
+#else
+#    define VC_COL_MASK ((matrix_row_t)((MATRIX_ROW_SHIFTER << MATRIX_COLS) - 1))
+#endif
+
+typedef struct {
+    matrix_row_t bit[VC_BITS];
+} vc_row_t;
+
+// Lanes whose counter is non-zero
+static inline matrix_row_t vc_active(const vc_row_t *vc) {
+    matrix_row_t active = 0;
+    for (uint8_t i = 0; i < VC_BITS; i++) {
+        active |= vc->bit[i];
+    }
+    return active;
+}
+
+// Load DEBOUNCE into the counters selected by mask
+static inline void vc_start(vc_row_t *vc, matrix_row_t mask) {
+    for (uint8_t i = 0; i < VC_BITS; i++) {
+        if ((DEBOUNCE >> i) & 1) {
+            vc->bit[i] |= mask;
+        } else {
+            vc->bit[i] &= ~mask;
+        }
+    }
+}
+
+// Clear the counters selected by mask
+static inline void vc_clear(vc_row_t *vc, matrix_row_t mask) {
+    for (uint8_t i = 0; i < VC_BITS; i++) {
+        vc->bit[i] &= ~mask;
+    }
+}
+
+/*
+Subtract elapsed_time from every non-zero counter in the row, saturating at zero.
+Returns the lanes that expired, i.e. whose counter was <= elapsed_time.
+*/
+static inline matrix_row_t vc_elapse(vc_row_t *vc, uint8_t elapsed_time) {
+    matrix_row_t active = vc_active(vc);
+    if (!active) {
+        return 0;
+    }
+
+    if (elapsed_time >> VC_BITS) {
+        // Longer than any counter can hold
+        vc_clear(vc, active);
+        return active;
+    }
+
+    // Ripple-borrow subtraction of the same constant from every lane
+    matrix_row_t borrow = 0;
+    matrix_row_t remain = 0;
+    for (uint8_t i = 0; i < VC_BITS; i++) {
+        matrix_row_t a = vc->bit[i];
+        matrix_row_t b = ((elapsed_time >> i) & 1) ? ~(matrix_row_t)0 : 0;
+        matrix_row_t d = (a ^ b ^ borrow) & active;
+        borrow         = (~a & b) | (~(a ^ b) & borrow);
+        vc->bit[i]     = d;
+        remain |= d;
+    }
+
+    matrix_row_t expired = active & (borrow | ~remain);
+    vc_clear(vc, expired);
+    return expired;
+}
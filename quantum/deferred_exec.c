@@ -4,44 +4,136 @@
 #include <stddef.h>
 #include <timer.h>
 #include <deferred_exec.h>
+#include <keyboard.h>
 
-#ifndef MAX_DEFERRED_EXECUTORS
-#    define MAX_DEFERRED_EXECUTORS 8
+// Executors are kept in a fixed slot table, with a binary min-heap of slot indices ordered by trigger time.
+// Tokens encode the slot they refer to, so lookups never need to search the table.
+
+#if MAX_DEFERRED_EXECUTORS > 254
+typedef uint16_t deferred_index_t;
+#else
+typedef uint8_t deferred_index_t;
+#endif
+
+#if MAX_DEFERRED_EXECUTORS > 127
+#    define DEFERRED_TOKEN_MAX UINT16_MAX
+#else
+#    define DEFERRED_TOKEN_MAX UINT8_MAX
+#endif
+
+#if DEFERRED_TOKEN_MAX / MAX_DEFERRED_EXECUTORS < 2
+#    error MAX_DEFERRED_EXECUTORS is too large
 #endif
 
+// Each slot cycles through this many distinct tokens before one is reused
+#define DEFERRED_TOKEN_GENERATIONS (DEFERRED_TOKEN_MAX / MAX_DEFERRED_EXECUTORS)
+
+#define NOT_IN_HEAP ((deferred_index_t)~(deferred_index_t)0)
+
 typedef struct deferred_executor_t {
     deferred_token         token;
+    deferred_index_t       heap_index;
     uint32_t               trigger_time;
     deferred_exec_callback callback;
     void *                 cb_arg;
 } deferred_executor_t;
 
-static deferred_token      current_token                     = 0;
-static uint32_t            last_deferred_exec_check          = 0;
-static deferred_executor_t executors[MAX_DEFERRED_EXECUTORS] = {0};
+static uint32_t            last_deferred_exec_check = 0;
+static deferred_executor_t executors[MAX_DEFERRED_EXECUTORS];
+static deferred_token      generations[MAX_DEFERRED_EXECUTORS];
+static deferred_index_t    heap[MAX_DEFERRED_EXECUTORS];
+static deferred_index_t    heap_size = 0;
+static deferred_index_t    due[MAX_DEFERRED_EXECUTORS];
+static deferred_index_t    free_count = 0;
+static deferred_index_t    free_slots[MAX_DEFERRED_EXECUTORS];
+static bool                initialized = false;
 
-static inline bool token_can_be_used(deferred_token token) {
-    if (token == INVALID_DEFERRED_TOKEN) {
-        return false;
+static inline bool triggers_before(deferred_index_t a, deferred_index_t b) { return ((int32_t)TIMER_DIFF_32(executors[a].trigger_time, executors[b].trigger_time)) < 0; }
+
+static inline void heap_place(deferred_index_t index, deferred_index_t slot) {
+    heap[index]                = slot;
+    executors[slot].heap_index = index;
+}
+
+static void heap_sift_up(deferred_index_t index) {
+    deferred_index_t slot = heap[index];
+    while (index > 0) {
+        deferred_index_t parent = (index - 1) / 2;
+        if (!triggers_before(slot, heap[parent])) {
+            break;
+        }
+        heap_place(index, heap[parent]);
+        index = parent;
     }
-    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
-        if (executors[i].token == token) {
-            return false;
+    heap_place(index, slot);
+}
+
+static void heap_sift_down(deferred_index_t index) {
+    deferred_index_t slot = heap[index];
+    for (;;) {
+        uint32_t child = 2 * (uint32_t)index + 1;
+        if (child >= heap_size) {
+            break;
+        }
+        if (child + 1 < heap_size && triggers_before(heap[child + 1], heap[child])) {
+            child++;
         }
+        if (!triggers_before(heap[child], slot)) {
+            break;
+        }
+        heap_place(index, heap[child]);
+        index = (deferred_index_t)child;
     }
-    return true;
+    heap_place(index, slot);
+}
+
+static void heap_push(deferred_index_t slot) {
+    heap_place(heap_size, slot);
+    heap_sift_up(heap_size++);
 }
 
-static inline deferred_token allocate_token(void) {
-    deferred_token first = ++current_token;
-    while (!token_can_be_used(current_token)) {
-        ++current_token;
-        if (current_token == first) {
-            // If we've looped back around to the first, everything is already allocated (yikes!). Need to exit with a failure.
-            return INVALID_DEFERRED_TOKEN;
+static void heap_remove(deferred_index_t slot) {
+    deferred_index_t index     = executors[slot].heap_index;
+    executors[slot].heap_index = NOT_IN_HEAP;
+    if (index != --heap_size) {
+        deferred_index_t moved = heap[heap_size];
+        heap_place(index, moved);
+        heap_sift_up(index);
+        heap_sift_down(executors[moved].heap_index);
+    }
+}
+
+// Re-establishes heap order after the trigger time of an entry has changed
+static void heap_update(deferred_index_t slot) {
+    heap_sift_up(executors[slot].heap_index);
+    heap_sift_down(executors[slot].heap_index);
+}
+
+static inline void init_executors(void) {
+    if (!initialized) {
+        for (deferred_index_t i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
+            executors[i].heap_index = NOT_IN_HEAP;
+            free_slots[i]           = MAX_DEFERRED_EXECUTORS - 1 - i;
         }
+        free_count  = MAX_DEFERRED_EXECUTORS;
+        initialized = true;
+    }
+}
+
+static inline deferred_executor_t *lookup(deferred_token token) {
+    if (token == INVALID_DEFERRED_TOKEN || token > DEFERRED_TOKEN_GENERATIONS * MAX_DEFERRED_EXECUTORS) {
+        return NULL;
     }
-    return current_token;
+    deferred_executor_t *entry = &executors[(token - 1) % MAX_DEFERRED_EXECUTORS];
+    return entry->token == token ? entry : NULL;
+}
+
+static inline void release_slot(deferred_executor_t *entry) {
+    entry->token             = INVALID_DEFERRED_TOKEN;
+    entry->trigger_time      = 0;
+    entry->callback          = NULL;
+    entry->cb_arg            = NULL;
+    free_slots[free_count++] = entry - executors;
 }
 
 deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
@@ -50,103 +142,131 @@ deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, vo
         return INVALID_DEFERRED_TOKEN;
     }
 
-    // Find an unused slot and claim it
-    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
-        deferred_executor_t *entry = &executors[i];
-        if (entry->token == INVALID_DEFERRED_TOKEN) {
-            // Work out the new token value, dropping out if none were available
-            deferred_token token = allocate_token();
-            if (token == INVALID_DEFERRED_TOKEN) {
-                return false;
-            }
-
-            // Set up the executor table entry
-            entry->token        = current_token;
-            entry->trigger_time = timer_read32() + delay_ms;
-            entry->callback     = callback;
-            entry->cb_arg       = cb_arg;
-            return current_token;
-        }
-    }
+    init_executors();
 
     // None available
-    return INVALID_DEFERRED_TOKEN;
+    if (free_count == 0) {
+        return INVALID_DEFERRED_TOKEN;
+    }
+
+    // Claim an unused slot, and work out its next token value
+    deferred_index_t slot = free_slots[--free_count];
+    generations[slot]     = (generations[slot] + 1) % DEFERRED_TOKEN_GENERATIONS;
+
+    // Set up the executor table entry
+    deferred_executor_t *entry = &executors[slot];
+    entry->token               = generations[slot] * MAX_DEFERRED_EXECUTORS + slot + 1;
+    entry->trigger_time        = timer_read32() + delay_ms;
+    entry->callback            = callback;
+    entry->cb_arg              = cb_arg;
+    heap_push(slot);
+    task_schedule_wake();
+    return entry->token;
 }
 
 bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
-    // Ignore queueing if it's a zero-time delay, or the token is not valid
-    if (delay_ms == 0 || token == INVALID_DEFERRED_TOKEN) {
+    // Ignore queueing if it's a zero-time delay
+    if (delay_ms == 0) {
         return false;
     }
 
     // Find the entry corresponding to the token
-    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
-        deferred_executor_t *entry = &executors[i];
-        if (entry->token == token) {
-            // Found it, extend the delay
-            entry->trigger_time = timer_read32() + delay_ms;
-            return true;
-        }
+    deferred_executor_t *entry = lookup(token);
+    if (!entry) {
+        return false;
     }
 
-    // Not found
-    return false;
+    // Found it, extend the delay
+    entry->trigger_time = timer_read32() + delay_ms;
+    if (entry->heap_index != NOT_IN_HEAP) {
+        heap_update(entry - executors);
+    }
+    task_schedule_wake();
+    return true;
 }
 
 bool cancel_deferred_exec(deferred_token token) {
-    // Ignore request if the token is not valid
-    if (token == INVALID_DEFERRED_TOKEN) {
+    // Find the entry corresponding to the token
+    deferred_executor_t *entry = lookup(token);
+    if (!entry) {
         return false;
     }
 
-    // Find the entry corresponding to the token
-    for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
-        deferred_executor_t *entry = &executors[i];
-        if (entry->token == token) {
-            // Found it, cancel and clear the table entry
-            entry->token        = INVALID_DEFERRED_TOKEN;
-            entry->trigger_time = 0;
-            entry->callback     = NULL;
-            entry->cb_arg       = NULL;
-            return true;
-        }
+    // Found it, cancel and clear the table entry
+    if (entry->heap_index != NOT_IN_HEAP) {
+        heap_remove(entry - executors);
     }
+    release_slot(entry);
+    return true;
+}
 
-    // Not found
-    return false;
+// Milliseconds until the earliest executor is due
+static uint32_t next_deadline(uint32_t now) {
+    if (heap_size == 0) {
+        return TASK_IDLE;
+    }
+    int32_t remaining = (int32_t)TIMER_DIFF_32(executors[heap[0]].trigger_time, now);
+    return remaining > 0 ? remaining : 1;
 }
 
-void deferred_exec_task(void) {
+uint32_t deferred_exec_task(void) {
     uint32_t now = timer_read32();
 
     // Throttle only once per millisecond
-    if (((int32_t)TIMER_DIFF_32(now, last_deferred_exec_check)) > 0) {
-        last_deferred_exec_check = now;
-
-        // Run through each of the executors
-        for (int i = 0; i < MAX_DEFERRED_EXECUTORS; ++i) {
-            deferred_executor_t *entry = &executors[i];
-
-            // Check if we're supposed to execute this entry
-            if (entry->token != INVALID_DEFERRED_TOKEN && ((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) <= 0) {
-                // Invoke the callback and work work out if we should be requeued
-                uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
-
-                // Update the trigger time if we have to repeat, otherwise clear it out
-                if (delay_ms > 0) {
-                    // Intentionally add just the delay to the existing trigger time -- this ensures the next
-                    // invocation is with respect to the previous trigger, rather than when it got to execution. Under
-                    // normal circumstances this won't cause issue, but if another executor is invoked that takes a
-                    // considerable length of time, then this ensures best-effort timing between invocations.
-                    entry->trigger_time += delay_ms;
-                } else {
-                    // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
-                    entry->token        = INVALID_DEFERRED_TOKEN;
-                    entry->trigger_time = 0;
-                    entry->callback     = NULL;
-                    entry->cb_arg       = NULL;
-                }
-            }
+    if (((int32_t)TIMER_DIFF_32(now, last_deferred_exec_check)) <= 0) {
+        return 1;
+    }
+    last_deferred_exec_check = now;
+
+    // Nothing is due yet
+    if (heap_size == 0 || ((int32_t)TIMER_DIFF_32(executors[heap[0]].trigger_time, now)) > 0) {
+        return next_deadline(now);
+    }
+
+    // Take every due entry off the heap first, so that each one runs at most once per pass
+    deferred_index_t due_count = 0;
+    while (heap_size > 0 && ((int32_t)TIMER_DIFF_32(executors[heap[0]].trigger_time, now)) <= 0) {
+        deferred_index_t slot = heap[0];
+        heap_remove(slot);
+        due[due_count++] = slot;
+    }
+
+    for (deferred_index_t i = 0; i < due_count; ++i) {
+        deferred_executor_t *entry = &executors[due[i]];
+        deferred_token       token = entry->token;
+
+        // Cancelled by an earlier callback in this pass, and possibly handed out again
+        if (token == INVALID_DEFERRED_TOKEN || entry->heap_index != NOT_IN_HEAP) {
+            continue;
+        }
+
+        // Extended by an earlier callback in this pass
+        if (((int32_t)TIMER_DIFF_32(entry->trigger_time, now)) > 0) {
+            heap_push(due[i]);
+            continue;
+        }
+
+        // Invoke the callback and work work out if we should be requeued
+        uint32_t delay_ms = entry->callback(entry->trigger_time, entry->cb_arg);
+
+        // The callback cancelled itself
+        if (entry->token != token) {
+            continue;
+        }
+
+        // Update the trigger time if we have to repeat, otherwise clear it out
+        if (delay_ms > 0) {
+            // Intentionally add just the delay to the existing trigger time -- this ensures the next
+            // invocation is with respect to the previous trigger, rather than when it got to execution. Under
+            // normal circumstances this won't cause issue, but if another executor is invoked that takes a
+            // considerable length of time, then this ensures best-effort timing between invocations.
+            entry->trigger_time += delay_ms;
+            heap_push(due[i]);
+        } else {
+            // If it was zero, then the callback is cancelling repeated execution. Free up the slot.
+            release_slot(entry);
         }
     }
+
+    return next_deadline(now);
 }
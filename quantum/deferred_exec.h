@@ -6,8 +6,16 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#ifndef MAX_DEFERRED_EXECUTORS
+#    define MAX_DEFERRED_EXECUTORS 8
+#endif
+
 // A token that can be used to cancel an existing deferred execution.
+#if MAX_DEFERRED_EXECUTORS > 127
+typedef uint16_t deferred_token;
+#else
 typedef uint8_t deferred_token;
+#endif
 #define INVALID_DEFERRED_TOKEN 0
 
 // Callback to execute.
@@ -35,4 +43,5 @@ bool extend_deferred_exec(deferred_token token, uint32_t delay_ms);
 bool cancel_deferred_exec(deferred_token token);
 
 // Forward declaration for the main loop in order to execute any deferred executors. Should not be invoked by keyboard/user code.
-void deferred_exec_task(void);
+//  -- Return value: the number of milliseconds until the next executor is due, or TASK_IDLE if there are none
+uint32_t deferred_exec_task(void);
@@ -31,6 +31,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "profiler.h"
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -100,6 +101,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef SLEEP_LED_ENABLE
 #    include "sleep_led.h"
 #endif
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSPORT_EVENTS)
+#    include "transactions.h"
+#endif
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) { return last_input_modification_time; }
@@ -115,6 +119,76 @@ uint32_t        last_encoder_activity_time(void) { return last_encoder_modificat
 uint32_t        last_encoder_activity_elapsed(void) { return timer_elapsed32(last_encoder_modification_time); }
 void            last_encoder_activity_trigger(void) { last_encoder_modification_time = last_input_modification_time = timer_read32(); }
 
+static task_schedule_t *task_schedules  = NULL;
+static uint16_t         task_wake_count = 0;
+
+/** \brief task_schedule_due
+ *
+ * Returns true if the task owning this schedule needs to run: it has never run, its
+ * deadline has passed, or there has been new input since it last ran.
+ */
+bool task_schedule_due(task_schedule_t *schedule) {
+    if (!schedule->registered) {
+        schedule->registered = true;
+        schedule->next       = task_schedules;
+        task_schedules       = schedule;
+        return true;
+    }
+    if (schedule->wake_count != task_wake_count) {
+        return true;
+    }
+    return !schedule->idle && ((int32_t)TIMER_DIFF_32(timer_read32(), schedule->next_run)) >= 0;
+}
+
+/** \brief task_schedule_update
+ *
+ * Records the delay returned by a task after it has run.
+ */
+void task_schedule_update(task_schedule_t *schedule, uint32_t delay_ms) {
+    schedule->wake_count = task_wake_count;
+    schedule->idle       = (delay_ms == TASK_IDLE);
+    schedule->next_run   = timer_read32() + (schedule->idle ? 0 : delay_ms);
+}
+
+/** \brief task_schedule_wake
+ *
+ * Signals new input, so that every scheduled task runs again on the next loop.
+ */
+void task_schedule_wake(void) { task_wake_count++; }
+
+/** \brief task_schedule_idle_time
+ *
+ * Returns the number of milliseconds until the earliest deadline of any scheduled task,
+ * or TASK_IDLE if every task is waiting for input.
+ */
+uint32_t task_schedule_idle_time(void) {
+    uint32_t now     = timer_read32();
+    uint32_t idle_ms = TASK_IDLE;
+    for (task_schedule_t *schedule = task_schedules; schedule; schedule = schedule->next) {
+        if (schedule->wake_count != task_wake_count) {
+            return 0;
+        }
+        if (!schedule->idle) {
+            int32_t remaining = (int32_t)TIMER_DIFF_32(schedule->next_run, now);
+            if (remaining <= 0) {
+                return 0;
+            }
+            if ((uint32_t)remaining < idle_ms) {
+                idle_ms = remaining;
+            }
+        }
+    }
+    return idle_ms;
+}
+
+/** \brief keyboard_idle_kb
+ *
+ * Called at the end of every main loop iteration with the time until the next scheduled
+ * task deadline. Keyboards that can be woken by a matrix interrupt may sleep here; only
+ * tasks on the scheduler are taken into account.
+ */
+__attribute__((weak)) void keyboard_idle_kb(uint32_t idle_ms) {}
+
 // Only enable this if console is enabled to print to
 #if defined(DEBUG_MATRIX_SCAN_RATE)
 static uint32_t matrix_timer           = 0;
@@ -297,6 +371,9 @@ void housekeeping_task(void) {
 void keyboard_init(void) {
     timer_init();
     sync_timer_init();
+#ifdef PROFILER_ENABLE
+    profiler_init();
+#endif
 #ifdef VIA_ENABLE
     via_init();
 #endif
@@ -363,6 +440,97 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
 #endif
 }
 
+#ifndef MATRIX_EVENT_QUEUE_SIZE
+#    ifdef QMK_KEYS_PER_SCAN
+#        define MATRIX_EVENT_QUEUE_SIZE QMK_KEYS_PER_SCAN
+#    else
+#        define MATRIX_EVENT_QUEUE_SIZE 16
+#    endif
+#endif
+
+_Static_assert(MATRIX_EVENT_QUEUE_SIZE > 0 && MATRIX_EVENT_QUEUE_SIZE <= 255, "MATRIX_EVENT_QUEUE_SIZE must be between 1 and 255");
+
+static keyevent_t matrix_event_queue[MATRIX_EVENT_QUEUE_SIZE];
+static uint8_t    matrix_event_count = 0;
+
+/** \brief matrix_collect_events
+ *
+ * Compare the current matrix against the last processed state and queue every
+ * changed key, in row/column order, each stamped with the time it was seen.
+ * Changes that do not fit in the queue are left pending for the next scan.
+ *
+ * With SPLIT_TRANSPORT_EVENTS the other half's own events are queued first, with
+ * the time they happened at, so short taps and their order survive the trip.
+ */
+static void matrix_collect_events(matrix_row_t matrix_prev[]) {
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSPORT_EVENTS)
+    static uint16_t last_scan = 0;
+    uint16_t        since     = last_scan;
+    keyevent_t      event;
+
+    last_scan = timer_read();
+    while (matrix_event_count < MATRIX_EVENT_QUEUE_SIZE && transactions_slave_event(&event)) {
+        matrix_row_t col_mask = MATRIX_ROW_SHIFTER << event.key.col;
+        if (!(matrix_prev[event.key.row] & col_mask) == !event.pressed) {
+            // already picked up from the matrix
+            continue;
+        }
+        // Never older than what the previous scan processed, tapping relies on event times going forward
+        if (!timer_expired(event.time, since)) {
+            event.time = since | 1;
+        }
+        matrix_event_queue[matrix_event_count++] = event;
+        matrix_prev[event.key.row] ^= col_mask;
+    }
+#endif
+    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
+        matrix_row_t matrix_row    = matrix_get_row(r);
+        matrix_row_t matrix_change = matrix_row ^ matrix_prev[r];
+        if (!matrix_change) {
+            continue;
+        }
+#ifdef MATRIX_HAS_GHOST
+        if (has_ghost_in_row(r, matrix_row)) {
+            continue;
+        }
+#endif
+        if (debug_matrix) matrix_print();
+        matrix_row_t col_mask = 1;
+        for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
+            if (matrix_change & col_mask) {
+                if (matrix_event_count >= MATRIX_EVENT_QUEUE_SIZE) {
+                    return;
+                }
+                matrix_event_queue[matrix_event_count++] = (keyevent_t){
+                    .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
+                };
+                // record a queued key
+                matrix_prev[r] ^= col_mask;
+            }
+        }
+    }
+}
+
+/** \brief matrix_process_events
+ *
+ * Drain the event queue through the action pipeline in one pass.
+ * Returns the number of events processed.
+ */
+static uint8_t matrix_process_events(void) {
+    uint8_t count = matrix_event_count;
+    for (uint8_t i = 0; i < count; i++) {
+        keyevent_t event = matrix_event_queue[i];
+        if (should_process_keypress()) {
+            PROFILER_BEGIN(ACTION_EXEC);
+            action_exec(event);
+            PROFILER_END(ACTION_EXEC);
+        }
+        switch_events(event.key.row, event.key.col, event.pressed);
+    }
+    matrix_event_count = 0;
+    return count;
+}
+
 /** \brief Keyboard task: Do keyboard routine jobs
  *
  * Do routine keyboard jobs:
@@ -376,67 +544,35 @@ void switch_events(uint8_t row, uint8_t col, bool pressed) {
  */
 void keyboard_task(void) {
     static matrix_row_t matrix_prev[MATRIX_ROWS];
-    static uint8_t      led_status    = 0;
-    matrix_row_t        matrix_row    = 0;
-    matrix_row_t        matrix_change = 0;
-#ifdef QMK_KEYS_PER_SCAN
-    uint8_t keys_processed = 0;
-#endif
+    static uint8_t      led_status = 0;
 #ifdef ENCODER_ENABLE
     bool encoders_changed = false;
 #endif
 
+    PROFILER_BEGIN(KEYBOARD_TASK);
+
+    PROFILER_BEGIN(MATRIX_SCAN);
     uint8_t matrix_changed = matrix_scan();
+    PROFILER_END(MATRIX_SCAN);
     if (matrix_changed) last_matrix_activity_trigger();
 
-    for (uint8_t r = 0; r < MATRIX_ROWS; r++) {
-        matrix_row    = matrix_get_row(r);
-        matrix_change = matrix_row ^ matrix_prev[r];
-        if (matrix_change) {
-#ifdef MATRIX_HAS_GHOST
-            if (has_ghost_in_row(r, matrix_row)) {
-                continue;
-            }
-#endif
-            if (debug_matrix) matrix_print();
-            matrix_row_t col_mask = 1;
-            for (uint8_t c = 0; c < MATRIX_COLS; c++, col_mask <<= 1) {
-                if (matrix_change & col_mask) {
-                    if (should_process_keypress()) {
-                        action_exec((keyevent_t){
-                            .key = (keypos_t){.row = r, .col = c}, .pressed = (matrix_row & col_mask), .time = (timer_read() | 1) /* time should not be 0 */
-                        });
-                    }
-                    // record a processed key
-                    matrix_prev[r] ^= col_mask;
-
-                    switch_events(r, c, (matrix_row & col_mask));
-
-#ifdef QMK_KEYS_PER_SCAN
-                    // only jump out if we have processed "enough" keys.
-                    if (++keys_processed >= QMK_KEYS_PER_SCAN)
-#endif
-                        // process a key per task call
-                        goto MATRIX_LOOP_END;
-                }
-            }
-        }
-    }
+    matrix_collect_events(matrix_prev);
+
     // call with pseudo tick event when no real key event.
-#ifdef QMK_KEYS_PER_SCAN
-    // we can get here with some keys processed now.
-    if (!keys_processed)
-#endif
+    if (!matrix_process_events()) {
+        PROFILER_BEGIN(ACTION_TICK);
         action_exec(TICK);
-
-MATRIX_LOOP_END:
+        PROFILER_END(ACTION_TICK);
+    }
 
 #ifdef DEBUG_MATRIX_SCAN_RATE
     matrix_scan_perf_task();
 #endif
 
 #if defined(RGBLIGHT_ENABLE)
+    PROFILER_BEGIN(RGBLIGHT_TASK);
     rgblight_task();
+    PROFILER_END(RGBLIGHT_TASK);
 #endif
 
 #ifdef LED_MATRIX_ENABLE
@@ -483,7 +619,10 @@ MATRIX_LOOP_END:
 
 #ifdef MOUSEKEY_ENABLE
     // mousekey repeat & acceleration
-    mousekey_task();
+    static task_schedule_t mousekey_schedule;
+    if (task_schedule_due(&mousekey_schedule)) {
+        task_schedule_update(&mousekey_schedule, mousekey_task());
+    }
 #endif
 
 #ifdef PS2_MOUSE_ENABLE
@@ -516,11 +655,21 @@ MATRIX_LOOP_END:
     programmable_button_send();
 #endif
 
+#ifdef EEPROM_DRIVER
+    eeprom_driver_task();
+#endif
+
     // update LED
     if (led_status != host_keyboard_leds()) {
         led_status = host_keyboard_leds();
         keyboard_set_leds(led_status);
     }
+
+    PROFILER_END(KEYBOARD_TASK);
+
+#ifdef PROFILER_ENABLE
+    profiler_task();
+#endif
 }
 
 /** \brief keyboard set leds
@@ -85,6 +85,31 @@ uint32_t last_encoder_activity_elapsed(void);  // Number of milliseconds since t
 
 uint32_t get_matrix_scan_rate(void);
 
+/* Task scheduling
+ *
+ * Tasks that know when they next need to run return the number of milliseconds until then,
+ * TASK_RUN_ALWAYS to run on every main loop iteration, or TASK_IDLE if nothing is pending
+ * until new input arrives. The caller keeps a task_schedule_t per task and skips the task
+ * until its deadline has passed or task_schedule_wake() has been called.
+ */
+#define TASK_RUN_ALWAYS 0
+#define TASK_IDLE UINT32_MAX
+
+typedef struct task_schedule_t {
+    struct task_schedule_t *next;
+    uint32_t                next_run;
+    uint16_t                wake_count;
+    bool                    idle;
+    bool                    registered;
+} task_schedule_t;
+
+bool     task_schedule_due(task_schedule_t *schedule);                       // Whether the task needs to run now
+void     task_schedule_update(task_schedule_t *schedule, uint32_t delay_ms);  // Record the value returned by the task
+void     task_schedule_wake(void);                                           // New input: run every scheduled task on the next loop
+uint32_t task_schedule_idle_time(void);                                      // Milliseconds until the earliest scheduled deadline, or TASK_IDLE
+
+void keyboard_idle_kb(uint32_t idle_ms);  // To be overridden by keyboard-level code that can sleep between scans
+
 #ifdef __cplusplus
 }
 #endif
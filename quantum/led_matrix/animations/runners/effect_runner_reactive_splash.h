@@ -4,23 +4,98 @@
 
 typedef uint8_t (*reactive_splash_f)(uint8_t val, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick);
 
-bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) {
+// How far from a hit, inclusive, an effect can still change an LED. Empty (min > max) once the hit has died down.
+typedef struct {
+    uint8_t min;
+    uint8_t max;
+} splash_reach_t;
+
+typedef splash_reach_t (*reactive_splash_reach_f)(uint16_t tick);
+
+splash_reach_t reactive_splash_reach(int32_t min, int32_t max) {
+    splash_reach_t reach = {1, 0};
+    if (min < 0) min = 0;
+    if (max > 255) max = 255;
+    if (min <= max) {
+        reach.min = min;
+        reach.max = max;
+    }
+    return reach;
+}
+
+typedef struct {
+    uint8_t  x;
+    uint8_t  y;
+    uint8_t  left;
+    uint8_t  right;
+    uint8_t  top;
+    uint8_t  bottom;
+    uint16_t tick;
+    uint16_t min_dist_sq;
+    uint32_t max_dist_sq;
+} splash_hit_t;
+
+static splash_hit_t splash_hits[LED_HITS_TO_REMEMBER];
+
+// Only calls effect_func for the LEDs within reach of each hit, which have to be the only ones it changes
+bool effect_runner_reactive_splash_culled(uint8_t start, effect_params_t* params, reactive_splash_f effect_func, reactive_splash_reach_f reach_func) {
     LED_MATRIX_USE_LIMITS(led_min, led_max);
 
-    uint8_t count = g_last_hit_tracker.count;
+    // Hits that have died down are left out, the rest get the box and ring of LEDs they can reach
+    uint8_t count = 0;
+    uint8_t left = 255, right = 0, top = 255, bottom = 0;
+    for (uint8_t j = start; j < g_last_hit_tracker.count; j++) {
+        splash_hit_t* hit = &splash_hits[count];
+        hit->x            = g_last_hit_tracker.x[j];
+        hit->y            = g_last_hit_tracker.y[j];
+        hit->tick         = scale16by8(g_last_hit_tracker.tick[j], led_matrix_eeconfig.speed);
+        if (reach_func) {
+            splash_reach_t reach = reach_func(hit->tick);
+            if (reach.min > reach.max) continue;
+            hit->left        = qsub8(hit->x, reach.max);
+            hit->right       = qadd8(hit->x, reach.max);
+            hit->top         = qsub8(hit->y, reach.max);
+            hit->bottom      = qadd8(hit->y, reach.max);
+            hit->min_dist_sq = (uint16_t)reach.min * reach.min;
+            hit->max_dist_sq = (uint32_t)(reach.max + 1) * (reach.max + 1) - 1;
+        } else {
+            hit->left        = 0;
+            hit->right       = 255;
+            hit->top         = 0;
+            hit->bottom      = 255;
+            hit->min_dist_sq = 0;
+            hit->max_dist_sq = UINT32_MAX;
+        }
+        if (hit->left < left) left = hit->left;
+        if (hit->right > right) right = hit->right;
+        if (hit->top < top) top = hit->top;
+        if (hit->bottom > bottom) bottom = hit->bottom;
+        count++;
+    }
+
     for (uint8_t i = led_min; i < led_max; i++) {
         LED_MATRIX_TEST_LED_FLAGS();
+        uint8_t x = g_led_config.point[i].x;
+        uint8_t y = g_led_config.point[i].y;
+        if (x < left || x > right || y < top || y > bottom) {
+            led_matrix_set_value(i, 0);
+            continue;
+        }
         uint8_t val = 0;
-        for (uint8_t j = start; j < count; j++) {
-            int16_t  dx   = g_led_config.point[i].x - g_last_hit_tracker.x[j];
-            int16_t  dy   = g_led_config.point[i].y - g_last_hit_tracker.y[j];
-            uint8_t  dist = sqrt16(dx * dx + dy * dy);
-            uint16_t tick = scale16by8(g_last_hit_tracker.tick[j], led_matrix_eeconfig.speed);
-            val           = effect_func(val, dx, dy, dist, tick);
+        for (uint8_t j = 0; j < count; j++) {
+            splash_hit_t* hit = &splash_hits[j];
+            if (x < hit->left || x > hit->right || y < hit->top || y > hit->bottom) continue;
+            int16_t  dx      = x - hit->x;
+            int16_t  dy      = y - hit->y;
+            uint32_t dist_sq = (int32_t)dx * dx + (int32_t)dy * dy;
+            if (dist_sq < hit->min_dist_sq || dist_sq > hit->max_dist_sq) continue;
+            val = effect_func(val, dx, dy, sqrt16(dist_sq), hit->tick);
         }
         led_matrix_set_value(i, scale8(val, led_matrix_eeconfig.val));
     }
     return led_matrix_check_finished_leds(led_max);
 }
 
+bool effect_runner_reactive_splash(uint8_t start, effect_params_t* params, reactive_splash_f effect_func) { return effect_runner_reactive_splash_culled(start, params, effect_func, NULL); }
+
 #endif  // LED_MATRIX_KEYREACTIVE_ENABLED
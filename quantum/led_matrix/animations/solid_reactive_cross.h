@@ -22,12 +22,15 @@ static uint8_t SOLID_REACTIVE_CROSS_math(uint8_t val, int16_t dx, int16_t dy, ui
     return qadd8(val, 255 - effect);
 }
 
+// tick + dist has to stay below 255
+static splash_reach_t SOLID_REACTIVE_CROSS_reach(uint16_t tick) { return reactive_splash_reach(0, 254 - (int32_t)tick); }
+
 #            ifdef ENABLE_LED_MATRIX_SOLID_REACTIVE_CROSS
-bool SOLID_REACTIVE_CROSS(effect_params_t* params) { return effect_runner_reactive_splash(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_CROSS_math); }
+bool SOLID_REACTIVE_CROSS(effect_params_t* params) { return effect_runner_reactive_splash_culled(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_CROSS_math, &SOLID_REACTIVE_CROSS_reach); }
 #            endif
 
 #            ifdef ENABLE_LED_MATRIX_SOLID_REACTIVE_MULTICROSS
-bool SOLID_REACTIVE_MULTICROSS(effect_params_t* params) { return effect_runner_reactive_splash(0, params, &SOLID_REACTIVE_CROSS_math); }
+bool SOLID_REACTIVE_MULTICROSS(effect_params_t* params) { return effect_runner_reactive_splash_culled(0, params, &SOLID_REACTIVE_CROSS_math, &SOLID_REACTIVE_CROSS_reach); }
 #            endif
 
 #        endif  // LED_MATRIX_CUSTOM_EFFECT_IMPLS
@@ -19,12 +19,15 @@ static uint8_t SOLID_REACTIVE_NEXUS_math(uint8_t val, int16_t dx, int16_t dy, ui
     return qadd8(val, 255 - effect);
 }
 
+// tick - dist has to stay between 0 and 254, no further than 72 out
+static splash_reach_t SOLID_REACTIVE_NEXUS_reach(uint16_t tick) { return reactive_splash_reach((int32_t)tick - 254, tick < 72 ? tick : 72); }
+
 #            ifdef ENABLE_LED_MATRIX_SOLID_REACTIVE_NEXUS
-bool SOLID_REACTIVE_NEXUS(effect_params_t* params) { return effect_runner_reactive_splash(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_NEXUS_math); }
+bool SOLID_REACTIVE_NEXUS(effect_params_t* params) { return effect_runner_reactive_splash_culled(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_NEXUS_math, &SOLID_REACTIVE_NEXUS_reach); }
 #            endif
 
 #            ifdef ENABLE_LED_MATRIX_SOLID_REACTIVE_MULTINEXUS
-bool SOLID_REACTIVE_MULTINEXUS(effect_params_t* params) { return effect_runner_reactive_splash(0, params, &SOLID_REACTIVE_NEXUS_math); }
+bool SOLID_REACTIVE_MULTINEXUS(effect_params_t* params) { return effect_runner_reactive_splash_culled(0, params, &SOLID_REACTIVE_NEXUS_math, &SOLID_REACTIVE_NEXUS_reach); }
 #            endif
 
 #        endif  // LED_MATRIX_CUSTOM_EFFECT_IMPLS
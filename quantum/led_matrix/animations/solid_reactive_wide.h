@@ -17,12 +17,15 @@ static uint8_t SOLID_REACTIVE_WIDE_math(uint8_t val, int16_t dx, int16_t dy, uin
     return qadd8(val, 255 - effect);
 }
 
+// tick + dist * 5 has to stay below 255
+static splash_reach_t SOLID_REACTIVE_WIDE_reach(uint16_t tick) { return reactive_splash_reach(0, tick < 255 ? (254 - tick) / 5 : -1); }
+
 #            ifdef ENABLE_LED_MATRIX_SOLID_REACTIVE_WIDE
-bool SOLID_REACTIVE_WIDE(effect_params_t* params) { return effect_runner_reactive_splash(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_WIDE_math); }
+bool SOLID_REACTIVE_WIDE(effect_params_t* params) { return effect_runner_reactive_splash_culled(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_WIDE_math, &SOLID_REACTIVE_WIDE_reach); }
 #            endif
 
 #            ifdef ENABLE_LED_MATRIX_SOLID_REACTIVE_MULTIWIDE
-bool SOLID_REACTIVE_MULTIWIDE(effect_params_t* params) { return effect_runner_reactive_splash(0, params, &SOLID_REACTIVE_WIDE_math); }
+bool SOLID_REACTIVE_MULTIWIDE(effect_params_t* params) { return effect_runner_reactive_splash_culled(0, params, &SOLID_REACTIVE_WIDE_math, &SOLID_REACTIVE_WIDE_reach); }
 #            endif
 
 #        endif  // LED_MATRIX_CUSTOM_EFFECT_IMPLS
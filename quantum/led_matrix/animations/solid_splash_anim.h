@@ -17,12 +17,15 @@ uint8_t SOLID_SPLASH_math(uint8_t val, int16_t dx, int16_t dy, uint8_t dist, uin
     return qadd8(val, 255 - effect);
 }
 
+// tick - dist has to stay between 0 and 254
+splash_reach_t SOLID_SPLASH_reach(uint16_t tick) { return reactive_splash_reach((int32_t)tick - 254, tick); }
+
 #            ifdef ENABLE_LED_MATRIX_SOLID_SPLASH
-bool SOLID_SPLASH(effect_params_t* params) { return effect_runner_reactive_splash(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_SPLASH_math); }
+bool SOLID_SPLASH(effect_params_t* params) { return effect_runner_reactive_splash_culled(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_SPLASH_math, &SOLID_SPLASH_reach); }
 #            endif
 
 #            ifdef ENABLE_LED_MATRIX_SOLID_MULTISPLASH
-bool SOLID_MULTISPLASH(effect_params_t* params) { return effect_runner_reactive_splash(0, params, &SOLID_SPLASH_math); }
+bool SOLID_MULTISPLASH(effect_params_t* params) { return effect_runner_reactive_splash_culled(0, params, &SOLID_SPLASH_math, &SOLID_SPLASH_reach); }
 #            endif
 
 #        endif  // LED_MATRIX_CUSTOM_EFFECT_IMPLS
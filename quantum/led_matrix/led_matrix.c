@@ -21,6 +21,7 @@
 #include "progmem.h"
 #include "config.h"
 #include "eeprom.h"
+#include "profiler.h"
 #include <string.h>
 #include <math.h>
 #include "led_tables.h"
@@ -90,6 +91,7 @@ const led_point_t k_led_matrix_center = LED_MATRIX_CENTER;
 // globals
 led_eeconfig_t led_matrix_eeconfig;  // TODO: would like to prefix this with g_ for global consistancy, do this in another pr
 uint32_t       g_led_timer;
+led_polar_t    g_led_polar[DRIVER_LED_TOTAL];
 #ifdef LED_MATRIX_FRAMEBUFFER_EFFECTS
 uint8_t g_led_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #endif  // LED_MATRIX_FRAMEBUFFER_EFFECTS
@@ -174,6 +176,18 @@ void led_matrix_set_value_all(uint8_t value) {
 #endif
 }
 
+#ifdef LED_MATRIX_KEYREACTIVE_ENABLED
+// Hits are kept oldest first, so the ones to forget are always at the front
+static void last_hit_forget(uint8_t count) {
+    uint8_t keep = last_hit_buffer.count - count;
+    memmove(&last_hit_buffer.x[0], &last_hit_buffer.x[count], keep);
+    memmove(&last_hit_buffer.y[0], &last_hit_buffer.y[count], keep);
+    memmove(&last_hit_buffer.tick[0], &last_hit_buffer.tick[count], keep * 2);  // 16 bit
+    memmove(&last_hit_buffer.index[0], &last_hit_buffer.index[count], keep);
+    last_hit_buffer.count = keep;
+}
+#endif  // LED_MATRIX_KEYREACTIVE_ENABLED
+
 void process_led_matrix(uint8_t row, uint8_t col, bool pressed) {
 #ifndef LED_MATRIX_SPLIT
     if (!is_keyboard_master()) return;
@@ -196,11 +210,7 @@ void process_led_matrix(uint8_t row, uint8_t col, bool pressed) {
     }
 
     if (last_hit_buffer.count + led_count > LED_HITS_TO_REMEMBER) {
-        memcpy(&last_hit_buffer.x[0], &last_hit_buffer.x[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.y[0], &last_hit_buffer.y[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.tick[0], &last_hit_buffer.tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2);  // 16 bit
-        memcpy(&last_hit_buffer.index[0], &last_hit_buffer.index[led_count], LED_HITS_TO_REMEMBER - led_count);
-        last_hit_buffer.count = LED_HITS_TO_REMEMBER - led_count;
+        last_hit_forget(last_hit_buffer.count + led_count - LED_HITS_TO_REMEMBER);
     }
 
     for (uint8_t i = 0; i < led_count; i++) {
@@ -248,14 +258,15 @@ static void led_task_timers(void) {
 
     // Update double buffer last hit timers
 #ifdef LED_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t count = last_hit_buffer.count;
-    for (uint8_t i = 0; i < count; ++i) {
-        if (UINT16_MAX - deltaTime < last_hit_buffer.tick[i]) {
-            last_hit_buffer.count--;
+    uint8_t expired = 0;
+    for (uint8_t i = 0; i < last_hit_buffer.count; ++i) {
+        if (last_hit_buffer.tick[i] + deltaTime > UINT16_MAX) {
+            expired = i + 1;
             continue;
         }
         last_hit_buffer.tick[i] += deltaTime;
     }
+    last_hit_forget(expired);
 #endif  // LED_MATRIX_KEYREACTIVE_ENABLED
 }
 
@@ -362,14 +373,18 @@ void led_matrix_task(void) {
             led_task_start();
             break;
         case RENDERING:
+            PROFILER_BEGIN(LED_MATRIX_RENDER);
             led_task_render(effect);
             if (effect) {
                 led_matrix_indicators();
                 led_matrix_indicators_advanced(&led_effect_params);
             }
+            PROFILER_END(LED_MATRIX_RENDER);
             break;
         case FLUSHING:
+            PROFILER_BEGIN(LED_MATRIX_FLUSH);
             led_task_flush(effect);
+            PROFILER_END(LED_MATRIX_FLUSH);
             break;
         case SYNCING:
             led_task_sync();
@@ -408,8 +423,18 @@ __attribute__((weak)) void led_matrix_indicators_advanced_kb(uint8_t led_min, ui
 
 __attribute__((weak)) void led_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {}
 
+void led_matrix_update_geometry(void) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        int16_t dx           = g_led_config.point[i].x - k_led_matrix_center.x;
+        int16_t dy           = g_led_config.point[i].y - k_led_matrix_center.y;
+        g_led_polar[i].dist  = sqrt16(dx * dx + dy * dy);
+        g_led_polar[i].angle = atan2_8(dy, dx);
+    }
+}
+
 void led_matrix_init(void) {
     led_matrix_driver.init();
+    led_matrix_update_geometry();
 
 #ifdef LED_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
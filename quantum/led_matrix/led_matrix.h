@@ -120,6 +120,9 @@ void led_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max);
 
 void led_matrix_init(void);
 
+// Works out g_led_polar again, for boards that move g_led_config.point around after led_matrix_init
+void led_matrix_update_geometry(void);
+
 void        led_matrix_set_suspend_state(bool state);
 bool        led_matrix_get_suspend_state(void);
 void        led_matrix_toggle(void);
@@ -183,6 +186,7 @@ extern led_eeconfig_t led_matrix_eeconfig;
 
 extern uint32_t     g_led_timer;
 extern led_config_t g_led_config;
+extern led_polar_t  g_led_polar[DRIVER_LED_TOTAL];
 #ifdef LED_MATRIX_KEYREACTIVE_ENABLED
 extern last_hit_t g_last_hit_tracker;
 #endif
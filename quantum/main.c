@@ -44,7 +44,7 @@ void protocol_task(void) {
 }
 
 #ifdef DEFERRED_EXEC_ENABLE
-void deferred_exec_task(void);
+uint32_t deferred_exec_task(void);
 #endif  // DEFERRED_EXEC_ENABLE
 
 /** \brief Main
@@ -65,9 +65,14 @@ int main(void) {
 
 #ifdef DEFERRED_EXEC_ENABLE
         // Run deferred executions
-        deferred_exec_task();
+        static task_schedule_t deferred_exec_schedule;
+        if (task_schedule_due(&deferred_exec_schedule)) {
+            task_schedule_update(&deferred_exec_schedule, deferred_exec_task());
+        }
 #endif  // DEFERRED_EXEC_ENABLE
 
         housekeeping_task();
+
+        keyboard_idle_kb(task_schedule_idle_time());
     }
 }
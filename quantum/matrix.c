@@ -21,6 +21,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "matrix.h"
 #include "debounce.h"
 #include "quantum.h"
+#include "profiler.h"
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
 #    include "split_common/transactions.h"
@@ -314,7 +315,7 @@ bool matrix_post_scan(void) {
     if (is_keyboard_master()) {
         static bool  last_connected              = false;
         matrix_row_t slave_matrix[ROWS_PER_HAND] = {0};
-        if (transport_master_if_connected(matrix + thisHand, slave_matrix)) {
+        if (PROFILED(SPLIT_TRANSACTIONS, transport_master_if_connected(matrix + thisHand, slave_matrix))) {
             changed = memcmp(matrix + thatHand, slave_matrix, sizeof(slave_matrix)) != 0;
 
             last_connected = true;
@@ -330,7 +331,9 @@ bool matrix_post_scan(void) {
 
         matrix_scan_quantum();
     } else {
+        PROFILER_BEGIN(SPLIT_TRANSACTIONS);
         transport_slave(matrix + thatHand, matrix + thisHand);
+        PROFILER_END(SPLIT_TRANSACTIONS);
 
         matrix_slave_scan_kb();
     }
@@ -358,11 +361,14 @@ uint8_t matrix_scan(void) {
     bool changed = memcmp(raw_matrix, curr_matrix, sizeof(curr_matrix)) != 0;
     if (changed) memcpy(raw_matrix, curr_matrix, sizeof(curr_matrix));
 
+    PROFILER_BEGIN(DEBOUNCE);
 #ifdef SPLIT_KEYBOARD
     debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed);
+    PROFILER_END(DEBOUNCE);
     changed = (changed || matrix_post_scan());
 #else
     debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
+    PROFILER_END(DEBOUNCE);
     matrix_scan_quantum();
 #endif
     return (uint8_t)changed;
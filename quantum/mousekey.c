@@ -21,6 +21,7 @@
 #include "timer.h"
 #include "print.h"
 #include "debug.h"
+#include "keyboard.h"
 #include "mousekey.h"
 
 inline int8_t times_inv_sqrt2(int8_t x) {
@@ -33,6 +34,7 @@ inline int8_t times_inv_sqrt2(int8_t x) {
 
 static report_mouse_t mouse_report = {0};
 static void           mousekey_debug(void);
+static uint32_t       mousekey_next_run(uint16_t c_timer, uint16_t c_interval, uint16_t w_timer, uint16_t w_interval);
 static uint8_t        mousekey_accel        = 0;
 static uint8_t        mousekey_repeat       = 0;
 static uint8_t        mousekey_wheel_repeat = 0;
@@ -207,7 +209,7 @@ static uint8_t wheel_unit(void) {
 #        endif /* #ifndef MK_KINETIC_SPEED */
 #    endif     /* #ifndef MK_COMBINED */
 
-void mousekey_task(void) {
+uint32_t mousekey_task(void) {
     // report cursor and scroll movement independently
     report_mouse_t const tmpmr = mouse_report;
 
@@ -253,6 +255,8 @@ void mousekey_task(void) {
 
     if (mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h) mousekey_send();
     mouse_report = tmpmr;
+
+    return mousekey_next_run(last_timer_c, mousekey_repeat ? mk_interval : mk_delay * 10, last_timer_w, mousekey_wheel_repeat ? mk_wheel_interval : mk_wheel_delay * 10);
 }
 
 void mousekey_on(uint8_t code) {
@@ -286,9 +290,12 @@ void mousekey_on(uint8_t code) {
         mousekey_accel |= (1 << 1);
     else if (code == KC_MS_ACCEL2)
         mousekey_accel |= (1 << 2);
+    // mousekey_task() may be idle, and not every caller goes through action_exec()
+    task_schedule_wake();
 }
 
 void mousekey_off(uint8_t code) {
+    bool const moving = mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h;
     if (code == KC_MS_UP && mouse_report.y < 0)
         mouse_report.y = 0;
     else if (code == KC_MS_DOWN && mouse_report.y > 0)
@@ -320,6 +327,7 @@ void mousekey_off(uint8_t code) {
 #    endif /* #ifdef MK_KINETIC_SPEED */
     }
     if (mouse_report.v == 0 && mouse_report.h == 0) mousekey_wheel_repeat = 0;
+    if (moving && !(mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h)) task_schedule_wake();
 }
 
 #else /* #ifndef MK_3_SPEED */
@@ -338,7 +346,7 @@ uint16_t        c_intervals[mkspd_COUNT] = {MK_C_INTERVAL_UNMOD, MK_C_INTERVAL_0
 uint16_t        w_offsets[mkspd_COUNT]   = {MK_W_OFFSET_UNMOD, MK_W_OFFSET_0, MK_W_OFFSET_1, MK_W_OFFSET_2};
 uint16_t        w_intervals[mkspd_COUNT] = {MK_W_INTERVAL_UNMOD, MK_W_INTERVAL_0, MK_W_INTERVAL_1, MK_W_INTERVAL_2};
 
-void mousekey_task(void) {
+uint32_t mousekey_task(void) {
     // report cursor and scroll movement independently
     report_mouse_t const tmpmr = mouse_report;
     mouse_report.x             = 0;
@@ -357,6 +365,8 @@ void mousekey_task(void) {
 
     if (mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h) mousekey_send();
     mouse_report = tmpmr;
+
+    return mousekey_next_run(last_timer_c, c_intervals[mk_speed], last_timer_w, w_intervals[mk_speed]);
 }
 
 void adjust_speed(void) {
@@ -416,9 +426,12 @@ void mousekey_on(uint8_t code) {
     else if (code == KC_MS_ACCEL2)
         mk_speed = mkspd_2;
     if (mk_speed != old_speed) adjust_speed();
+    // mousekey_task() may be idle, and not every caller goes through action_exec()
+    task_schedule_wake();
 }
 
 void mousekey_off(uint8_t code) {
+    bool const moving = mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h;
 #    ifdef MK_MOMENTARY_ACCEL
     uint8_t const old_speed = mk_speed;
 #    endif
@@ -449,6 +462,7 @@ void mousekey_off(uint8_t code) {
         mk_speed = mkspd_DEFAULT;
     if (mk_speed != old_speed) adjust_speed();
 #    endif
+    if (moving && !(mouse_report.x || mouse_report.y || mouse_report.v || mouse_report.h)) task_schedule_wake();
 }
 
 #endif /* #ifndef MK_3_SPEED */
@@ -468,6 +482,21 @@ void mousekey_clear(void) {
     mousekey_accel        = 0;
 }
 
+// Milliseconds until a movement report is next due, given the timer and interval of the cursor and wheel
+static uint32_t mousekey_next_run(uint16_t c_timer, uint16_t c_interval, uint16_t w_timer, uint16_t w_interval) {
+    uint32_t next_run = TASK_IDLE;
+    if (mouse_report.x || mouse_report.y) {
+        uint16_t elapsed = timer_elapsed(c_timer);
+        next_run         = elapsed > c_interval ? 0 : c_interval - elapsed + 1;
+    }
+    if (mouse_report.v || mouse_report.h) {
+        uint16_t elapsed = timer_elapsed(w_timer);
+        uint32_t w_next  = elapsed > w_interval ? 0 : w_interval - elapsed + 1;
+        if (w_next < next_run) next_run = w_next;
+    }
+    return next_run;
+}
+
 static void mousekey_debug(void) {
     if (!debug_mouse) return;
     print("mousekey [btn|x y v h](rep/acl): [");
@@ -18,6 +18,7 @@
 
 #include "pointing_device.h"
 #include <string.h>
+#include "timer.h"
 #ifdef MOUSEKEY_ENABLE
 #    include "mousekey.h"
 #endif
@@ -25,8 +26,49 @@
 #    error More than one rotation selected.  This is not supported.
 #endif
 
+#ifndef POINTING_DEVICE_MOTION_SCALE
+#    define POINTING_DEVICE_MOTION_SCALE 256
+#endif
+
+// Motion is accumulated in 1/256 of a count, so scaling never drops a fraction, and never more than this
+#define MOTION_LIMIT ((int32_t)1 << 30)
+
 static report_mouse_t mouseReport = {};
 
+// Sensor motion added since the last poll, before rotation and scaling
+static int32_t sensor_x = 0, sensor_y = 0;
+// Scaled motion that has not made it into a report yet
+static int32_t  motion_x = 0, motion_y = 0;
+static uint16_t motion_scale = POINTING_DEVICE_MOTION_SCALE;
+
+#ifdef POINTING_DEVICE_TASK_STATS
+#    include "debug.h"
+#    ifdef PROTOCOL_CHIBIOS
+#        include <ch.h>
+#    endif
+// CPU cycles where the port has a realtime counter, milliseconds otherwise
+#    ifndef POINTING_DEVICE_TICKS
+#        if defined(PORT_SUPPORTS_RT) && PORT_SUPPORTS_RT == TRUE
+#            define POINTING_DEVICE_TICKS() port_rt_get_counter_value()
+#        else
+#            define POINTING_DEVICE_TICKS() timer_read32()
+#        endif
+#    endif
+
+static pointing_device_stats_t stats       = {};
+static pointing_device_stats_t last_stats  = {};
+static uint32_t                stats_timer = 0;
+#endif
+
+static int32_t constrain_motion(int32_t value, int32_t limit) { return value < -limit ? -limit : (value > limit ? limit : value); }
+
+// Takes as many whole counts as one report can hold, the rest stays for the next report
+static mouse_xy_report_t take_motion(int32_t *motion) {
+    int32_t counts = constrain_motion(*motion / 256, MOUSE_REPORT_XY_MAX);
+    *motion -= counts * 256;
+    return counts;
+}
+
 extern const pointing_device_driver_t pointing_device_driver;
 
 __attribute__((weak)) bool has_mouse_report_changed(report_mouse_t new, report_mouse_t old) { return memcmp(&new, &old, sizeof(new)); }
@@ -60,6 +102,9 @@ __attribute__((weak)) void pointing_device_send(void) {
     // If you need to do other things, like debugging, this is the place to do it.
     if (has_mouse_report_changed(mouseReport, old_report)) {
         host_mouse_send(&mouseReport);
+#ifdef POINTING_DEVICE_TASK_STATS
+        stats.reports++;
+#endif
     }
     // send it and 0 it out except for buttons, so those stay until they are explicity over-ridden using update_pointing_device
     mouseReport.x = 0;
@@ -70,37 +115,96 @@ __attribute__((weak)) void pointing_device_send(void) {
     memcpy(&old_report, &mouseReport, sizeof(mouseReport));
 }
 
+void pointing_device_add_motion(int16_t x, int16_t y) {
+    sensor_x = constrain_motion(sensor_x + x, INT16_MAX);
+    sensor_y = constrain_motion(sensor_y + y, INT16_MAX);
+}
+
+#ifdef POINTING_DEVICE_TASK_STATS
+static void pointing_device_stats_task(uint32_t start) {
+    stats.ticks += POINTING_DEVICE_TICKS() - start;
+
+    uint32_t timer_now = timer_read32();
+    if (TIMER_DIFF_32(timer_now, stats_timer) >= 1000) {
+#    ifdef CONSOLE_ENABLE
+        if (debug_mouse) dprintf("pointing device: %lu scans, %lu polls, %lu reports, %lu ticks\n", stats.scans, stats.polls, stats.reports, stats.ticks);
+#    endif
+        last_stats  = stats;
+        stats       = (pointing_device_stats_t){};
+        stats_timer = timer_now;
+    }
+}
+
+pointing_device_stats_t pointing_device_get_stats(void) { return last_stats; }
+#endif
+
 __attribute__((weak)) void pointing_device_task(void) {
+#ifdef POINTING_DEVICE_TASK_STATS
+    uint32_t start = POINTING_DEVICE_TICKS();
+    stats.scans++;
+#endif
+#if POINTING_DEVICE_TASK_THROTTLE_MS > 0
+    // Poll on a fixed schedule, so that a slow scan doesn't push every later poll back
+    static uint32_t next_poll = 0;
+    uint32_t        now       = timer_read32();
+    if (!timer_expired32(now, next_poll)) {
+#    ifdef POINTING_DEVICE_TASK_STATS
+        pointing_device_stats_task(start);
+#    endif
+        return;
+    }
+    next_poll += POINTING_DEVICE_TASK_THROTTLE_MS;
+    if (timer_expired32(now, next_poll)) {
+        // More than a poll behind, start over from here rather than catching up
+        next_poll = now + POINTING_DEVICE_TASK_THROTTLE_MS;
+    }
+#endif
+#ifdef POINTING_DEVICE_TASK_STATS
+    stats.polls++;
+#endif
+
     // Gather report info
 #ifdef POINTING_DEVICE_MOTION_PIN
     if (!readPin(POINTING_DEVICE_MOTION_PIN))
 #endif
         mouseReport = pointing_device_driver.get_report(mouseReport);
 
-        // Support rotation of the sensor data
+    // Drivers either fill in the report, or add motion that may not fit one
+    int32_t x = constrain_motion(sensor_x + mouseReport.x, INT16_MAX);
+    int32_t y = constrain_motion(sensor_y + mouseReport.y, INT16_MAX);
+    sensor_x  = 0;
+    sensor_y  = 0;
+
+    // Support rotation of the sensor data
 #if defined(POINTING_DEVICE_ROTATION_90) || defined(POINTING_DEVICE_ROTATION_180) || defined(POINTING_DEVICE_ROTATION_270)
-    int8_t x = mouseReport.x, y = mouseReport.y;
+    int32_t raw_x = x, raw_y = y;
 #    if defined(POINTING_DEVICE_ROTATION_90)
-    mouseReport.x = y;
-    mouseReport.y = -x;
+    x = raw_y;
+    y = -raw_x;
 #    elif defined(POINTING_DEVICE_ROTATION_180)
-    mouseReport.x = -x;
-    mouseReport.y = -y;
+    x = -raw_x;
+    y = -raw_y;
 #    elif defined(POINTING_DEVICE_ROTATION_270)
-    mouseReport.x = -y;
-    mouseReport.y = x;
+    x = -raw_y;
+    y = raw_x;
 #    else
 #        error "How the heck did you get here?!"
 #    endif
 #endif
     // Support Inverting the X and Y Axises
 #if defined(POINTING_DEVICE_INVERT_X)
-    mouseReport.x = -mouseReport.x;
+    x = -x;
 #endif
 #if defined(POINTING_DEVICE_INVERT_Y)
-    mouseReport.y = -mouseReport.y;
+    y = -y;
 #endif
 
+    // Motion that doesn't fit in this report goes out with the next ones
+    motion_x      = constrain_motion(motion_x + x * motion_scale, MOTION_LIMIT);
+    motion_y      = constrain_motion(motion_y + y * motion_scale, MOTION_LIMIT);
+    mouseReport.x = take_motion(&motion_x);
+    mouseReport.y = take_motion(&motion_y);
+
     // allow kb to intercept and modify report
     mouseReport = pointing_device_task_kb(mouseReport);
     // combine with mouse report to ensure that the combined is sent correctly
@@ -109,6 +213,9 @@ __attribute__((weak)) void pointing_device_task(void) {
     mouseReport.buttons            = mouseReport.buttons | mousekey_report.buttons;
 #endif
     pointing_device_send();
+#ifdef POINTING_DEVICE_TASK_STATS
+    pointing_device_stats_task(start);
+#endif
 }
 
 report_mouse_t pointing_device_get_report(void) { return mouseReport; }
@@ -118,3 +225,7 @@ void pointing_device_set_report(report_mouse_t newMouseReport) { mouseReport = n
 uint16_t pointing_device_get_cpi(void) { return pointing_device_driver.get_cpi(); }
 
 void pointing_device_set_cpi(uint16_t cpi) { pointing_device_driver.set_cpi(cpi); }
+
+uint16_t pointing_device_get_motion_scale(void) { return motion_scale; }
+
+void pointing_device_set_motion_scale(uint16_t scale) { motion_scale = scale > INT16_MAX ? INT16_MAX : scale; }
@@ -54,6 +54,14 @@ uint16_t       pointing_device_driver_get_cpi(void);
 void           pointing_device_driver_set_cpi(uint16_t cpi);
 #endif
 
+#ifndef POINTING_DEVICE_TASK_THROTTLE_MS
+#    ifdef USB_POLLING_INTERVAL_MS
+#        define POINTING_DEVICE_TASK_THROTTLE_MS USB_POLLING_INTERVAL_MS
+#    else
+#        define POINTING_DEVICE_TASK_THROTTLE_MS 1
+#    endif
+#endif
+
 typedef struct {
     void (*init)(void);
     report_mouse_t (*get_report)(report_mouse_t mouse_report);
@@ -72,14 +80,29 @@ typedef enum {
     POINTING_DEVICE_BUTTON8,
 } pointing_device_buttons_t;
 
+#ifdef POINTING_DEVICE_TASK_STATS
+typedef struct {
+    uint32_t scans;    // calls to pointing_device_task()
+    uint32_t polls;    // of those, the ones that read the sensor
+    uint32_t reports;  // reports that went to the host
+    uint32_t ticks;    // time spent in pointing_device_task(), see POINTING_DEVICE_TICKS()
+} pointing_device_stats_t;
+#endif
+
 void           pointing_device_init(void);
 void           pointing_device_task(void);
 void           pointing_device_send(void);
 report_mouse_t pointing_device_get_report(void);
 void           pointing_device_set_report(report_mouse_t newMouseReport);
-bool           has_mouse_report_changed(report_mouse_t new, report_mouse_t old);
+bool           has_mouse_report_changed(report_mouse_t new_report, report_mouse_t old_report);
 uint16_t       pointing_device_get_cpi(void);
 void           pointing_device_set_cpi(uint16_t cpi);
+void           pointing_device_add_motion(int16_t x, int16_t y);
+uint16_t       pointing_device_get_motion_scale(void);
+void           pointing_device_set_motion_scale(uint16_t scale);
+#ifdef POINTING_DEVICE_TASK_STATS
+pointing_device_stats_t pointing_device_get_stats(void);
+#endif
 
 void           pointing_device_init_kb(void);
 void           pointing_device_init_user(void);
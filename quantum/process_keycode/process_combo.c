@@ -67,6 +67,30 @@ static queued_combo_t combo_buffer[COMBO_BUFFER_LENGTH];
 
 #define INCREMENT_MOD(i) i = (i + 1) % COMBO_BUFFER_LENGTH
 
+#ifdef COMBO_INDEX_SIZE
+/* Reverse index from keycode to the combos using it, sorted by keycode and
+ * then by combo index so combos are still visited in their declared order.
+ * Each entry packs the combo index above the position of the key in that
+ * combo; the keycode itself is read back from the combo's keys. */
+#    if MAX_COMBO_LENGTH > 16
+#        define COMBO_INDEX_KEY_BITS 5
+#    elif MAX_COMBO_LENGTH > 8
+#        define COMBO_INDEX_KEY_BITS 4
+#    else
+#        define COMBO_INDEX_KEY_BITS 3
+#    endif
+#    define COMBO_INDEX_MAX_COMBOS (1 << (16 - COMBO_INDEX_KEY_BITS))
+#    define COMBO_INDEX_COMBO(entry) ((entry) >> COMBO_INDEX_KEY_BITS)
+#    define COMBO_INDEX_KEY(entry) ((entry) & ((1 << COMBO_INDEX_KEY_BITS) - 1))
+
+typedef uint16_t combo_index_entry_t;
+static combo_index_entry_t combo_index[COMBO_INDEX_SIZE];
+static uint16_t            combo_index_size  = 0;
+static uint16_t            combo_index_len   = 0;
+static bool                combo_index_built = false;
+static bool                combo_index_valid = false;
+#endif
+
 #define COMBO_KEY_POS ((keypos_t){.col = 254, .row = 254})
 
 #ifndef EXTRA_SHORT_COMBOS
@@ -215,7 +239,6 @@ static inline void dump_key_buffer(void) {
     key_buffer_next = key_buffer_size = 0;
 }
 
-#define NO_COMBO_KEYS_ARE_DOWN (0 == COMBO_STATE(combo))
 #define ALL_COMBO_KEYS_ARE_DOWN(state, key_count) (((1 << key_count) - 1) == state)
 #define ONLY_ONE_KEY_IS_DOWN(state) !(state & (state - 1))
 #define KEY_NOT_YET_RELEASED(state, key_index) ((1 << key_index) & state)
@@ -237,6 +260,90 @@ static inline void _find_key_index_and_count(const uint16_t *keys, uint16_t keyc
     }
 }
 
+#ifdef COMBO_INDEX_SIZE
+static inline uint16_t combo_index_keycode(combo_index_entry_t entry) { return pgm_read_word(&key_combos[COMBO_INDEX_COMBO(entry)].keys[COMBO_INDEX_KEY(entry)]); }
+
+static inline bool combo_index_entry_less(combo_index_entry_t a, combo_index_entry_t b) {
+    uint16_t keycode_a = combo_index_keycode(a), keycode_b = combo_index_keycode(b);
+    if (keycode_a != keycode_b) return keycode_a < keycode_b;
+    return a < b;
+}
+
+static uint16_t combo_index_find(uint16_t keycode) {
+    /* Binary search for the first entry of keycode */
+    uint16_t lo = 0, hi = combo_index_size;
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+        if (combo_index_keycode(combo_index[mid]) < keycode) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+#endif
+
+void build_combo_index(void) {
+#ifdef COMBO_INDEX_SIZE
+    uint16_t size = 0;
+
+    combo_index_built = true;
+    combo_index_valid = false;
+    combo_index_len   = COMBO_LEN;
+    combo_index_size  = 0;
+
+    if (COMBO_LEN > COMBO_INDEX_MAX_COMBOS) {
+        dprintf("combo: too many combos to index, scanning all combos\n");
+        return;
+    }
+
+    for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
+        const uint16_t *keys      = key_combos[idx].keys;
+        uint8_t         key_count = 0;
+        while (COMBO_END != pgm_read_word(&keys[key_count])) {
+            key_count++;
+        }
+
+        for (uint8_t key_index = 0; key_index < key_count; key_index++) {
+            uint16_t keycode   = pgm_read_word(&keys[key_index]);
+            bool     duplicate = false;
+            /* A repeated keycode only counts at its last position, same as _find_key_index_and_count */
+            for (uint8_t i = key_index + 1; i < key_count; i++) {
+                if (pgm_read_word(&keys[i]) == keycode) duplicate = true;
+            }
+            if (duplicate) continue;
+
+            if (size == COMBO_INDEX_SIZE) {
+                dprintf("combo: COMBO_INDEX_SIZE too small, scanning all combos\n");
+                return;
+            }
+            combo_index[size++] = idx << COMBO_INDEX_KEY_BITS | key_index;
+        }
+    }
+
+    /* Shell sort: no extra memory and no recursion */
+    uint16_t gap = 1;
+    while (gap < size / 3) {
+        gap = gap * 3 + 1;
+    }
+    for (; gap > 0; gap /= 3) {
+        for (uint16_t i = gap; i < size; i++) {
+            combo_index_entry_t entry = combo_index[i];
+            uint16_t            j     = i;
+            while (j >= gap && combo_index_entry_less(entry, combo_index[j - gap])) {
+                combo_index[j] = combo_index[j - gap];
+                j -= gap;
+            }
+            combo_index[j] = entry;
+        }
+    }
+
+    combo_index_size  = size;
+    combo_index_valid = true;
+#endif
+}
+
 void drop_combo_from_buffer(uint16_t combo_index) {
     /* Mark a combo as processed from the buffer. If the buffer is in the
      * beginning of the buffer, drop it.  */
@@ -350,16 +457,7 @@ combo_t *overlaps(combo_t *combo1, combo_t *combo2) {
     return combo1;
 }
 
-static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index) {
-    uint8_t  key_count = 0;
-    uint16_t key_index = -1;
-    _find_key_index_and_count(combo->keys, keycode, &key_index, &key_count);
-
-    /* Continue processing if key isn't part of current combo. */
-    if (-1 == (int16_t)key_index) {
-        return false;
-    }
-
+static bool process_combo_key(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index, uint8_t key_index, uint8_t key_count) {
     bool key_is_part_of_combo = !COMBO_DISABLED(combo) && is_combo_enabled();
 
     if (record->event.pressed && key_is_part_of_combo) {
@@ -463,9 +561,21 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
     return key_is_part_of_combo;
 }
 
+static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index) {
+    uint8_t  key_count = 0;
+    uint16_t key_index = -1;
+    _find_key_index_and_count(combo->keys, keycode, &key_index, &key_count);
+
+    /* Continue processing if key isn't part of current combo. */
+    if (-1 == (int16_t)key_index) {
+        return false;
+    }
+
+    return process_combo_key(combo, keycode, record, combo_index, key_index, key_count);
+}
+
 bool process_combo(uint16_t keycode, keyrecord_t *record) {
-    bool is_combo_key          = false;
-    bool no_combo_keys_pressed = true;
+    bool is_combo_key = false;
 
     if (keycode == CMB_ON && record->event.pressed) {
         combo_enable();
@@ -487,10 +597,28 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     keycode = keymap_key_to_keycode(COMBO_ONLY_FROM_LAYER, record->event.key);
 #endif
 
-    for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
-        combo_t *combo = &key_combos[idx];
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+#ifdef COMBO_INDEX_SIZE
+    if (!combo_index_built || combo_index_len != COMBO_LEN) {
+        build_combo_index();
+    }
+
+    if (combo_index_valid) {
+        /* Only visit the combos that contain this keycode. */
+        for (uint16_t i = combo_index_find(keycode); i < combo_index_size && combo_index_keycode(combo_index[i]) == keycode; ++i) {
+            uint16_t idx       = COMBO_INDEX_COMBO(combo_index[i]);
+            uint8_t  key_count = COMBO_INDEX_KEY(combo_index[i]) + 1;
+            while (COMBO_END != pgm_read_word(&key_combos[idx].keys[key_count])) {
+                key_count++;
+            }
+            is_combo_key |= process_combo_key(&key_combos[idx], keycode, record, idx, COMBO_INDEX_KEY(combo_index[i]), key_count);
+        }
+    } else
+#endif
+    {
+        for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
+            combo_t *combo = &key_combos[idx];
+            is_combo_key |= process_single_combo(combo, keycode, record, idx);
+        }
     }
 
     if (record->event.pressed && is_combo_key) {
@@ -528,13 +656,17 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     return !is_combo_key;
 }
 
-void combo_task(void) {
+uint32_t combo_task(void) {
     if (!b_combo_enable) {
-        return;
+        return TASK_IDLE;
     }
 
 #ifndef COMBO_NO_TIMER
-    if (timer && timer_elapsed(timer) > longest_term) {
+    if (timer) {
+        uint16_t elapsed = timer_elapsed(timer);
+        if (elapsed <= longest_term) {
+            return longest_term - elapsed + 1;
+        }
         if (combo_buffer_read != combo_buffer_write) {
             apply_combos();
             longest_term = 0;
@@ -544,8 +676,11 @@ void combo_task(void) {
             timer = 0;
             clear_combos();
         }
+        // the replayed keys may have started timers in tasks that already ran this loop
+        task_schedule_wake();
     }
 #endif
+    return TASK_IDLE;
 }
 
 void combo_enable(void) { b_combo_enable = true; }
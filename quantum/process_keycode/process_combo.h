@@ -37,6 +37,10 @@
 #    define COMBO_BUFFER_LENGTH 4
 #endif
 
+#if defined(COMBO_INDEX_SIZE) && (COMBO_INDEX_SIZE < 1 || COMBO_INDEX_SIZE > 65535)
+#    error "COMBO_INDEX_SIZE must be between 1 and 65535"
+#endif
+
 typedef struct {
     const uint16_t *keys;
     uint16_t        keycode;
@@ -72,10 +76,11 @@ typedef struct {
 #define KEYCODE_IS_MOD(code) (IS_MOD(code) || (code >= QK_MODS && code <= QK_MODS_MAX && !(code & QK_BASIC_MAX)))
 
 bool process_combo(uint16_t keycode, keyrecord_t *record);
-void combo_task(void);
+uint32_t combo_task(void);
 void process_combo_event(uint16_t combo_index, bool pressed);
 
 void combo_enable(void);
 void combo_disable(void);
 void combo_toggle(void);
 bool is_combo_enabled(void);
+void build_combo_index(void);
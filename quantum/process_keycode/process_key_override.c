@@ -153,6 +153,7 @@ static void schedule_deferred_register(const uint16_t keycode) {
         defer_delay          = 50;  // 50ms
     }
     deferred_register = keycode;
+    task_schedule_wake();
 }
 
 const key_override_t *clear_active_override(const bool allow_reregister) {
@@ -380,18 +381,22 @@ static bool try_activating_override(const uint16_t keycode, const uint8_t layer,
     return true;
 }
 
-void key_override_task(void) {
+uint32_t key_override_task(void) {
     if (deferred_register == 0) {
-        return;
+        return TASK_IDLE;
     }
 
-    if (timer_elapsed32(defer_reference_time) >= defer_delay) {
-        key_override_printf("Registering deferred key\n");
-        register_code16(deferred_register);
-        deferred_register    = 0;
-        defer_reference_time = 0;
-        defer_delay          = 0;
+    uint32_t elapsed = timer_elapsed32(defer_reference_time);
+    if (elapsed < defer_delay) {
+        return defer_delay - elapsed;
     }
+
+    key_override_printf("Registering deferred key\n");
+    register_code16(deferred_register);
+    deferred_register    = 0;
+    defer_reference_time = 0;
+    defer_delay          = 0;
+    return TASK_IDLE;
 }
 
 bool process_key_override(const uint16_t keycode, const keyrecord_t *const record) {
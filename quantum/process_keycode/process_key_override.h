@@ -107,7 +107,7 @@ bool key_override_is_enabled(void);
 bool process_key_override(const uint16_t keycode, const keyrecord_t *const record);
 
 /** Perform any deferred keys */
-void key_override_task(void);
+uint32_t key_override_task(void);
 
 /**
  *  Preferrably use these macros to create key overrides. They fix many of the options to a standard setting that should satisfy most basic use-cases. Only directly create a key_override_t struct when you really need to.
@@ -163,9 +163,10 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
-void tap_dance_task() {
-    if (highest_td == -1) return;
+uint32_t tap_dance_task() {
+    if (highest_td == -1) return TASK_IDLE;
     uint16_t tap_user_defined;
+    uint32_t next_run = TASK_IDLE;
 
     for (uint8_t i = 0; i <= highest_td; i++) {
         qk_tap_dance_action_t *action = &tap_dance_actions[i];
@@ -178,11 +179,17 @@ void tap_dance_task() {
             tap_user_defined = TAPPING_TERM;
 #endif
         }
-        if (action->state.count && timer_elapsed(action->state.timer) > tap_user_defined) {
-            process_tap_dance_action_on_dance_finished(action);
-            reset_tap_dance(&action->state);
+        if (action->state.count) {
+            uint16_t elapsed = timer_elapsed(action->state.timer);
+            if (elapsed > tap_user_defined) {
+                process_tap_dance_action_on_dance_finished(action);
+                reset_tap_dance(&action->state);
+            } else if ((uint32_t)(tap_user_defined - elapsed + 1) < next_run) {
+                next_run = tap_user_defined - elapsed + 1;
+            }
         }
     }
+    return next_run;
 }
 
 void reset_tap_dance(qk_tap_dance_state_t *state) {
@@ -0,0 +1,217 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include "profiler.h"
+#include "print.h"
+#include "progmem.h"
+#include "timer.h"
+
+#define PROFILER_ZONE(id, name) static const char PROGMEM profiler_zone_name_##id[] = #name;
+#include "profiler_zones.inc"
+#undef PROFILER_ZONE
+
+static const char *const profiler_zone_names[] PROGMEM = {
+#define PROFILER_ZONE(id, name) profiler_zone_name_##id,
+#include "profiler_zones.inc"
+#undef PROFILER_ZONE
+};
+
+// Sized for the longest name
+typedef union {
+#define PROFILER_ZONE(id, name) char id[sizeof(#name)];
+#include "profiler_zones.inc"
+#undef PROFILER_ZONE
+} profiler_zone_name_t;
+
+static profiler_stats_t profiler_stats[PROFILER_ZONE_COUNT];
+
+// When each of the zones that are under way started
+static uint32_t profiler_stack[PROFILER_STACK_DEPTH];
+static uint8_t  profiler_depth = 0;
+
+static uint32_t ticks_per_ms      = 0;
+static uint32_t overhead          = 0;
+static uint32_t calibration_ticks = 0;
+static uint32_t calibration_time  = 0;
+#if PROFILER_DUMP_INTERVAL > 0
+static uint32_t dump_timer = 0;
+#endif
+
+void profiler_init(void) {
+    profiler_clock_init();
+    ticks_per_ms = profiler_clock_rate();
+
+    // What it costs to read the clock, which every recorded time includes once
+    overhead = UINT32_MAX;
+    for (uint8_t i = 0; i < 8; i++) {
+        uint32_t start = profiler_clock_read();
+        uint32_t ticks = profiler_clock_read() - start;
+        if (ticks < overhead) overhead = ticks;
+    }
+
+    calibration_time  = timer_read32();
+    calibration_ticks = profiler_clock_read();
+    profiler_reset();
+}
+
+void profiler_task(void) {
+    if (!profiler_clock_rate()) {
+        uint32_t elapsed = timer_elapsed32(calibration_time);
+        if (elapsed >= 1000) {
+            uint32_t now = profiler_clock_read();
+            // Longer than that and the clock could have wrapped around in between
+            if (elapsed < 2000) {
+                ticks_per_ms = (now - calibration_ticks) / elapsed;
+            }
+            calibration_ticks = now;
+            calibration_time += elapsed;
+        }
+    }
+#if PROFILER_DUMP_INTERVAL > 0
+    if (timer_elapsed32(dump_timer) >= PROFILER_DUMP_INTERVAL) {
+        dump_timer = timer_read32();
+        profiler_dump();
+    }
+#endif
+}
+
+void profiler_reset(void) { memset(profiler_stats, 0, sizeof(profiler_stats)); }
+
+void profiler_enter(void) {
+    if (profiler_depth < UINT8_MAX) profiler_depth++;
+    // Read last, so the bookkeeping isn't part of the zone
+    if (profiler_depth <= PROFILER_STACK_DEPTH) profiler_stack[profiler_depth - 1] = profiler_clock_read();
+}
+
+bool profiler_leave(profiler_zone_t zone, bool result) {
+    uint32_t now = profiler_clock_read();
+    if (profiler_depth) {
+        profiler_depth--;
+        if (profiler_depth < PROFILER_STACK_DEPTH) profiler_record(zone, now - profiler_stack[profiler_depth]);
+    }
+    return result;
+}
+
+void profiler_record(profiler_zone_t zone, uint32_t ticks) {
+    profiler_stats_t *stats = &profiler_stats[zone];
+    if (!stats->count || ticks < stats->min) stats->min = ticks;
+    if (ticks > stats->max) stats->max = ticks;
+    stats->count++;
+    stats->total += ticks;
+
+    uint8_t bucket = 0;
+    for (uint32_t rest = ticks; rest && bucket < PROFILER_HISTOGRAM_BUCKETS - 1; rest >>= 1) {
+        bucket++;
+    }
+    if (stats->histogram[bucket] == UINT16_MAX) {
+        for (uint8_t i = 0; i < PROFILER_HISTOGRAM_BUCKETS; i++) {
+            stats->histogram[i] >>= 1;
+        }
+    }
+    stats->histogram[bucket]++;
+}
+
+const profiler_stats_t *profiler_get_stats(profiler_zone_t zone) { return &profiler_stats[zone]; }
+
+void profiler_get_zone_name(profiler_zone_t zone, char *name, uint8_t size) {
+    if (!size) return;
+    PGM_P   source = (PGM_P)pgm_read_ptr(&profiler_zone_names[zone]);
+    uint8_t i      = 0;
+    for (; i < size - 1; i++) {
+        name[i] = pgm_read_byte(&source[i]);
+        if (!name[i]) return;
+    }
+    name[i] = 0;
+}
+
+uint32_t profiler_get_ticks_per_ms(void) { return ticks_per_ms; }
+
+uint32_t profiler_get_overhead(void) { return overhead; }
+
+static uint32_t profiler_mean(const profiler_stats_t *stats) { return stats->count ? stats->total / stats->count : 0; }
+
+void profiler_dump(void) {
+    char name[sizeof(profiler_zone_name_t)];
+
+    uprintf("profiler: %lu ticks/ms, %lu ticks per clock read\n", ticks_per_ms, overhead);
+    uprintf("%-28s %10s %10s %10s %10s\n", "zone", "count", "min", "mean", "max");
+    for (uint8_t zone = 0; zone < PROFILER_ZONE_COUNT; zone++) {
+        const profiler_stats_t *stats = &profiler_stats[zone];
+        if (!stats->count) continue;
+        profiler_get_zone_name(zone, name, sizeof(name));
+        uprintf("%-28s %10lu %10lu %10lu %10lu\n", name, stats->count, stats->min, profiler_mean(stats), stats->max);
+        // Only the buckets that were hit, as log2 of the ticks they go up to
+        uprintf("  log2:");
+        for (uint8_t bucket = 0; bucket < PROFILER_HISTOGRAM_BUCKETS; bucket++) {
+            if (stats->histogram[bucket]) uprintf(" %u=%u", bucket, stats->histogram[bucket]);
+        }
+        uprintf("\n");
+    }
+}
+
+static void profiler_put32(uint8_t *data, uint32_t value) {
+    data[0] = value;
+    data[1] = value >> 8;
+    data[2] = value >> 16;
+    data[3] = value >> 24;
+}
+
+bool profiler_raw_hid_command(uint8_t *data, uint8_t length) {
+    if (length < 3 || data[0] != PROFILER_RAW_HID_ID) return false;
+    uint8_t  command = data[1];
+    uint8_t  zone    = data[2];
+    uint8_t *reply   = &data[3];
+    uint8_t  size    = length - 3;
+
+    switch (command) {
+        case PROFILER_RAW_HID_INFO:
+            if (size < 10) return false;
+            reply[0] = PROFILER_ZONE_COUNT;
+            reply[1] = PROFILER_HISTOGRAM_BUCKETS;
+            profiler_put32(&reply[2], ticks_per_ms);
+            profiler_put32(&reply[6], overhead);
+            return true;
+        case PROFILER_RAW_HID_STATS: {
+            if (zone >= PROFILER_ZONE_COUNT || size < 16) return false;
+            const profiler_stats_t *stats = &profiler_stats[zone];
+            profiler_put32(&reply[0], stats->count);
+            profiler_put32(&reply[4], stats->min);
+            profiler_put32(&reply[8], profiler_mean(stats));
+            profiler_put32(&reply[12], stats->max);
+            return true;
+        }
+        case PROFILER_RAW_HID_HISTOGRAM: {
+            if (zone >= PROFILER_ZONE_COUNT || size < 1) return false;
+            uint8_t bucket = reply[0];
+            for (uint8_t i = 1; i + 1 < size; i += 2, bucket++) {
+                uint16_t count = bucket < PROFILER_HISTOGRAM_BUCKETS ? profiler_stats[zone].histogram[bucket] : 0;
+                reply[i]       = count;
+                reply[i + 1]   = count >> 8;
+            }
+            return true;
+        }
+        case PROFILER_RAW_HID_NAME:
+            if (zone >= PROFILER_ZONE_COUNT || size < 1) return false;
+            profiler_get_zone_name(zone, (char *)reply, size);
+            return true;
+        case PROFILER_RAW_HID_RESET:
+            profiler_reset();
+            return true;
+    }
+    return false;
+}
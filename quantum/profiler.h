@@ -0,0 +1,100 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Log2 buckets kept for each zone. Bucket 0 counts runs that took no ticks at all, bucket n those that
+// took at least 2^(n-1) and less than 2^n ticks, and the last one everything longer.
+#ifndef PROFILER_HISTOGRAM_BUCKETS
+#    define PROFILER_HISTOGRAM_BUCKETS 20
+#endif
+
+// How deep zones can be nested, deeper ones are not recorded
+#ifndef PROFILER_STACK_DEPTH
+#    define PROFILER_STACK_DEPTH 8
+#endif
+
+// Prints the table to the console every this many milliseconds, 0 to only print it on request
+#ifndef PROFILER_DUMP_INTERVAL
+#    define PROFILER_DUMP_INTERVAL 0
+#endif
+
+// The first byte of raw HID reports that profiler_raw_hid_command() answers
+#ifndef PROFILER_RAW_HID_ID
+#    define PROFILER_RAW_HID_ID 0xF0
+#endif
+
+typedef enum {
+#define PROFILER_ZONE(id, name) PROFILER_ZONE_##id,
+#include "profiler_zones.inc"
+#undef PROFILER_ZONE
+    PROFILER_ZONE_COUNT
+} profiler_zone_t;
+
+typedef struct {
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+    // Halved whenever one of them would overflow, so they keep their shape
+    uint16_t histogram[PROFILER_HISTOGRAM_BUCKETS];
+} profiler_stats_t;
+
+enum profiler_raw_hid_command {
+    PROFILER_RAW_HID_INFO,       // zone count, bucket count, ticks per ms, ticks per clock read
+    PROFILER_RAW_HID_STATS,      // count, min, mean and max of zone data[2]
+    PROFILER_RAW_HID_HISTOGRAM,  // the buckets of zone data[2] from bucket data[3] on, as many as fit
+    PROFILER_RAW_HID_NAME,       // the name of zone data[2]
+    PROFILER_RAW_HID_RESET,
+};
+
+void profiler_init(void);
+void profiler_task(void);
+void profiler_reset(void);
+
+void profiler_enter(void);
+bool profiler_leave(profiler_zone_t zone, bool result);
+void profiler_record(profiler_zone_t zone, uint32_t ticks);
+
+const profiler_stats_t *profiler_get_stats(profiler_zone_t zone);
+// Copies the name of the zone, truncated to size including the terminator
+void     profiler_get_zone_name(profiler_zone_t zone, char *name, uint8_t size);
+uint32_t profiler_get_ticks_per_ms(void);
+uint32_t profiler_get_overhead(void);
+
+void profiler_dump(void);
+// Answers a report starting with PROFILER_RAW_HID_ID in place, returns false and leaves it alone for anything else
+bool profiler_raw_hid_command(uint8_t *data, uint8_t length);
+
+// Implemented by each platform
+void     profiler_clock_init(void);
+uint32_t profiler_clock_read(void);
+// Ticks per millisecond, or 0 to have profiler_task() measure it against the millisecond timer
+uint32_t profiler_clock_rate(void);
+
+#ifdef PROFILER_ENABLE
+#    define PROFILER_BEGIN(zone) profiler_enter()
+#    define PROFILER_END(zone) (void)profiler_leave(PROFILER_ZONE_##zone, true)
+// Times a call that returns true to continue, as the process_* handlers do
+#    define PROFILED(zone, call) (profiler_enter(), profiler_leave(PROFILER_ZONE_##zone, (call)))
+#else
+#    define PROFILER_BEGIN(zone)
+#    define PROFILER_END(zone)
+#    define PROFILED(zone, call) (call)
+#endif
@@ -16,6 +16,7 @@
 
 #include "quantum.h"
 #include "magic.h"
+#include "profiler.h"
 
 #ifdef BLUETOOTH_ENABLE
 #    include "outputselect.h"
@@ -37,6 +38,10 @@
 #    include "haptic.h"
 #endif
 
+#ifdef EEPROM_DRIVER
+#    include "eeprom_driver.h"
+#endif
+
 #ifdef AUDIO_ENABLE
 #    ifndef GOODBYE_SONG
 #        define GOODBYE_SONG SONG(GOODBYE_SOUND)
@@ -134,6 +139,9 @@ void reset_keyboard(void) {
 #endif
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
+#endif
+#ifdef EEPROM_DRIVER
+    eeprom_flush();
 #endif
     bootloader_jump();
 }
@@ -176,7 +184,7 @@ uint16_t get_event_keycode(keyevent_t event, bool update_layer_cache) {
 bool pre_process_record_quantum(keyrecord_t *record) {
     if (!(
 #ifdef COMBO_ENABLE
-            process_combo(get_record_keycode(record, true), record) &&
+            PROFILED(PROCESS_COMBO, process_combo(get_record_keycode(record, true), record)) &&
 #endif
             true)) {
         return false;
@@ -223,81 +231,81 @@ bool process_record_quantum(keyrecord_t *record) {
     if (!(
 #if defined(KEY_LOCK_ENABLE)
             // Must run first to be able to mask key_up events.
-            process_key_lock(&keycode, record) &&
+            PROFILED(PROCESS_KEY_LOCK, process_key_lock(&keycode, record)) &&
 #endif
 #if defined(DYNAMIC_MACRO_ENABLE) && !defined(DYNAMIC_MACRO_USER_CALL)
             // Must run asap to ensure all keypresses are recorded.
-            process_dynamic_macro(keycode, record) &&
+            PROFILED(PROCESS_DYNAMIC_MACRO, process_dynamic_macro(keycode, record)) &&
 #endif
 #if defined(AUDIO_ENABLE) && defined(AUDIO_CLICKY)
-            process_clicky(keycode, record) &&
+            PROFILED(PROCESS_CLICKY, process_clicky(keycode, record)) &&
 #endif
 #ifdef HAPTIC_ENABLE
-            process_haptic(keycode, record) &&
+            PROFILED(PROCESS_HAPTIC, process_haptic(keycode, record)) &&
 #endif
 #if defined(VIA_ENABLE)
-            process_record_via(keycode, record) &&
+            PROFILED(PROCESS_RECORD_VIA, process_record_via(keycode, record)) &&
 #endif
-            process_record_kb(keycode, record) &&
+            PROFILED(PROCESS_RECORD_KB, process_record_kb(keycode, record)) &&
 #if defined(SEQUENCER_ENABLE)
-            process_sequencer(keycode, record) &&
+            PROFILED(PROCESS_SEQUENCER, process_sequencer(keycode, record)) &&
 #endif
 #if defined(MIDI_ENABLE) && defined(MIDI_ADVANCED)
-            process_midi(keycode, record) &&
+            PROFILED(PROCESS_MIDI, process_midi(keycode, record)) &&
 #endif
 #ifdef AUDIO_ENABLE
-            process_audio(keycode, record) &&
+            PROFILED(PROCESS_AUDIO, process_audio(keycode, record)) &&
 #endif
 #if defined(BACKLIGHT_ENABLE) || defined(LED_MATRIX_ENABLE)
-            process_backlight(keycode, record) &&
+            PROFILED(PROCESS_BACKLIGHT, process_backlight(keycode, record)) &&
 #endif
 #ifdef STENO_ENABLE
-            process_steno(keycode, record) &&
+            PROFILED(PROCESS_STENO, process_steno(keycode, record)) &&
 #endif
 #if (defined(AUDIO_ENABLE) || (defined(MIDI_ENABLE) && defined(MIDI_BASIC))) && !defined(NO_MUSIC_MODE)
-            process_music(keycode, record) &&
+            PROFILED(PROCESS_MUSIC, process_music(keycode, record)) &&
 #endif
 #ifdef KEY_OVERRIDE_ENABLE
-            process_key_override(keycode, record) &&
+            PROFILED(PROCESS_KEY_OVERRIDE, process_key_override(keycode, record)) &&
 #endif
 #ifdef TAP_DANCE_ENABLE
-            process_tap_dance(keycode, record) &&
+            PROFILED(PROCESS_TAP_DANCE, process_tap_dance(keycode, record)) &&
 #endif
 #if defined(UNICODE_ENABLE) || defined(UNICODEMAP_ENABLE) || defined(UCIS_ENABLE)
-            process_unicode_common(keycode, record) &&
+            PROFILED(PROCESS_UNICODE_COMMON, process_unicode_common(keycode, record)) &&
 #endif
 #ifdef LEADER_ENABLE
-            process_leader(keycode, record) &&
+            PROFILED(PROCESS_LEADER, process_leader(keycode, record)) &&
 #endif
 #ifdef PRINTING_ENABLE
-            process_printer(keycode, record) &&
+            PROFILED(PROCESS_PRINTER, process_printer(keycode, record)) &&
 #endif
 #ifdef AUTO_SHIFT_ENABLE
-            process_auto_shift(keycode, record) &&
+            PROFILED(PROCESS_AUTO_SHIFT, process_auto_shift(keycode, record)) &&
 #endif
 #ifdef DYNAMIC_TAPPING_TERM_ENABLE
-            process_dynamic_tapping_term(keycode, record) &&
+            PROFILED(PROCESS_DYNAMIC_TAPPING_TERM, process_dynamic_tapping_term(keycode, record)) &&
 #endif
 #ifdef TERMINAL_ENABLE
-            process_terminal(keycode, record) &&
+            PROFILED(PROCESS_TERMINAL, process_terminal(keycode, record)) &&
 #endif
 #ifdef SPACE_CADET_ENABLE
-            process_space_cadet(keycode, record) &&
+            PROFILED(PROCESS_SPACE_CADET, process_space_cadet(keycode, record)) &&
 #endif
 #ifdef MAGIC_KEYCODE_ENABLE
-            process_magic(keycode, record) &&
+            PROFILED(PROCESS_MAGIC, process_magic(keycode, record)) &&
 #endif
 #ifdef GRAVE_ESC_ENABLE
-            process_grave_esc(keycode, record) &&
+            PROFILED(PROCESS_GRAVE_ESC, process_grave_esc(keycode, record)) &&
 #endif
 #if defined(RGBLIGHT_ENABLE) || defined(RGB_MATRIX_ENABLE)
-            process_rgb(keycode, record) &&
+            PROFILED(PROCESS_RGB, process_rgb(keycode, record)) &&
 #endif
 #ifdef JOYSTICK_ENABLE
-            process_joystick(keycode, record) &&
+            PROFILED(PROCESS_JOYSTICK, process_joystick(keycode, record)) &&
 #endif
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-            process_programmable_button(keycode, record) &&
+            PROFILED(PROCESS_PROGRAMMABLE_BUTTON, process_programmable_button(keycode, record)) &&
 #endif
             true)) {
         return false;
@@ -426,7 +434,10 @@ void matrix_scan_quantum() {
 #endif
 
 #ifdef KEY_OVERRIDE_ENABLE
-    key_override_task();
+    static task_schedule_t key_override_schedule;
+    if (task_schedule_due(&key_override_schedule)) {
+        task_schedule_update(&key_override_schedule, key_override_task());
+    }
 #endif
 
 #ifdef SEQUENCER_ENABLE
@@ -434,11 +445,24 @@ void matrix_scan_quantum() {
 #endif
 
 #ifdef TAP_DANCE_ENABLE
-    tap_dance_task();
+    static task_schedule_t tap_dance_schedule;
+    if (task_schedule_due(&tap_dance_schedule)) {
+        task_schedule_update(&tap_dance_schedule, tap_dance_task());
+    }
 #endif
 
 #ifdef COMBO_ENABLE
-    combo_task();
+    static task_schedule_t combo_schedule;
+    if (task_schedule_due(&combo_schedule)) {
+        task_schedule_update(&combo_schedule, combo_task());
+    }
+#endif
+
+#ifdef SEND_STRING_QUEUE_LENGTH
+    static task_schedule_t send_string_schedule;
+    if (task_schedule_due(&send_string_schedule)) {
+        task_schedule_update(&send_string_schedule, send_string_task());
+    }
 #endif
 
 #ifdef LED_MATRIX_ENABLE
@@ -488,6 +512,11 @@ __attribute__((weak)) void suspend_power_down_user(void) {}
 __attribute__((weak)) void suspend_power_down_kb(void) { suspend_power_down_user(); }
 
 void suspend_power_down_quantum(void) {
+#ifdef EEPROM_DRIVER
+    // Don't leave settings in RAM if the host cuts power
+    eeprom_flush();
+#endif
+
 #ifndef NO_SUSPEND_POWER_DOWN
 // Turn off backlight
 #    ifdef BACKLIGHT_ENABLE
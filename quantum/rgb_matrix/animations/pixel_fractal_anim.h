@@ -25,6 +25,10 @@ static bool PIXEL_FRACTAL(effect_params_t* params) {
     static bool led[MATRIX_ROWS][MATRIX_COLS];
 
     static uint32_t wait_timer = 0;
+    if (params->init) {  // Start from a blank grid, not where it was last time it ran
+        memset(led, 0, sizeof(led));
+        wait_timer = 0;
+    }
     if (wait_timer > g_rgb_timer) {
         return false;
     }
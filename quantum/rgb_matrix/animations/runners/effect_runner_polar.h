@@ -0,0 +1,15 @@
+#pragma once
+
+typedef HSV (*polar_f)(HSV hsv, uint8_t angle, uint8_t dist, uint8_t time);
+
+bool effect_runner_polar(effect_params_t* params, polar_f effect_func) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+
+    uint8_t time = scale16by8(g_rgb_timer, rgb_matrix_config.speed / 2);
+    for (uint8_t i = led_min; i < led_max; i++) {
+        RGB_MATRIX_TEST_LED_FLAGS();
+        rgb_matrix_span.hsv[i - led_min] = effect_func(rgb_matrix_config.hsv, g_led_polar[i].angle, g_led_polar[i].dist, time);
+    }
+    rgb_matrix_set_span(params, led_min, led_max);
+    return rgb_matrix_check_finished_leds(led_max);
+}
@@ -23,12 +23,15 @@ static HSV SOLID_REACTIVE_CROSS_math(HSV hsv, int16_t dx, int16_t dy, uint8_t di
     return hsv;
 }
 
+// tick + dist has to stay below 255
+static splash_reach_t SOLID_REACTIVE_CROSS_reach(uint16_t tick) { return reactive_splash_reach(0, 254 - (int32_t)tick); }
+
 #            ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_CROSS
-bool SOLID_REACTIVE_CROSS(effect_params_t* params) { return effect_runner_reactive_splash(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_CROSS_math); }
+bool SOLID_REACTIVE_CROSS(effect_params_t* params) { return effect_runner_reactive_splash_culled(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_CROSS_math, &SOLID_REACTIVE_CROSS_reach); }
 #            endif
 
 #            ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_MULTICROSS
-bool SOLID_REACTIVE_MULTICROSS(effect_params_t* params) { return effect_runner_reactive_splash(0, params, &SOLID_REACTIVE_CROSS_math); }
+bool SOLID_REACTIVE_MULTICROSS(effect_params_t* params) { return effect_runner_reactive_splash_culled(0, params, &SOLID_REACTIVE_CROSS_math, &SOLID_REACTIVE_CROSS_reach); }
 #            endif
 
 #        endif  // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
@@ -16,17 +16,21 @@ static HSV SOLID_REACTIVE_NEXUS_math(HSV hsv, int16_t dx, int16_t dy, uint8_t di
     if (effect > 255) effect = 255;
     if (dist > 72) effect = 255;
     if ((dx > 8 || dx < -8) && (dy > 8 || dy < -8)) effect = 255;
+    if (effect == 255) return hsv;
     hsv.v = qadd8(hsv.v, 255 - effect);
     hsv.h = rgb_matrix_config.hsv.h + dy / 4;
     return hsv;
 }
 
+// tick - dist has to stay between 0 and 254, no further than 72 out
+static splash_reach_t SOLID_REACTIVE_NEXUS_reach(uint16_t tick) { return reactive_splash_reach((int32_t)tick - 254, tick < 72 ? tick : 72); }
+
 #            ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_NEXUS
-bool SOLID_REACTIVE_NEXUS(effect_params_t* params) { return effect_runner_reactive_splash(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_NEXUS_math); }
+bool SOLID_REACTIVE_NEXUS(effect_params_t* params) { return effect_runner_reactive_splash_culled(qsub8(g_last_hit_tracker.count, 1), params, &SOLID_REACTIVE_NEXUS_math, &SOLID_REACTIVE_NEXUS_reach); }
 #            endif
 
 #            ifdef ENABLE_RGB_MATRIX_SOLID_REACTIVE_MULTINEXUS
-bool SOLID_REACTIVE_MULTINEXUS(effect_params_t* params) { return effect_runner_reactive_splash(0, params, &SOLID_REACTIVE_NEXUS_math); }
+bool SOLID_REACTIVE_MULTINEXUS(effect_params_t* params) { return effect_runner_reactive_splash_culled(0, params, &SOLID_REACTIVE_NEXUS_math, &SOLID_REACTIVE_NEXUS_reach); }
 #            endif
 
 #        endif  // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
@@ -13,18 +13,21 @@ RGB_MATRIX_EFFECT(MULTISPLASH)
 
 HSV SPLASH_math(HSV hsv, int16_t dx, int16_t dy, uint8_t dist, uint16_t tick) {
     uint16_t effect = tick - dist;
-    if (effect > 255) effect = 255;
+    if (effect > 254) return hsv;
     hsv.h += effect;
     hsv.v = qadd8(hsv.v, 255 - effect);
     return hsv;
 }
 
+// tick - dist has to stay between 0 and 254
+splash_reach_t SPLASH_reach(uint16_t tick) { return reactive_splash_reach((int32_t)tick - 254, tick); }
+
 #            ifdef ENABLE_RGB_MATRIX_SPLASH
-bool SPLASH(effect_params_t* params) { return effect_runner_reactive_splash(qsub8(g_last_hit_tracker.count, 1), params, &SPLASH_math); }
+bool SPLASH(effect_params_t* params) { return effect_runner_reactive_splash_culled(qsub8(g_last_hit_tracker.count, 1), params, &SPLASH_math, &SPLASH_reach); }
 #            endif
 
 #            ifdef ENABLE_RGB_MATRIX_MULTISPLASH
-bool MULTISPLASH(effect_params_t* params) { return effect_runner_reactive_splash(0, params, &SPLASH_math); }
+bool MULTISPLASH(effect_params_t* params) { return effect_runner_reactive_splash_culled(0, params, &SPLASH_math, &SPLASH_reach); }
 #            endif
 
 #        endif  // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
@@ -20,6 +20,7 @@
 #include "progmem.h"
 #include "config.h"
 #include "eeprom.h"
+#include "profiler.h"
 #include <string.h>
 #include <math.h>
 
@@ -33,6 +34,31 @@ const led_point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 
 __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) { return hsv_to_rgb(hsv); }
 
+// Override together with rgb_matrix_hsv_to_rgb(), the effect runners convert through this one
+__attribute__((weak)) void rgb_matrix_hsv_to_rgb_buffer(const HSV *hsv, RGB *rgb, uint8_t count) { hsv_to_rgb_buffer(hsv, rgb, count); }
+
+#if defined(RGB_MATRIX_LED_PROCESS_LIMIT) && RGB_MATRIX_LED_PROCESS_LIMIT > 0 && RGB_MATRIX_LED_PROCESS_LIMIT < DRIVER_LED_TOTAL
+#    define RGB_MATRIX_SPAN_SIZE (RGB_MATRIX_LED_PROCESS_LIMIT)
+#else
+#    define RGB_MATRIX_SPAN_SIZE DRIVER_LED_TOTAL
+#endif
+
+// The effect runners render the LEDs of one pass here, led_min at index 0, and convert them all at once
+static union {
+    HSV hsv[RGB_MATRIX_SPAN_SIZE];
+    RGB rgb[RGB_MATRIX_SPAN_SIZE];
+} rgb_matrix_span;
+
+static void rgb_matrix_set_span(effect_params_t *params, uint8_t led_min, uint8_t led_max) {
+    if (led_max <= led_min) return;
+    rgb_matrix_hsv_to_rgb_buffer(rgb_matrix_span.hsv, rgb_matrix_span.rgb, led_max - led_min);
+    for (uint8_t i = led_min; i < led_max; i++) {
+        RGB_MATRIX_TEST_LED_FLAGS();
+        RGB *rgb = &rgb_matrix_span.rgb[i - led_min];
+        rgb_matrix_set_color(i, rgb->r, rgb->g, rgb->b);
+    }
+}
+
 // Generic effect runners
 #include "rgb_matrix_runners.inc"
 
@@ -111,6 +137,7 @@ __attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) { return hsv_to_rgb(hsv
 // globals
 rgb_config_t rgb_matrix_config;  // TODO: would like to prefix this with g_ for global consistancy, do this in another pr
 uint32_t     g_rgb_timer;
+led_polar_t  g_led_polar[DRIVER_LED_TOTAL];
 #ifdef RGB_MATRIX_FRAMEBUFFER_EFFECTS
 uint8_t g_rgb_frame_buffer[MATRIX_ROWS][MATRIX_COLS] = {{0}};
 #endif  // RGB_MATRIX_FRAMEBUFFER_EFFECTS
@@ -188,6 +215,18 @@ void rgb_matrix_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
 #endif
 }
 
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+// Hits are kept oldest first, so the ones to forget are always at the front
+static void last_hit_forget(uint8_t count) {
+    uint8_t keep = last_hit_buffer.count - count;
+    memmove(&last_hit_buffer.x[0], &last_hit_buffer.x[count], keep);
+    memmove(&last_hit_buffer.y[0], &last_hit_buffer.y[count], keep);
+    memmove(&last_hit_buffer.tick[0], &last_hit_buffer.tick[count], keep * 2);  // 16 bit
+    memmove(&last_hit_buffer.index[0], &last_hit_buffer.index[count], keep);
+    last_hit_buffer.count = keep;
+}
+#endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
+
 void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
 #ifndef RGB_MATRIX_SPLIT
     if (!is_keyboard_master()) return;
@@ -210,11 +249,7 @@ void process_rgb_matrix(uint8_t row, uint8_t col, bool pressed) {
     }
 
     if (last_hit_buffer.count + led_count > LED_HITS_TO_REMEMBER) {
-        memcpy(&last_hit_buffer.x[0], &last_hit_buffer.x[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.y[0], &last_hit_buffer.y[led_count], LED_HITS_TO_REMEMBER - led_count);
-        memcpy(&last_hit_buffer.tick[0], &last_hit_buffer.tick[led_count], (LED_HITS_TO_REMEMBER - led_count) * 2);  // 16 bit
-        memcpy(&last_hit_buffer.index[0], &last_hit_buffer.index[led_count], LED_HITS_TO_REMEMBER - led_count);
-        last_hit_buffer.count = LED_HITS_TO_REMEMBER - led_count;
+        last_hit_forget(last_hit_buffer.count + led_count - LED_HITS_TO_REMEMBER);
     }
 
     for (uint8_t i = 0; i < led_count; i++) {
@@ -286,14 +321,15 @@ static void rgb_task_timers(void) {
 
     // Update double buffer last hit timers
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
-    uint8_t count = last_hit_buffer.count;
-    for (uint8_t i = 0; i < count; ++i) {
-        if (UINT16_MAX - deltaTime < last_hit_buffer.tick[i]) {
-            last_hit_buffer.count--;
+    uint8_t expired = 0;
+    for (uint8_t i = 0; i < last_hit_buffer.count; ++i) {
+        if (last_hit_buffer.tick[i] + deltaTime > UINT16_MAX) {
+            expired = i + 1;
             continue;
         }
         last_hit_buffer.tick[i] += deltaTime;
     }
+    last_hit_forget(expired);
 #endif  // RGB_MATRIX_KEYREACTIVE_ENABLED
 }
 
@@ -407,14 +443,18 @@ void rgb_matrix_task(void) {
             rgb_task_start();
             break;
         case RENDERING:
+            PROFILER_BEGIN(RGB_MATRIX_RENDER);
             rgb_task_render(effect);
             if (effect) {
                 rgb_matrix_indicators();
                 rgb_matrix_indicators_advanced(&rgb_effect_params);
             }
+            PROFILER_END(RGB_MATRIX_RENDER);
             break;
         case FLUSHING:
+            PROFILER_BEGIN(RGB_MATRIX_FLUSH);
             rgb_task_flush(effect);
+            PROFILER_END(RGB_MATRIX_FLUSH);
             break;
         case SYNCING:
             rgb_task_sync();
@@ -453,8 +493,18 @@ __attribute__((weak)) void rgb_matrix_indicators_advanced_kb(uint8_t led_min, ui
 
 __attribute__((weak)) void rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max) {}
 
+void rgb_matrix_update_geometry(void) {
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        int16_t dx           = g_led_config.point[i].x - k_rgb_matrix_center.x;
+        int16_t dy           = g_led_config.point[i].y - k_rgb_matrix_center.y;
+        g_led_polar[i].dist  = sqrt16(dx * dx + dy * dy);
+        g_led_polar[i].angle = atan2_8(dy, dx);
+    }
+}
+
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
+    rgb_matrix_update_geometry();
 
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
@@ -136,6 +136,9 @@ void rgb_matrix_indicators_advanced_user(uint8_t led_min, uint8_t led_max);
 
 void rgb_matrix_init(void);
 
+// Works out g_led_polar again, for boards that move g_led_config.point around after rgb_matrix_init
+void rgb_matrix_update_geometry(void);
+
 void        rgb_matrix_set_suspend_state(bool state);
 bool        rgb_matrix_get_suspend_state(void);
 void        rgb_matrix_toggle(void);
@@ -252,6 +255,7 @@ extern rgb_config_t rgb_matrix_config;
 
 extern uint32_t     g_rgb_timer;
 extern led_config_t g_led_config;
+extern led_polar_t  g_led_polar[DRIVER_LED_TOTAL];
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
 extern last_hit_t g_last_hit_tracker;
 #endif
@@ -153,6 +153,21 @@ void sethsv_raw(uint8_t hue, uint8_t sat, uint8_t val, LED_TYPE *led1) {
 
 void sethsv(uint8_t hue, uint8_t sat, uint8_t val, LED_TYPE *led1) { sethsv_raw(hue, sat, val > RGBLIGHT_LIMIT_VAL ? RGBLIGHT_LIMIT_VAL : val, led1); }
 
+// Override together with rgblight_hsv_to_rgb(), effects that fill a whole HSV buffer convert through this one
+__attribute__((weak)) void rgblight_hsv_to_rgb_buffer(const HSV *hsv, RGB *rgb, uint8_t count) { hsv_to_rgb_buffer(hsv, rgb, count); }
+
+void sethsv_buffer(const HSV *hsv, uint8_t count, LED_TYPE *leds) {
+#ifdef RGBW
+    for (uint8_t i = 0; i < count; i++) {
+        RGB rgb;
+        rgblight_hsv_to_rgb_buffer(&hsv[i], &rgb, 1);
+        setrgb(rgb.r, rgb.g, rgb.b, &leds[i]);
+    }
+#else
+    rgblight_hsv_to_rgb_buffer(hsv, leds, count);
+#endif
+}
+
 void setrgb(uint8_t r, uint8_t g, uint8_t b, LED_TYPE *led1) {
     led1->r = r;
     led1->g = g;
@@ -1100,13 +1115,16 @@ void rgblight_effect_rainbow_mood(animation_status_t *anim) {
 __attribute__((weak)) const uint8_t RGBLED_RAINBOW_SWIRL_INTERVALS[] PROGMEM = {100, 50, 20};
 
 void rgblight_effect_rainbow_swirl(animation_status_t *anim) {
-    uint8_t hue;
+    HSV     hsv[RGBLED_NUM];
+    uint8_t val = rgblight_config.val > RGBLIGHT_LIMIT_VAL ? RGBLIGHT_LIMIT_VAL : rgblight_config.val;
     uint8_t i;
 
     for (i = 0; i < rgblight_ranges.effect_num_leds; i++) {
-        hue = (RGBLIGHT_RAINBOW_SWIRL_RANGE / rgblight_ranges.effect_num_leds * i + anim->current_hue);
-        sethsv(hue, rgblight_config.sat, rgblight_config.val, (LED_TYPE *)&led[i + rgblight_ranges.effect_start_pos]);
+        hsv[i].h = (RGBLIGHT_RAINBOW_SWIRL_RANGE / rgblight_ranges.effect_num_leds * i + anim->current_hue);
+        hsv[i].s = rgblight_config.sat;
+        hsv[i].v = val;
     }
+    sethsv_buffer(hsv, rgblight_ranges.effect_num_leds, (LED_TYPE *)&led[rgblight_ranges.effect_start_pos]);
     rgblight_set();
 
     if (anim->delta % 2) {
@@ -273,6 +273,7 @@ extern rgblight_ranges_t rgblight_ranges;
 void sethsv(uint8_t hue, uint8_t sat, uint8_t val, LED_TYPE *led1);
 void sethsv_raw(uint8_t hue, uint8_t sat, uint8_t val, LED_TYPE *led1);  // without RGBLIGHT_LIMIT_VAL check
 void setrgb(uint8_t r, uint8_t g, uint8_t b, LED_TYPE *led1);
+void sethsv_buffer(const HSV *hsv, uint8_t count, LED_TYPE *leds);  // count colors in one pass, without RGBLIGHT_LIMIT_VAL check
 
 /* === Low level Functions === */
 void rgblight_set(void);
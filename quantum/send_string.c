@@ -15,6 +15,7 @@
  */
 
 #include <ctype.h>
+#include <string.h>
 
 #include "quantum.h"
 
@@ -228,6 +229,154 @@ void send_string_with_delay_P(const char *str, uint8_t interval) {
     }
 }
 
+#ifdef SEND_STRING_QUEUE_LENGTH
+typedef struct {
+    const char *         str;  // next character to send
+    send_string_handle_t handle;
+    uint8_t              interval;
+    bool                 progmem;
+} send_string_job_t;
+
+// The first job in the queue is the one being typed, the rest move up as it finishes
+static send_string_job_t    send_string_queue[SEND_STRING_QUEUE_LENGTH];
+static uint8_t              send_string_queue_count = 0;
+static send_string_handle_t send_string_last_handle = INVALID_SEND_STRING_HANDLE;
+static uint32_t             send_string_wait_start  = 0;
+static uint32_t             send_string_wait        = 0;
+// Keys the running job pressed with SS_DOWN, released if it gets cancelled
+static uint8_t send_string_held[32];
+
+static send_string_handle_t send_string_enqueue(const char *str, uint8_t interval, bool progmem) {
+    if (send_string_queue_count >= SEND_STRING_QUEUE_LENGTH) {
+        return INVALID_SEND_STRING_HANDLE;
+    }
+
+    do {
+        send_string_last_handle++;
+    } while (send_string_last_handle == INVALID_SEND_STRING_HANDLE || is_send_string_pending(send_string_last_handle));
+
+    send_string_queue[send_string_queue_count++] = (send_string_job_t){
+        .str      = str,
+        .handle   = send_string_last_handle,
+        .interval = interval,
+        .progmem  = progmem,
+    };
+    task_schedule_wake();
+    return send_string_last_handle;
+}
+
+send_string_handle_t send_string_async(const char *str, uint8_t interval) { return send_string_enqueue(str, interval, false); }
+
+send_string_handle_t send_string_async_P(const char *str, uint8_t interval) { return send_string_enqueue(str, interval, true); }
+
+bool is_send_string_pending(send_string_handle_t handle) {
+    for (uint8_t i = 0; i < send_string_queue_count; i++) {
+        if (send_string_queue[i].handle == handle) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void send_string_drop(uint8_t position) {
+    if (position == 0) {
+        // Forget the running job's state, the next one starts right away
+        memset(send_string_held, 0, sizeof(send_string_held));
+        send_string_wait = 0;
+    }
+    for (; position + 1 < send_string_queue_count; position++) {
+        send_string_queue[position] = send_string_queue[position + 1];
+    }
+    send_string_queue_count--;
+}
+
+bool cancel_send_string(send_string_handle_t handle) {
+    for (uint8_t i = 0; i < send_string_queue_count; i++) {
+        if (send_string_queue[i].handle != handle) {
+            continue;
+        }
+        if (i == 0) {
+            for (uint16_t keycode = 0; keycode < 256; keycode++) {
+                if (send_string_held[keycode / 8] & (1 << (keycode % 8))) {
+                    unregister_code(keycode);
+                }
+            }
+        }
+        send_string_drop(i);
+        return true;
+    }
+    return false;
+}
+
+static char send_string_read(send_string_job_t *job, uint8_t offset) { return job->progmem ? pgm_read_byte(job->str + offset) : job->str[offset]; }
+
+// Sends the next character or code of the running job, returns the time to wait before the one after it
+static uint32_t send_string_next(send_string_job_t *job) {
+    char ascii_code = send_string_read(job, 0);
+    if (!ascii_code) {
+        send_string_drop(0);
+        return 0;
+    }
+
+    if (ascii_code == SS_QMK_PREFIX) {
+        ascii_code      = send_string_read(job, 1);
+        uint8_t keycode = ascii_code ? send_string_read(job, 2) : 0;
+        if (ascii_code == SS_TAP_CODE) {
+            tap_code(keycode);
+            job->str += 3;
+        } else if (ascii_code == SS_DOWN_CODE) {
+            register_code(keycode);
+            send_string_held[keycode / 8] |= 1 << (keycode % 8);
+            job->str += 3;
+        } else if (ascii_code == SS_UP_CODE) {
+            unregister_code(keycode);
+            send_string_held[keycode / 8] &= ~(1 << (keycode % 8));
+            job->str += 3;
+        } else if (ascii_code == SS_DELAY_CODE) {
+            uint32_t ms     = 0;
+            uint8_t  offset = 2;
+            while (isdigit(keycode)) {
+                ms *= 10;
+                ms += keycode - '0';
+                keycode = send_string_read(job, ++offset);
+            }
+            // Skip the delimiter after the digits
+            job->str += keycode ? offset + 1 : offset;
+            return ms + job->interval;
+        } else {
+            job->str += ascii_code ? 2 : 1;
+        }
+    } else {
+        send_char(ascii_code);
+        job->str++;
+    }
+    return job->interval;
+}
+
+uint32_t send_string_task(void) {
+    if (!send_string_queue_count) {
+        return TASK_IDLE;
+    }
+
+    if (send_string_wait) {
+        uint32_t elapsed = timer_elapsed32(send_string_wait_start);
+        if (elapsed < send_string_wait) {
+            return send_string_wait - elapsed;
+        }
+        send_string_wait = 0;
+    }
+
+    // One step per call, so typing a long string never holds up the main loop
+    uint32_t wait = send_string_next(&send_string_queue[0]);
+    if (wait) {
+        send_string_wait_start = timer_read32();
+        send_string_wait       = wait;
+        return wait;
+    }
+    return send_string_queue_count ? TASK_RUN_ALWAYS : TASK_IDLE;
+}
+#endif
+
 void send_char(char ascii_code) {
 #if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
     if (ascii_code == '\a') {  // BEL
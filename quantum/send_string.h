@@ -14,6 +14,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "progmem.h"
@@ -46,6 +47,27 @@ void send_string_P(const char *str);
 void send_string_with_delay_P(const char *str, uint8_t interval);
 void send_char(char ascii_code);
 
+#ifdef SEND_STRING_QUEUE_LENGTH
+// Asynchronous send_string: the string is typed from the main loop, one character or
+// code per iteration, and SS_DELAY and the interval no longer block. The string has to
+// stay valid until it has been sent, so it can't live on the stack.
+typedef uint8_t send_string_handle_t;
+
+#    define INVALID_SEND_STRING_HANDLE 0
+
+#    define SEND_STRING_ASYNC(string) send_string_async_P(PSTR(string), 0)
+#    define SEND_STRING_ASYNC_DELAY(string, interval) send_string_async_P(PSTR(string), interval)
+
+// Queue a string, returns INVALID_SEND_STRING_HANDLE if the queue is full
+send_string_handle_t send_string_async(const char *str, uint8_t interval);
+send_string_handle_t send_string_async_P(const char *str, uint8_t interval);
+// Whether the string is still queued or being typed
+bool is_send_string_pending(send_string_handle_t handle);
+// Stop a string, releasing any key it holds down with SS_DOWN
+bool     cancel_send_string(send_string_handle_t handle);
+uint32_t send_string_task(void);
+#endif
+
 void send_dword(uint32_t number);
 void send_word(uint16_t number);
 void send_byte(uint8_t number);
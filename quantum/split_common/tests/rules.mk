@@ -0,0 +1,33 @@
+SPLIT_TRANSACTIONS_DEFS := -DNO_PRINT -DNO_DEBUG -DIGNORE_ATOMIC_BLOCK \
+	-DMATRIX_ROWS=8 -DMATRIX_COLS=6 \
+	-DSPLIT_KEYBOARD \
+	-DSPLIT_TRANSPORT_MIRROR \
+	-DSPLIT_LAYER_STATE_ENABLE \
+	-DSPLIT_LED_STATE_ENABLE \
+	-DSPLIT_MODS_ENABLE
+
+SPLIT_TRANSACTIONS_INC := $(QUANTUM_PATH)/split_common
+
+SPLIT_TRANSACTIONS_SRC := \
+	$(QUANTUM_PATH)/split_common/tests/split_transactions_tests.cpp \
+	$(QUANTUM_PATH)/split_common/transactions.c \
+	$(QUANTUM_PATH)/sync_timer.c \
+	$(QUANTUM_PATH)/crc.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/transport_loopback.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
+
+split_transactions_DEFS := $(SPLIT_TRANSACTIONS_DEFS)
+split_transactions_INC := $(SPLIT_TRANSACTIONS_INC)
+split_transactions_SRC := $(SPLIT_TRANSACTIONS_SRC)
+
+split_transactions_batch_DEFS := $(SPLIT_TRANSACTIONS_DEFS) -DSPLIT_TRANSPORT_BATCH
+split_transactions_batch_INC := $(SPLIT_TRANSACTIONS_INC)
+split_transactions_batch_SRC := $(SPLIT_TRANSACTIONS_SRC)
+
+split_transactions_events_DEFS := $(SPLIT_TRANSACTIONS_DEFS) -DSPLIT_TRANSPORT_EVENTS
+split_transactions_events_INC := $(SPLIT_TRANSACTIONS_INC)
+split_transactions_events_SRC := $(SPLIT_TRANSACTIONS_SRC)
+
+split_transactions_events_push_DEFS := $(SPLIT_TRANSACTIONS_DEFS) -DSPLIT_TRANSPORT_EVENTS -DSPLIT_TRANSPORT_EVENTS_PUSH
+split_transactions_events_push_INC := $(SPLIT_TRANSACTIONS_INC)
+split_transactions_events_push_SRC := $(SPLIT_TRANSACTIONS_SRC)
@@ -0,0 +1,658 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <vector>
+
+extern "C" {
+#include "keyboard.h"
+#include "sync_timer.h"
+#include "timer.h"
+#include "transport_loopback.h"
+
+void advance_time(uint32_t ms);
+void set_time(uint32_t ms);
+
+#ifdef SPLIT_TRANSPORT_EVENTS
+bool transactions_slave_event(keyevent_t* event);
+#endif
+}
+
+#ifndef FORCED_SYNC_THROTTLE_MS
+#    define FORCED_SYNC_THROTTLE_MS 100
+#endif
+
+/* This suite is built four times: split_transactions runs one transaction per feature,
+ * split_transactions_batch defines SPLIT_TRANSPORT_BATCH, split_transactions_events defines
+ * SPLIT_TRANSPORT_EVENTS and split_transactions_events_push adds SPLIT_TRANSPORT_EVENTS_PUSH,
+ * with the loopback standing in for a transport that can push. All builds have to keep the
+ * halves in sync the same way. */
+
+#define HALF_ROWS ((MATRIX_ROWS) / 2)
+
+#ifdef SPLIT_TRANSPORT_BATCH
+#    define RECOVERY_SCANS 3
+#else
+// A corrupted write is only repaired by the next forced sync, nothing checks master-to-slave data
+#    define RECOVERY_SCANS (FORCED_SYNC_THROTTLE_MS + 3)
+#endif
+
+/* The bits of keyboard state that the transactions read on the master and write on the slave */
+struct Half {
+    layer_state_t layer_state;
+    layer_state_t default_layer_state;
+    uint8_t       mods;
+    uint8_t       weak_mods;
+    uint8_t       oneshot_mods;
+    uint8_t       leds;
+};
+
+static Half  master_half, slave_half;
+static Half* current = &master_half;
+
+extern "C" {
+layer_state_t layer_state;
+layer_state_t default_layer_state;
+volatile bool isLeftHand = true;
+
+bool is_keyboard_master(void) { return current == &master_half; }
+static bool transport_connected = true;
+bool        is_transport_connected(void) { return transport_connected; }
+
+uint8_t get_mods(void) { return current->mods; }
+uint8_t get_weak_mods(void) { return current->weak_mods; }
+uint8_t get_oneshot_mods(void) { return current->oneshot_mods; }
+void    set_mods(uint8_t mods) { current->mods = mods; }
+void    set_weak_mods(uint8_t mods) { current->weak_mods = mods; }
+void    set_oneshot_mods(uint8_t mods) { current->oneshot_mods = mods; }
+uint8_t host_keyboard_leds(void) { return current->leds; }
+void    set_split_host_keyboard_leds(uint8_t led_state) { current->leds = led_state; }
+}
+
+static uint32_t xorshift(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+class SplitTransactions : public ::testing::Test {
+   protected:
+    matrix_row_t master_matrix[HALF_ROWS]   = {};  // the master's own keys
+    matrix_row_t slave_matrix[HALF_ROWS]    = {};  // the slave's own keys
+    matrix_row_t received_matrix[HALF_ROWS] = {};  // the slave's keys as seen by the master
+    matrix_row_t mirrored_matrix[HALF_ROWS] = {};  // the master's keys as seen by the slave
+
+    void SetUp() override {
+        transport_loopback_reset();
+        transport_connected = true;
+        master_half = slave_half = Half{};
+        settle();
+#ifdef SPLIT_TRANSPORT_EVENTS
+        drain();
+#endif
+    }
+
+    /* The slave keeps its shared memory up to date on its own */
+    void slave_scan() {
+        current             = &slave_half;
+        layer_state         = slave_half.layer_state;
+        default_layer_state = slave_half.default_layer_state;
+        transport_loopback_slave(mirrored_matrix, slave_matrix);
+        slave_half.layer_state         = layer_state;
+        slave_half.default_layer_state = default_layer_state;
+    }
+
+    bool master_scan() {
+        current             = &master_half;
+        layer_state         = master_half.layer_state;
+        default_layer_state = master_half.default_layer_state;
+        return transport_master(master_matrix, received_matrix);
+    }
+
+    /* One scan on each half */
+    bool scan() {
+        slave_scan();
+        bool okay = master_scan();
+        advance_time(1);
+        return okay;
+    }
+
+    void settle() {
+        for (int i = 0; i < 3; i++) {
+            scan();
+        }
+    }
+
+    void expect_in_sync() {
+        EXPECT_EQ(slave_half.layer_state, master_half.layer_state);
+        EXPECT_EQ(slave_half.default_layer_state, master_half.default_layer_state);
+        EXPECT_EQ(slave_half.mods, master_half.mods);
+        EXPECT_EQ(slave_half.weak_mods, master_half.weak_mods);
+        EXPECT_EQ(slave_half.oneshot_mods, master_half.oneshot_mods);
+        EXPECT_EQ(slave_half.leds, master_half.leds);
+        EXPECT_EQ(0, std::memcmp(received_matrix, slave_matrix, sizeof(slave_matrix)));
+        EXPECT_EQ(0, std::memcmp(mirrored_matrix, master_matrix, sizeof(master_matrix)));
+    }
+
+#ifdef SPLIT_TRANSPORT_EVENTS
+    /* What keyboard_task would queue ahead of the matrix */
+    std::vector<keyevent_t> drain() {
+        std::vector<keyevent_t> events;
+        keyevent_t              event;
+        while (transactions_slave_event(&event)) {
+            events.push_back(event);
+        }
+        return events;
+    }
+
+    /* Long enough for a forced sync, which syncs the timers and tells the master whether the slave pushes */
+    void forced_sync() {
+        slave_matrix[HALF_ROWS - 1] ^= 1;
+        for (int i = 0; i < FORCED_SYNC_THROTTLE_MS + 2; i++) {
+            scan();
+        }
+        drain();
+    }
+#endif
+};
+
+TEST_F(SplitTransactions, MasterStateReachesSlave) {
+    master_half.layer_state         = 0x0C;
+    master_half.default_layer_state = 0x02;
+    master_half.mods                = 0x11;
+    master_half.weak_mods           = 0x22;
+    master_half.oneshot_mods        = 0x04;
+    master_half.leds                = 0x03;
+    master_matrix[1]                = 0x05;
+
+    // The master sends on this scan, the slave applies it on the next
+    EXPECT_TRUE(scan());
+    EXPECT_TRUE(scan());
+    expect_in_sync();
+}
+
+TEST_F(SplitTransactions, SlaveMatrixReachesMasterOnTheSameScan) {
+    slave_matrix[0] = 0x21;
+    slave_matrix[3] = 0x08;
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(0, std::memcmp(received_matrix, slave_matrix, sizeof(slave_matrix)));
+
+    slave_matrix[0] = 0;
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(0, std::memcmp(received_matrix, slave_matrix, sizeof(slave_matrix)));
+}
+
+TEST_F(SplitTransactions, SyncTimerFollowsMaster) {
+    advance_time(1000);
+    for (int i = 0; i < FORCED_SYNC_THROTTLE_MS + 2; i++) {
+        scan();
+    }
+    uint32_t master_time = sync_timer_read32();
+    current              = &slave_half;
+    uint32_t slave_time  = sync_timer_read32();
+    current              = &master_half;
+    EXPECT_NEAR((double)slave_time, (double)master_time, FORCED_SYNC_THROTTLE_MS + 2);
+}
+
+TEST_F(SplitTransactions, RecoversFromTransportFaults) {
+    const transport_loopback_fault_t faults[] = {LOOPBACK_LOSE_REQUEST, LOOPBACK_LOSE_REPLY, LOOPBACK_CORRUPT_REQUEST, LOOPBACK_CORRUPT_REPLY};
+    uint8_t                          value    = 1;
+
+    for (auto fault : faults) {
+        for (int skip = 0; skip < 3; skip++) {
+            master_half.layer_state = value;
+            master_half.mods        = value + 1;
+            master_matrix[0]        = value;
+            slave_matrix[1]         = value;
+            value++;
+
+            // Hit each of the first few transactions of the scan, not just the first one
+            transport_loopback_inject(fault, skip);
+            for (int i = 0; i < RECOVERY_SCANS; i++) {
+                scan();
+            }
+            expect_in_sync();
+        }
+    }
+}
+
+#ifndef SPLIT_TRANSPORT_EVENTS_PUSH
+// With SPLIT_TRANSPORT_EVENTS_PUSH nothing tells the master that a push went missing, see LostPushIsMadeUpFor
+/* A press on the slave whose reply goes missing must still arrive, even though the slave already built a reply for it */
+TEST_F(SplitTransactions, LostReplyDoesNotLoseSlaveKeys) {
+    for (uint8_t i = 1; i < 50; i++) {
+        slave_matrix[i % HALF_ROWS] ^= 1 << (i % MATRIX_COLS);
+        transport_loopback_inject(i % 2 ? LOOPBACK_LOSE_REPLY : LOOPBACK_CORRUPT_REPLY, 0);
+        scan();
+        EXPECT_EQ(0, std::memcmp(received_matrix, slave_matrix, sizeof(slave_matrix))) << "after change " << (int)i;
+    }
+}
+#endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+
+/* Without a connection nothing is retried, so a single failed transfer has to fail the scan.
+ * Only the batch exchange also tells when the slave never got the request. */
+TEST_F(SplitTransactions, FailedTransferFailsTheScan) {
+#ifdef SPLIT_TRANSPORT_BATCH
+    const transport_loopback_fault_t faults[] = {LOOPBACK_LOSE_REQUEST, LOOPBACK_LOSE_REPLY, LOOPBACK_CORRUPT_REQUEST, LOOPBACK_STALE_REPLY};
+#else
+    const transport_loopback_fault_t faults[] = {LOOPBACK_LOSE_REQUEST, LOOPBACK_LOSE_REPLY};
+#endif
+    transport_connected                       = false;
+    for (auto fault : faults) {
+        slave_matrix[0] ^= 1;
+        master_half.mods ^= 0x01;
+        transport_loopback_inject(fault, 0);
+        EXPECT_FALSE(master_scan()) << "fault " << fault;
+        advance_time(1);
+        EXPECT_TRUE(scan()) << "after fault " << fault;
+    }
+}
+
+#ifdef SPLIT_TRANSPORT_BATCH
+TEST_F(SplitTransactions, OneRoundTripPerScan) {
+    uint32_t rng = 99;
+    for (int i = 0; i < 500; i++) {
+        slave_matrix[xorshift(rng) % HALF_ROWS] ^= 1 << (xorshift(rng) % MATRIX_COLS);
+        master_matrix[xorshift(rng) % HALF_ROWS] ^= 1 << (xorshift(rng) % MATRIX_COLS);
+        master_half.layer_state = 1 << (xorshift(rng) % 4);
+        master_half.mods        = xorshift(rng);
+
+        uint32_t before = transport_loopback_stats.round_trips;
+        EXPECT_TRUE(scan());
+        EXPECT_EQ(transport_loopback_stats.round_trips - before, 1u);
+    }
+    scan();
+    expect_in_sync();
+}
+
+/* A reply the slave never wrote for this frame must not clear what the master still has to send */
+TEST_F(SplitTransactions, StaleReplyIsNotAnAcknowledgement) {
+    master_half.mods = 0x08;
+    transport_loopback_inject(LOOPBACK_STALE_REPLY, 0);
+    scan();
+    scan();
+    expect_in_sync();
+}
+
+TEST_F(SplitTransactions, UnchangedSectionsAreNotResent) {
+    const unsigned scans  = FORCED_SYNC_THROTTLE_MS * 2;
+    uint32_t       before = transport_loopback_stats.initiator2target_bytes;
+    for (unsigned i = 0; i < scans; i++) {
+        scan();
+    }
+    // Nothing but the flags, the length and the checksum, apart from the sync timer on every forced sync.
+    // Everything else is forced through too, but is identical to what the slave already has.
+    EXPECT_EQ(transport_loopback_stats.initiator2target_bytes - before, scans * 3 + 2 * (1 + sizeof(uint32_t)));
+
+    // Right after a forced sync, so that only the change goes out
+    uint32_t sent;
+    do {
+        before = transport_loopback_stats.initiator2target_bytes;
+        scan();
+        sent = transport_loopback_stats.initiator2target_bytes - before;
+    } while (sent == 3);
+
+    master_half.mods = 0x40;
+    before           = transport_loopback_stats.initiator2target_bytes;
+    scan();
+    EXPECT_EQ(transport_loopback_stats.initiator2target_bytes - before, 3u + 1 + sizeof(split_mods_sync_t));
+}
+#endif  // SPLIT_TRANSPORT_BATCH
+
+#ifdef SPLIT_TRANSPORT_EVENTS
+TEST_F(SplitTransactions, EventsKeepTheirOrderAndTime) {
+    forced_sync();
+
+    // A tap and a press between two master scans, the tap never shows in the matrix
+    uint16_t times[3];
+    slave_matrix[0] |= 1 << 1;
+    times[0] = timer_read();
+    slave_scan();
+    advance_time(3);
+    slave_matrix[2] |= 1 << 3;
+    times[1] = timer_read();
+    slave_scan();
+    advance_time(4);
+    slave_matrix[0] &= ~(1 << 1);
+    times[2] = timer_read();
+    slave_scan();
+    advance_time(2);
+
+    EXPECT_TRUE(master_scan());
+    EXPECT_EQ(0, std::memcmp(received_matrix, slave_matrix, sizeof(slave_matrix)));
+
+    auto events = drain();
+    ASSERT_EQ(events.size(), 3u);
+    const uint8_t rows[]    = {HALF_ROWS + 0, HALF_ROWS + 2, HALF_ROWS + 0};
+    const uint8_t cols[]    = {1, 3, 1};
+    const bool    pressed[] = {true, true, false};
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(events[i].key.row, rows[i]) << "event " << i;
+        EXPECT_EQ(events[i].key.col, cols[i]) << "event " << i;
+        EXPECT_EQ(events[i].pressed, pressed[i]) << "event " << i;
+        // Only as close as the sync timer gets the two clocks
+        EXPECT_NEAR(events[i].time, times[i], 1) << "event " << i;
+    }
+}
+
+#    ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+TEST_F(SplitTransactions, PushedEventsNeedNoPolling) {
+    const unsigned scans = FORCED_SYNC_THROTTLE_MS * 5;
+    uint32_t       rng   = 7;
+
+    forced_sync();
+    transport_loopback_stats = {};
+    for (unsigned i = 0; i < scans; i++) {
+        if (i % 3 == 0) {
+            slave_matrix[xorshift(rng) % HALF_ROWS] ^= 1 << (xorshift(rng) % MATRIX_COLS);
+        }
+        scan();
+        EXPECT_EQ(0, std::memcmp(received_matrix, slave_matrix, sizeof(slave_matrix))) << "after scan " << i;
+        drain();
+    }
+    // Only forced syncs go out, each with a transaction or two per feature
+    EXPECT_LE(transport_loopback_stats.round_trips, (scans / FORCED_SYNC_THROTTLE_MS + 1) * 10);
+}
+
+TEST_F(SplitTransactions, LostPushIsMadeUpFor) {
+    forced_sync();
+
+    // By the next push
+    slave_matrix[1] ^= 1 << 2;
+    transport_loopback_inject(LOOPBACK_LOSE_REPLY, 0);
+    scan();
+    EXPECT_NE(0, std::memcmp(received_matrix, slave_matrix, sizeof(slave_matrix)));
+    slave_matrix[3] ^= 1 << 4;
+    scan();
+    expect_in_sync();
+    auto events = drain();
+    ASSERT_EQ(events.size(), 2u);
+    EXPECT_EQ(events[0].key.row, HALF_ROWS + 1);
+    EXPECT_EQ(events[1].key.row, HALF_ROWS + 3);
+
+    // Or by the next forced sync, without one
+    slave_matrix[2] ^= 1 << 5;
+    transport_loopback_inject(LOOPBACK_LOSE_REPLY, 0);
+    for (int i = 0; i < FORCED_SYNC_THROTTLE_MS + 2; i++) {
+        scan();
+    }
+    expect_in_sync();
+    EXPECT_EQ(drain().size(), 1u);
+}
+
+TEST_F(SplitTransactions, CorruptPushIsNotReplayed) {
+    forced_sync();
+
+    slave_matrix[0] ^= 1 << 5;
+    transport_loopback_inject(LOOPBACK_CORRUPT_REPLY, 0);
+    EXPECT_TRUE(scan());
+    expect_in_sync();
+    auto events = drain();
+    ASSERT_EQ(events.size(), 1u);
+    EXPECT_EQ(events[0].key.row, HALF_ROWS + 0);
+    EXPECT_EQ(events[0].key.col, 5);
+}
+
+#    endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+
+TEST_F(SplitTransactions, SlaveThatCannotPushIsPolled) {
+#    ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+    transport_loopback_allow_push(false);
+#    endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+    forced_sync();
+
+    for (int i = 0; i < 20; i++) {
+        slave_matrix[i % HALF_ROWS] ^= 1 << (i % MATRIX_COLS);
+        uint32_t round_trips = transport_loopback_stats.round_trips;
+        scan();
+        EXPECT_GT(transport_loopback_stats.round_trips, round_trips);
+        EXPECT_EQ(0, std::memcmp(received_matrix, slave_matrix, sizeof(slave_matrix)));
+        auto events = drain();
+        ASSERT_EQ(events.size(), 1u);
+        EXPECT_EQ(events[0].key.row, HALF_ROWS + i % HALF_ROWS);
+    }
+}
+
+/* More events than the ring holds between two master scans are given up on, the matrix still catches up */
+TEST_F(SplitTransactions, TooManyEventsFallBackToTheMatrix) {
+    forced_sync();
+
+    for (int i = 0; i < SPLIT_EVENT_COUNT + 3; i++) {
+        slave_matrix[i % HALF_ROWS] ^= 1 << (i % MATRIX_COLS);
+        slave_scan();
+    }
+    master_scan();
+    master_scan();
+    expect_in_sync();
+    EXPECT_EQ(drain().size(), 0u);
+
+    // And events flow again right after
+    slave_matrix[0] ^= 1;
+    scan();
+    expect_in_sync();
+    EXPECT_EQ(drain().size(), 1u);
+}
+#endif  // SPLIT_TRANSPORT_EVENTS
+
+/* Typing on both halves with the odd layer and modifier change, to compare what each build puts on the wire */
+TEST_F(SplitTransactions, BytesAndRoundTripsPerScan) {
+    const unsigned scans = 20000;
+    uint32_t       rng   = 0x5EED;
+
+    transport_loopback_stats = {};
+    for (unsigned i = 0; i < scans; i++) {
+        // Around one key event per 20 scans on each half
+        if (xorshift(rng) % 20 == 0) {
+            slave_matrix[xorshift(rng) % HALF_ROWS] ^= 1 << (xorshift(rng) % MATRIX_COLS);
+        }
+        if (xorshift(rng) % 20 == 0) {
+            master_matrix[xorshift(rng) % HALF_ROWS] ^= 1 << (xorshift(rng) % MATRIX_COLS);
+        }
+        if (xorshift(rng) % 200 == 0) {
+            master_half.layer_state = 1 << (xorshift(rng) % 4);
+        }
+        if (xorshift(rng) % 100 == 0) {
+            master_half.mods = xorshift(rng) & 0x0F;
+        }
+        ASSERT_TRUE(scan());
+    }
+    transport_loopback_stats_t stats = transport_loopback_stats;
+    scan();
+    expect_in_sync();
+
+    double round_trips = (double)stats.round_trips / scans;
+    double bytes       = (double)(stats.initiator2target_bytes + stats.target2initiator_bytes) / scans;
+    std::cout << "[ BENCHMARK] " << scans << " scans: " << round_trips << " round trips/scan, " << bytes << " bytes/scan" << std::endl;
+    RecordProperty("round_trips_per_1000_scans", (int)(round_trips * 1000));
+    RecordProperty("bytes_per_1000_scans", (int)(bytes * 1000));
+#if defined(SPLIT_TRANSPORT_BATCH)
+    EXPECT_EQ(stats.round_trips, scans);
+#elif defined(SPLIT_TRANSPORT_EVENTS_PUSH)
+    EXPECT_LT(stats.round_trips, scans / 2);
+#else
+    EXPECT_GT(stats.round_trips, scans);
+#endif
+}
+
+/* A rough model of the wire: the soft serial driver at its default speed */
+#define LINK_TRANSFER_US 100
+#define LINK_BYTE_US 75
+#define MASTER_SCAN_US 500  // scanning and processing on the master, not counting the transport
+#define SLAVE_SCAN_US 300
+#define SLAVE_CLOCK_SKEW_MS 7777
+
+/* Both halves scan on their own schedule with a wire in between that takes time. Measures how long a
+ * change on the slave takes to reach the master's keyboard_task, and how close the time it gets is. */
+TEST_F(SplitTransactions, EndToEndLatency) {
+    struct Change {
+        uint64_t time_us;
+        uint8_t  row;
+        uint8_t  col;
+        bool     pressed;
+    };
+    const uint64_t length_us = 30 * 1000 * 1000;
+    const uint32_t start_ms  = timer_read32() + 1;
+    uint32_t       rng       = 0xC0FFEE;
+
+    // Keys change at random, and never twice within 5 ms, like debounced keys would
+    std::vector<Change> changes;
+    uint64_t            last_change[HALF_ROWS][MATRIX_COLS] = {};
+    matrix_row_t        state[HALF_ROWS];
+    std::memcpy(state, slave_matrix, sizeof(state));
+    for (uint64_t t = 2 * FORCED_SYNC_THROTTLE_MS * 1000; t < length_us; t += 1000 + xorshift(rng) % 30000) {
+        uint8_t row = xorshift(rng) % HALF_ROWS, col = xorshift(rng) % MATRIX_COLS;
+        if (t - last_change[row][col] < 5000) {
+            continue;
+        }
+        last_change[row][col] = t;
+        state[row] ^= 1 << col;
+        changes.push_back({t, row, col, (state[row] & (1 << col)) != 0});
+    }
+
+    std::deque<Change>   recorded;                          // every change, in the order the slave picked them up
+    std::deque<uint64_t> pending[HALF_ROWS][MATRIX_COLS];   // when each change not yet seen by the master happened
+    std::deque<uint64_t> arrivals;                          // pushes still on the wire
+    matrix_row_t         processed[HALF_ROWS];              // the slave's keys as processed by the master
+    std::memcpy(processed, received_matrix, sizeof(processed));
+
+    unsigned delivered = 0, out_of_order = 0, unexpected = 0, master_scans = 0;
+    uint64_t latency_sum = 0, latency_max = 0, time_error_sum = 0, time_error_max = 0;
+    uint64_t now = 0, next_slave = 0, next_master = SLAVE_SCAN_US / 2, wire_free = 0;
+    size_t   next_change = 0;
+
+    auto process = [&](uint8_t row, uint8_t col, bool pressed, uint16_t time) {
+        if (pending[row][col].empty()) {
+            unexpected++;
+            return;
+        }
+        uint64_t happened = pending[row][col].front();
+        pending[row][col].pop_front();
+
+        auto in_order = std::find_if(recorded.begin(), recorded.end(), [&](const Change& c) { return c.row == row && c.col == col; });
+        if (in_order != recorded.begin() || in_order->pressed != pressed) {
+            out_of_order++;
+        }
+        recorded.erase(in_order);
+
+        uint64_t latency    = now - happened;
+        uint64_t time_error = std::abs((int16_t)(time - (uint16_t)(start_ms + happened / 1000)));
+        latency_sum += latency;
+        latency_max = std::max(latency_max, latency);
+        time_error_sum += time_error;
+        time_error_max = std::max(time_error_max, time_error);
+        delivered++;
+    };
+
+#ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+    transport_loopback_hold_pushes(true);
+#endif
+    transport_loopback_stats = {};
+    while (now < length_us + 100 * 1000) {
+        if (!arrivals.empty() && arrivals.front() <= std::min(next_slave, next_master)) {
+            now = arrivals.front();
+            arrivals.pop_front();
+#ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+            set_time(start_ms + now / 1000);
+            transport_loopback_deliver_push();
+#endif
+        } else if (next_slave <= next_master) {
+            now = next_slave;
+            std::vector<Change> scanned;
+            for (; next_change < changes.size() && changes[next_change].time_us <= now; next_change++) {
+                const Change& change = changes[next_change];
+                slave_matrix[change.row] ^= 1 << change.col;
+                pending[change.row][change.col].push_back(change.time_us);
+                scanned.push_back(change);
+            }
+            // One scan sees its changes in row and column order
+            std::sort(scanned.begin(), scanned.end(), [](const Change& a, const Change& b) { return a.row != b.row ? a.row < b.row : a.col < b.col; });
+            recorded.insert(recorded.end(), scanned.begin(), scanned.end());
+
+            transport_loopback_stats_t before = transport_loopback_stats;
+            set_time(start_ms + now / 1000 + SLAVE_CLOCK_SKEW_MS);
+            slave_scan();
+            if (transport_loopback_stats.pushes != before.pushes) {
+                wire_free = std::max(now, wire_free) + LINK_TRANSFER_US + (transport_loopback_stats.target2initiator_bytes - before.target2initiator_bytes) * LINK_BYTE_US;
+                arrivals.push_back(wire_free);
+            }
+            next_slave += SLAVE_SCAN_US;
+        } else {
+            now = next_master;
+            transport_loopback_stats_t before = transport_loopback_stats;
+            set_time(start_ms + now / 1000);
+            master_scan();
+            master_scans++;
+            uint32_t round_trips = transport_loopback_stats.round_trips - before.round_trips;
+            if (round_trips > 0) {
+                // Half duplex, so the master waits for a push that is still going
+                uint32_t bytes = (transport_loopback_stats.initiator2target_bytes - before.initiator2target_bytes) + (transport_loopback_stats.target2initiator_bytes - before.target2initiator_bytes);
+                now            = std::max(now, wire_free) + round_trips * LINK_TRANSFER_US + bytes * LINK_BYTE_US;
+                wire_free      = now;
+            }
+
+            // What keyboard_task would queue: the slave's own events first, then whatever the matrix says on top
+#ifdef SPLIT_TRANSPORT_EVENTS
+            keyevent_t event;
+            while (transactions_slave_event(&event)) {
+                uint8_t row = event.key.row - HALF_ROWS;
+                if (!(processed[row] & (1 << event.key.col)) != !event.pressed) {
+                    processed[row] ^= 1 << event.key.col;
+                    process(row, event.key.col, event.pressed, event.time);
+                }
+            }
+#endif
+            for (uint8_t row = 0; row < HALF_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    if ((received_matrix[row] ^ processed[row]) & (1 << col)) {
+                        processed[row] ^= 1 << col;
+                        process(row, col, received_matrix[row] & (1 << col), timer_read() | 1);
+                    }
+                }
+            }
+            next_master = now + MASTER_SCAN_US;
+        }
+    }
+#ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+    transport_loopback_hold_pushes(false);
+#endif
+    transport_loopback_stats_t stats = transport_loopback_stats;
+
+    EXPECT_EQ(delivered, changes.size());
+    EXPECT_EQ(unexpected, 0u);
+    EXPECT_EQ(0, std::memcmp(processed, slave_matrix, sizeof(processed)));
+    // Every change gets through within a few scans, none has to wait for a forced sync
+    EXPECT_LT(latency_max, 10u * MASTER_SCAN_US);
+#ifdef SPLIT_TRANSPORT_EVENTS
+    EXPECT_EQ(out_of_order, 0u);
+    // A ms for the sync timer, and a ms for the slave's scan
+    EXPECT_LE(time_error_max, 2u);
+#endif
+
+    double latency    = (double)latency_sum / delivered;
+    double time_error = (double)time_error_sum / delivered;
+    std::cout << "[ BENCHMARK] " << delivered << " slave key events: " << latency << " us mean latency, " << latency_max << " us max, " << time_error << " ms mean time error, " << out_of_order << " out of order, " << (double)stats.round_trips / master_scans << " round trips/master scan" << std::endl;
+    RecordProperty("mean_latency_us", (int)latency);
+    RecordProperty("max_latency_us", (int)latency_max);
+    RecordProperty("mean_time_error_us", (int)(time_error * 1000));
+    RecordProperty("out_of_order", (int)out_of_order);
+}
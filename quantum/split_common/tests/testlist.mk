@@ -0,0 +1 @@
+TEST_LIST += split_transactions split_transactions_batch split_transactions_events split_transactions_events_push
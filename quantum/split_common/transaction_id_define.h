@@ -24,6 +24,11 @@ enum serial_transaction_id {
     GET_SLAVE_MATRIX_CHECKSUM,
     GET_SLAVE_MATRIX_DATA,
 
+#ifdef SPLIT_TRANSPORT_EVENTS
+    GET_SLAVE_EVENTS_POLL,
+    GET_SLAVE_EVENTS_DATA,
+#endif  // SPLIT_TRANSPORT_EVENTS
+
 #ifdef SPLIT_TRANSPORT_MIRROR
     PUT_MASTER_MATRIX,
 #endif  // SPLIT_TRANSPORT_MIRROR
@@ -78,6 +83,10 @@ enum serial_transaction_id {
     PUT_ST7565,
 #endif  // defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+#ifdef SPLIT_TRANSPORT_BATCH
+    EXCHANGE_BATCH,
+#endif  // SPLIT_TRANSPORT_BATCH
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     PUT_RPC_INFO,
     PUT_RPC_REQ_DATA,
@@ -32,6 +32,23 @@
 #    define FORCED_SYNC_THROTTLE_MS 100
 #endif  // FORCED_SYNC_THROTTLE_MS
 
+#ifdef SPLIT_TRANSPORT_EVENTS
+#    ifdef SPLIT_TRANSPORT_BATCH
+#        error "SPLIT_TRANSPORT_EVENTS and SPLIT_TRANSPORT_BATCH cannot be used together"
+#    endif  // SPLIT_TRANSPORT_BATCH
+#    ifdef DISABLE_SYNC_TIMER
+#        error "SPLIT_TRANSPORT_EVENTS needs the sync timer to date the slave's key events"
+#    endif  // DISABLE_SYNC_TIMER
+#    if (SPLIT_EVENT_COUNT) > 128 || ((SPLIT_EVENT_COUNT) & ((SPLIT_EVENT_COUNT)-1)) != 0
+#        error "SPLIT_EVENT_COUNT must be a power of two, 128 at most"
+#    endif
+#    if (MATRIX_ROWS) / 2 * (MATRIX_COLS) > 128
+#        error "SPLIT_TRANSPORT_EVENTS only supports up to 128 keys per half"
+#    endif
+#elif defined(SPLIT_TRANSPORT_EVENTS_PUSH)
+#    error "SPLIT_TRANSPORT_EVENTS_PUSH needs SPLIT_TRANSPORT_EVENTS"
+#endif  // SPLIT_TRANSPORT_EVENTS
+
 #define sizeof_member(type, member) sizeof(((type *)NULL)->member)
 
 #define trans_initiator2target_initializer_cb(member, cb) \
@@ -42,8 +59,19 @@
     { &dummy, 0, 0, sizeof_member(split_shared_memory_t, member), offsetof(split_shared_memory_t, member), cb }
 #define trans_target2initiator_initializer(member) trans_target2initiator_initializer_cb(member, NULL)
 
-#define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
-#define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
+#define trans_exchange_initializer_cb(initiator2target_member, target2initiator_member, cb) \
+    { &dummy, sizeof_member(split_shared_memory_t, initiator2target_member), offsetof(split_shared_memory_t, initiator2target_member), sizeof_member(split_shared_memory_t, target2initiator_member), offsetof(split_shared_memory_t, target2initiator_member), cb }
+
+#ifdef SPLIT_TRANSPORT_BATCH
+// Core sync data is staged for the next batch frame instead of going out on its own transaction
+static bool batch_stage(int8_t id, const void *data, size_t length);
+static bool batch_fetch(int8_t id, void *data, size_t length);
+#    define transport_write(id, data, length) ((id) < EXCHANGE_BATCH ? batch_stage(id, data, length) : transport_execute_transaction(id, data, length, NULL, 0))
+#    define transport_read(id, data, length) ((id) < EXCHANGE_BATCH ? batch_fetch(id, data, length) : transport_execute_transaction(id, NULL, 0, data, length))
+#else  // SPLIT_TRANSPORT_BATCH
+#    define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
+#    define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
+#endif  // SPLIT_TRANSPORT_BATCH
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 // Forward-declare the RPC callback handlers
@@ -114,16 +142,33 @@ inline static bool send_if_data_mismatch(int8_t trans_id, uint32_t *last_update,
 ////////////////////////////////////////////////////
 // Slave matrix
 
+#ifdef SPLIT_TRANSPORT_EVENTS
+// Set while the slave's key events cannot be relied on to keep the matrix below up to date
+static bool slave_matrix_stale = true;
+#endif  // SPLIT_TRANSPORT_EVENTS
+
 static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t     last_update                    = 0;
     static matrix_row_t last_matrix[(MATRIX_ROWS) / 2] = {0};  // last successfully-read matrix, so we can replicate if there are checksum errors
     matrix_row_t        temp_matrix[(MATRIX_ROWS) / 2];        // holding area while we test whether or not checksum is correct
 
+#ifdef SPLIT_TRANSPORT_EVENTS
+    // The slave's key events have already been applied to the shared memory copy, only read the matrix to catch up
+    if (!slave_matrix_stale && timer_elapsed32(last_update) < FORCED_SYNC_THROTTLE_MS) {
+        memcpy(last_matrix, split_shmem->smatrix.matrix, sizeof(last_matrix));
+        memcpy(slave_matrix, last_matrix, sizeof(last_matrix));
+        return true;
+    }
+#endif  // SPLIT_TRANSPORT_EVENTS
+
     bool okay = read_if_checksum_mismatch(GET_SLAVE_MATRIX_CHECKSUM, GET_SLAVE_MATRIX_DATA, &last_update, temp_matrix, split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
     if (okay) {
         // Checksum matches the received data, save as the last matrix state
         memcpy(last_matrix, temp_matrix, sizeof(temp_matrix));
     }
+#ifdef SPLIT_TRANSPORT_EVENTS
+    slave_matrix_stale = !okay;
+#endif  // SPLIT_TRANSPORT_EVENTS
     // Copy out the last-known-good matrix state to the slave matrix
     memcpy(slave_matrix, last_matrix, sizeof(last_matrix));
     return okay;
@@ -142,6 +187,196 @@ static void slave_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row
     [GET_SLAVE_MATRIX_DATA]     = trans_target2initiator_initializer(smatrix.matrix),
 // clang-format on
 
+////////////////////////////////////////////////////
+// Slave key events
+//
+// The slave records every change of its debounced matrix in a small ring, dropping the oldest
+// events, and the master polls the ring the same way it would poll the matrix. It replays the
+// events it has not seen yet, in order and with the time they happened at, and only reads the
+// whole matrix when events went missing or on a forced sync.
+//
+// With SPLIT_TRANSPORT_EVENTS_PUSH the slave also pushes whatever is new to the master right
+// away, and the master stops polling the ring in between forced syncs. None of the in-tree
+// transports can start a transfer from the slave, so that is for custom transports only.
+
+#ifdef SPLIT_TRANSPORT_EVENTS
+
+#    ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+#        define SPLIT_PUSH_CONSUMED 0xFF  // count of a push the master has already looked at
+
+static uint8_t slave_push_length(uint8_t count) { return offsetof(split_slave_push_t, events) + count * sizeof(split_key_event_t); }
+#    endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+
+static keyevent_t slave_event_queue[SPLIT_EVENT_COUNT];
+static uint8_t    slave_event_head = 0;
+static uint8_t    slave_event_tail = 0;
+
+static void slave_event_replay(const split_key_event_t *event) {
+    uint8_t key     = event->key & ~SPLIT_KEY_EVENT_PRESSED;
+    uint8_t row     = key / (MATRIX_COLS);
+    uint8_t col     = key % (MATRIX_COLS);
+    bool    pressed = event->key & SPLIT_KEY_EVENT_PRESSED;
+    if (row >= (MATRIX_ROWS) / 2) {
+        return;
+    }
+
+    if (pressed) {
+        split_shmem->smatrix.matrix[row] |= MATRIX_ROW_SHIFTER << col;
+    } else {
+        split_shmem->smatrix.matrix[row] &= ~(MATRIX_ROW_SHIFTER << col);
+    }
+
+    // If keyboard_task falls behind the event is dropped here, and picked up from the matrix instead
+    if ((uint8_t)(slave_event_head - slave_event_tail) < SPLIT_EVENT_COUNT) {
+        // Only the low byte of the slave's sync timer comes across, which is plenty for an event from
+        // the last few ms. That timer runs SYNC_TIMER_OFFSET ahead to make up for the transfer, which
+        // is long over by now; whatever is left of that must not put the event in the future.
+        uint16_t now = timer_read();
+        uint8_t  age = (uint8_t)(now + SYNC_TIMER_OFFSET) - event->time;
+        if (age > UINT8_MAX - 16) {
+            age = 0;
+        }
+        slave_event_queue[slave_event_head++ % SPLIT_EVENT_COUNT] = (keyevent_t){
+            .key = (keypos_t){.row = row + (isLeftHand ? (MATRIX_ROWS) / 2 : 0), .col = col}, .pressed = pressed, .time = ((now - age) | 1) /* time should not be 0 */
+        };
+    }
+}
+
+static bool slave_events_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static uint32_t       last_update = 0;
+    static uint8_t        seen        = 0;  // ring head as of the last event replayed
+    split_slave_events_t *ring        = &split_shmem->sevents.events;
+
+#    ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+    split_slave_push_t *push      = &split_shmem->spush;
+    bool                need_ring = !ring->pushes || slave_matrix_stale || timer_elapsed32(last_update) >= FORCED_SYNC_THROTTLE_MS;
+
+    if (push->count != SPLIT_PUSH_CONSUMED) {
+        int8_t ahead = push->head - seen;
+        if (push->count > SPLIT_EVENT_COUNT || push->checksum != crc8(&push->head, slave_push_length(push->count) - 1) || ahead > push->count) {
+            // Damaged, or an earlier push went missing
+            need_ring = true;
+        } else if (!need_ring) {
+            // A push that overlaps events already replayed from the ring only adds the rest
+            for (uint8_t i = ahead > 0 ? push->count - ahead : push->count; i < push->count; i++) {
+                slave_event_replay(&push->events[i]);
+            }
+            if (ahead > 0) {
+                seen = push->head;
+            }
+            push->count = SPLIT_PUSH_CONSUMED;
+        }
+    }
+    if (!need_ring) {
+        return true;
+    }
+#    endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+
+    split_slave_events_poll_t poll;
+    bool                      okay = transport_read(GET_SLAVE_EVENTS_POLL, &poll, sizeof(poll));
+    if (okay && (timer_elapsed32(last_update) >= FORCED_SYNC_THROTTLE_MS || poll.head != ring->head || poll.checksum != crc8(ring, sizeof(*ring)))) {
+        split_slave_events_t temp;
+        okay &= transport_read(GET_SLAVE_EVENTS_DATA, &temp, sizeof(temp));
+        okay &= poll.head == ring->head && poll.checksum == crc8(ring, sizeof(*ring));
+        if (okay) {
+            last_update = timer_read32();
+        }
+    }
+    if (!okay) {
+        return false;
+    }
+#    ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+    // The push, if any, stays put until the ring has been read, so that a retry looks at it again
+    push->count = SPLIT_PUSH_CONSUMED;
+#    endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+    if (slave_matrix_stale || (uint8_t)(ring->head - seen) > SPLIT_EVENT_COUNT) {
+        // Events have been lost, start over from the matrix
+        seen               = ring->head;
+        slave_matrix_stale = true;
+        return true;
+    }
+    for (; seen != ring->head; seen++) {
+        slave_event_replay(&ring->events[seen % SPLIT_EVENT_COUNT]);
+    }
+    return true;
+}
+
+#    ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+static void slave_events_push(split_slave_events_t *ring) {
+    static uint8_t      recorded = 0;  // ring head as of the last call
+    static uint8_t      pushed   = 0;  // ring head as of the last push
+    split_slave_push_t *push     = &split_shmem->spush;
+
+    if (ring->head == recorded) {
+        return;
+    }
+    recorded = ring->head;
+
+    // Push everything since the last push that is still in the ring, the master asks for the ring if that is not enough
+    uint8_t count = ring->head - pushed;
+    if (count > SPLIT_EVENT_COUNT) {
+        count = SPLIT_EVENT_COUNT;
+    }
+    push->head  = ring->head;
+    push->count = count;
+    for (uint8_t i = 0; i < count; i++) {
+        push->events[i] = ring->events[(uint8_t)(ring->head - count + i) % SPLIT_EVENT_COUNT];
+    }
+    push->checksum = crc8(&push->head, slave_push_length(count) - 1);
+
+    ring->pushes = transport_slave_push(slave_push_length(count));
+    if (ring->pushes) {
+        pushed = ring->head;
+    }
+}
+#    endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+
+static void slave_events_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static matrix_row_t   last_matrix[(MATRIX_ROWS) / 2] = {0};  // the matrix as described by the recorded events
+    split_slave_events_t *ring                           = &split_shmem->sevents.events;
+
+    for (uint8_t row = 0; row < (MATRIX_ROWS) / 2; row++) {
+        matrix_row_t changes = slave_matrix[row] ^ last_matrix[row];
+        for (uint8_t col = 0; changes; col++, changes >>= 1) {
+            if (changes & 1) {
+                bool pressed                                   = slave_matrix[row] & (MATRIX_ROW_SHIFTER << col);
+                ring->events[ring->head++ % SPLIT_EVENT_COUNT] = (split_key_event_t){.key = (row * (MATRIX_COLS) + col) | (pressed ? SPLIT_KEY_EVENT_PRESSED : 0), .time = sync_timer_read()};
+            }
+        }
+        last_matrix[row] = slave_matrix[row];
+    }
+
+#    ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+    slave_events_push(ring);
+#    endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+    // Always prepare the ring for read
+    split_shmem->sevents.poll = (split_slave_events_poll_t){.checksum = crc8(ring, sizeof(*ring)), .head = ring->head};
+}
+
+bool transactions_slave_event(keyevent_t *event) {
+    if (slave_event_tail == slave_event_head) {
+        return false;
+    }
+    *event = slave_event_queue[slave_event_tail++ % SPLIT_EVENT_COUNT];
+    return true;
+}
+
+// clang-format off
+#    define TRANSACTIONS_SLAVE_EVENTS_MASTER() TRANSACTION_HANDLER_MASTER(slave_events)
+#    define TRANSACTIONS_SLAVE_EVENTS_SLAVE() TRANSACTION_HANDLER_SLAVE(slave_events)
+#    define TRANSACTIONS_SLAVE_EVENTS_REGISTRATIONS \
+    [GET_SLAVE_EVENTS_POLL] = trans_target2initiator_initializer(sevents.poll), \
+    [GET_SLAVE_EVENTS_DATA] = trans_target2initiator_initializer(sevents.events),
+// clang-format on
+
+#else  // SPLIT_TRANSPORT_EVENTS
+
+#    define TRANSACTIONS_SLAVE_EVENTS_MASTER()
+#    define TRANSACTIONS_SLAVE_EVENTS_SLAVE()
+#    define TRANSACTIONS_SLAVE_EVENTS_REGISTRATIONS
+
+#endif  // SPLIT_TRANSPORT_EVENTS
+
 ////////////////////////////////////////////////////
 // Master matrix
 
@@ -578,6 +813,218 @@ static void st7565_handlers_slave(matrix_row_t master_matrix[], matrix_row_t sla
 
 #endif  // defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+////////////////////////////////////////////////////
+// Batch exchange
+//
+// Every core transaction registered above becomes a section of one frame per scan. The master
+// sends only the master-to-slave sections that changed since the slave last acknowledged them,
+// and the slave answers with the slave-to-master sections that changed since the master last
+// acknowledged those. Sections carry absolute values, so resending one is always harmless.
+//
+// Frame layout, both directions: [flags] [length] ([transaction ID] [section data])... [crc8]
+
+#ifdef SPLIT_TRANSPORT_BATCH
+
+#    define BATCH_FIRST_ID GET_SLAVE_MATRIX_CHECKSUM
+#    define BATCH_HEADER_SIZE 2
+#    define BATCH_OVERHEAD (BATCH_HEADER_SIZE + 1)
+
+// Low nibble of the flags byte. The high nibble numbers each frame, and the reply echoes it so
+// that a stale reply left over in the slave's buffers is never taken as an acknowledgement.
+#    define BATCH_ACK 0x01        // m2s: the reply to the previous frame arrived. s2m: the frame was applied
+#    define BATCH_FULL 0x02       // m2s: every section is being resent, the slave should start over too
+#    define BATCH_NEED_FULL 0x04  // s2m: the slave has not seen a full frame since it started
+#    define BATCH_SEQUENCE_MASK 0xF0
+#    define BATCH_SEQUENCE_STEP 0x10
+
+// Sections are tracked as bits of a uint32_t
+_Static_assert(EXCHANGE_BATCH <= 32, "Too many transactions for SPLIT_TRANSPORT_BATCH");
+
+// A master-to-slave section has to fit in a frame of its own, or it would stay pending forever
+#    define BATCH_ASSERT_M2S(member) _Static_assert(1 + sizeof_member(split_shared_memory_t, member) <= SPLIT_BATCH_M2S_BUFFER_SIZE - BATCH_OVERHEAD, "SPLIT_BATCH_M2S_BUFFER_SIZE is too small for " #member)
+#    ifdef SPLIT_TRANSPORT_MIRROR
+BATCH_ASSERT_M2S(mmatrix);
+#    endif
+#    ifndef DISABLE_SYNC_TIMER
+BATCH_ASSERT_M2S(sync_timer);
+#    endif
+#    if !defined(NO_ACTION_LAYER) && defined(SPLIT_LAYER_STATE_ENABLE)
+BATCH_ASSERT_M2S(layers.layer_state);
+#    endif
+#    ifdef SPLIT_MODS_ENABLE
+BATCH_ASSERT_M2S(mods);
+#    endif
+#    if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+BATCH_ASSERT_M2S(rgblight_sync);
+#    endif
+#    if defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
+BATCH_ASSERT_M2S(led_matrix_sync);
+#    endif
+#    if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
+BATCH_ASSERT_M2S(rgb_matrix_sync);
+#    endif
+
+static uint32_t batch_pending = 0;  // master-to-slave sections waiting for an acknowledgement
+
+static uint8_t batch_section_size(uint8_t id, bool initiator2target) {
+    if (id < BATCH_FIRST_ID || id >= EXCHANGE_BATCH) return 0;
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    return initiator2target ? trans->initiator2target_buffer_size : trans->target2initiator_buffer_size;
+}
+
+static uint8_t *batch_section_buffer(uint8_t id, bool initiator2target) {
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    return initiator2target ? split_trans_initiator2target_buffer(trans) : split_trans_target2initiator_buffer(trans);
+}
+
+static uint8_t batch_frame_finish(uint8_t *frame, uint8_t flags, uint8_t length) {
+    frame[0]      = flags;
+    frame[1]      = length - BATCH_HEADER_SIZE;
+    frame[length] = crc8(frame, length);
+    return length + 1;
+}
+
+// Checks the whole frame before any of it is applied, so a corrupt frame never leaves half an update behind
+static bool batch_frame_valid(const uint8_t *frame, uint8_t size, bool initiator2target) {
+    if (size < BATCH_OVERHEAD || frame[1] > size - BATCH_OVERHEAD) return false;
+    uint8_t end = BATCH_HEADER_SIZE + frame[1];
+    if (frame[end] != crc8(frame, end)) return false;
+    for (uint8_t pos = BATCH_HEADER_SIZE; pos < end;) {
+        uint8_t length = batch_section_size(frame[pos++], initiator2target);
+        if (length == 0 || length > end - pos) return false;
+        pos += length;
+    }
+    return true;
+}
+
+static void batch_frame_apply(const uint8_t *frame, bool initiator2target) {
+    uint8_t end = BATCH_HEADER_SIZE + frame[1];
+    for (uint8_t pos = BATCH_HEADER_SIZE; pos < end;) {
+        uint8_t id     = frame[pos++];
+        uint8_t length = batch_section_size(id, initiator2target);
+        memcpy(batch_section_buffer(id, initiator2target), &frame[pos], length);
+        pos += length;
+    }
+}
+
+static bool batch_stage(int8_t id, const void *data, size_t length) {
+    uint8_t *buffer = batch_section_buffer(id, true);
+    uint8_t  size   = batch_section_size(id, true);
+    if (length > size) length = size;
+    if (memcmp(buffer, data, length) != 0) {
+        memcpy(buffer, data, length);
+        batch_pending |= (uint32_t)1 << id;
+    }
+    return true;
+}
+
+static bool batch_fetch(int8_t id, void *data, size_t length) {
+    // Already unpacked from the last reply
+    uint8_t size = batch_section_size(id, false);
+    memcpy(data, batch_section_buffer(id, false), length < size ? length : size);
+    return true;
+}
+
+static bool batch_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    static bool    resync   = true;
+    static uint8_t ack      = 0;
+    static uint8_t sequence = 0;
+    uint8_t        frame[SPLIT_BATCH_M2S_BUFFER_SIZE];
+    uint8_t        reply[SPLIT_BATCH_S2M_BUFFER_SIZE];
+    uint32_t       sent   = 0;
+    uint8_t        length = BATCH_HEADER_SIZE;
+
+    for (uint8_t id = BATCH_FIRST_ID; id < EXCHANGE_BATCH; id++) {
+        uint8_t section = batch_section_size(id, true);
+        if (resync && section) {
+            batch_pending |= (uint32_t)1 << id;
+        }
+        // Whatever doesn't fit goes out with the next scan
+        if (!(batch_pending & ((uint32_t)1 << id)) || 1 + section > sizeof(frame) - 1 - length) continue;
+        frame[length++] = id;
+        memcpy(&frame[length], batch_section_buffer(id, true), section);
+        length += section;
+        sent |= (uint32_t)1 << id;
+    }
+    sequence += BATCH_SEQUENCE_STEP;
+
+    length = batch_frame_finish(frame, sequence | ack | (resync ? BATCH_FULL : 0), length);
+
+    if (!transport_execute_transaction(EXCHANGE_BATCH, frame, length, reply, sizeof(reply)) || !batch_frame_valid(reply, sizeof(reply), false)) {
+        ack = 0;
+        return false;
+    }
+    batch_frame_apply(reply, false);
+    ack = BATCH_ACK;
+
+    if (!(reply[0] & BATCH_ACK) || (reply[0] & BATCH_SEQUENCE_MASK) != sequence) {
+        return false;
+    }
+    batch_pending &= ~sent;
+    if (reply[0] & BATCH_NEED_FULL) {
+        resync = true;
+    } else if (frame[0] & BATCH_FULL) {
+        resync = false;
+    }
+    return true;
+}
+
+static void slave_batch_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    // Images of every slave-to-master section: as of the last reply, and as of the last acknowledged one
+    static uint8_t sent[SPLIT_BATCH_S2M_BUFFER_SIZE];
+    static uint8_t acked[SPLIT_BATCH_S2M_BUFFER_SIZE];
+    static bool    acked_valid = false;
+    static bool    synced      = false;
+    const uint8_t *frame       = (const uint8_t *)initiator2target_buffer;
+    uint8_t *      reply       = (uint8_t *)target2initiator_buffer;
+    uint8_t        flags       = 0;
+
+    if (batch_frame_valid(frame, initiator2target_buffer_size, true)) {
+        if (frame[0] & BATCH_FULL) {
+            synced      = true;
+            acked_valid = false;
+        } else if (frame[0] & BATCH_ACK) {
+            memcpy(acked, sent, sizeof(acked));
+            acked_valid = true;
+        }
+        batch_frame_apply(frame, true);
+        flags |= BATCH_ACK | (frame[0] & BATCH_SEQUENCE_MASK);
+    }
+    if (!synced) {
+        flags |= BATCH_NEED_FULL;
+    }
+
+    uint8_t image  = 0;
+    uint8_t length = BATCH_HEADER_SIZE;
+    for (uint8_t id = BATCH_FIRST_ID; id < EXCHANGE_BATCH; id++) {
+        uint8_t section = batch_section_size(id, false);
+        if (section == 0) continue;
+        if (section > sizeof(sent) - image) break;
+        const uint8_t *buffer = batch_section_buffer(id, false);
+        memcpy(&sent[image], buffer, section);
+        if (!acked_valid || memcmp(&acked[image], buffer, section) != 0) {
+            if (1 + section <= target2initiator_buffer_size - 1 - length) {
+                reply[length++] = id;
+                memcpy(&reply[length], buffer, section);
+                length += section;
+            } else {
+                // No room this time, so remember something that can't match and send it with a later reply
+                sent[image] = ~buffer[0];
+            }
+        }
+        image += section;
+    }
+    batch_frame_finish(reply, flags, length);
+}
+
+#    define TRANSACTIONS_BATCH_REGISTRATIONS [EXCHANGE_BATCH] = trans_exchange_initializer_cb(batch.m2s, batch.s2m, slave_batch_callback),
+
+#else  // SPLIT_TRANSPORT_BATCH
+
+#    define TRANSACTIONS_BATCH_REGISTRATIONS
+
+#endif  // SPLIT_TRANSPORT_BATCH
+
 ////////////////////////////////////////////////////
 
 uint8_t                  dummy;
@@ -591,6 +1038,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 
     // clang-format off
     TRANSACTIONS_SLAVE_MATRIX_REGISTRATIONS
+    TRANSACTIONS_SLAVE_EVENTS_REGISTRATIONS
     TRANSACTIONS_MASTER_MATRIX_REGISTRATIONS
     TRANSACTIONS_ENCODERS_REGISTRATIONS
     TRANSACTIONS_SYNC_TIMER_REGISTRATIONS
@@ -604,6 +1052,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
     TRANSACTIONS_WPM_REGISTRATIONS
     TRANSACTIONS_OLED_REGISTRATIONS
     TRANSACTIONS_ST7565_REGISTRATIONS
+    TRANSACTIONS_BATCH_REGISTRATIONS
 // clang-format on
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
@@ -615,6 +1064,29 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 };
 
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+#ifdef SPLIT_TRANSPORT_BATCH
+    // Stage everything headed for the slave, swap it all in one exchange, then unpack what came back
+    TRANSACTIONS_MASTER_MATRIX_MASTER();
+    TRANSACTIONS_SYNC_TIMER_MASTER();
+    TRANSACTIONS_LAYER_STATE_MASTER();
+    TRANSACTIONS_LED_STATE_MASTER();
+    TRANSACTIONS_MODS_MASTER();
+    TRANSACTIONS_BACKLIGHT_MASTER();
+    TRANSACTIONS_RGBLIGHT_MASTER();
+    TRANSACTIONS_LED_MATRIX_MASTER();
+    TRANSACTIONS_RGB_MATRIX_MASTER();
+    TRANSACTIONS_WPM_MASTER();
+    TRANSACTIONS_OLED_MASTER();
+    TRANSACTIONS_ST7565_MASTER();
+    // The exchange is the only transfer, so the scan fails exactly when it does
+    if (!transaction_handler_master(master_matrix, slave_matrix, "batch", &batch_handlers_master)) {
+        return false;
+    }
+    TRANSACTIONS_SLAVE_MATRIX_MASTER();
+    TRANSACTIONS_ENCODERS_MASTER();
+    return true;
+#else  // SPLIT_TRANSPORT_BATCH
+    TRANSACTIONS_SLAVE_EVENTS_MASTER();
     TRANSACTIONS_SLAVE_MATRIX_MASTER();
     TRANSACTIONS_MASTER_MATRIX_MASTER();
     TRANSACTIONS_ENCODERS_MASTER();
@@ -630,10 +1102,12 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     TRANSACTIONS_OLED_MASTER();
     TRANSACTIONS_ST7565_MASTER();
     return true;
+#endif  // SPLIT_TRANSPORT_BATCH
 }
 
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     TRANSACTIONS_SLAVE_MATRIX_SLAVE();
+    TRANSACTIONS_SLAVE_EVENTS_SLAVE();
     TRANSACTIONS_MASTER_MATRIX_SLAVE();
     TRANSACTIONS_ENCODERS_SLAVE();
     TRANSACTIONS_SYNC_TIMER_SLAVE();
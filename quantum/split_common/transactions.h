@@ -23,6 +23,10 @@
 #include "transaction_id_define.h"
 #include "transport.h"
 
+#ifdef SPLIT_TRANSPORT_EVENTS
+#    include "keyboard.h"
+#endif  // SPLIT_TRANSPORT_EVENTS
+
 typedef void (*slave_callback_t)(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
 
 // Split transaction Descriptor
@@ -46,6 +50,12 @@ extern split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS];
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 
+#ifdef SPLIT_TRANSPORT_EVENTS
+// Hands out the slave's key events in the order they happened, with their rows and times
+// already translated for the master. Returns false once there are none left.
+bool transactions_slave_event(keyevent_t *event);
+#endif  // SPLIT_TRANSPORT_EVENTS
+
 void transaction_register_rpc(int8_t transaction_id, slave_callback_t callback);
 
 bool transaction_rpc_exec(int8_t transaction_id, uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer);
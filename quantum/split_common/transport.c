@@ -113,6 +113,11 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
 
 #endif  // USE_I2C
 
+#ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+// Both I2C and the serial driver only ever answer the master
+#    error "SPLIT_TRANSPORT_EVENTS_PUSH needs a transport that can start a transfer from the slave, use SPLIT_TRANSPORT = custom"
+#endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) { return transactions_master(master_matrix, slave_matrix); }
 
 void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) { transactions_slave(master_matrix, slave_matrix); }
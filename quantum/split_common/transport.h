@@ -40,6 +40,13 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 
 bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length);
 
+#ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+// Sends the first `length` bytes of the slave's split_shmem->spush into the master's, without
+// waiting to be polled. Returns false if the push could not be started this time.
+// None of the in-tree transports implement this, only custom ones and the test loopback.
+bool transport_slave_push(uint8_t length);
+#endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+
 #ifdef ENCODER_ENABLE
 #    include "encoder.h"
 #    define NUMBER_OF_ENCODERS (sizeof((pin_t[])ENCODERS_PAD_A) / sizeof(pin_t))
@@ -58,6 +65,50 @@ typedef struct _split_slave_matrix_sync_t {
     matrix_row_t matrix[(MATRIX_ROWS) / 2];
 } split_slave_matrix_sync_t;
 
+#ifdef SPLIT_TRANSPORT_EVENTS
+#    ifndef SPLIT_EVENT_COUNT
+#        define SPLIT_EVENT_COUNT 8
+#    endif  // SPLIT_EVENT_COUNT
+
+#    define SPLIT_KEY_EVENT_PRESSED 0x80
+
+typedef struct _split_key_event_t {
+    uint8_t key;   // row * MATRIX_COLS + col within the slave half, or'ed with SPLIT_KEY_EVENT_PRESSED for a press
+    uint8_t time;  // low byte of the sync timer when the key changed
+} split_key_event_t;
+
+// The slave's most recent key events, for the master to poll
+typedef struct _split_slave_events_t {
+    uint8_t head;  // events recorded so far, wrapping; the newest is at (head - 1) % SPLIT_EVENT_COUNT
+#    ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+    bool pushes;  // the slave's transport delivered the newest events on its own
+#    endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+    split_key_event_t events[SPLIT_EVENT_COUNT];
+} split_slave_events_t;
+
+// What the master polls for. A checksum alone misses about one change in 256, the head never does.
+typedef struct _split_slave_events_poll_t {
+    uint8_t checksum;
+    uint8_t head;
+} split_slave_events_poll_t;
+
+typedef struct _split_slave_events_sync_t {
+    split_slave_events_poll_t poll;
+    split_slave_events_t      events;
+} split_slave_events_sync_t;
+
+#    ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+// The events that are new since the slave's previous push, oldest first. Only the
+// first `count` events are sent, the checksum covers everything after it that was.
+typedef struct _split_slave_push_t {
+    uint8_t           checksum;
+    uint8_t           head;  // the ring's head after these events
+    uint8_t           count;
+    split_key_event_t events[SPLIT_EVENT_COUNT];
+} split_slave_push_t;
+#    endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+#endif      // SPLIT_TRANSPORT_EVENTS
+
 #ifdef SPLIT_TRANSPORT_MIRROR
 typedef struct _split_master_matrix_sync_t {
     matrix_row_t matrix[(MATRIX_ROWS) / 2];
@@ -106,6 +157,24 @@ typedef struct _split_mods_sync_t {
 } split_mods_sync_t;
 #endif  // SPLIT_MODS_ENABLE
 
+#ifdef SPLIT_TRANSPORT_BATCH
+#    ifndef SPLIT_BATCH_M2S_BUFFER_SIZE
+#        define SPLIT_BATCH_M2S_BUFFER_SIZE 32
+#    endif  // SPLIT_BATCH_M2S_BUFFER_SIZE
+
+// The reply always has room for every slave-to-master section: 3 bytes of framing plus an ID byte per section
+#    ifdef ENCODER_ENABLE
+#        define SPLIT_BATCH_S2M_BUFFER_SIZE (3 + 2 + sizeof(split_slave_matrix_sync_t) + 2 + sizeof(split_slave_encoder_sync_t))
+#    else
+#        define SPLIT_BATCH_S2M_BUFFER_SIZE (3 + 2 + sizeof(split_slave_matrix_sync_t))
+#    endif  // ENCODER_ENABLE
+
+typedef struct _split_batch_sync_t {
+    uint8_t m2s[SPLIT_BATCH_M2S_BUFFER_SIZE];
+    uint8_t s2m[SPLIT_BATCH_S2M_BUFFER_SIZE];
+} split_batch_sync_t;
+#endif  // SPLIT_TRANSPORT_BATCH
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 typedef struct _rpc_sync_info_t {
     int8_t  transaction_id;
@@ -121,6 +190,13 @@ typedef struct _split_shared_memory_t {
 
     split_slave_matrix_sync_t smatrix;
 
+#ifdef SPLIT_TRANSPORT_EVENTS
+    split_slave_events_sync_t sevents;
+#    ifdef SPLIT_TRANSPORT_EVENTS_PUSH
+    split_slave_push_t spush;
+#    endif  // SPLIT_TRANSPORT_EVENTS_PUSH
+#endif      // SPLIT_TRANSPORT_EVENTS
+
 #ifdef SPLIT_TRANSPORT_MIRROR
     split_master_matrix_sync_t mmatrix;
 #endif  // SPLIT_TRANSPORT_MIRROR
@@ -173,6 +249,10 @@ typedef struct _split_shared_memory_t {
     uint8_t current_st7565_state;
 #endif  // ST7565_ENABLE(OLED_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
+#ifdef SPLIT_TRANSPORT_BATCH
+    split_batch_sync_t batch;
+#endif  // SPLIT_TRANSPORT_BATCH
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     rpc_sync_info_t rpc_info;
     uint8_t         rpc_m2s_buffer[RPC_M2S_BUFFER_SIZE];
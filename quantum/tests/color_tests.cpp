@@ -0,0 +1,187 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "color.h"
+#include "led_tables.h"
+}
+
+/* RGB is laid out in whatever order the LEDs take, so it can't be brace initialized */
+static RGB make_rgb(uint8_t r, uint8_t g, uint8_t b) {
+    RGB rgb;
+    rgb.r = r;
+    rgb.g = g;
+    rgb.b = b;
+    return rgb;
+}
+
+/* The conversion as it was written before it lost its division, to check against */
+static RGB reference_hsv_to_rgb(HSV hsv, bool use_cie) {
+    RGB      rgb;
+    uint8_t  region, remainder, p, q, t;
+    uint16_t h, s, v;
+
+    h = hsv.h;
+    s = hsv.s;
+    v = use_cie ? CIE1931_CURVE[hsv.v] : hsv.v;
+
+    if (s == 0) {
+        return make_rgb(v, v, v);
+    }
+
+    region    = h * 6 / 255;
+    remainder = (h * 2 - region * 85) * 3;
+
+    p = (v * (255 - s)) >> 8;
+    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    switch (region) {
+        case 6:
+        case 0:
+            rgb = make_rgb(v, t, p);
+            break;
+        case 1:
+            rgb = make_rgb(q, v, p);
+            break;
+        case 2:
+            rgb = make_rgb(p, v, t);
+            break;
+        case 3:
+            rgb = make_rgb(p, q, v);
+            break;
+        case 4:
+            rgb = make_rgb(t, p, v);
+            break;
+        default:
+            rgb = make_rgb(v, p, q);
+            break;
+    }
+    return rgb;
+}
+
+static bool operator==(const RGB& a, const RGB& b) { return a.r == b.r && a.g == b.g && a.b == b.b; }
+
+static std::ostream& operator<<(std::ostream& os, const RGB& rgb) { return os << "{" << (int)rgb.r << ", " << (int)rgb.g << ", " << (int)rgb.b << "}"; }
+
+class Color : public testing::Test {
+   protected:
+    std::vector<HSV> hsv;
+    std::vector<RGB> rgb;
+
+    /* One hue and saturation plane at a time, with every value */
+    void plane(uint8_t h) {
+        hsv.resize(256 * 256);
+        rgb.resize(256 * 256);
+        for (int s = 0; s < 256; s++) {
+            for (int v = 0; v < 256; v++) {
+                hsv[s * 256 + v] = {.h = h, .s = (uint8_t)s, .v = (uint8_t)v};
+            }
+        }
+    }
+};
+
+TEST_F(Color, EveryColorMatchesTheReference) {
+    for (int h = 0; h < 256; h++) {
+        plane(h);
+        for (auto& in : hsv) {
+            ASSERT_EQ(hsv_to_rgb(in), reference_hsv_to_rgb(in, true)) << "h " << (int)in.h << " s " << (int)in.s << " v " << (int)in.v;
+            ASSERT_EQ(hsv_to_rgb_nocie(in), reference_hsv_to_rgb(in, false)) << "h " << (int)in.h << " s " << (int)in.s << " v " << (int)in.v;
+        }
+    }
+}
+
+TEST_F(Color, BuffersMatchOneAtATime) {
+    for (int h = 0; h < 256; h++) {
+        plane(h);
+        for (size_t row = 0; row < hsv.size(); row += 256) {
+            hsv_to_rgb_buffer(&hsv[row], &rgb[row], 256);
+        }
+        for (size_t i = 0; i < hsv.size(); i++) {
+            ASSERT_EQ(rgb[i], hsv_to_rgb(hsv[i])) << "h " << (int)hsv[i].h << " s " << (int)hsv[i].s << " v " << (int)hsv[i].v;
+        }
+        for (size_t row = 0; row < hsv.size(); row += 256) {
+            hsv_to_rgb_buffer_nocie(&hsv[row], &rgb[row], 256);
+        }
+        for (size_t i = 0; i < hsv.size(); i++) {
+            ASSERT_EQ(rgb[i], hsv_to_rgb_nocie(hsv[i])) << "h " << (int)hsv[i].h << " s " << (int)hsv[i].s << " v " << (int)hsv[i].v;
+        }
+    }
+}
+
+TEST_F(Color, BufferConvertsInPlace) {
+    plane(100);
+    hsv.resize(4096);
+    std::vector<HSV> in = hsv;
+    hsv_to_rgb_buffer(hsv.data(), (RGB*)hsv.data(), hsv.size());
+    for (size_t i = 0; i < in.size(); i++) {
+        ASSERT_EQ(((RGB*)hsv.data())[i], hsv_to_rgb(in[i])) << "s " << (int)in[i].s << " v " << (int)in[i].v;
+    }
+}
+
+TEST_F(Color, EmptyBufferIsLeftAlone) {
+    RGB out = make_rgb(1, 2, 3);
+    HSV in  = {.h = 0, .s = 255, .v = 255};
+    hsv_to_rgb_buffer(&in, &out, 0);
+    EXPECT_EQ(out, make_rgb(1, 2, 3));
+}
+
+TEST_F(Color, Benchmark) {
+    using clock = std::chrono::steady_clock;
+
+    /* Every hue at full saturation and a few values, like a rainbow across a board */
+    hsv.clear();
+    for (int i = 0; i < 4096; i++) {
+        hsv.push_back({.h = (uint8_t)(i * 7), .s = (uint8_t)(255 - i % 64), .v = (uint8_t)(i * 13)});
+    }
+    rgb.resize(hsv.size());
+
+    const int rounds = 2000;
+    uint32_t  sink   = 0;
+
+    auto start = clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < hsv.size(); i++) {
+            rgb[i] = reference_hsv_to_rgb(hsv[i], true);
+        }
+        sink += rgb[r % rgb.size()].r;
+    }
+    double reference = std::chrono::duration<double, std::nano>(clock::now() - start).count() / rounds / hsv.size();
+
+    start = clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < hsv.size(); i++) {
+            rgb[i] = hsv_to_rgb(hsv[i]);
+        }
+        sink += rgb[r % rgb.size()].r;
+    }
+    double single = std::chrono::duration<double, std::nano>(clock::now() - start).count() / rounds / hsv.size();
+
+    start = clock::now();
+    for (int r = 0; r < rounds; r++) {
+        hsv_to_rgb_buffer(hsv.data(), rgb.data(), hsv.size());
+        sink += rgb[r % rgb.size()].r;
+    }
+    double buffer = std::chrono::duration<double, std::nano>(clock::now() - start).count() / rounds / hsv.size();
+
+    std::cout << "[ BENCHMARK] hsv_to_rgb: " << single << " ns/color, hsv_to_rgb_buffer: " << buffer << " ns/color, with division: " << reference << " ns/color (" << sink % 2 << ")" << std::endl;
+}
@@ -0,0 +1,11 @@
+color_DEFS := -DNO_PRINT -DNO_DEBUG -DUSE_CIE1931_CURVE
+
+color_SRC := \
+	$(QUANTUM_PATH)/tests/color_tests.cpp \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/led_tables.c
+
+# The same checks with q and t worked out side by side in one word, as on Cortex-M4
+color_packed_DEFS := $(color_DEFS) -DHSV_TO_RGB_PACKED
+
+color_packed_SRC := $(color_SRC)
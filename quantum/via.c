@@ -44,6 +44,7 @@
 
 #include "raw_hid.h"
 #include "dynamic_keymap.h"
+#include "profiler.h"
 #include "eeprom.h"
 #include "version.h"  // for QMK_BUILDDATE used in EEPROM magic
 #include "via_ensure_keycode.h"
@@ -374,6 +375,11 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             break;
         }
         default: {
+#ifdef PROFILER_ENABLE
+            if (profiler_raw_hid_command(data, length)) {
+                break;
+            }
+#endif
             // The command ID is not known
             // Return the unhandled state
             *command_id = id_unhandled;
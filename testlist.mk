@@ -3,6 +3,13 @@ FULL_TESTS := $(notdir $(TEST_LIST))
 
 include $(QUANTUM_PATH)/debounce/tests/testlist.mk
 include $(QUANTUM_PATH)/sequencer/tests/testlist.mk
+include $(QUANTUM_PATH)/split_common/tests/testlist.mk
+include $(QUANTUM_PATH)/audio/tests/testlist.mk
+include $(QUANTUM_PATH)/tests/testlist.mk
+include $(DRIVER_PATH)/oled/tests/testlist.mk
+include $(DRIVER_PATH)/sensors/tests/testlist.mk
+include $(DRIVER_PATH)/ps2/tests/testlist.mk
+include $(DRIVER_PATH)/led/issi/tests/testlist.mk
 include $(PLATFORM_PATH)/test/testlist.mk
 
 define VALIDATE_TEST_LIST
@@ -0,0 +1,76 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::SaveArg;
+
+class ChordLatency : public TestFixture, public testing::WithParamInterface<std::vector<uint16_t>> {
+   protected:
+    /* Run scan loops until the last report sent matches the expected one, returning the number of scans it took. */
+    unsigned scans_until_report(TestDriver& driver, const std::vector<uint8_t>& expected, unsigned max_scans) {
+        report_keyboard_t last    = {};
+        auto              matcher = testing::MakeMatcher(new KeyboardReportMatcher(expected));
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber()).WillRepeatedly(SaveArg<0>(&last));
+        for (unsigned scans = 1; scans <= max_scans; scans++) {
+            run_one_scan_loop();
+            if (matcher.Matches(last)) {
+                return scans;
+            }
+        }
+        return max_scans + 1;
+    }
+};
+
+TEST_P(ChordLatency, WholeChordIsReportedInOneScan) {
+    TestDriver             driver;
+    std::vector<KeymapKey> keys;
+    std::vector<uint8_t>   report;
+
+    for (auto code : GetParam()) {
+        keys.emplace_back(0, keys.size(), 0, code);
+        report.push_back(code);
+    }
+    for (auto& key : keys) {
+        add_key(key);
+    }
+
+    for (auto& key : keys) {
+        key.press();
+    }
+    EXPECT_EQ(scans_until_report(driver, report, keys.size()), 1u);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    for (auto& key : keys) {
+        key.release();
+    }
+    EXPECT_EQ(scans_until_report(driver, {}, keys.size()), 1u);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+// clang-format off
+INSTANTIATE_TEST_CASE_P(
+    Chords,
+    ChordLatency,
+    testing::Values(
+        std::vector<uint16_t>{KC_A, KC_B},
+        std::vector<uint16_t>{KC_A, KC_B, KC_C, KC_D, KC_E, KC_F},
+        std::vector<uint16_t>{KC_LCTL, KC_LSFT, KC_LALT, KC_LGUI, KC_A, KC_B, KC_C, KC_D, KC_E, KC_F}
+    ));
+// clang-format on
@@ -57,6 +57,7 @@ TEST_F(KeyPress, ANonMappedKeyDoesNothing) {
 
 TEST_F(KeyPress, CorrectKeysAreReportedWhenTwoKeysArePressed) {
     TestDriver driver;
+    InSequence s;
     auto       key_b = KeymapKey(0, 0, 0, KC_B);
     auto       key_c = KeymapKey(0, 1, 1, KC_C);
 
@@ -64,11 +65,8 @@ TEST_F(KeyPress, CorrectKeysAreReportedWhenTwoKeysArePressed) {
 
     key_b.press();
     key_c.press();
-    // Note that QMK only processes one key at a time
-    // See issue #1476 for more information
+    // Every key that changed is processed in the same scan, in matrix order
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code)));
-    keyboard_task();
-
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_b.report_code, key_c.report_code)));
     keyboard_task();
 
@@ -76,14 +74,13 @@ TEST_F(KeyPress, CorrectKeysAreReportedWhenTwoKeysArePressed) {
     key_c.release();
     // Note that the first key released is the first one in the matrix order
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_c.report_code)));
-    keyboard_task();
-
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
     keyboard_task();
 }
 
 TEST_F(KeyPress, LeftShiftIsReportedCorrectly) {
     TestDriver driver;
+    InSequence s;
     auto       key_a    = KeymapKey(0, 0, 0, KC_A);
     auto       key_lsft = KeymapKey(0, 3, 0, KC_LSFT);
 
@@ -95,7 +92,6 @@ TEST_F(KeyPress, LeftShiftIsReportedCorrectly) {
     // Unfortunately modifiers are also processed in the wrong order
     // See issue #1476 for more information
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code)));
-    keyboard_task();
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_a.report_code, key_lsft.report_code)));
     keyboard_task();
 
@@ -110,6 +106,7 @@ TEST_F(KeyPress, LeftShiftIsReportedCorrectly) {
 
 TEST_F(KeyPress, PressLeftShiftAndControl) {
     TestDriver driver;
+    InSequence s;
     auto       key_lsft  = KeymapKey(0, 3, 0, KC_LSFT);
     auto       key_lctrl = KeymapKey(0, 5, 0, KC_LCTRL);
 
@@ -121,8 +118,6 @@ TEST_F(KeyPress, PressLeftShiftAndControl) {
     // Unfortunately modifiers are also processed in the wrong order
     // See issue #1476 for more information
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code)));
-    keyboard_task();
-
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code, key_lctrl.report_code)));
     keyboard_task();
 
@@ -130,14 +125,13 @@ TEST_F(KeyPress, PressLeftShiftAndControl) {
     key_lctrl.release();
 
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lctrl.report_code)));
-    keyboard_task();
-
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
     keyboard_task();
 }
 
 TEST_F(KeyPress, LeftAndRightShiftCanBePressedAtTheSameTime) {
     TestDriver driver;
+    InSequence s;
     auto       key_lsft = KeymapKey(0, 3, 0, KC_LSFT);
     auto       key_rsft = KeymapKey(0, 4, 0, KC_RSFT);
 
@@ -148,8 +142,6 @@ TEST_F(KeyPress, LeftAndRightShiftCanBePressedAtTheSameTime) {
     // Unfortunately modifiers are also processed in the wrong order
     // See issue #1476 for more information
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code)));
-    keyboard_task();
-
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_lsft.report_code, key_rsft.report_code)));
     keyboard_task();
 
@@ -157,8 +149,6 @@ TEST_F(KeyPress, LeftAndRightShiftCanBePressedAtTheSameTime) {
     key_rsft.release();
 
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(key_rsft.report_code)));
-    keyboard_task();
-
     EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
     keyboard_task();
 }
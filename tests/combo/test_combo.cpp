@@ -0,0 +1,326 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#endif
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "action_tapping.h"
+
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+using testing::Invoke;
+
+/* This suite is built twice: tests/combo scans every combo, tests/combo_index
+ * defines COMBO_INDEX_SIZE. Both builds have to pass the same expectations. */
+
+#define MAX_TEST_COMBOS 500
+#define MAX_TEST_COMBO_KEYS 4
+
+extern "C" {
+combo_t  key_combos[MAX_TEST_COMBOS];
+uint16_t COMBO_LEN = 0;
+}
+
+static uint16_t combo_keys[MAX_TEST_COMBOS][MAX_TEST_COMBO_KEYS + 1];
+
+struct TestCombo {
+    std::vector<uint16_t> keys;
+    uint16_t              keycode;
+};
+
+static void set_combos(const std::vector<TestCombo>& combos) {
+    ASSERT_LE(combos.size(), MAX_TEST_COMBOS);
+    for (size_t i = 0; i < combos.size(); i++) {
+        ASSERT_LE(combos[i].keys.size(), MAX_TEST_COMBO_KEYS);
+        size_t k = 0;
+        for (; k < combos[i].keys.size(); k++) {
+            combo_keys[i][k] = combos[i].keys[k];
+        }
+        combo_keys[i][k] = COMBO_END;
+        key_combos[i]    = (combo_t)COMBO(combo_keys[i], combos[i].keycode);
+    }
+    COMBO_LEN = combos.size();
+    build_combo_index();
+}
+
+namespace {
+uint64_t read_cycles() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/* Small deterministic PRNG so both builds see the same input */
+uint32_t xorshift(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+}  // namespace
+
+class Combo : public TestFixture {
+   protected:
+    KeymapKey key_a = KeymapKey(0, 0, 0, KC_A);
+    KeymapKey key_b = KeymapKey(0, 1, 0, KC_B);
+    KeymapKey key_c = KeymapKey(0, 2, 0, KC_C);
+    KeymapKey key_d = KeymapKey(0, 3, 0, KC_D);
+
+    void SetUp() override {
+        set_keymap({key_a, key_b, key_c, key_d});
+        set_combos({
+            {{KC_A, KC_B}, KC_X},
+            {{KC_B, KC_C}, KC_Y},
+            {{KC_A, KC_B, KC_C}, KC_Z},
+        });
+    }
+
+    void TearDown() override { set_combos({}); }
+};
+
+TEST_F(Combo, ChordSendsComboKeycode) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    key_a.press();
+    run_one_scan_loop();
+    key_b.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X)));
+    idle_for(COMBO_TERM + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_a.release();
+    run_one_scan_loop();
+    key_b.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(Combo, LongestOverlappingComboWins) {
+    TestDriver driver;
+    InSequence s;
+
+    key_a.press();
+    run_one_scan_loop();
+    key_b.press();
+    run_one_scan_loop();
+    key_c.press();
+    run_one_scan_loop();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Z)));
+    idle_for(COMBO_TERM + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_a.release();
+    key_b.release();
+    key_c.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(Combo, LoneComboKeyIsSentAfterTerm) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    key_a.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    idle_for(COMBO_TERM + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_a.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(Combo, NonComboKeyPassesThrough) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_D)));
+    key_d.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_d.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(Combo, ReleasedComboKeyIsNotHeldBack) {
+    TestDriver driver;
+    InSequence s;
+
+    /* Tapping a combo key quickly sends it once it is released */
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_b.press();
+    run_one_scan_loop();
+    key_b.release();
+    run_one_scan_loop();
+    idle_for(COMBO_TERM + 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+class ComboStream : public TestFixture {
+   protected:
+    std::vector<KeymapKey> keys;
+
+    void SetUp() override {
+        for (uint8_t i = 0; i < MATRIX_COLS; i++) {
+            keys.push_back(KeymapKey(0, i, 0, KC_A + i));
+        }
+        for (auto& key : keys) {
+            add_key(key);
+        }
+    }
+
+    void TearDown() override { set_combos({}); }
+
+    /* Overlapping combos of 2 to MAX_TEST_COMBO_KEYS distinct keys, results F1-F12 */
+    std::vector<TestCombo> random_combos(size_t count, uint32_t& rng) {
+        std::vector<TestCombo> combos;
+        while (combos.size() < count) {
+            TestCombo combo{{}, (uint16_t)(KC_F1 + combos.size() % 12)};
+            size_t    length = 2 + xorshift(rng) % (MAX_TEST_COMBO_KEYS - 1);
+            while (combo.keys.size() < length) {
+                uint16_t keycode = keys[xorshift(rng) % keys.size()].code;
+                if (std::find(combo.keys.begin(), combo.keys.end(), keycode) == combo.keys.end()) {
+                    combo.keys.push_back(keycode);
+                }
+            }
+            combos.push_back(combo);
+        }
+        return combos;
+    }
+
+    /* Presses and releases random keys with random gaps, some of them close enough to chord */
+    void type_randomly(unsigned events, uint32_t& rng) {
+        std::vector<bool> pressed(keys.size(), false);
+
+        for (unsigned i = 0; i < events; i++) {
+            size_t k = xorshift(rng) % keys.size();
+            if (pressed[k]) {
+                keys[k].release();
+            } else {
+                keys[k].press();
+            }
+            pressed[k] = !pressed[k];
+            run_one_scan_loop();
+            idle_for(xorshift(rng) % (COMBO_TERM * 2));
+        }
+
+        for (size_t k = 0; k < keys.size(); k++) {
+            if (pressed[k]) {
+                keys[k].release();
+            }
+        }
+        idle_for(COMBO_TERM * 2);
+    }
+};
+
+/* The checksum of every report sent for a fixed random workload. It was recorded
+ * with the linear scan, so the index has to reproduce it exactly. */
+TEST_F(ComboStream, ReportsMatchReference) {
+    TestDriver driver;
+    uint32_t   rng      = 0xC0FFEE;
+    uint32_t   checksum = 0;
+    unsigned   reports  = 0;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&](report_keyboard_t& report) {
+        for (size_t i = 0; i < sizeof(report.raw); i++) {
+            checksum = (checksum * 31) ^ report.raw[i];
+        }
+        reports++;
+    }));
+
+    set_combos(random_combos(24, rng));
+    type_randomly(4000, rng);
+
+    EXPECT_EQ(reports, 3872u);
+    EXPECT_EQ(checksum, 0xD392E0u);
+}
+
+/* Same kind of workload, fed straight into process_combo so that only the
+ * combo matching is timed and not the rest of the scan loop. */
+TEST_F(ComboStream, CyclesPerKeyEvent) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (size_t count : {10, 100, 500}) {
+        const unsigned    events = 20000;
+        uint32_t          rng    = 0x1234567;
+        uint64_t          cycles = 0;
+        std::vector<bool> pressed(keys.size(), false);
+
+        set_combos(random_combos(count, rng));
+        for (unsigned i = 0; i < events; i++) {
+            size_t k   = xorshift(rng) % keys.size();
+            pressed[k] = !pressed[k];
+
+            keyrecord_t record = {.event = {.key = keys[k].position, .pressed = pressed[k], .time = (uint16_t)(timer_read() | 1)}};
+
+            uint64_t start       = read_cycles();
+            bool     pass_through = process_combo(keys[k].code, &record);
+            cycles += read_cycles() - start;
+
+            if (pass_through) {
+                action_tapping_process(record);
+            }
+            advance_time(xorshift(rng) % (COMBO_TERM * 2));
+            combo_task();
+        }
+
+        for (size_t k = 0; k < keys.size(); k++) {
+            if (pressed[k]) {
+                keyrecord_t record = {.event = {.key = keys[k].position, .pressed = false, .time = (uint16_t)(timer_read() | 1)}};
+                if (process_combo(keys[k].code, &record)) {
+                    action_tapping_process(record);
+                }
+            }
+        }
+        idle_for(COMBO_TERM * 2);
+
+        std::cout << "[ BENCHMARK] " << count << " combos, " << events << " key events: " << (double)cycles / events << " cycles/event" << std::endl;
+        RecordProperty("cycles_per_event_" + std::to_string(count), (int)(cycles / events));
+    }
+}
@@ -0,0 +1,89 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::AtLeast;
+
+/* A tap dance that sends KC_A when tapped and holds Shift when held past the tapping term */
+static void dance_finished(qk_tap_dance_state_t *state, void *user_data) { register_code(state->pressed ? KC_LSFT : KC_A); }
+
+static void dance_reset(qk_tap_dance_state_t *state, void *user_data) {
+    unregister_code(KC_LSFT);
+    unregister_code(KC_A);
+}
+
+extern "C" {
+qk_tap_dance_action_t tap_dance_actions[] = {
+    [0] = ACTION_TAP_DANCE_FN_ADVANCED(NULL, dance_finished, dance_reset),
+};
+
+uint16_t key_combo_keys[] = {TD(0), KC_B, COMBO_END};
+combo_t  key_combos[]     = {COMBO(key_combo_keys, KC_X)};
+uint16_t COMBO_LEN        = 1;
+}
+
+class ComboTapDance : public TestFixture {};
+
+TEST_F(ComboTapDance, HeldDanceKeyOfAComboIsAHold) {
+    TestDriver driver;
+    auto       key_dance = KeymapKey(0, 0, 0, TD(0));
+    auto       key_b     = KeymapKey(0, 1, 0, KC_B);
+    set_keymap({key_dance, key_b});
+    /* The combo timer reads 0 as not running, so keep the press away from the very first millisecond */
+    run_one_scan_loop();
+
+    /* The combo holds the press back for its term, then hands it to the tap dance, which has to decide on its own */
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    key_dance.press();
+    run_one_scan_loop();
+    idle_for(COMBO_TERM);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    idle_for(TAPPING_TERM + 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AtLeast(1));
+    key_dance.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(ComboTapDance, TappedDanceKeyOfAComboIsATap) {
+    TestDriver driver;
+    auto       key_dance = KeymapKey(0, 0, 0, TD(0));
+    auto       key_b     = KeymapKey(0, 1, 0, KC_B);
+    set_keymap({key_dance, key_b});
+    run_one_scan_loop();
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    key_dance.press();
+    run_one_scan_loop();
+    key_dance.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).Times(AtLeast(1));
+    idle_for(COMBO_TERM + TAPPING_TERM + 2);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
@@ -0,0 +1,212 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <vector>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "deferred_exec.h"
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+}
+
+struct Invocation {
+    uintptr_t id;
+    uint32_t  time;
+};
+
+static std::vector<Invocation> invocations;
+static uint32_t                repeat_delay  = 0;
+static deferred_token          cancel_target = INVALID_DEFERRED_TOKEN;
+
+static uint32_t record_callback(uint32_t trigger_time, void* cb_arg) {
+    invocations.push_back({(uintptr_t)cb_arg, timer_read32()});
+    return repeat_delay;
+}
+
+static uint32_t cancelling_callback(uint32_t trigger_time, void* cb_arg) {
+    invocations.push_back({(uintptr_t)cb_arg, timer_read32()});
+    cancel_deferred_exec(cancel_target);
+    return 0;
+}
+
+class DeferredExec : public testing::Test {
+   protected:
+    void SetUp() override {
+        // Time keeps moving forward between tests, as the task only runs once per millisecond
+        advance_time(1000);
+        base = timer_read32();
+        invocations.clear();
+        repeat_delay  = 0;
+        cancel_target = INVALID_DEFERRED_TOKEN;
+    }
+
+    void TearDown() override {
+        for (auto token : tokens) {
+            cancel_deferred_exec(token);
+        }
+    }
+
+    deferred_token defer(uint32_t delay_ms, uintptr_t id, deferred_exec_callback callback = record_callback) {
+        deferred_token token = defer_exec(delay_ms, callback, (void*)id);
+        tokens.push_back(token);
+        return token;
+    }
+
+    void run_for(uint32_t ms) {
+        for (uint32_t i = 0; i < ms; i++) {
+            advance_time(1);
+            deferred_exec_task();
+        }
+    }
+
+    std::vector<deferred_token> tokens;
+    uint32_t                    base;
+};
+
+TEST_F(DeferredExec, InvalidArgumentsAreRejected) {
+    EXPECT_EQ(defer_exec(0, record_callback, nullptr), INVALID_DEFERRED_TOKEN);
+    EXPECT_EQ(defer_exec(10, nullptr, nullptr), INVALID_DEFERRED_TOKEN);
+    EXPECT_FALSE(extend_deferred_exec(INVALID_DEFERRED_TOKEN, 10));
+    EXPECT_FALSE(cancel_deferred_exec(INVALID_DEFERRED_TOKEN));
+}
+
+TEST_F(DeferredExec, FiresOnceAfterDelay) {
+    auto token = defer(10, 1);
+    ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+
+    run_for(9);
+    EXPECT_TRUE(invocations.empty());
+    run_for(1);
+    ASSERT_EQ(invocations.size(), 1u);
+    EXPECT_EQ(invocations[0].time, base + 10);
+
+    run_for(100);
+    EXPECT_EQ(invocations.size(), 1u);
+    EXPECT_FALSE(cancel_deferred_exec(token));
+}
+
+TEST_F(DeferredExec, RepeatsRelativeToPreviousTrigger) {
+    repeat_delay = 5;
+    defer(10, 1);
+
+    run_for(20);
+    ASSERT_EQ(invocations.size(), 3u);
+    EXPECT_EQ(invocations[0].time, base + 10);
+    EXPECT_EQ(invocations[1].time, base + 15);
+    EXPECT_EQ(invocations[2].time, base + 20);
+}
+
+TEST_F(DeferredExec, CancelledExecutorDoesNotFire) {
+    auto token = defer(10, 1);
+    run_for(5);
+    EXPECT_TRUE(cancel_deferred_exec(token));
+    EXPECT_FALSE(cancel_deferred_exec(token));
+    run_for(20);
+    EXPECT_TRUE(invocations.empty());
+}
+
+TEST_F(DeferredExec, ExtendMovesDeadline) {
+    auto token = defer(10, 1);
+    run_for(5);
+    EXPECT_TRUE(extend_deferred_exec(token, 10));
+    run_for(9);
+    EXPECT_TRUE(invocations.empty());
+    run_for(1);
+    ASSERT_EQ(invocations.size(), 1u);
+    EXPECT_EQ(invocations[0].time, base + 15);
+}
+
+TEST_F(DeferredExec, FiresInDeadlineOrder) {
+    defer(30, 3);
+    defer(10, 1);
+    defer(20, 2);
+    auto token = defer(25, 4);
+    EXPECT_TRUE(extend_deferred_exec(token, 1));
+
+    run_for(30);
+    ASSERT_EQ(invocations.size(), 4u);
+    EXPECT_EQ(invocations[0].id, 4u);
+    EXPECT_EQ(invocations[1].id, 1u);
+    EXPECT_EQ(invocations[2].id, 2u);
+    EXPECT_EQ(invocations[3].id, 3u);
+}
+
+TEST_F(DeferredExec, CallbackCanCancelAnotherDueExecutor) {
+    defer(10, 1, cancelling_callback);
+    cancel_target = defer(10, 2);
+
+    run_for(10);
+    ASSERT_EQ(invocations.size(), 1u);
+    EXPECT_EQ(invocations[0].id, 1u);
+}
+
+TEST_F(DeferredExec, StaleTokenDoesNotMatchReusedSlot) {
+    auto stale = defer(10, 1);
+    EXPECT_TRUE(cancel_deferred_exec(stale));
+
+    auto fresh = defer(10, 2);
+    EXPECT_NE(fresh, stale);
+    EXPECT_FALSE(cancel_deferred_exec(stale));
+    EXPECT_FALSE(extend_deferred_exec(stale, 10));
+
+    run_for(10);
+    ASSERT_EQ(invocations.size(), 1u);
+    EXPECT_EQ(invocations[0].id, 2u);
+}
+
+TEST_F(DeferredExec, SupportsManyExecutors) {
+    std::set<deferred_token> unique;
+    for (uintptr_t i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        auto token = defer(MAX_DEFERRED_EXECUTORS - i, i);
+        ASSERT_NE(token, INVALID_DEFERRED_TOKEN);
+        unique.insert(token);
+    }
+    EXPECT_EQ(unique.size(), (size_t)MAX_DEFERRED_EXECUTORS);
+    EXPECT_EQ(defer_exec(1, record_callback, nullptr), INVALID_DEFERRED_TOKEN);
+
+    run_for(MAX_DEFERRED_EXECUTORS);
+    ASSERT_EQ(invocations.size(), (size_t)MAX_DEFERRED_EXECUTORS);
+    for (uintptr_t i = 0; i < MAX_DEFERRED_EXECUTORS; i++) {
+        EXPECT_EQ(invocations[i].id, MAX_DEFERRED_EXECUTORS - 1 - i);
+        EXPECT_EQ(invocations[i].time, base + 1 + i);
+    }
+}
+
+/* The cost of a task call with nothing due should not depend on how many executors are pending */
+TEST_F(DeferredExec, BenchmarkIdleTaskCost) {
+    const uint32_t calls = 100000;
+
+    for (size_t count : {1, 10, 100, MAX_DEFERRED_EXECUTORS}) {
+        while (tokens.size() < count) {
+            defer(calls * 2, tokens.size());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        run_for(calls);
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "[ BENCHMARK] " << count << " pending executors: " << (double)ns / calls << " ns per deferred_exec_task()" << std::endl;
+        for (auto token : tokens) {
+            extend_deferred_exec(token, calls * 2);
+        }
+    }
+    EXPECT_TRUE(invocations.empty());
+}
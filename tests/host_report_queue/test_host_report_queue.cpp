@@ -0,0 +1,276 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+using testing::Invoke;
+
+#define ENDPOINT_DELAY 8
+
+class HostReportQueue : public TestFixture {
+   protected:
+    std::vector<KeymapKey> keys;
+
+    std::vector<report_keyboard_t> keyboard_reports;
+    std::vector<report_mouse_t>    mouse_reports;
+
+    void SetUp() override {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            keys.push_back(KeymapKey(0, col, 0, KC_A + col));
+        }
+        for (auto& key : keys) {
+            add_key(key);
+        }
+    }
+
+    void record(TestDriver& driver) {
+        EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber()).WillRepeatedly(Invoke([this](report_keyboard_t& report) { keyboard_reports.push_back(report); }));
+        EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber()).WillRepeatedly(Invoke([this](report_mouse_t& report) { mouse_reports.push_back(report); }));
+    }
+
+    /* Runs the script with a step every `interval` scans, returns how long that took */
+    uint32_t play(std::vector<std::pair<uint8_t, bool>> script, unsigned interval = 1) {
+        uint32_t start = timer_read32();
+        for (auto& step : script) {
+            if (step.second) {
+                keys[step.first].press();
+            } else {
+                keys[step.first].release();
+            }
+            idle_for(interval);
+        }
+        return timer_elapsed32(start);
+    }
+
+    static std::set<uint8_t> keys_in(const report_keyboard_t& report) {
+        std::set<uint8_t> down;
+        for (uint8_t k = 0; k < KEYBOARD_REPORT_KEYS; k++) {
+            if (report.keys[k]) down.insert(report.keys[k]);
+        }
+        return down;
+    }
+
+    /* Every press and release the host sees, in order. Changes that arrive in the same report are listed together. */
+    std::vector<std::pair<std::set<uint8_t>, std::set<uint8_t>>> host_events(void) {
+        std::vector<std::pair<std::set<uint8_t>, std::set<uint8_t>>> events;
+        std::set<uint8_t>                                             down;
+        for (auto& report : keyboard_reports) {
+            std::set<uint8_t> now = keys_in(report);
+            std::set<uint8_t> pressed, released;
+            for (uint8_t code : now) {
+                if (!down.count(code)) pressed.insert(code);
+            }
+            for (uint8_t code : down) {
+                if (!now.count(code)) released.insert(code);
+            }
+            events.push_back({pressed, released});
+            down = now;
+        }
+        return events;
+    }
+
+    /* The host must see every press and every release, and the presses one at a time and in the order they happened */
+    void expect_lossless(std::vector<std::pair<uint8_t, bool>> script) {
+        std::vector<uint8_t>      presses;
+        std::map<uint8_t, size_t> changes;
+        for (auto& step : script) {
+            if (step.second) presses.push_back(KC_A + step.first);
+            changes[KC_A + step.first]++;
+        }
+
+        std::vector<uint8_t>      host_presses;
+        std::map<uint8_t, size_t> host_changes;
+        for (auto& event : host_events()) {
+            EXPECT_LE(event.first.size(), 1u) << "two presses arrived in the same report";
+            for (uint8_t code : event.first) {
+                host_presses.push_back(code);
+                host_changes[code]++;
+            }
+            for (uint8_t code : event.second) {
+                host_changes[code]++;
+            }
+        }
+        EXPECT_EQ(host_presses, presses);
+        EXPECT_EQ(host_changes, changes);
+        ASSERT_FALSE(keyboard_reports.empty());
+        EXPECT_TRUE(keys_in(keyboard_reports.back()).empty());
+    }
+};
+
+TEST_F(HostReportQueue, ReportsWaitForTheEndpoint) {
+    TestDriver driver;
+    InSequence s;
+    driver.set_endpoint_delay(ENDPOINT_DELAY);
+
+    uint32_t start = timer_read32();
+    auto     at    = [&](uint32_t t) { return Invoke([=](report_keyboard_t&) { EXPECT_EQ(timer_elapsed32(start), t); }); };
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).WillOnce(at(0));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).WillOnce(at(ENDPOINT_DELAY));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B))).WillOnce(at(2 * ENDPOINT_DELAY));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).WillOnce(at(3 * ENDPOINT_DELAY));
+    EXPECT_EQ(play({{0, true}, {0, false}, {1, true}, {1, false}}), 4u);
+    idle_for(4 * ENDPOINT_DELAY);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(HostReportQueue, FastTappingLosesNothing) {
+    TestDriver driver;
+    driver.set_endpoint_delay(ENDPOINT_DELAY);
+    record(driver);
+
+    /* Only a release and the press after it can share a report, the queue fills up and the scan loop has to wait */
+    std::vector<std::pair<uint8_t, bool>> script;
+    for (uint8_t i = 0; i < 20; i++) {
+        script.push_back({i % MATRIX_COLS, true});
+        script.push_back({i % MATRIX_COLS, false});
+    }
+    uint32_t elapsed = play(script);
+    idle_for(HOST_REPORT_QUEUE_SIZE * ENDPOINT_DELAY * 2);
+
+    EXPECT_GT(elapsed, script.size());
+    EXPECT_GE(keyboard_reports.size(), script.size() / 2);
+    expect_lossless(script);
+}
+
+TEST_F(HostReportQueue, PressesStayInOrder) {
+    TestDriver driver;
+    driver.set_endpoint_delay(ENDPOINT_DELAY);
+    record(driver);
+
+    /* Six keys go down one after the other, then come up together */
+    std::vector<std::pair<uint8_t, bool>> script;
+    for (uint8_t i = 0; i < 6; i++) {
+        script.push_back({5 - i, true});
+    }
+    for (uint8_t i = 0; i < 6; i++) {
+        script.push_back({i, false});
+    }
+    play(script);
+    idle_for(HOST_REPORT_QUEUE_SIZE * ENDPOINT_DELAY * 2);
+
+    expect_lossless(script);
+}
+
+TEST_F(HostReportQueue, RolledTypingCoalescesWithoutStalling) {
+    TestDriver driver;
+    driver.set_endpoint_delay(ENDPOINT_DELAY);
+    record(driver);
+
+    /* Each key goes down before the one before it comes up, as fast as the endpoint takes presses */
+    std::vector<std::pair<uint8_t, bool>> script = {{0, true}};
+    for (uint8_t i = 1; i < 30; i++) {
+        script.push_back({i % MATRIX_COLS, true});
+        script.push_back({(i - 1) % MATRIX_COLS, false});
+    }
+    script.push_back({29 % MATRIX_COLS, false});
+    uint32_t elapsed = play(script, ENDPOINT_DELAY / 2);
+    idle_for(HOST_REPORT_QUEUE_SIZE * ENDPOINT_DELAY * 2);
+
+    EXPECT_EQ(elapsed, script.size() * ENDPOINT_DELAY / 2);
+    EXPECT_LT(keyboard_reports.size(), script.size());
+    expect_lossless(script);
+    RecordProperty("KeyboardReports", keyboard_reports.size());
+}
+
+TEST_F(HostReportQueue, MouseMovementAddsUp) {
+    TestDriver driver;
+    driver.set_endpoint_delay(ENDPOINT_DELAY);
+    record(driver);
+
+    int      x = 0, y = 0;
+    uint32_t start = timer_read32();
+    for (int i = 0; i < 60; i++) {
+        report_mouse_t report = {};
+        report.buttons        = (i >= 20 && i < 40) ? MOUSE_BTN1 : 0;
+        report.x              = 1 + i % 5;
+        report.y              = -(i % 3);
+        x += report.x;
+        y += report.y;
+        host_mouse_send(&report);
+        run_one_scan_loop();
+    }
+    EXPECT_EQ(timer_elapsed32(start), 60u);
+    idle_for(HOST_REPORT_QUEUE_SIZE * ENDPOINT_DELAY * 2);
+
+    int     host_x = 0, host_y = 0, clicks = 0;
+    uint8_t buttons = 0;
+    for (auto& report : mouse_reports) {
+        host_x += report.x;
+        host_y += report.y;
+        if (report.buttons != buttons) clicks++;
+        buttons = report.buttons;
+    }
+    EXPECT_EQ(host_x, x);
+    EXPECT_EQ(host_y, y);
+    /* The button went down and back up, with movement on either side kept apart */
+    EXPECT_EQ(clicks, 2);
+    EXPECT_LT(mouse_reports.size(), 20u);
+}
+
+TEST_F(HostReportQueue, ExtraReportsKeepTheirOrder) {
+    TestDriver driver;
+    InSequence s;
+    driver.set_endpoint_delay(ENDPOINT_DELAY);
+
+    EXPECT_CALL(driver, send_consumer_mock(AUDIO_VOL_UP));
+    EXPECT_CALL(driver, send_consumer_mock(0));
+    EXPECT_CALL(driver, send_system_mock(SYSTEM_SLEEP));
+    EXPECT_CALL(driver, send_system_mock(0));
+    host_consumer_send(AUDIO_VOL_UP);
+    host_consumer_send(0);
+    host_system_send(SYSTEM_SLEEP);
+    host_system_send(0);
+    idle_for(4 * ENDPOINT_DELAY);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(HostReportQueue, HostThatStopsReadingDoesNotFreezeTheKeyboard) {
+    TestDriver driver;
+    /* The endpoint takes one report and is never read again */
+    driver.set_endpoint_delay(UINT32_MAX / 2);
+
+    std::vector<uint16_t> sent;
+    EXPECT_CALL(driver, send_consumer_mock(_)).Times(AnyNumber()).WillRepeatedly(Invoke([&](uint16_t usage) { sent.push_back(usage); }));
+    uint32_t start = timer_read32();
+    for (uint16_t i = 1; i <= 3 * HOST_REPORT_QUEUE_SIZE; i++) {
+        uint32_t before = timer_read32();
+        host_consumer_send(i);
+        /* Each one waits no longer than the timeout */
+        EXPECT_LE(timer_elapsed32(before), 10u + 1);
+    }
+    EXPECT_LE(timer_elapsed32(start), 3 * HOST_REPORT_QUEUE_SIZE * 11u);
+    EXPECT_EQ(sent, std::vector<uint16_t>({1}));
+
+    /* The scan loop keeps running, and the newest reports are what is left once the host reads again */
+    run_one_scan_loop();
+    driver.set_endpoint_delay(ENDPOINT_DELAY);
+    idle_for(HOST_REPORT_QUEUE_SIZE * ENDPOINT_DELAY * 2);
+    std::vector<uint16_t> expected = {1};
+    for (uint16_t i = 2 * HOST_REPORT_QUEUE_SIZE + 1; i <= 3 * HOST_REPORT_QUEUE_SIZE; i++) {
+        expected.push_back(i);
+    }
+    EXPECT_EQ(sent, expected);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
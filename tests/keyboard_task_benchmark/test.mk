@@ -0,0 +1,27 @@
+# Copyright 2021 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+COMBO_ENABLE = yes
+KEY_OVERRIDE_ENABLE = yes
+TAP_DANCE_ENABLE = yes
+
+SRC += tests/keyboard_task_benchmark/benchmark_keymap.c
+
+# Count heap allocations made by the firmware while it is being measured. --wrap is
+# only understood by the GNU and LLVM linkers, so elsewhere the count is left out.
+ifeq ($(shell uname -s),Linux)
+    OPT_DEFS += -DBENCHMARK_COUNT_ALLOCATIONS
+    LDFLAGS += -Wl,--wrap=malloc,--wrap=calloc,--wrap=realloc
+endif
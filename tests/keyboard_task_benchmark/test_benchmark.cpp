@@ -0,0 +1,474 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef __linux__
+#    include <linux/perf_event.h>
+#    include <sys/ioctl.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "host.h"
+
+void advance_time(uint32_t ms);
+}
+
+/* Replays recorded key streams through keyboard_task against one keymap that
+ * uses combos, home row mod-taps, a tap dance and a key override. For every
+ * stream it reports the cost of keyboard_task per key event, how long in
+ * simulated milliseconds each event took to show up in a report and how many
+ * heap allocations the firmware made, where the linker can count them. Set QMK_BENCHMARK_JSON to a file name to
+ * get the results as JSON, `make test:keyboard_task_benchmark:bench` does that for you. */
+
+/* Heap allocations, only counted while keyboard_task is being measured. The
+ * wrappers are hooked in with --wrap in test.mk. */
+static bool     counting_allocations = false;
+static unsigned allocations          = 0;
+
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+extern "C" {
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+
+void* __wrap_malloc(size_t size) {
+    allocations += counting_allocations;
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    allocations += counting_allocations;
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    allocations += counting_allocations;
+    return __real_realloc(ptr, size);
+}
+}
+#endif
+
+namespace {
+/* Retired user space instructions, if the kernel lets us count them */
+class InstructionCounter {
+   public:
+    InstructionCounter() {
+#ifdef __linux__
+        perf_event_attr attr = {};
+        attr.type            = PERF_TYPE_HARDWARE;
+        attr.size            = sizeof(attr);
+        attr.config          = PERF_COUNT_HW_INSTRUCTIONS;
+        attr.disabled        = 1;
+        attr.exclude_kernel  = 1;
+        attr.exclude_hv      = 1;
+        m_fd                 = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+
+    ~InstructionCounter() {
+#ifdef __linux__
+        if (available()) {
+            close(m_fd);
+        }
+#endif
+    }
+
+    bool available() const { return m_fd >= 0; }
+
+    void start() {
+#ifdef __linux__
+        if (available()) {
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+
+    void stop() {
+#ifdef __linux__
+        if (available()) {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+        }
+#endif
+    }
+
+    uint64_t read() {
+        uint64_t count = 0;
+#ifdef __linux__
+        if (available() && ::read(m_fd, &count, sizeof(count)) != sizeof(count)) {
+            count = 0;
+        }
+#endif
+        return count;
+    }
+
+   private:
+    int m_fd = -1;
+};
+
+struct KeyEvent {
+    uint32_t time;
+    size_t   key;
+    bool     pressed;
+};
+
+struct Result {
+    std::string           name;
+    unsigned              events       = 0;
+    unsigned              scans        = 0;
+    unsigned              reports      = 0;
+    unsigned              allocations  = 0;
+    double                instructions = -1;
+    double                wall_ns      = 0;
+    std::vector<uint32_t> latencies;
+};
+
+std::vector<Result> results;
+
+/* Collects what the host would see while a stream is replayed */
+struct Recorder {
+    Result*               result;
+    std::vector<uint32_t> pending;
+
+    void report() {
+        result->reports++;
+        for (uint32_t time : pending) {
+            result->latencies.push_back(timer_read32() - time);
+        }
+        pending.clear();
+    }
+};
+
+Recorder* recorder = nullptr;
+
+void record_report(void) {
+    if (recorder) {
+        recorder->report();
+    }
+}
+
+uint8_t keyboard_leds(void) { return 0; }
+void    send_keyboard(report_keyboard_t* report) { record_report(); }
+void    send_mouse(report_mouse_t* report) { record_report(); }
+void    send_system(uint16_t data) { record_report(); }
+void    send_consumer(uint16_t data) { record_report(); }
+
+host_driver_t benchmark_driver = {keyboard_leds, send_keyboard, send_mouse, send_system, send_consumer};
+
+uint32_t xorshift(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+uint32_t percentile(const std::vector<uint32_t>& sorted, unsigned percent) { return sorted.empty() ? 0 : sorted[std::min(sorted.size() - 1, sorted.size() * percent / 100)]; }
+
+std::string to_json(const Result& result) {
+    std::vector<uint32_t> sorted = result.latencies;
+    std::sort(sorted.begin(), sorted.end());
+    double mean = 0;
+    for (uint32_t latency : sorted) {
+        mean += latency;
+    }
+    mean = sorted.empty() ? 0 : mean / sorted.size();
+
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(1);
+    json << "{\"name\": \"" << result.name << "\", ";
+    json << "\"events\": " << result.events << ", ";
+    json << "\"scans\": " << result.scans << ", ";
+    json << "\"reports\": " << result.reports << ", ";
+    if (result.instructions < 0) {
+        json << "\"instructions_per_event\": null, ";
+    } else {
+        json << "\"instructions_per_event\": " << result.instructions / result.events << ", ";
+    }
+    json << "\"wall_ns_per_event\": " << result.wall_ns / result.events << ", ";
+    json << "\"wall_ns_per_scan\": " << result.wall_ns / result.scans << ", ";
+    json << "\"latency_ms\": {\"mean\": " << mean << ", \"p50\": " << percentile(sorted, 50) << ", \"p99\": " << percentile(sorted, 99) << ", \"max\": " << percentile(sorted, 100) << "}, ";
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+    json << "\"allocations\": " << result.allocations << "}";
+#else
+    json << "\"allocations\": null}";
+#endif
+    return json.str();
+}
+
+/* Writes every stream's results once the whole suite has run */
+class BenchmarkReport : public ::testing::Environment {
+   public:
+    void TearDown() override {
+        const char* path = std::getenv("QMK_BENCHMARK_JSON");
+        if (!path) {
+            return;
+        }
+        std::ofstream out(path);
+        out << "{\"benchmarks\": [\n";
+        for (size_t i = 0; i < results.size(); i++) {
+            out << "    " << to_json(results[i]) << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "]}\n";
+    }
+};
+
+::testing::Environment* const benchmark_report = ::testing::AddGlobalTestEnvironment(new BenchmarkReport);
+}  // namespace
+
+// clang-format off
+static const uint16_t base_layer[MATRIX_ROWS][MATRIX_COLS] = {
+    {KC_Q,    KC_W,    KC_E,  KC_R,    KC_T,   KC_Y,   KC_U,    KC_I,    KC_O,    KC_P},
+    {KC_A,    KC_S,    KC_D,  KC_F,    KC_G,   KC_H,   KC_J,    KC_K,    KC_L,    KC_SCLN},
+    {KC_Z,    KC_X,    KC_C,  KC_V,    KC_B,   KC_N,   KC_M,    KC_COMM, KC_DOT,  KC_SLSH},
+    {KC_LSFT, KC_LCTL, TD(0), KC_BSPC, KC_SPC, KC_ENT, KC_QUOT, KC_RSFT, KC_RCTL, KC_RALT},
+};
+
+/* Layer 1 only changes the home row */
+static const uint16_t home_row_mods[MATRIX_COLS] = {
+    LGUI_T(KC_A), LALT_T(KC_S), LCTL_T(KC_D), LSFT_T(KC_F), KC_TRNS, KC_TRNS, RSFT_T(KC_J), RCTL_T(KC_K), LALT_T(KC_L), RGUI_T(KC_SCLN),
+};
+// clang-format on
+
+static const char corpus[] =
+    "The quick brown fox jumps over the lazy dog. Keyboards spend most of their time waiting for the next key, "
+    "so every scan that finds nothing to do should be cheap. When a key does change, the report has to reach the "
+    "host as soon as the keymap allows it. Home row mods, combos and tap dances all hold keys back for a while, "
+    "and that delay is part of what we want to see here. Typing this text at a steady pace, with the odd fast "
+    "roll between neighbouring letters, gives a workload that looks a lot like real use.";
+
+class KeyboardTaskBenchmark : public TestFixture {
+   protected:
+    std::vector<KeymapKey> keys;
+    std::vector<KeyEvent>  stream;
+    std::vector<uint32_t>  free_at;
+    uint32_t               clock = 0;
+    uint32_t               rng   = 0x5EED;
+
+    void SetUp() override {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keys.push_back(KeymapKey(0, col, row, base_layer[row][col]));
+                add_key(keys.back());
+                add_key(KeymapKey(1, col, row, row == 1 ? home_row_mods[col] : KC_TRNS));
+            }
+        }
+        free_at.assign(keys.size(), 0);
+
+        // A mocked driver would cost more than the code being measured
+        host_set_driver(&benchmark_driver);
+    }
+
+    size_t key_for(uint16_t keycode) {
+        for (size_t i = 0; i < keys.size(); i++) {
+            if (keys[i].code == keycode) {
+                return i;
+            }
+        }
+        ADD_FAILURE() << "No key for keycode " << keycode;
+        return 0;
+    }
+
+    uint32_t random_between(uint32_t min, uint32_t max) { return min + xorshift(rng) % (max - min + 1); }
+
+    /* Holds a key from time (or as soon as it has been let go of) for duration ms, returns when it went down */
+    uint32_t hold(size_t key, uint32_t time, uint32_t duration) {
+        time = std::max(time, free_at[key]);
+        stream.push_back({time, key, true});
+        stream.push_back({time + duration, key, false});
+        free_at[key] = time + duration + 1;
+        return time;
+    }
+
+    /* A typist hitting one key every interval ms, holding each for hold ms. When
+     * the hold is longer than the interval neighbouring keys roll into each other. */
+    void type(const char* text, uint32_t min_interval, uint32_t max_interval, uint32_t min_hold, uint32_t max_hold) {
+        const size_t shift = key_for(KC_LSFT);
+        for (const char* c = text; *c; c++) {
+            uint8_t  ascii    = (uint8_t)*c;
+            bool     shifted  = (ascii_to_shift_lut[ascii / 8] >> (ascii % 8)) & 1;
+            size_t   key      = key_for(ascii_to_keycode_lut[ascii]);
+            uint32_t duration = random_between(min_hold, max_hold);
+            if (shifted) {
+                uint32_t time = hold(key, hold(shift, clock, duration + 40) + 20, duration);
+                clock         = std::max(clock, time);
+            } else {
+                clock = hold(key, clock, duration);
+            }
+            clock += random_between(min_interval, max_interval);
+        }
+    }
+
+    /* Plays the stream back. No event may take longer than max_latency simulated
+     * ms to reach a report, that is how long the slowest feature in play may hold
+     * a key back plus the scan it gets resolved in. */
+    void replay(const char* name, uint32_t max_latency) {
+        std::stable_sort(stream.begin(), stream.end(), [](const KeyEvent& a, const KeyEvent& b) { return a.time < b.time; });
+
+        results.push_back(Result());
+        Result& result = results.back();
+        result.name    = name;
+        result.events  = stream.size();
+        result.latencies.reserve(stream.size());
+
+        Recorder run = {&result, {}};
+        run.pending.reserve(stream.size());
+        recorder = &run;
+
+        /* What an empty measurement costs, so that it can be taken out again */
+        InstructionCounter counter;
+        const unsigned     calibration_rounds = 1000;
+        for (unsigned i = 0; i < calibration_rounds; i++) {
+            counter.start();
+            auto start = std::chrono::steady_clock::now();
+            auto end   = std::chrono::steady_clock::now();
+            counter.stop();
+            (void)(end - start);
+        }
+        double overhead = (double)counter.read() / calibration_rounds;
+
+        std::chrono::steady_clock::duration wall   = std::chrono::steady_clock::duration::zero();
+        const uint32_t                      base   = timer_read32();
+        size_t                              next   = 0;
+        uint64_t                            before = counter.read();
+        while (next < stream.size() || timer_elapsed32(base) < stream.back().time + TAPPING_TERM * 5) {
+            for (; next < stream.size() && stream[next].time <= timer_elapsed32(base); next++) {
+                if (stream[next].pressed) {
+                    keys[stream[next].key].press();
+                } else {
+                    keys[stream[next].key].release();
+                }
+                run.pending.push_back(timer_read32());
+            }
+
+            allocations          = 0;
+            counting_allocations = true;
+            counter.start();
+            auto start = std::chrono::steady_clock::now();
+            keyboard_task();
+            auto end = std::chrono::steady_clock::now();
+            counter.stop();
+            counting_allocations = false;
+
+            wall += end - start;
+            result.allocations += allocations;
+            result.scans++;
+            advance_time(1);
+        }
+        if (counter.available()) {
+            result.instructions = std::max(0.0, (double)(counter.read() - before) - overhead * result.scans);
+        }
+        result.wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(wall).count();
+
+        recorder = nullptr;
+
+        // Every event has to have been followed by a report, and the scan loop must never allocate
+        EXPECT_TRUE(run.pending.empty());
+#ifdef BENCHMARK_COUNT_ALLOCATIONS
+        EXPECT_EQ(result.allocations, 0u);
+#endif
+        EXPECT_GT(result.reports, 0u);
+
+        std::vector<uint32_t> sorted = result.latencies;
+        std::sort(sorted.begin(), sorted.end());
+        EXPECT_LE(percentile(sorted, 100), max_latency);
+        std::cout << "[ BENCHMARK] " << name << ": " << result.events << " key events, " << result.scans << " scans, ";
+        if (counter.available()) {
+            std::cout << (uint64_t)(result.instructions / result.events) << " instructions/event, ";
+        }
+        std::cout << (uint64_t)(result.wall_ns / result.events) << " ns/event, latency p50 " << percentile(sorted, 50) << " ms p99 " << percentile(sorted, 99) << " ms max " << percentile(sorted, 100) << " ms" << std::endl;
+        RecordProperty("wall_ns_per_event", (int)(result.wall_ns / result.events));
+        RecordProperty("latency_p99_ms", (int)percentile(sorted, 99));
+    }
+};
+
+TEST_F(KeyboardTaskBenchmark, Typing) {
+    type(corpus, 80, 160, 50, 100);
+    // Only the combo keys wait
+    replay("typing", COMBO_TERM + 1);
+}
+
+TEST_F(KeyboardTaskBenchmark, TapHoldRolls) {
+    layer_on(1);
+    type(corpus, 40, 100, 60, 120);
+    replay("tap_hold_rolls", TAPPING_TERM + 1);
+}
+
+TEST_F(KeyboardTaskBenchmark, Chords) {
+    const uint16_t chords[][2] = {{KC_J, KC_K}, {KC_D, KC_F}, {KC_C, KC_V}};
+    for (int i = 0; i < 200; i++) {
+        const uint16_t* chord = chords[xorshift(rng) % 3];
+        // Both keys land within the combo term, in either order
+        uint32_t first  = hold(key_for(chord[i % 2]), clock, random_between(80, 140));
+        uint32_t second = hold(key_for(chord[1 - i % 2]), first + random_between(0, COMBO_TERM / 2), random_between(80, 140));
+        clock           = second + 300;
+        if (i % 4 == 0) {
+            type("the ", 80, 160, 50, 100);
+        }
+    }
+    // The chords' keys are mod-taps when they don't make a combo
+    replay("chords", TAPPING_TERM + 1);
+}
+
+TEST_F(KeyboardTaskBenchmark, TapDance) {
+    const size_t dance = key_for(TD(0));
+    for (int i = 0; i < 200; i++) {
+        switch (xorshift(rng) % 3) {
+            case 0:
+                clock = hold(dance, clock, 60);
+                break;
+            case 1:
+                clock = hold(dance, hold(dance, clock, 60) + 120, 60);
+                break;
+            default:
+                clock = hold(dance, clock, TAPPING_TERM + 100);
+                break;
+        }
+        // Half of the dances are cut short by the next key
+        clock += (i % 2) ? TAPPING_TERM + 50 : 80;
+        type("a ", 80, 160, 50, 100);
+        clock += TAPPING_TERM;
+    }
+    replay("tap_dance", TAPPING_TERM + 1);
+}
+
+TEST_F(KeyboardTaskBenchmark, KeyOverride) {
+    const size_t shift     = key_for(KC_LSFT);
+    const size_t backspace = key_for(KC_BSPC);
+    for (int i = 0; i < 200; i++) {
+        unsigned taps  = 1 + xorshift(rng) % 3;
+        uint32_t start = hold(shift, clock, 150 * taps + 100);
+        clock          = start + 80;
+        for (unsigned tap = 0; tap < taps; tap++) {
+            clock = hold(backspace, clock, 60) + 150;
+        }
+        clock = start + 150 * taps + 200;
+        type("x", 80, 160, 50, 100);
+    }
+    // Overrides never hold a key back
+    replay("key_override", 0);
+}
@@ -0,0 +1,197 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+/* This suite is built twice: tests/layer_cache caches every key, tests/layer_cache_partial
+ * only the first few so that both paths are used. Either way layer_switch_get_layer() has to
+ * give the same answers as walking the layers. */
+
+#define TEST_LAYERS 8
+
+namespace {
+uint32_t xorshift(uint32_t& state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+}  // namespace
+
+class LayerCache : public TestFixture {
+   protected:
+    layer_state_t saved_default_layer_state;
+    uint32_t      rng = 0xCAFE;
+
+    void SetUp() override { saved_default_layer_state = default_layer_state; }
+
+    void TearDown() override { default_layer_state = saved_default_layer_state; }
+
+    /* Every position on every layer, transparent_percent of them KC_TRNS */
+    void random_keymap(unsigned transparent_percent) {
+        keymap.clear();
+        for (uint8_t layer = 0; layer < TEST_LAYERS; layer++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    uint16_t keycode = xorshift(rng) % 100 < transparent_percent ? KC_TRNS : KC_A + xorshift(rng) % 26;
+                    add_key(KeymapKey(layer, col, row, keycode));
+                }
+            }
+        }
+        layer_cache_invalidate();
+    }
+
+    /* The walk layer_switch_get_layer() has always done */
+    uint8_t reference_layer(keypos_t key) {
+        layer_state_t layers = layer_state | default_layer_state;
+        for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+            if ((layers >> i) & 1 && action_for_key(i, key).code != ACTION_TRANSPARENT) {
+                return i;
+            }
+        }
+        return 0;
+    }
+
+    void random_layer_change() {
+        const uint8_t       layer = xorshift(rng) % TEST_LAYERS;
+        const layer_state_t state = xorshift(rng) & ((1 << TEST_LAYERS) - 1);
+        switch (xorshift(rng) % 7) {
+            case 0:
+                layer_on(layer);
+                break;
+            case 1:
+                layer_off(layer);
+                break;
+            case 2:
+                layer_invert(layer);
+                break;
+            case 3:
+                layer_move(layer);
+                break;
+            case 4:
+                layer_state_set(state);
+                break;
+            case 5:
+                default_layer_set((layer_state_t)1 << layer);
+                break;
+            default:
+                // Some code writes the state without going through layer_state_set()
+                layer_state = state;
+                break;
+        }
+    }
+
+    keypos_t random_key() { return (keypos_t){.col = (uint8_t)(xorshift(rng) % MATRIX_COLS), .row = (uint8_t)(xorshift(rng) % MATRIX_ROWS)}; }
+};
+
+TEST_F(LayerCache, MatchesLayerWalk) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (unsigned transparent_percent : {0, 50, 90, 100}) {
+        random_keymap(transparent_percent);
+        for (int round = 0; round < 2000; round++) {
+            random_layer_change();
+            // Only look at a few keys most of the time, so that the cache is partly filled when the layers change
+            const int lookups = round % 10 ? 3 : MATRIX_ROWS * MATRIX_COLS;
+            for (int i = 0; i < lookups; i++) {
+                keypos_t key = i < 3 ? random_key() : (keypos_t){.col = (uint8_t)(i % MATRIX_COLS), .row = (uint8_t)(i / MATRIX_COLS % MATRIX_ROWS)};
+                ASSERT_EQ(layer_switch_get_layer(key), reference_layer(key)) << "key " << +key.col << "," << +key.row << " with " << transparent_percent << "% transparent keys, round " << round;
+            }
+        }
+    }
+}
+
+TEST_F(LayerCache, KeymapChangeIsSeenAfterInvalidate) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    random_keymap(100);
+    layer_on(1);
+    keypos_t key = {.col = 0, .row = 0};
+    EXPECT_EQ(layer_switch_get_layer(key), 0);
+
+    // What a dynamic keymap write does to the keymap
+    std::vector<KeymapKey> old_keymap = keymap;
+    keymap.clear();
+    for (auto& k : old_keymap) {
+        add_key(k.layer == 1 && k.position.col == 0 && k.position.row == 0 ? KeymapKey(1, 0, 0, KC_B) : k);
+    }
+    layer_cache_invalidate();
+    EXPECT_EQ(layer_switch_get_layer(key), 1);
+}
+
+TEST_F(LayerCache, ReleaseUsesLayerOfPress) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_base  = KeymapKey(0, 0, 0, KC_A);
+    auto       key_upper = KeymapKey(1, 0, 0, KC_B);
+    set_keymap({key_base, key_upper});
+    layer_cache_invalidate();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    key_base.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // The release is still looked up on layer 0, where the key went down
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    layer_on(1);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_base.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    key_upper.press();
+    run_one_scan_loop();
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    key_upper.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerCache, StoredActionsMatchReference) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    random_keymap(60);
+
+    /* source_layers_cache as it should behave: the layer is picked on press and kept until release */
+    uint8_t pressed_on[MATRIX_ROWS][MATRIX_COLS];
+    bool    pressed[MATRIX_ROWS][MATRIX_COLS] = {};
+
+    for (int round = 0; round < 20000; round++) {
+        if (xorshift(rng) % 4 == 0) {
+            random_layer_change();
+        }
+
+        keypos_t key = random_key();
+        bool&    down = pressed[key.row][key.col];
+        down          = !down;
+        if (down) {
+            pressed_on[key.row][key.col] = reference_layer(key);
+        }
+
+        action_t expected = action_for_key(pressed_on[key.row][key.col], key);
+        ASSERT_EQ(store_or_get_action(down, key).code, expected.code) << "key " << +key.col << "," << +key.row << (down ? " pressed" : " released") << ", round " << round;
+    }
+}
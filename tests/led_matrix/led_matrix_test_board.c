@@ -0,0 +1,78 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "led_matrix_test_board.h"
+
+/* A 40 key board with 64 more LEDs around its edge, and one in the middle */
+led_config_t g_led_config = {
+    {
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9},
+        {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+        {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+        {30, 31, 32, 33, 34, 35, 36, 37, 38, 39},
+    },
+    {
+        {  0,  0}, { 25,  0}, { 50,  0}, { 75,  0}, {100,  0}, {124,  0}, {149,  0}, {174,  0},
+        {199,  0}, {224,  0}, {  0, 21}, { 25, 21}, { 50, 21}, { 75, 21}, {100, 21}, {124, 21},
+        {149, 21}, {174, 21}, {199, 21}, {224, 21}, {  0, 43}, { 25, 43}, { 50, 43}, { 75, 43},
+        {100, 43}, {124, 43}, {149, 43}, {174, 43}, {199, 43}, {224, 43}, {  0, 64}, { 25, 64},
+        { 50, 64}, { 75, 64}, {100, 64}, {124, 64}, {149, 64}, {174, 64}, {199, 64}, {224, 64},
+        {  0,  0}, {  9,  0}, { 18,  0}, { 27,  0}, { 37,  0}, { 46,  0}, { 55,  0}, { 64,  0},
+        { 73,  0}, { 82,  0}, { 91,  0}, {101,  0}, {110,  0}, {119,  0}, {128,  0}, {137,  0},
+        {146,  0}, {155,  0}, {165,  0}, {174,  0}, {183,  0}, {192,  0}, {201,  0}, {210,  0},
+        {219,  0}, {224,  5}, {224, 14}, {224, 23}, {224, 32}, {224, 41}, {224, 50}, {224, 59},
+        {219, 64}, {210, 64}, {201, 64}, {192, 64}, {183, 64}, {174, 64}, {165, 64}, {155, 64},
+        {146, 64}, {137, 64}, {128, 64}, {119, 64}, {110, 64}, {101, 64}, { 91, 64}, { 82, 64},
+        { 73, 64}, { 64, 64}, { 55, 64}, { 46, 64}, { 37, 64}, { 27, 64}, { 18, 64}, {  9, 64},
+        {  0, 64}, {  0, 55}, {  0, 46}, {  0, 37}, {  0, 27}, {  0, 18}, {  0,  9}, {112, 32},
+    },
+    {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+        2, 2, 2, 2,
+    },
+};
+
+uint8_t  test_leds[DRIVER_LED_TOTAL];
+uint32_t test_frame_checksum;
+uint32_t test_frames;
+
+static void test_init(void) {}
+
+static void test_set_value(int index, uint8_t value) { test_leds[index] = value; }
+
+static void test_set_value_all(uint8_t value) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        test_set_value(i, value);
+    }
+}
+
+static void test_flush(void) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        test_frame_checksum = test_frame_checksum * 31 + test_leds[i];
+    }
+    test_frames++;
+}
+
+const led_matrix_driver_t led_matrix_driver = {
+    .init          = test_init,
+    .flush         = test_flush,
+    .set_value     = test_set_value,
+    .set_value_all = test_set_value_all,
+};
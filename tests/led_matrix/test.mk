@@ -0,0 +1,22 @@
+# Copyright 2021 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+LED_MATRIX_ENABLE = yes
+LED_MATRIX_DRIVER = custom
+
+SRC += tests/led_matrix/led_matrix_test_board.c
+
+# led_matrix.c includes the board's config.h
+VPATH += $(TEST_PATH)
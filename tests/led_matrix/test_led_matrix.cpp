@@ -0,0 +1,235 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "led_matrix_test_board.h"
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+struct golden_t {
+    uint8_t     mode;
+    const char* name;
+    uint32_t    checksum;
+};
+
+/* Frame checksums over the script below, as the effects rendered them before their math was cached */
+static const std::vector<golden_t> golden = {
+    {LED_MATRIX_BAND_PINWHEEL, "BAND_PINWHEEL", 0xd0611d9b},
+    {LED_MATRIX_BAND_SPIRAL, "BAND_SPIRAL", 0xd3913868},
+    {LED_MATRIX_CYCLE_OUT_IN, "CYCLE_OUT_IN", 0x629985d7},
+    {LED_MATRIX_SOLID_REACTIVE_WIDE, "SOLID_REACTIVE_WIDE", 0x9051ef22},
+    {LED_MATRIX_SOLID_REACTIVE_MULTIWIDE, "SOLID_REACTIVE_MULTIWIDE", 0x51f1ab65},
+    {LED_MATRIX_SOLID_REACTIVE_CROSS, "SOLID_REACTIVE_CROSS", 0x218d040b},
+    {LED_MATRIX_SOLID_REACTIVE_MULTICROSS, "SOLID_REACTIVE_MULTICROSS", 0x2e6c9153},
+    {LED_MATRIX_SOLID_REACTIVE_NEXUS, "SOLID_REACTIVE_NEXUS", 0x574e6fbf},
+    {LED_MATRIX_SOLID_REACTIVE_MULTINEXUS, "SOLID_REACTIVE_MULTINEXUS", 0x96caaf21},
+    {LED_MATRIX_SOLID_SPLASH, "SOLID_SPLASH", 0x3c7e075c},
+    {LED_MATRIX_SOLID_MULTISPLASH, "SOLID_MULTISPLASH", 0x4e1322ab},
+};
+
+class LedMatrix : public TestFixture {
+   protected:
+    std::vector<KeymapKey> keys;
+
+    void SetUp() override {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keys.push_back(KeymapKey(0, col, row, KC_A + (row * MATRIX_COLS + col) % 26));
+            }
+        }
+        for (auto& key : keys) {
+            add_key(key);
+        }
+    }
+
+    /* Three seconds of an effect, with a few keys typed over the first one */
+    uint32_t play(uint8_t mode) {
+        led_matrix_mode_noeeprom(mode);
+        led_matrix_set_val_noeeprom(255);
+        led_matrix_set_speed_noeeprom(128);
+        idle_for(100);
+
+        test_frame_checksum = 0;
+        test_frames         = 0;
+        for (uint8_t i = 0; i < 12; i++) {
+            KeymapKey& key = keys[(i * 7) % keys.size()];
+            key.press();
+            idle_for(30);
+            key.release();
+            idle_for(50);
+        }
+        idle_for(2040);
+        return test_frame_checksum;
+    }
+};
+
+TEST_F(LedMatrix, EffectsRenderTheSameFrames) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (auto& effect : golden) {
+        uint32_t checksum = play(effect.mode);
+        EXPECT_GT(test_frames, 100u) << effect.name;
+        std::stringstream actual;
+        actual << "0x" << std::hex << std::setw(8) << std::setfill('0') << checksum;
+        EXPECT_EQ(checksum, effect.checksum) << effect.name << " rendered " << actual.str();
+    }
+}
+
+struct effect_t {
+    uint8_t     mode;
+    const char* name;
+};
+
+/* Every effect the board enables, straight from the list led_matrix numbers them by */
+static const std::vector<effect_t> every_effect = {
+#define LED_MATRIX_EFFECT(name) {LED_MATRIX_##name, #name},
+#include "led_matrix_effects.inc"
+#undef LED_MATRIX_EFFECT
+};
+
+/* Frame checksums for every effect over render() */
+static const std::map<std::string, uint32_t> every_golden = {
+    {"SOLID", 0x85948800},
+    {"ALPHAS_MODS", 0x85948800},
+    {"BREATHING", 0xc059b980},
+    {"BAND", 0x5b9ba053},
+    {"BAND_PINWHEEL", 0x50ea6f59},
+    {"BAND_SPIRAL", 0x0f2b0c7b},
+    {"CYCLE_LEFT_RIGHT", 0x759dc4c0},
+    {"CYCLE_UP_DOWN", 0x28773eaa},
+    {"CYCLE_OUT_IN", 0x5ab88ec1},
+    {"DUAL_BEACON", 0x61fdde4d},
+    {"SOLID_REACTIVE_SIMPLE", 0xc86b49f8},
+    {"SOLID_REACTIVE_WIDE", 0x1e17affb},
+    {"SOLID_REACTIVE_MULTIWIDE", 0xa558cc20},
+    {"SOLID_REACTIVE_CROSS", 0xa193eb2d},
+    {"SOLID_REACTIVE_MULTICROSS", 0x0d32e81d},
+    {"SOLID_REACTIVE_NEXUS", 0x2eddbcee},
+    {"SOLID_REACTIVE_MULTINEXUS", 0x0f2bdb5c},
+    {"SOLID_SPLASH", 0x68176356},
+    {"SOLID_MULTISPLASH", 0xb10906ca},
+    {"WAVE_LEFT_RIGHT", 0x3aebf82c},
+    {"WAVE_UP_DOWN", 0xa9875cd0},
+};
+
+struct render_t {
+    uint32_t checksum;
+    uint32_t frames;
+    double   ns;
+};
+
+/* Runs led_matrix_task() by itself once per simulated millisecond for three
+ * seconds, with a key hit every 80 ms over the first. Each run starts from
+ * blank LEDs on the same 16 bit timer value with no hits left over, so an
+ * effect renders the same frames wherever it is in the list. Only the time
+ * spent in led_matrix_task() is counted. */
+static render_t render(uint8_t mode) {
+    advance_time(0x10000 - timer_read32() % 0x10000);
+    /* Forgets the previous run's hits */
+    led_matrix_init();
+    led_matrix_mode_noeeprom(mode);
+    led_matrix_set_val_noeeprom(255);
+    led_matrix_set_speed_noeeprom(128);
+    memset(test_leds, 0, sizeof(test_leds));
+
+    render_t result = {};
+    for (uint32_t ms = 0; ms < 3100; ms++) {
+        if (ms == 100) {
+            test_frame_checksum = 0;
+            test_frames         = 0;
+            result.ns           = 0;
+        }
+        if (ms >= 100 && ms < 1060 && ms % 80 < 60) {
+            uint8_t led = ((ms - 100) / 80 * 7) % (MATRIX_ROWS * MATRIX_COLS);
+            if (ms % 80 == 20) process_led_matrix(led / MATRIX_COLS, led % MATRIX_COLS, true);
+            if (ms % 80 == 50) process_led_matrix(led / MATRIX_COLS, led % MATRIX_COLS, false);
+        }
+        advance_time(1);
+        auto start = std::chrono::steady_clock::now();
+        led_matrix_task();
+        result.ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+    result.checksum = test_frame_checksum;
+    result.frames   = test_frames;
+    return result;
+}
+
+/* What the last `make test:led_matrix:bench` measured, to compare against */
+static std::map<std::string, double> read_baseline(const char* path) {
+    std::map<std::string, double> baseline;
+    std::ifstream                 in(path);
+    std::string                   line;
+    while (std::getline(in, line)) {
+        size_t name = line.find("\"name\": \"");
+        size_t ns   = line.find("\"ns_per_frame\": ");
+        if (name == std::string::npos || ns == std::string::npos) continue;
+        name += 9;
+        baseline[line.substr(name, line.find('"', name) - name)] = std::stod(line.substr(ns + 16));
+    }
+    return baseline;
+}
+
+TEST_F(LedMatrix, EveryEffectRendersItsGoldenFrames) {
+    const char* path     = std::getenv("QMK_BENCHMARK_JSON");
+    auto        baseline = path ? read_baseline(path) : std::map<std::string, double>();
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::stringstream json;
+    json << std::fixed << std::setprecision(1) << "{\"benchmarks\": [\n";
+    for (auto& effect : every_effect) {
+        render_t result = render(effect.mode);
+        EXPECT_GT(result.frames, 150u) << effect.name;
+        std::stringstream actual;
+        actual << "0x" << std::hex << std::setw(8) << std::setfill('0') << result.checksum;
+        auto golden = every_golden.find(effect.name);
+        if (golden == every_golden.end()) {
+            ADD_FAILURE() << effect.name << " has no golden frames, it rendered " << actual.str();
+        } else {
+            EXPECT_EQ(result.checksum, golden->second) << effect.name << " rendered " << actual.str();
+        }
+
+        // Timings are only worth reading from a quiet machine, so they are left to the bench target
+        double per_frame = result.ns / result.frames;
+        if (path) {
+            std::cout << "[ BENCHMARK] " << effect.name << ": " << per_frame << " ns/frame, " << per_frame / DRIVER_LED_TOTAL << " ns/LED";
+            if (baseline.count(effect.name)) {
+                std::cout << " (" << std::showpos << (per_frame / baseline[effect.name] - 1) * 100 << std::noshowpos << "%)";
+            }
+            std::cout << std::endl;
+        }
+        json << "    {\"name\": \"" << effect.name << "\", \"frames\": " << result.frames << ", \"ns_per_frame\": " << per_frame << ", \"ns_per_led\": " << per_frame / DRIVER_LED_TOTAL << "}" << (&effect != &every_effect.back() ? ",\n" : "\n");
+    }
+    json << "]}\n";
+    if (path) {
+        std::ofstream(path) << json.str();
+    }
+}
@@ -0,0 +1,197 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <vector>
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "pointing_device.h"
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::Invoke;
+
+struct motion_t {
+    int16_t x;
+    int16_t y;
+};
+
+/* What the sensor sees on each poll, fed through the custom driver */
+static std::vector<motion_t> trace;
+static size_t                trace_position;
+static std::vector<uint32_t> polls;
+
+extern "C" report_mouse_t pointing_device_driver_get_report(report_mouse_t mouse_report) {
+    polls.push_back(timer_read32());
+    if (trace_position < trace.size()) {
+        pointing_device_add_motion(trace[trace_position].x, trace[trace_position].y);
+        trace_position++;
+    }
+    return mouse_report;
+}
+
+class PointingDevice : public TestFixture {
+   protected:
+    std::vector<report_mouse_t> reports;
+
+    void SetUp() override {
+        trace.clear();
+        trace_position = 0;
+    }
+
+    void TearDown() override { pointing_device_set_motion_scale(256); }
+
+    void record(TestDriver& driver) {
+        EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber()).WillRepeatedly(Invoke([this](report_mouse_t& report) { reports.push_back(report); }));
+    }
+
+    /* Runs the whole trace, then scans until nothing is left to report */
+    void play(void) {
+        while (trace_position < trace.size()) {
+            run_one_scan_loop();
+        }
+        size_t sent;
+        do {
+            sent = reports.size();
+            idle_for(POINTING_DEVICE_TASK_THROTTLE_MS + 1);
+        } while (reports.size() != sent);
+    }
+
+    /* Where the sensor moved, turned the way the host should see it */
+    static std::pair<int32_t, int32_t> expected(int32_t x, int32_t y) {
+#ifdef POINTING_DEVICE_ROTATION_90
+        return {y, -x};
+#else
+        return {x, y};
+#endif
+    }
+
+    void expect_total(int32_t x, int32_t y) {
+        int32_t host_x = 0, host_y = 0;
+        for (auto& report : reports) {
+            EXPECT_GE(report.x, MOUSE_REPORT_XY_MIN);
+            EXPECT_LE(report.x, MOUSE_REPORT_XY_MAX);
+            EXPECT_GE(report.y, MOUSE_REPORT_XY_MIN);
+            EXPECT_LE(report.y, MOUSE_REPORT_XY_MAX);
+            host_x += report.x;
+            host_y += report.y;
+        }
+        auto motion = expected(x, y);
+        EXPECT_EQ(host_x, motion.first);
+        EXPECT_EQ(host_y, motion.second);
+    }
+};
+
+TEST_F(PointingDevice, FastMotionIsSplitAcrossReports) {
+    TestDriver driver;
+    record(driver);
+
+    /* A high CPI sensor flicked across the desk and back: up to 3000 counts a poll */
+    int32_t x = 0, y = 0;
+    for (int i = 0; i < 100; i++) {
+        int16_t speed = i < 50 ? i * 60 : (i - 100) * 60;
+        trace.push_back({speed, (int16_t)(-speed / 3)});
+        x += speed;
+        y += -speed / 3;
+    }
+    play();
+
+    expect_total(x, y);
+    RecordProperty("MouseReports", reports.size());
+}
+
+TEST_F(PointingDevice, SlowMotionStillArrives) {
+    TestDriver driver;
+    record(driver);
+
+    for (int i = 0; i < 40; i++) {
+        trace.push_back({1, (int16_t)(i % 2 ? -1 : 0)});
+    }
+    play();
+
+    expect_total(40, -20);
+    EXPECT_EQ(reports.size(), 40u);
+}
+
+TEST_F(PointingDevice, ScalingKeepsTheFractions) {
+    TestDriver driver;
+    record(driver);
+
+    /* A third of a count per count, which drops everything if each poll is scaled on its own */
+    pointing_device_set_motion_scale(85);
+    for (int i = 0; i < 256; i++) {
+        trace.push_back({1, -1});
+    }
+    play();
+
+    expect_total(85, -85);
+}
+
+TEST_F(PointingDevice, ScaledUpMotionIsNotClipped) {
+    TestDriver driver;
+    record(driver);
+
+    pointing_device_set_motion_scale(8 * 256);
+    for (int i = 0; i < 4; i++) {
+        trace.push_back({INT16_MAX, INT16_MIN + 1});
+    }
+    play();
+
+    expect_total(4 * 8 * INT16_MAX, 4 * 8 * (INT16_MIN + 1));
+}
+
+TEST_F(PointingDevice, PollsFollowTheThrottle) {
+    TestDriver driver;
+    record(driver);
+
+    polls.clear();
+    idle_for(100 * POINTING_DEVICE_TASK_THROTTLE_MS);
+    EXPECT_EQ(polls.size(), 100u);
+
+    /* A scan that makes the next poll late doesn't push back the ones after it */
+    uint32_t phase = polls.back() % POINTING_DEVICE_TASK_THROTTLE_MS;
+    advance_time(polls.back() + POINTING_DEVICE_TASK_THROTTLE_MS + 1 - timer_read32());
+    polls.clear();
+    idle_for(100 * POINTING_DEVICE_TASK_THROTTLE_MS);
+    ASSERT_GE(polls.size(), 99u);
+    for (size_t i = 1; i < polls.size(); i++) {
+        EXPECT_EQ(polls[i] % POINTING_DEVICE_TASK_THROTTLE_MS, phase);
+    }
+}
+
+#ifdef POINTING_DEVICE_TASK_STATS
+TEST_F(PointingDevice, StatsCountEachSecond) {
+    TestDriver driver;
+    record(driver);
+
+    for (int i = 0; i < 3000; i++) {
+        trace.push_back({1, 0});
+    }
+    /* Wait out the second that is under way, then count a whole one */
+    idle_for(1000);
+    uint32_t start = timer_read32();
+    while (timer_elapsed32(start) < 1000) {
+        run_one_scan_loop();
+    }
+    pointing_device_stats_t stats = pointing_device_get_stats();
+    EXPECT_NEAR(stats.scans, 1000u, 1);
+    EXPECT_NEAR(stats.polls, 1000u / POINTING_DEVICE_TASK_THROTTLE_MS, 1);
+    EXPECT_EQ(stats.reports, stats.polls);
+}
+#endif
@@ -0,0 +1,189 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include "keycode.h"
+#include "test_common.hpp"
+
+extern "C" {
+#include "profiler.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+class Profiler : public TestFixture {
+   protected:
+    void SetUp() override { profiler_reset(); }
+
+    static uint32_t histogram_total(profiler_zone_t zone) {
+        uint32_t total = 0;
+        for (uint8_t bucket = 0; bucket < PROFILER_HISTOGRAM_BUCKETS; bucket++) {
+            total += profiler_get_stats(zone)->histogram[bucket];
+        }
+        return total;
+    }
+
+    static uint32_t get32(const uint8_t* data) { return data[0] | data[1] << 8 | data[2] << 16 | (uint32_t)data[3] << 24; }
+};
+
+TEST_F(Profiler, ZonesCountEveryScanAndKeyEvent) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key});
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    key.press();
+    run_one_scan_loop();
+    idle_for(10);
+    key.release();
+    run_one_scan_loop();
+    idle_for(10);
+
+    EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_KEYBOARD_TASK)->count, 22u);
+    EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_MATRIX_SCAN)->count, 22u);
+    EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_ACTION_EXEC)->count, 2u);
+    EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_ACTION_TICK)->count, 20u);
+    EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_PROCESS_RECORD_KB)->count, 2u);
+    EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_PROCESS_SPACE_CADET)->count, 2u);
+    /* The test matrix doesn't debounce */
+    EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_DEBOUNCE)->count, 0u);
+
+    for (uint8_t zone = 0; zone < PROFILER_ZONE_COUNT; zone++) {
+        const profiler_stats_t* stats = profiler_get_stats((profiler_zone_t)zone);
+        EXPECT_EQ(histogram_total((profiler_zone_t)zone), stats->count) << "zone " << (int)zone;
+        if (!stats->count) continue;
+        EXPECT_LE(stats->min, stats->total / stats->count);
+        EXPECT_GE(stats->max, stats->total / stats->count);
+    }
+    /* The whole scan takes at least as long as the parts it is made of */
+    EXPECT_GE(profiler_get_stats(PROFILER_ZONE_KEYBOARD_TASK)->total, profiler_get_stats(PROFILER_ZONE_ACTION_EXEC)->total + profiler_get_stats(PROFILER_ZONE_ACTION_TICK)->total);
+    EXPECT_GE(profiler_get_stats(PROFILER_ZONE_ACTION_EXEC)->total, profiler_get_stats(PROFILER_ZONE_PROCESS_RECORD_KB)->total);
+
+    profiler_dump();
+}
+
+TEST_F(Profiler, HistogramBucketsAreLog2) {
+    const uint32_t ticks[]   = {0, 1, 2, 3, 4, 1000, 1023, 1024, UINT32_MAX};
+    const uint8_t  buckets[] = {0, 1, 2, 2, 3, 10, 10, 11, 11};
+    for (size_t i = 0; i < sizeof(ticks) / sizeof(ticks[0]); i++) {
+        profiler_reset();
+        profiler_record(PROFILER_ZONE_DEBOUNCE, ticks[i]);
+        EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_DEBOUNCE)->histogram[buckets[i]], 1u) << ticks[i] << " ticks";
+        EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_DEBOUNCE)->min, ticks[i]);
+        EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_DEBOUNCE)->max, ticks[i]);
+    }
+}
+
+TEST_F(Profiler, FullBucketHalvesTheHistogram) {
+    for (uint32_t i = 0; i < UINT16_MAX; i++) {
+        profiler_record(PROFILER_ZONE_DEBOUNCE, 1);
+    }
+    profiler_record(PROFILER_ZONE_DEBOUNCE, 100);
+    profiler_record(PROFILER_ZONE_DEBOUNCE, 100);
+    profiler_record(PROFILER_ZONE_DEBOUNCE, 100);
+    profiler_record(PROFILER_ZONE_DEBOUNCE, 1);
+
+    const profiler_stats_t* stats = profiler_get_stats(PROFILER_ZONE_DEBOUNCE);
+    EXPECT_EQ(stats->histogram[1], UINT16_MAX / 2 + 1);
+    EXPECT_EQ(stats->histogram[7], 1u);
+    EXPECT_EQ(stats->count, UINT16_MAX + 4u);
+    EXPECT_EQ(stats->total, UINT16_MAX + 301u);
+}
+
+TEST_F(Profiler, ZonesDeeperThanTheStackAreLeftOut) {
+    profiler_enter();
+    for (int i = 0; i < PROFILER_STACK_DEPTH; i++) {
+        profiler_enter();
+    }
+    EXPECT_FALSE(profiler_leave(PROFILER_ZONE_DEBOUNCE, false));
+    for (int i = 1; i < PROFILER_STACK_DEPTH; i++) {
+        EXPECT_TRUE(profiler_leave(PROFILER_ZONE_MATRIX_SCAN, true));
+    }
+    EXPECT_TRUE(profiler_leave(PROFILER_ZONE_KEYBOARD_TASK, true));
+    /* Nothing is under way anymore */
+    EXPECT_TRUE(profiler_leave(PROFILER_ZONE_KEYBOARD_TASK, true));
+
+    EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_DEBOUNCE)->count, 0u);
+    EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_MATRIX_SCAN)->count, PROFILER_STACK_DEPTH - 1u);
+    EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_KEYBOARD_TASK)->count, 1u);
+    EXPECT_GE(profiler_get_stats(PROFILER_ZONE_KEYBOARD_TASK)->max, profiler_get_stats(PROFILER_ZONE_MATRIX_SCAN)->max);
+}
+
+TEST_F(Profiler, RawHidReadsTheTable) {
+    profiler_record(PROFILER_ZONE_MATRIX_SCAN, 10);
+    profiler_record(PROFILER_ZONE_MATRIX_SCAN, 30);
+
+    uint8_t data[32] = {PROFILER_RAW_HID_ID, PROFILER_RAW_HID_INFO};
+    ASSERT_TRUE(profiler_raw_hid_command(data, sizeof(data)));
+    EXPECT_EQ(data[3], PROFILER_ZONE_COUNT);
+    EXPECT_EQ(data[4], PROFILER_HISTOGRAM_BUCKETS);
+    EXPECT_EQ(get32(&data[5]), 1000000u);
+
+    uint8_t stats[32] = {PROFILER_RAW_HID_ID, PROFILER_RAW_HID_STATS, PROFILER_ZONE_MATRIX_SCAN};
+    ASSERT_TRUE(profiler_raw_hid_command(stats, sizeof(stats)));
+    EXPECT_EQ(get32(&stats[3]), 2u);
+    EXPECT_EQ(get32(&stats[7]), 10u);
+    EXPECT_EQ(get32(&stats[11]), 20u);
+    EXPECT_EQ(get32(&stats[15]), 30u);
+
+    uint8_t histogram[32] = {PROFILER_RAW_HID_ID, PROFILER_RAW_HID_HISTOGRAM, PROFILER_ZONE_MATRIX_SCAN, 4};
+    ASSERT_TRUE(profiler_raw_hid_command(histogram, sizeof(histogram)));
+    /* 10 is in bucket 4, 30 in bucket 5, the buckets past the end read as empty */
+    EXPECT_EQ(histogram[4] | histogram[5] << 8, 1);
+    EXPECT_EQ(histogram[6] | histogram[7] << 8, 1);
+    EXPECT_EQ(histogram[30] | histogram[31] << 8, 0);
+
+    uint8_t name[32] = {PROFILER_RAW_HID_ID, PROFILER_RAW_HID_NAME, PROFILER_ZONE_MATRIX_SCAN};
+    ASSERT_TRUE(profiler_raw_hid_command(name, sizeof(name)));
+    EXPECT_STREQ((char*)&name[3], "matrix_scan");
+
+    uint8_t reset[32] = {PROFILER_RAW_HID_ID, PROFILER_RAW_HID_RESET};
+    ASSERT_TRUE(profiler_raw_hid_command(reset, sizeof(reset)));
+    EXPECT_EQ(profiler_get_stats(PROFILER_ZONE_MATRIX_SCAN)->count, 0u);
+
+    /* Reports for someone else, and zones that don't exist, are left alone */
+    uint8_t other[32] = {0x01, PROFILER_RAW_HID_INFO};
+    EXPECT_FALSE(profiler_raw_hid_command(other, sizeof(other)));
+    uint8_t missing[32] = {PROFILER_RAW_HID_ID, PROFILER_RAW_HID_STATS, PROFILER_ZONE_COUNT};
+    EXPECT_FALSE(profiler_raw_hid_command(missing, sizeof(missing)));
+    EXPECT_EQ(missing[3], 0);
+}
+
+TEST_F(Profiler, Benchmark) {
+    using clock = std::chrono::steady_clock;
+
+    const int rounds = 100000;
+    auto      start  = clock::now();
+    for (int i = 0; i < rounds; i++) {
+        profiler_enter();
+        profiler_leave(PROFILER_ZONE_DEBOUNCE, true);
+    }
+    double total = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+    double ns    = total / rounds;
+
+    /* The zones are timed with the same clock, and each one lies within its round */
+    const profiler_stats_t* stats = profiler_get_stats(PROFILER_ZONE_DEBOUNCE);
+    EXPECT_EQ(stats->count, (uint32_t)rounds);
+    EXPECT_LE(stats->min, stats->total / stats->count);
+    EXPECT_GE(stats->max, stats->total / stats->count);
+    EXPECT_LE(stats->total, total);
+    /* A round reads the clock at least twice */
+    EXPECT_LE(profiler_get_overhead(), ns);
+    std::cout << "[ BENCHMARK] profiler: " << ns << " ns per zone, an empty zone records " << stats->min << " to " << stats->max << " ns, reading the clock takes " << profiler_get_overhead() << " ns" << std::endl;
+}
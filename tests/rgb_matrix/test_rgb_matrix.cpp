@@ -0,0 +1,269 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "rgb_matrix_test_board.h"
+void            advance_time(uint32_t ms);
+extern uint16_t rand16seed;
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+struct golden_t {
+    uint8_t     mode;
+    const char* name;
+    uint32_t    checksum;
+};
+
+/* Frame checksums over the script below, as the effects rendered them before their math was cached.
+ * MULTINEXUS and MULTISPLASH have since stopped changing the hue of LEDs that a hit doesn't light. */
+static const std::vector<golden_t> golden = {
+    {RGB_MATRIX_BAND_PINWHEEL_SAT, "BAND_PINWHEEL_SAT", 0xfacaaf00},
+    {RGB_MATRIX_BAND_PINWHEEL_VAL, "BAND_PINWHEEL_VAL", 0x39ea0e95},
+    {RGB_MATRIX_BAND_SPIRAL_SAT, "BAND_SPIRAL_SAT", 0xf9296500},
+    {RGB_MATRIX_BAND_SPIRAL_VAL, "BAND_SPIRAL_VAL", 0xe46e3d88},
+    {RGB_MATRIX_CYCLE_OUT_IN, "CYCLE_OUT_IN", 0xaea1057d},
+    {RGB_MATRIX_CYCLE_OUT_IN_DUAL, "CYCLE_OUT_IN_DUAL", 0x22c36f3c},
+    {RGB_MATRIX_CYCLE_PINWHEEL, "CYCLE_PINWHEEL", 0xbca3b88f},
+    {RGB_MATRIX_CYCLE_SPIRAL, "CYCLE_SPIRAL", 0x096b90e6},
+    {RGB_MATRIX_SOLID_REACTIVE_WIDE, "SOLID_REACTIVE_WIDE", 0x3283d170},
+    {RGB_MATRIX_SOLID_REACTIVE_MULTIWIDE, "SOLID_REACTIVE_MULTIWIDE", 0xed077fe5},
+    {RGB_MATRIX_SOLID_REACTIVE_CROSS, "SOLID_REACTIVE_CROSS", 0xc628031c},
+    {RGB_MATRIX_SOLID_REACTIVE_MULTICROSS, "SOLID_REACTIVE_MULTICROSS", 0x67eb15c2},
+    {RGB_MATRIX_SOLID_REACTIVE_NEXUS, "SOLID_REACTIVE_NEXUS", 0x59003487},
+    {RGB_MATRIX_SOLID_REACTIVE_MULTINEXUS, "SOLID_REACTIVE_MULTINEXUS", 0x12f2035e},
+    {RGB_MATRIX_SPLASH, "SPLASH", 0x4311201a},
+    {RGB_MATRIX_MULTISPLASH, "MULTISPLASH", 0x8072575e},
+    {RGB_MATRIX_SOLID_SPLASH, "SOLID_SPLASH", 0xb72b5db7},
+    {RGB_MATRIX_SOLID_MULTISPLASH, "SOLID_MULTISPLASH", 0x7f5a3196},
+};
+
+class RgbMatrix : public TestFixture {
+   protected:
+    std::vector<KeymapKey> keys;
+
+    void SetUp() override {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keys.push_back(KeymapKey(0, col, row, KC_A + (row * MATRIX_COLS + col) % 26));
+            }
+        }
+        for (auto& key : keys) {
+            add_key(key);
+        }
+    }
+
+    /* Three seconds of an effect, with a few keys typed over the first one */
+    uint32_t play(uint8_t mode) {
+        rgb_matrix_mode_noeeprom(mode);
+        rgb_matrix_sethsv_noeeprom(170, 255, 255);
+        rgb_matrix_set_speed_noeeprom(128);
+        idle_for(100);
+
+        test_frame_checksum = 0;
+        test_frames         = 0;
+        for (uint8_t i = 0; i < 12; i++) {
+            KeymapKey& key = keys[(i * 7) % keys.size()];
+            key.press();
+            idle_for(30);
+            key.release();
+            idle_for(50);
+        }
+        idle_for(2040);
+        return test_frame_checksum;
+    }
+};
+
+TEST_F(RgbMatrix, EffectsRenderTheSameFrames) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (auto& effect : golden) {
+        uint32_t checksum = play(effect.mode);
+        EXPECT_GT(test_frames, 100u) << effect.name;
+        std::stringstream actual;
+        actual << "0x" << std::hex << std::setw(8) << std::setfill('0') << checksum;
+        EXPECT_EQ(checksum, effect.checksum) << effect.name << " rendered " << actual.str();
+    }
+}
+
+struct effect_t {
+    uint8_t     mode;
+    const char* name;
+};
+
+/* Every effect the board enables, straight from the list rgb_matrix numbers them by */
+static const std::vector<effect_t> every_effect = {
+#define RGB_MATRIX_EFFECT(name) {RGB_MATRIX_##name, #name},
+#include "rgb_matrix_effects.inc"
+#undef RGB_MATRIX_EFFECT
+};
+
+/* Frame checksums for every effect over render() */
+static const std::map<std::string, uint32_t> every_golden = {
+    {"SOLID_COLOR", 0x85948800},
+    {"ALPHAS_MODS", 0x85948800},
+    {"GRADIENT_UP_DOWN", 0x251b3f50},
+    {"GRADIENT_LEFT_RIGHT", 0xf37d24d0},
+    {"BREATHING", 0xc059b980},
+    {"BAND_SAT", 0xa8cb4d00},
+    {"BAND_VAL", 0x74f41175},
+    {"BAND_PINWHEEL_SAT", 0x9b826b00},
+    {"BAND_PINWHEEL_VAL", 0x50ea6f59},
+    {"BAND_SPIRAL_SAT", 0x4f38a600},
+    {"BAND_SPIRAL_VAL", 0x0f2b0c7b},
+    {"CYCLE_ALL", 0x43ae7a80},
+    {"CYCLE_LEFT_RIGHT", 0xb2b9c31e},
+    {"CYCLE_UP_DOWN", 0x83adf8f7},
+    {"RAINBOW_MOVING_CHEVRON", 0x0272d00b},
+    {"CYCLE_OUT_IN", 0x7385b833},
+    {"CYCLE_OUT_IN_DUAL", 0x8f2d7796},
+    {"CYCLE_PINWHEEL", 0x6c8bd329},
+    {"CYCLE_SPIRAL", 0x96d8b2bd},
+    {"DUAL_BEACON", 0x7701863d},
+    {"RAINBOW_BEACON", 0x4c6316ba},
+    {"RAINBOW_PINWHEELS", 0x7f3cbae8},
+    {"RAINDROPS", 0x02f58aa8},
+    {"JELLYBEAN_RAINDROPS", 0x3142054d},
+    {"HUE_BREATHING", 0x64948800},
+    {"HUE_PENDULUM", 0xc1788800},
+    {"HUE_WAVE", 0x565c8800},
+    {"PIXEL_RAIN", 0x06abba35},
+    {"PIXEL_FRACTAL", 0x0e32c220},
+    {"TYPING_HEATMAP", 0x63a7fce3},
+    {"DIGITAL_RAIN", 0x526b18c6},
+    {"SOLID_REACTIVE_SIMPLE", 0x92e32757},
+    {"SOLID_REACTIVE", 0xbcefa784},
+    {"SOLID_REACTIVE_WIDE", 0x736bcc3a},
+    {"SOLID_REACTIVE_MULTIWIDE", 0xfc6ad43d},
+    {"SOLID_REACTIVE_CROSS", 0xf8065d8c},
+    {"SOLID_REACTIVE_MULTICROSS", 0x70d03d7c},
+    {"SOLID_REACTIVE_NEXUS", 0x00964c5b},
+    {"SOLID_REACTIVE_MULTINEXUS", 0x1260fb49},
+    {"SPLASH", 0x2ab8f831},
+    {"MULTISPLASH", 0x9b2ba64f},
+    {"SOLID_SPLASH", 0xb8b83216},
+    {"SOLID_MULTISPLASH", 0xc4fc1e93},
+};
+
+struct render_t {
+    uint32_t checksum;
+    uint32_t frames;
+    double   ns;
+};
+
+/* Runs rgb_matrix_task() by itself once per simulated millisecond for three
+ * seconds, with a key hit every 80 ms over the first. Each run starts from
+ * blank LEDs on the same 16 bit timer value with no hits left over, so an
+ * effect renders the same frames wherever it is in the list. Only the time
+ * spent in rgb_matrix_task() is counted. */
+static render_t render(uint8_t mode) {
+    advance_time(0x10000 - timer_read32() % 0x10000);
+    /* Forgets the previous run's hits */
+    rgb_matrix_init();
+    rgb_matrix_mode_noeeprom(mode);
+    rgb_matrix_sethsv_noeeprom(170, 255, 255);
+    rgb_matrix_set_speed_noeeprom(128);
+    srand(1);
+    rand16seed = 1337;
+    /* Some effects only paint over what was there */
+    memset(test_leds, 0, sizeof(test_leds));
+
+    render_t result = {};
+    for (uint32_t ms = 0; ms < 3100; ms++) {
+        if (ms == 100) {
+            test_frame_checksum = 0;
+            test_frames         = 0;
+            result.ns           = 0;
+        }
+        if (ms >= 100 && ms < 1060 && ms % 80 < 60) {
+            uint8_t led = ((ms - 100) / 80 * 7) % (MATRIX_ROWS * MATRIX_COLS);
+            if (ms % 80 == 20) process_rgb_matrix(led / MATRIX_COLS, led % MATRIX_COLS, true);
+            if (ms % 80 == 50) process_rgb_matrix(led / MATRIX_COLS, led % MATRIX_COLS, false);
+        }
+        advance_time(1);
+        auto start = std::chrono::steady_clock::now();
+        rgb_matrix_task();
+        result.ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    }
+    result.checksum = test_frame_checksum;
+    result.frames   = test_frames;
+    return result;
+}
+
+/* What the last `make test:rgb_matrix:bench` measured, to compare against */
+static std::map<std::string, double> read_baseline(const char* path) {
+    std::map<std::string, double> baseline;
+    std::ifstream                 in(path);
+    std::string                   line;
+    while (std::getline(in, line)) {
+        size_t name = line.find("\"name\": \"");
+        size_t ns   = line.find("\"ns_per_frame\": ");
+        if (name == std::string::npos || ns == std::string::npos) continue;
+        name += 9;
+        baseline[line.substr(name, line.find('"', name) - name)] = std::stod(line.substr(ns + 16));
+    }
+    return baseline;
+}
+
+TEST_F(RgbMatrix, EveryEffectRendersItsGoldenFrames) {
+    const char* path     = std::getenv("QMK_BENCHMARK_JSON");
+    auto        baseline = path ? read_baseline(path) : std::map<std::string, double>();
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::stringstream json;
+    json << std::fixed << std::setprecision(1) << "{\"benchmarks\": [\n";
+    for (auto& effect : every_effect) {
+        render_t result = render(effect.mode);
+        EXPECT_GT(result.frames, 150u) << effect.name;
+        std::stringstream actual;
+        actual << "0x" << std::hex << std::setw(8) << std::setfill('0') << result.checksum;
+        auto golden = every_golden.find(effect.name);
+        if (golden == every_golden.end()) {
+            ADD_FAILURE() << effect.name << " has no golden frames, it rendered " << actual.str();
+        } else {
+            EXPECT_EQ(result.checksum, golden->second) << effect.name << " rendered " << actual.str();
+        }
+
+        // Timings are only worth reading from a quiet machine, so they are left to the bench target
+        double per_frame = result.ns / result.frames;
+        if (path) {
+            std::cout << "[ BENCHMARK] " << effect.name << ": " << per_frame << " ns/frame, " << per_frame / DRIVER_LED_TOTAL << " ns/LED";
+            if (baseline.count(effect.name)) {
+                std::cout << " (" << std::showpos << (per_frame / baseline[effect.name] - 1) * 100 << std::noshowpos << "%)";
+            }
+            std::cout << std::endl;
+        }
+        json << "    {\"name\": \"" << effect.name << "\", \"frames\": " << result.frames << ", \"ns_per_frame\": " << per_frame << ", \"ns_per_led\": " << per_frame / DRIVER_LED_TOTAL << "}" << (&effect != &every_effect.back() ? ",\n" : "\n");
+    }
+    json << "]}\n";
+    if (path) {
+        std::ofstream(path) << json.str();
+    }
+}
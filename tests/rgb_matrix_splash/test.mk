@@ -0,0 +1,24 @@
+# Copyright 2021 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+
+RGB_MATRIX_ENABLE = yes
+RGB_MATRIX_DRIVER = custom
+RGB_MATRIX_CUSTOM_KB = yes
+
+SRC += tests/rgb_matrix/rgb_matrix_test_board.c
+
+# rgb_matrix.c includes the board's config.h and rgb_matrix_kb.inc
+VPATH += $(TEST_PATH) tests/rgb_matrix
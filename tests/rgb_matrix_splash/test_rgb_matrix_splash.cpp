@@ -0,0 +1,102 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "rgb_matrix_test_board.h"
+}
+
+using testing::_;
+using testing::AnyNumber;
+
+struct splash_effect_t {
+    uint8_t     culled;
+    uint8_t     unculled;
+    const char* name;
+};
+
+static const std::vector<splash_effect_t> effects = {
+    {RGB_MATRIX_SOLID_REACTIVE_MULTIWIDE, RGB_MATRIX_CUSTOM_UNCULLED_MULTIWIDE, "SOLID_REACTIVE_MULTIWIDE"},
+    {RGB_MATRIX_SOLID_REACTIVE_MULTICROSS, RGB_MATRIX_CUSTOM_UNCULLED_MULTICROSS, "SOLID_REACTIVE_MULTICROSS"},
+    {RGB_MATRIX_SOLID_REACTIVE_MULTINEXUS, RGB_MATRIX_CUSTOM_UNCULLED_MULTINEXUS, "SOLID_REACTIVE_MULTINEXUS"},
+    {RGB_MATRIX_MULTISPLASH, RGB_MATRIX_CUSTOM_UNCULLED_MULTISPLASH, "MULTISPLASH"},
+    {RGB_MATRIX_SOLID_MULTISPLASH, RGB_MATRIX_CUSTOM_UNCULLED_SOLID_MULTISPLASH, "SOLID_MULTISPLASH"},
+};
+
+class RgbMatrixSplash : public TestFixture {
+   protected:
+    std::vector<KeymapKey> keys;
+
+    void SetUp() override {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keys.push_back(KeymapKey(0, col, row, KC_A + (row * MATRIX_COLS + col) % 26));
+            }
+        }
+        for (auto& key : keys) {
+            add_key(key);
+        }
+    }
+
+    /* Someone typing at 20 keys a second for four seconds, so every remembered hit is in use */
+    uint32_t play(uint8_t mode, uint8_t speed, double* ns_per_frame) {
+        /* Forget the hits from the last run, at slow speeds they would still be showing */
+        rgb_matrix_init();
+        rgb_matrix_mode_noeeprom(mode);
+        rgb_matrix_sethsv_noeeprom(170, 255, 255);
+        rgb_matrix_set_speed_noeeprom(speed);
+        idle_for(100);
+
+        test_frame_checksum = 0;
+        test_frames         = 0;
+        auto start          = std::chrono::steady_clock::now();
+        for (uint8_t i = 0; i < 80; i++) {
+            KeymapKey& key = keys[(i * 13) % keys.size()];
+            key.press();
+            idle_for(20);
+            key.release();
+            idle_for(30);
+        }
+        idle_for(1000);
+        auto ns       = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        *ns_per_frame = (double)ns / test_frames;
+        return test_frame_checksum;
+    }
+};
+
+TEST_F(RgbMatrixSplash, CulledHitsRenderTheSameFrames) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    /* The timings are only printed by `make test:rgb_matrix_splash:bench` */
+    const bool bench = std::getenv("QMK_BENCHMARK_JSON");
+    for (auto& effect : effects) {
+        for (uint8_t speed : {0, 128, 255}) {
+            double culled_ns, unculled_ns;
+            EXPECT_EQ(play(effect.culled, speed, &culled_ns), play(effect.unculled, speed, &unculled_ns)) << effect.name << " at speed " << (int)speed;
+            EXPECT_GT(test_frames, 200u);
+            if (bench && speed == 128) {
+                std::cout << "[ BENCHMARK] " << effect.name << " with " << LED_HITS_TO_REMEMBER << " hits: " << culled_ns << " ns/frame culled, " << unculled_ns << " ns/frame unculled" << std::endl;
+            }
+        }
+    }
+}
@@ -0,0 +1,230 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+using testing::Invoke;
+using testing::InvokeWithoutArgs;
+
+class SendStringAsync : public TestFixture {
+   protected:
+    void TearDown() override {
+        // Don't leak queued strings into the next test
+        for (send_string_handle_t handle = 1; handle != INVALID_SEND_STRING_HANDLE; handle++) {
+            cancel_send_string(handle);
+        }
+    }
+
+    /* Scans until every queued string has been typed, returns the number of scans */
+    unsigned run_until_sent(send_string_handle_t handle, unsigned limit = 100000) {
+        unsigned scans = 0;
+        while (is_send_string_pending(handle) && scans < limit) {
+            run_one_scan_loop();
+            scans++;
+        }
+        return scans;
+    }
+};
+
+#define AT_TIME(t) WillOnce(InvokeWithoutArgs([current_time]() { EXPECT_EQ(timer_elapsed32(current_time), t); }))
+
+TEST_F(SendStringAsync, QueuingDoesNotSendAnything) {
+    TestDriver driver;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    send_string_handle_t handle = SEND_STRING_ASYNC("ab");
+    EXPECT_NE(handle, INVALID_SEND_STRING_HANDLE);
+    EXPECT_TRUE(is_send_string_pending(handle));
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_until_sent(handle);
+    EXPECT_FALSE(is_send_string_pending(handle));
+}
+
+TEST_F(SendStringAsync, OneCharacterPerScan) {
+    TestDriver driver;
+    InSequence s;
+
+    send_string_handle_t handle = SEND_STRING_ASYNC("aB");
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    run_until_sent(handle);
+    EXPECT_FALSE(is_send_string_pending(handle));
+}
+
+TEST_F(SendStringAsync, DelayAndIntervalAreWaitedOutWithoutBlocking) {
+    TestDriver driver;
+    InSequence s;
+
+    send_string_handle_t handle       = SEND_STRING_ASYNC_DELAY("a" SS_DELAY(100) "b", 10);
+    uint32_t             current_time = timer_read32();
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A))).AT_TIME(0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(0);
+    // Interval after "a", then the delay plus its own interval
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B))).AT_TIME(10 + 100 + 10);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).AT_TIME(10 + 100 + 10);
+    run_until_sent(handle);
+}
+
+TEST_F(SendStringAsync, StringsAreTypedInQueueOrder) {
+    TestDriver driver;
+    InSequence s;
+
+    static const char ram_string[] = "c";
+
+    send_string_handle_t first  = SEND_STRING_ASYNC("a");
+    send_string_handle_t second = SEND_STRING_ASYNC("b");
+    send_string_handle_t third  = send_string_async(ram_string, 0);
+    EXPECT_NE(first, second);
+    EXPECT_NE(second, third);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_until_sent(third);
+    EXPECT_FALSE(is_send_string_pending(first));
+    EXPECT_FALSE(is_send_string_pending(second));
+}
+
+TEST_F(SendStringAsync, FullQueueRejectsString) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    for (int i = 0; i < SEND_STRING_QUEUE_LENGTH; i++) {
+        EXPECT_NE(SEND_STRING_ASYNC("a"), INVALID_SEND_STRING_HANDLE);
+    }
+    EXPECT_EQ(SEND_STRING_ASYNC("a"), INVALID_SEND_STRING_HANDLE);
+}
+
+TEST_F(SendStringAsync, CancelQueuedString) {
+    TestDriver driver;
+    InSequence s;
+
+    send_string_handle_t first  = SEND_STRING_ASYNC("a");
+    send_string_handle_t second = SEND_STRING_ASYNC("b");
+    send_string_handle_t third  = SEND_STRING_ASYNC("c");
+    EXPECT_TRUE(cancel_send_string(second));
+    EXPECT_FALSE(cancel_send_string(second));
+    EXPECT_FALSE(is_send_string_pending(second));
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_until_sent(third);
+    EXPECT_FALSE(is_send_string_pending(first));
+}
+
+TEST_F(SendStringAsync, CancelRunningStringReleasesHeldKeys) {
+    TestDriver driver;
+    InSequence s;
+
+    send_string_handle_t handle = SEND_STRING_ASYNC(SS_DOWN(X_LCTL) SS_DELAY(1000) "a" SS_UP(X_LCTL));
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LCTL)));
+    idle_for(100);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_TRUE(cancel_send_string(handle));
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    idle_for(2000);
+    EXPECT_FALSE(is_send_string_pending(handle));
+}
+
+TEST_F(SendStringAsync, KeyboardKeepsScanningWhileTypingLongString) {
+    TestDriver driver;
+    auto       key_shift = KeymapKey(0, 0, 0, KC_RSFT);
+    set_keymap({key_shift});
+
+    std::string text;
+    for (int i = 0; i < 1000; i++) {
+        text += i % 10 == 9 ? ' ' : (char)('a' + i % 26);
+    }
+
+    /* Rebuild what was typed from the reports: every newly pressed key is one character */
+    std::vector<uint8_t> typed;
+    bool                 shift_seen         = false;
+    unsigned             reports_this_scan  = 0;
+    unsigned             max_reports_a_scan = 0;
+    uint8_t              last_key           = 0;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke([&](report_keyboard_t& report) {
+        reports_this_scan++;
+        shift_seen |= report.mods & MOD_BIT(KC_RSFT);
+        uint8_t key = report.keys[0];
+        if (key && key != last_key) {
+            typed.push_back(key);
+        }
+        last_key = key;
+    }));
+
+    send_string_handle_t handle = send_string_async(text.c_str(), 0);
+    unsigned             scans  = 0;
+    while (is_send_string_pending(handle) && scans < 10000) {
+        // Hold a real key in the middle of the string, it has to get through right away
+        if (scans == 500) {
+            key_shift.press();
+        }
+        if (scans == 510) {
+            EXPECT_TRUE(shift_seen);
+            key_shift.release();
+        }
+        reports_this_scan = 0;
+        run_one_scan_loop();
+        max_reports_a_scan = std::max(max_reports_a_scan, reports_this_scan);
+        scans++;
+    }
+
+    EXPECT_FALSE(is_send_string_pending(handle));
+    // One character per scan, plus the scan that retires the string
+    EXPECT_EQ(scans, text.size() + 1);
+    EXPECT_LE(max_reports_a_scan, 3u);
+
+    ASSERT_EQ(typed.size(), text.size());
+    for (size_t i = 0; i < text.size(); i++) {
+        uint8_t expected = text[i] == ' ' ? KC_SPC : KC_A + (text[i] - 'a');
+        EXPECT_EQ(typed[i], expected) << "at character " << i;
+    }
+}
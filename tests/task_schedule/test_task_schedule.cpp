@@ -0,0 +1,142 @@
+/* Copyright 2021 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keycode.h"
+#include "mousekey.h"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+
+/* Schedules are linked into a global list, so they have to outlive the test */
+static task_schedule_t schedule;
+static unsigned        invocations;
+static uint32_t        next_delay;
+
+static uint32_t fake_task(void) {
+    invocations++;
+    return next_delay;
+}
+
+class TaskSchedule : public TestFixture {
+   protected:
+    void SetUp() override {
+        invocations = 0;
+        next_delay  = TASK_IDLE;
+        // Make sure the schedule is registered and has run once
+        run_fake_task();
+        invocations = 0;
+    }
+
+    void TearDown() override {
+        next_delay = TASK_IDLE;
+        run_fake_task();
+    }
+
+    void run_fake_task() {
+        if (task_schedule_due(&schedule)) {
+            task_schedule_update(&schedule, fake_task());
+        }
+    }
+
+    void run_for(unsigned ms) {
+        for (unsigned i = 0; i < ms; i++) {
+            run_one_scan_loop();
+            run_fake_task();
+        }
+    }
+};
+
+TEST_F(TaskSchedule, AlwaysRunningTaskRunsEveryLoop) {
+    TestDriver driver;
+    next_delay = TASK_RUN_ALWAYS;
+    task_schedule_wake();
+    run_for(1000);
+    EXPECT_EQ(invocations, 1000u);
+}
+
+TEST_F(TaskSchedule, IdleTaskWaitsForInput) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+    set_keymap({key});
+
+    run_for(1000);
+    EXPECT_EQ(invocations, 0u);
+    EXPECT_EQ(task_schedule_idle_time(), TASK_IDLE);
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    key.press();
+    run_for(1000);
+    EXPECT_EQ(invocations, 1u);
+
+    key.release();
+    run_for(1000);
+    EXPECT_EQ(invocations, 2u);
+}
+
+TEST_F(TaskSchedule, TaskRunsAtItsDeadline) {
+    TestDriver driver;
+    next_delay = 100;
+    task_schedule_wake();
+    run_for(1000);
+    EXPECT_EQ(invocations, 10u);
+    EXPECT_LE(task_schedule_idle_time(), 100u);
+    EXPECT_GT(task_schedule_idle_time(), 0u);
+}
+
+TEST_F(TaskSchedule, IdleTimeIsZeroWhenTaskIsDue) {
+    TestDriver driver;
+    next_delay = 10;
+    task_schedule_wake();
+    EXPECT_EQ(task_schedule_idle_time(), 0u);
+    run_for(1);
+    EXPECT_EQ(task_schedule_idle_time(), 10u);
+    run_for(9);
+    EXPECT_EQ(task_schedule_idle_time(), 1u);
+}
+
+TEST_F(TaskSchedule, MousekeyTaskSleepsWhenNoMovementIsActive) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_MS_UP);
+    set_keymap({key});
+
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber());
+    key.press();
+    run_for(100);
+    // Holding a mouse key keeps the mousekey task on a short deadline
+    EXPECT_NE(task_schedule_idle_time(), TASK_IDLE);
+
+    key.release();
+    run_for(100);
+    EXPECT_EQ(task_schedule_idle_time(), TASK_IDLE);
+}
+
+TEST_F(TaskSchedule, MousekeyOnWakesTheMousekeyTask) {
+    TestDriver driver;
+    run_for(100);
+    EXPECT_EQ(task_schedule_idle_time(), TASK_IDLE);
+
+    // Called straight from user code, without a key event to wake the scheduler
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(testing::AtLeast(1));
+    mousekey_on(KC_MS_UP);
+    run_for(300);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_mouse_mock(_)).Times(AnyNumber());
+    mousekey_off(KC_MS_UP);
+    run_for(100);
+    EXPECT_EQ(task_schedule_idle_time(), TASK_IDLE);
+}
@@ -15,10 +15,11 @@
  */
 
 #include "test_driver.hpp"
+#include "timer.h"
 
 TestDriver* TestDriver::m_this = nullptr;
 
-TestDriver::TestDriver() : m_driver{&TestDriver::keyboard_leds, &TestDriver::send_keyboard, &TestDriver::send_mouse, &TestDriver::send_system, &TestDriver::send_consumer} {
+TestDriver::TestDriver() : m_driver{&TestDriver::keyboard_leds, &TestDriver::send_keyboard, &TestDriver::send_mouse, &TestDriver::send_system, &TestDriver::send_consumer, nullptr, &TestDriver::report_ready} {
     host_set_driver(&m_driver);
     m_this = this;
 }
@@ -27,13 +28,39 @@ TestDriver::~TestDriver() { m_this = nullptr; }
 
 uint8_t TestDriver::keyboard_leds(void) { return m_this->m_leds; }
 
+bool TestDriver::report_ready(host_report_type_t type) {
+    if (m_this->m_endpoint_busy[type] && timer_elapsed32(m_this->m_endpoint_since[type]) >= m_this->m_endpoint_delay) {
+        m_this->m_endpoint_busy[type] = false;
+    }
+    return !m_this->m_endpoint_busy[type];
+}
+
+void TestDriver::start_transfer(host_report_type_t type) {
+    if (m_this->m_endpoint_delay == 0) {
+        return;
+    }
+    EXPECT_TRUE(report_ready(type)) << "report sent while the endpoint was still busy";
+    m_this->m_endpoint_busy[type]  = true;
+    m_this->m_endpoint_since[type] = timer_read32();
+}
+
 void TestDriver::send_keyboard(report_keyboard_t* report) {
     test_logger.trace() << *report;
+    start_transfer(HOST_REPORT_KEYBOARD);
     m_this->send_keyboard_mock(*report);
 }
 
-void TestDriver::send_mouse(report_mouse_t* report) { m_this->send_mouse_mock(*report); }
+void TestDriver::send_mouse(report_mouse_t* report) {
+    start_transfer(HOST_REPORT_MOUSE);
+    m_this->send_mouse_mock(*report);
+}
 
-void TestDriver::send_system(uint16_t data) { m_this->send_system_mock(data); }
+void TestDriver::send_system(uint16_t data) {
+    start_transfer(HOST_REPORT_EXTRA);
+    m_this->send_system_mock(data);
+}
 
-void TestDriver::send_consumer(uint16_t data) { m_this->send_consumer(data); }
+void TestDriver::send_consumer(uint16_t data) {
+    start_transfer(HOST_REPORT_EXTRA);
+    m_this->send_consumer_mock(data);
+}
@@ -27,6 +27,8 @@ class TestDriver {
     TestDriver();
     ~TestDriver();
     void set_leds(uint8_t leds) { m_leds = leds; }
+    /* Keeps each endpoint busy for this long after a report, like a host that is slow to poll */
+    void set_endpoint_delay(uint32_t ms) { m_endpoint_delay = ms; }
 
     MOCK_METHOD1(send_keyboard_mock, void(report_keyboard_t&));
     MOCK_METHOD1(send_mouse_mock, void(report_mouse_t&));
@@ -39,7 +41,12 @@ class TestDriver {
     static void        send_mouse(report_mouse_t* report);
     static void        send_system(uint16_t data);
     static void        send_consumer(uint16_t data);
+    static bool        report_ready(host_report_type_t type);
+    static void        start_transfer(host_report_type_t type);
     host_driver_t      m_driver;
-    uint8_t            m_leds = 0;
+    uint8_t            m_leds           = 0;
+    uint32_t           m_endpoint_delay = 0;
+    bool               m_endpoint_busy[HOST_REPORT_EXTRA + 1]{};
+    uint32_t           m_endpoint_since[HOST_REPORT_EXTRA + 1]{};
     static TestDriver* m_this;
 };
@@ -22,6 +22,7 @@ extern "C" {
 #include "eeconfig.h"
 #include "keyboard.h"
 #include "keymap.h"
+#include "host.h"
 
 void set_time(uint32_t t);
 void advance_time(uint32_t ms);
@@ -148,6 +149,10 @@ void TestFixture::get_keycode(const layer_t layer, const keypos_t position, uint
 void TestFixture::run_one_scan_loop() {
     keyboard_task();
     advance_time(1);
+#ifdef HOST_REPORT_QUEUE
+    /* Stands in for the IN callbacks of whatever the endpoints finished sending meanwhile */
+    host_report_sent();
+#endif
 }
 
 void TestFixture::idle_for(unsigned time) {
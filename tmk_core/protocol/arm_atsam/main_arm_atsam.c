@@ -41,7 +41,7 @@ void    send_system(uint16_t data);
 void    send_consumer(uint16_t data);
 
 #ifdef DEFERRED_EXEC_ENABLE
-void deferred_exec_task(void);
+uint32_t deferred_exec_task(void);
 #endif  // DEFERRED_EXEC_ENABLE
 
 host_driver_t arm_atsam_driver = {keyboard_leds, send_keyboard, send_mouse, send_system, send_consumer};
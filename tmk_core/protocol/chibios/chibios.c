@@ -61,9 +61,16 @@ void    send_mouse(report_mouse_t *report);
 void    send_system(uint16_t data);
 void    send_consumer(uint16_t data);
 void    send_digitizer(report_digitizer_t *report);
+#ifdef HOST_REPORT_QUEUE
+bool report_ready(host_report_type_t type);
+#endif
 
 /* host struct */
+#ifdef HOST_REPORT_QUEUE
+host_driver_t chibios_driver = {keyboard_leds, send_keyboard, send_mouse, send_system, send_consumer, NULL, report_ready};
+#else
 host_driver_t chibios_driver = {keyboard_leds, send_keyboard, send_mouse, send_system, send_consumer};
+#endif
 
 #ifdef VIRTSER_ENABLE
 void virtser_task(void);
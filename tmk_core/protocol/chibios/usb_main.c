@@ -766,9 +766,13 @@ __attribute__((weak)) void restart_usb_driver(USBDriver *usbp) {
 /* keyboard IN callback hander (a kbd report has made it IN) */
 #ifndef KEYBOARD_SHARED_EP
 void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
     (void)usbp;
     (void)ep;
+#    ifdef HOST_REPORT_QUEUE
+    osalSysLockFromISR();
+    host_report_sent();
+    osalSysUnlockFromISR();
+#    endif
 }
 #endif
 
@@ -817,10 +821,46 @@ static void keyboard_idle_timer_cb(void *arg) {
 /* LED status */
 uint8_t keyboard_leds(void) { return keyboard_led_state; }
 
+#ifdef HOST_REPORT_QUEUE
+/* The host queue only sends a report once report_ready() said its endpoint is free,
+ * and does so with the system already locked, also from the IN callbacks */
+#    define send_report_lock()
+#    define send_report_unlock()
+
+bool report_ready(host_report_type_t type) {
+    /* reports are dropped while USB is down, as they would be without the queue */
+    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
+        return true;
+    }
+    switch (type) {
+        case HOST_REPORT_KEYBOARD:
+#    ifdef NKRO_ENABLE
+            if (keymap_config.nkro && keyboard_protocol) {
+                return !usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM);
+            }
+#    endif
+            return !usbGetTransmitStatusI(&USB_DRIVER, KEYBOARD_IN_EPNUM);
+#    ifdef MOUSE_ENABLE
+        case HOST_REPORT_MOUSE:
+            return !usbGetTransmitStatusI(&USB_DRIVER, MOUSE_IN_EPNUM);
+#    endif
+#    ifdef EXTRAKEY_ENABLE
+        case HOST_REPORT_EXTRA:
+            return !usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM);
+#    endif
+        default:
+            return true;
+    }
+}
+#else
+#    define send_report_lock() osalSysLock()
+#    define send_report_unlock() osalSysUnlock()
+#endif
+
 /* prepare and start sending a report IN
- * not callable from ISR or locked state */
+ * not callable from ISR or locked state, unless HOST_REPORT_QUEUE is enabled */
 void send_keyboard(report_keyboard_t *report) {
-    osalSysLock();
+    send_report_lock();
     if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
         goto unlock;
     }
@@ -875,7 +915,7 @@ void send_keyboard(report_keyboard_t *report) {
     keyboard_report_sent = *report;
 
 unlock:
-    osalSysUnlock();
+    send_report_unlock();
 }
 
 /* ---------------------------------------------------------
@@ -890,13 +930,18 @@ unlock:
 void mouse_in_cb(USBDriver *usbp, usbep_t ep) {
     (void)usbp;
     (void)ep;
+#        ifdef HOST_REPORT_QUEUE
+    osalSysLockFromISR();
+    host_report_sent();
+    osalSysUnlockFromISR();
+#        endif
 }
 #    endif
 
 void send_mouse(report_mouse_t *report) {
-    osalSysLock();
+    send_report_lock();
     if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
+        send_report_unlock();
         return;
     }
 
@@ -906,12 +951,12 @@ void send_mouse(report_mouse_t *report) {
          * no interrupts served, so USB not going through as well.
          * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
         if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[MOUSE_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
+            send_report_unlock();
             return;
         }
     }
     usbStartTransmitI(&USB_DRIVER, MOUSE_IN_EPNUM, (uint8_t *)report, sizeof(report_mouse_t));
-    osalSysUnlock();
+    send_report_unlock();
 }
 
 #else  /* MOUSE_ENABLE */
@@ -925,9 +970,13 @@ void send_mouse(report_mouse_t *report) { (void)report; }
 #ifdef SHARED_EP_ENABLE
 /* shared IN callback hander */
 void shared_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
     (void)usbp;
     (void)ep;
+#    ifdef HOST_REPORT_QUEUE
+    osalSysLockFromISR();
+    host_report_sent();
+    osalSysUnlockFromISR();
+#    endif
 }
 #endif
 
@@ -938,9 +987,9 @@ void shared_in_cb(USBDriver *usbp, usbep_t ep) {
 
 #ifdef EXTRAKEY_ENABLE
 static void send_extra(uint8_t report_id, uint16_t data) {
-    osalSysLock();
+    send_report_lock();
     if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
+        send_report_unlock();
         return;
     }
 
@@ -950,7 +999,7 @@ static void send_extra(uint8_t report_id, uint16_t data) {
          * no interrupts served, so USB not going through as well.
          * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
         if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
+            send_report_unlock();
             return;
         }
     }
@@ -959,7 +1008,7 @@ static void send_extra(uint8_t report_id, uint16_t data) {
     report = (report_extra_t){.report_id = report_id, .usage = data};
 
     usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report_extra_t));
-    osalSysUnlock();
+    send_report_unlock();
 }
 #endif
 
@@ -29,11 +29,202 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 extern keymap_config_t keymap_config;
 #endif
 
+#ifdef HOST_REPORT_QUEUE
+#    include <string.h>
+#    include "atomic_util.h"
+#    include "wait.h"
+
+#    ifndef HOST_REPORT_QUEUE_SIZE
+#        define HOST_REPORT_QUEUE_SIZE 4
+#    endif
+#    ifndef HOST_REPORT_QUEUE_TIMEOUT
+#        define HOST_REPORT_QUEUE_TIMEOUT 10
+#    endif
+#endif
+
 static host_driver_t *driver;
 static uint16_t       last_system_report              = 0;
 static uint16_t       last_consumer_report            = 0;
 static uint32_t       last_programmable_button_report = 0;
 
+#ifdef HOST_REPORT_QUEUE
+/* Reports wait here while their endpoint is busy, and are handed to the driver as soon as
+ * it is free again. The report last handed over stays put, the driver may still be sending it.
+ */
+typedef struct {
+    uint8_t head;
+    uint8_t count;
+} report_ring_t;
+
+static report_keyboard_t keyboard_queue[HOST_REPORT_QUEUE_SIZE];
+static report_keyboard_t keyboard_in_flight;
+static report_ring_t     keyboard_ring;
+static report_mouse_t    mouse_queue[HOST_REPORT_QUEUE_SIZE];
+static report_mouse_t    mouse_in_flight;
+static report_ring_t     mouse_ring;
+static report_extra_t    extra_queue[HOST_REPORT_QUEUE_SIZE];
+static report_ring_t     extra_ring;
+
+static uint8_t ring_index(report_ring_t *ring, uint8_t n) { return (ring->head + n) % HOST_REPORT_QUEUE_SIZE; }
+
+static uint8_t ring_pop(report_ring_t *ring) {
+    uint8_t index = ring->head;
+    ring->head    = ring_index(ring, 1);
+    ring->count--;
+    return index;
+}
+
+/* Byte i of the state of every key in the report, byte 0 holds the mods */
+#    define KEYBOARD_STATE_BYTES 33
+static uint8_t keyboard_report_state(const report_keyboard_t *report, uint8_t i) {
+#    ifdef NKRO_ENABLE
+    if (keyboard_protocol && keymap_config.nkro) {
+        if (i == 0) return report->nkro.mods;
+        return i <= KEYBOARD_REPORT_BITS ? report->nkro.bits[i - 1] : 0;
+    }
+#    endif
+    if (i == 0) return report->mods;
+    uint8_t state = 0;
+    for (uint8_t k = 0; k < KEYBOARD_REPORT_KEYS; k++) {
+        if (report->keys[k] && report->keys[k] / 8 == i - 1) {
+            state |= 1 << (report->keys[k] % 8);
+        }
+    }
+    return state;
+}
+
+/* Whether next can replace last without the host missing a press or a release, or seeing two presses at once that happened one after the other */
+static bool keyboard_report_supersedes(const report_keyboard_t *prev, const report_keyboard_t *last, const report_keyboard_t *next) {
+    uint8_t pressed_by_last = 0;
+    uint8_t pressed_by_next = 0;
+    for (uint8_t i = 0; i < KEYBOARD_STATE_BYTES; i++) {
+        uint8_t p = keyboard_report_state(prev, i);
+        uint8_t l = keyboard_report_state(last, i);
+        uint8_t n = keyboard_report_state(next, i);
+        if ((p ^ l) & (l ^ n)) {
+            return false;
+        }
+        pressed_by_last |= l & ~p;
+        pressed_by_next |= n & ~l;
+    }
+    return !(pressed_by_last && pressed_by_next);
+}
+
+/* Duplicates are always dropped, other keyboard states only replace the one queued last once the queue is full */
+static bool keyboard_queue_push(const report_keyboard_t *report) {
+    if (keyboard_ring.count) {
+        report_keyboard_t *last = &keyboard_queue[ring_index(&keyboard_ring, keyboard_ring.count - 1)];
+        report_keyboard_t *prev = keyboard_ring.count > 1 ? &keyboard_queue[ring_index(&keyboard_ring, keyboard_ring.count - 2)] : &keyboard_in_flight;
+        if (memcmp(last, report, sizeof(report_keyboard_t)) == 0 || (keyboard_ring.count == HOST_REPORT_QUEUE_SIZE && keyboard_report_supersedes(prev, last, report))) {
+            *last = *report;
+            return true;
+        }
+    }
+    if (keyboard_ring.count == HOST_REPORT_QUEUE_SIZE) {
+        return false;
+    }
+    keyboard_queue[ring_index(&keyboard_ring, keyboard_ring.count++)] = *report;
+    return true;
+}
+
+static bool mouse_delta_fits(int32_t sum, int32_t max) { return sum >= -max && sum <= max; }
+
+/* Movement adds up into the report queued last, as long as the buttons stay the same */
+static bool mouse_queue_push(const report_mouse_t *report) {
+    if (mouse_ring.count) {
+        report_mouse_t *last = &mouse_queue[ring_index(&mouse_ring, mouse_ring.count - 1)];
+        if (last->buttons == report->buttons && mouse_delta_fits(last->x + report->x, MOUSE_REPORT_XY_MAX) && mouse_delta_fits(last->y + report->y, MOUSE_REPORT_XY_MAX) && mouse_delta_fits(last->v + report->v, INT8_MAX) && mouse_delta_fits(last->h + report->h, INT8_MAX)) {
+            last->x += report->x;
+            last->y += report->y;
+            last->v += report->v;
+            last->h += report->h;
+            return true;
+        }
+    }
+    if (mouse_ring.count == HOST_REPORT_QUEUE_SIZE) {
+        return false;
+    }
+    mouse_queue[ring_index(&mouse_ring, mouse_ring.count++)] = *report;
+    return true;
+}
+
+static bool extra_queue_push(const report_extra_t *report) {
+    if (extra_ring.count == HOST_REPORT_QUEUE_SIZE) {
+        return false;
+    }
+    extra_queue[ring_index(&extra_ring, extra_ring.count++)] = *report;
+    return true;
+}
+
+void host_report_sent(void) {
+    if (!driver || !driver->report_ready) return;
+
+    while (keyboard_ring.count && driver->report_ready(HOST_REPORT_KEYBOARD)) {
+        keyboard_in_flight = keyboard_queue[ring_pop(&keyboard_ring)];
+        (*driver->send_keyboard)(&keyboard_in_flight);
+    }
+    while (mouse_ring.count && driver->report_ready(HOST_REPORT_MOUSE)) {
+        mouse_in_flight = mouse_queue[ring_pop(&mouse_ring)];
+        (*driver->send_mouse)(&mouse_in_flight);
+    }
+    while (extra_ring.count && driver->report_ready(HOST_REPORT_EXTRA)) {
+        report_extra_t *report = &extra_queue[ring_pop(&extra_ring)];
+        if (report->report_id == REPORT_ID_SYSTEM) {
+            (*driver->send_system)(report->usage);
+        } else {
+            (*driver->send_consumer)(report->usage);
+        }
+    }
+}
+
+static bool host_report_queue_push(host_report_type_t type, const void *report) {
+    switch (type) {
+        case HOST_REPORT_KEYBOARD:
+            return keyboard_queue_push(report);
+        case HOST_REPORT_MOUSE:
+            return mouse_queue_push(report);
+        case HOST_REPORT_EXTRA:
+            return extra_queue_push(report);
+    }
+    return false;
+}
+
+static void host_report_queue_drop_oldest(host_report_type_t type) {
+    switch (type) {
+        case HOST_REPORT_KEYBOARD:
+            ring_pop(&keyboard_ring);
+            break;
+        case HOST_REPORT_MOUSE:
+            ring_pop(&mouse_ring);
+            break;
+        case HOST_REPORT_EXTRA:
+            ring_pop(&extra_ring);
+            break;
+    }
+}
+
+/* Queues the report and sends whatever the endpoints can take. When nothing in a full queue
+ * could be coalesced, this waits for the endpoint, like the driver would without the queue.
+ * A host that stops reading the endpoint altogether loses the oldest queued report after
+ * HOST_REPORT_QUEUE_TIMEOUT ms, instead of stalling the keyboard.
+ */
+static void host_report_queue(host_report_type_t type, const void *report) {
+    bool queued = false;
+    for (uint16_t waited = 0;; waited++) {
+        ATOMIC_BLOCK_FORCEON {
+            queued = host_report_queue_push(type, report);
+            if (!queued && waited >= HOST_REPORT_QUEUE_TIMEOUT) {
+                host_report_queue_drop_oldest(type);
+                queued = host_report_queue_push(type, report);
+            }
+            host_report_sent();
+        }
+        if (queued) return;
+        wait_ms(1);
+    }
+}
+#endif
+
 void host_set_driver(host_driver_t *d) { driver = d; }
 
 host_driver_t *host_get_driver(void) { return driver; }
@@ -70,7 +261,14 @@ void host_keyboard_send(report_keyboard_t *report) {
         report->report_id = REPORT_ID_KEYBOARD;
 #endif
     }
-    (*driver->send_keyboard)(report);
+#ifdef HOST_REPORT_QUEUE
+    if (driver->report_ready) {
+        host_report_queue(HOST_REPORT_KEYBOARD, report);
+    } else
+#endif
+    {
+        (*driver->send_keyboard)(report);
+    }
 
     if (debug_keyboard) {
         dprint("keyboard_report: ");
@@ -85,6 +283,12 @@ void host_mouse_send(report_mouse_t *report) {
     if (!driver) return;
 #ifdef MOUSE_SHARED_EP
     report->report_id = REPORT_ID_MOUSE;
+#endif
+#ifdef HOST_REPORT_QUEUE
+    if (driver->report_ready) {
+        host_report_queue(HOST_REPORT_MOUSE, report);
+        return;
+    }
 #endif
     (*driver->send_mouse)(report);
 }
@@ -94,6 +298,12 @@ void host_system_send(uint16_t report) {
     last_system_report = report;
 
     if (!driver) return;
+#ifdef HOST_REPORT_QUEUE
+    if (driver->report_ready) {
+        host_report_queue(HOST_REPORT_EXTRA, &(report_extra_t){.report_id = REPORT_ID_SYSTEM, .usage = report});
+        return;
+    }
+#endif
     (*driver->send_system)(report);
 }
 
@@ -102,6 +312,12 @@ void host_consumer_send(uint16_t report) {
     last_consumer_report = report;
 
     if (!driver) return;
+#ifdef HOST_REPORT_QUEUE
+    if (driver->report_ready) {
+        host_report_queue(HOST_REPORT_EXTRA, &(report_extra_t){.report_id = REPORT_ID_CONSUMER, .usage = report});
+        return;
+    }
+#endif
     (*driver->send_consumer)(report);
 }
 
@@ -49,6 +49,9 @@ void    host_system_send(uint16_t data);
 void    host_consumer_send(uint16_t data);
 void    host_programmable_button_send(uint32_t data);
 
+/* with HOST_REPORT_QUEUE, called by the driver with interrupts locked once an endpoint is free again */
+void host_report_sent(void);
+
 uint16_t host_last_system_report(void);
 uint16_t host_last_consumer_report(void);
 uint32_t host_last_programmable_button_report(void);
@@ -18,11 +18,18 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "report.h"
 #ifdef MIDI_ENABLE
 #    include "midi.h"
 #endif
 
+typedef enum {
+    HOST_REPORT_KEYBOARD,
+    HOST_REPORT_MOUSE,
+    HOST_REPORT_EXTRA,  // system and consumer
+} host_report_type_t;
+
 typedef struct {
     uint8_t (*keyboard_leds)(void);
     void (*send_keyboard)(report_keyboard_t *);
@@ -30,6 +37,10 @@ typedef struct {
     void (*send_system)(uint16_t);
     void (*send_consumer)(uint16_t);
     void (*send_programmable_button)(uint32_t);
+    /* Optional, for HOST_REPORT_QUEUE: whether a report of this type can be sent without waiting.
+     * Drivers that set it get their reports from the queue, with interrupts locked, and call
+     * host_report_sent() once a transfer completes. */
+    bool (*report_ready)(host_report_type_t);
 } host_driver_t;
 
 void send_digitizer(report_digitizer_t *report);
\ No newline at end of file
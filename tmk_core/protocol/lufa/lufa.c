@@ -72,6 +72,10 @@ extern keymap_config_t keymap_config;
 #    else
 #        include "../serial.h"
 #    endif
+#    if defined(MOUSE_ENABLE) && defined(MOUSE_EXTENDED_REPORT)
+// Both Bluetooth paths in send_mouse() only carry 8-bit X/Y, larger moves would wrap around
+#        error "MOUSE_EXTENDED_REPORT is not supported with BLUETOOTH_ENABLE"
+#    endif
 #endif
 
 #ifdef VIRTSER_ENABLE